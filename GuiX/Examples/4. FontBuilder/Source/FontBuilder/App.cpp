@@ -5,6 +5,7 @@
 #include <GuiX/Localize.h>
 #include <GuiX/Context.h>
 #include <GuiX/Style.h>
+#include <GuiX/Text.h>
 
 #include <Shared/CodepointRange.h>
 #include <Shared/CodepointPreset.h>
@@ -747,6 +748,11 @@ GxString MainWindow::myExportFile()
 	fwrite(output.Raw(), 1, output.Length(), file);
 	fclose(file);
 
+	// Convert the text file to a binary font file, which loads faster.
+	GxString binPath = fontPath + fontName + ".gxf";
+	if(!GxFontDatabase::Get()->ConvertFont(txtPath.Raw(), binPath.Raw()))
+		return "Failed to write the binary font file: " + binPath;
+
 	// Report that the exporting was succesful.
 	app->MessageDialog("Done exporting", "Finished exporting: " + fontName);
 
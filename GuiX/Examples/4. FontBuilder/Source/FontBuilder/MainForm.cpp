@@ -41,13 +41,13 @@ void MainForm::Create(GxContext* context, GxCallback* callback)
 	settings->Add(new GxLabel("Output name"));
 	settings->Add(nameEdit = new GxLineEdit, 2);
 	nameEdit->SetToolTip("The file name that is used to create the "
-		"font XML file and glyph page images.");
+		"text and binary font files and glyph page images.");
 
 	settings->Add(new GxLabel("Output folder"));
 	settings->Add(folderEdit = new GxLineEdit);
 	settings->Add(new GxButton(idFolder, "Select folder..."));
 	folderEdit->SetToolTip("The directory to which the "
-		"font XML file and glyph page images are saved.");
+		"text and binary font files and glyph page images are saved.");
 
 	settings->Add(new GxLabel("Output font size"));
 	settings->Add(sizeEdit = new GxSpinner, 2);
@@ -47,8 +47,10 @@ void PageForm::Create(GxContext* context, GxCallback* callback)
 
 	// Create page frame.
 	GxFrameV* pageFrame = new GxFrameV;
-	pageFrame->GetPolicy().adjustFlags = false;
-	pageFrame->GetPolicy().flagsH = GX_SP_RESIZE;
+	GxSizePolicy pagePolicy = pageFrame->GetPolicy();
+	pagePolicy.adjustFlags = false;
+	pagePolicy.flagsH = GX_SP_RESIZE;
+	pageFrame->SetPolicy(pagePolicy);
 	frameTop->Add(pageFrame);
 
 	// Create font entries widgets.
@@ -105,7 +107,9 @@ void PageForm::Create(GxContext* context, GxCallback* callback)
 
 	fontGrid->Add(charsetList = new GxSelectList);
 	charsetList->SetToolTip("List of characters for which glyph images are rendered.");
-	charsetList->GetPolicy().flagsH = GX_SP_EXPAND;
+	GxSizePolicy charsetPolicy = charsetList->GetPolicy();
+	charsetPolicy.flagsH = GX_SP_EXPAND;
+	charsetList->SetPolicy(charsetPolicy);
 
 	GxFrameV* csbFrame = new GxFrameV;
 	fontGrid->Add(csbFrame);
@@ -0,0 +1,1540 @@
+// ***** Benchmark example implementation ********************************************
+//
+// This example builds a set of reproducible widget scenes and measures the time spent
+// in GxContext::Tick and GxContext::Draw per frame, along with the geometry that GuiX
+// submits to the render interface. It does not open a window; the scenes are drawn with
+// a null renderer, which only counts the geometry, or with the headless software renderer.
+// With --deferred, GxDraw records the geometry and reorders it by texture before drawing.
+// With --cache, every widget caches its geometry and only records it again when it changes.
+// With --xml, it measures the xml parsers on a generated localization document instead.
+// With --strings, it measures common string operations and the heap allocations they make.
+// With --refcount, it measures reference counting, and stress tests sharing between threads.
+// With --localize, it measures loading translations and looking them up.
+// With --resources, it measures loading, freezing and looking up a large set of resources.
+//
+// Usage: Benchmark [--frames n] [--size wxh] [--scene name] [--software] [--deferred] [--cache]
+//                  [--xml] [--strings] [--refcount] [--localize] [--resources]
+//
+// ***********************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <time.h>
+	#include <pthread.h>
+#endif
+
+#include <GuiX/Core.h>
+#include <GuiX/Draw.h>
+#include <GuiX/Input.h>
+#include <GuiX/Widgets.h>
+#include <GuiX/Context.h>
+#include <GuiX/Localize.h>
+#include <GuiX/Resources.h>
+#include <GuiX/ListLayout.h>
+#include <GuiX/FreeLayout.h>
+
+#include <GuiX/RenderInterfaceSoftware.h>
+
+// The xml parsers are internal to GuiX.
+#include <Src/Xml.h>
+#include <Src/ContextImp.h>
+#include <Src/StringMap.h>
+
+using namespace guix;
+using namespace guix::framework;
+
+// ===================================================================================
+// Utility functions
+// ===================================================================================
+
+// Returns a timestamp in seconds from a high resolution monotonic clock.
+static double GetTime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static GxString Format(const char* fmt, int a, int b = 0)
+{
+	GxString str;
+	str.Format(fmt, a, b);
+	return str;
+}
+
+// Moves the mouse and presses the left mouse button. The context is ticked in between,
+// so the widget under the mouse becomes the hover widget before it receives the press.
+static void Press(GxContext* context, int x, int y)
+{
+	GxInput* input = GxInput::Get();
+	input->SetMousePos(x, y);
+	context->Tick(1 / 60.f);
+	input->OnMousePress(GX_MC_LEFT, x, y);
+}
+
+// ===================================================================================
+// BenchmarkRenderer
+// ===================================================================================
+
+// Counts the geometry submitted by GuiX, and only rasterizes it if requested.
+class BenchmarkRenderer : public GxRenderInterfaceSoftware
+{
+public:
+	BenchmarkRenderer(bool rasterize)
+		:drawCalls(0), vertices(0), triangles(0), myRasterize(rasterize) {}
+
+	void DrawTriangles(const GxVertex* v, int vertexCount, GxTextureHandle texture)
+	{
+		++drawCalls;
+		vertices += vertexCount;
+		triangles += vertexCount / 3;
+		if(myRasterize) GxRenderInterfaceSoftware::DrawTriangles(v, vertexCount, texture);
+	}
+
+	void DrawTriangles(const GxVertex* v, int vertexCount, const uint* indices, int indexCount, GxTextureHandle texture)
+	{
+		++drawCalls;
+		vertices += vertexCount;
+		triangles += indexCount / 3;
+		if(myRasterize) GxRenderInterfaceSoftware::DrawTriangles(v, vertexCount, indices, indexCount, texture);
+	}
+
+	void ResetCounters()
+	{
+		drawCalls = vertices = triangles = 0;
+	}
+
+	bool IsRasterizing() const
+	{
+		return myRasterize;
+	}
+
+	int drawCalls, vertices, triangles;
+
+private:
+	bool myRasterize;
+};
+
+// ===================================================================================
+// Scenes
+// ===================================================================================
+
+// A scene creates a widget hierarchy, and simulates user input before every frame.
+// Input is derived from the frame number only, so every run performs the same work.
+class Scene
+{
+public:
+	virtual ~Scene() {}
+
+	virtual const char* GetName() const = 0;
+	virtual GxWidget* Create(GxVec2i view) = 0;
+
+	// Called once after the first tick, when the widgets have been arranged.
+	virtual void Start(GxContext* context, GxVec2i view) {}
+
+	// By default, the mouse sweeps over the view to generate hover changes.
+	virtual void Step(int frame, GxVec2i view)
+	{
+		GxInput::Get()->SetMousePos((frame * 97) % view.x, (frame * 61) % view.y);
+	}
+};
+
+// 10,000 labels in a vertical scroll area, scrolled by the mouse wheel.
+class LabelScene : public Scene
+{
+public:
+	const char* GetName() const { return "labels"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxScrollArea* area = new GxScrollArea;
+		area->SetScrollV(true);
+		area->SetLayout(new GxListLayout);
+		for(int i=0; i<10000; ++i)
+			area->Add(new GxLabel(Format("Label number %i", i)));
+		return area;
+	}
+
+	void Step(int frame, GxVec2i view)
+	{
+		GxInput* input = GxInput::Get();
+		input->SetMousePos(view.x / 2, view.y / 2);
+		input->OnMouseScroll((frame / 100) % 2 == 1);
+	}
+};
+
+// 20,000 rows of widgets in a vertical scroll area with lazy arrangement, scrolled by the
+// mouse wheel while the mouse moves over the rows.
+class RowScene : public Scene
+{
+public:
+	const char* GetName() const { return "rows"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxScrollArea* area = new GxScrollArea;
+		area->SetScrollV(true);
+		area->SetLazyArrange(true);
+		area->SetLayout(new GxListLayout);
+		for(int i=0; i<20000; ++i)
+		{
+			GxFrameH* row = new GxFrameH;
+			row->Add(new GxLabel(Format("Row %i", i)));
+			row->Add(new GxCheckbox(NULL, "Enabled"));
+			row->Add(new GxButton(NULL, "Edit"));
+			area->Add(row);
+		}
+		return area;
+	}
+
+	void Step(int frame, GxVec2i view)
+	{
+		GxInput* input = GxInput::Get();
+		input->SetMousePos((frame * 97) % view.x, (frame * 61) % view.y);
+		input->OnMouseScroll((frame / 100) % 2 == 1);
+	}
+};
+
+// Frames nested six levels deep, alternating between horizontal and vertical lists, with
+// 4,096 buttons at the bottom level.
+class NestedScene : public Scene
+{
+public:
+	const char* GetName() const { return "nested"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		return myCreateLevel(0);
+	}
+
+private:
+	GxWidget* myCreateLevel(int depth)
+	{
+		if(depth == 6) return new GxButton(NULL, "Button");
+
+		GxFrame* frame = new GxFrame(new GxListLayout(depth % 2 == 0));
+		for(int i=0; i<4; ++i)
+			frame->Add(myCreateLevel(depth + 1));
+		return frame;
+	}
+};
+
+// Four select lists with 25,000 items each, scrolled and clicked by the mouse.
+class SelectListScene : public Scene
+{
+public:
+	const char* GetName() const { return "selectlist"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxFrameH* frame = new GxFrameH;
+		for(int i=0; i<4; ++i)
+		{
+			GxSelectList* list = new GxSelectList;
+			GxSizePolicy policy = list->GetPolicy();
+			policy.flagsH = GX_SP_EXPAND;
+			policy.flagsV = GX_SP_EXPAND;
+			list->SetPolicy(policy);
+			for(int j=0; j<25000; ++j)
+				list->AddItem(Format("List %i, item %i", i, j));
+			frame->Add(list);
+		}
+		return frame;
+	}
+
+	void Step(int frame, GxVec2i view)
+	{
+		// Clicks are sent to the widget that was hovered during the previous frame.
+		GxInput* input = GxInput::Get();
+		if(frame % 10 == 0)
+		{
+			const GxVec2i pos = input->GetMousePos();
+			input->OnMousePress(GX_MC_LEFT, pos.x, pos.y);
+			input->OnMouseRelease(GX_MC_LEFT, pos.x, pos.y);
+		}
+		input->OnMouseScroll((frame / 100) % 2 == 1);
+		input->SetMousePos((view.x / 8) * (1 + (frame % 4) * 2), view.y / 4 + (frame * 13) % (view.y / 2));
+	}
+};
+
+// Provides a million rows to a select list, formatting the text of a row when it is asked for.
+class RowModel : public GxListModel
+{
+public:
+	int list;
+
+	int GetRowCount() const { return 1000000; }
+	GxString GetRowText(int index) const { return Format("List %i, row %i", list, index); }
+};
+
+// Four select lists backed by models with a million rows each, driven like the select list scene.
+class VirtualListScene : public SelectListScene
+{
+public:
+	const char* GetName() const { return "virtuallist"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxFrameH* frame = new GxFrameH;
+		for(int i=0; i<4; ++i)
+		{
+			GxSelectList* list = new GxSelectList;
+			GxSizePolicy policy = list->GetPolicy();
+			policy.flagsH = GX_SP_EXPAND;
+			policy.flagsV = GX_SP_EXPAND;
+			list->SetPolicy(policy);
+			myModels[i].list = i;
+			list->SetModel(&myModels[i]);
+			frame->Add(list);
+		}
+		return frame;
+	}
+
+private:
+	RowModel myModels[4];
+};
+
+// Provides 100,000 rows to a droplist, named like the items of the droplist scene.
+class NameModel : public GxListModel
+{
+public:
+	int GetRowCount() const { return 100000; }
+	GxString GetRowText(int index) const { return DroplistName(index); }
+
+	static GxString DroplistName(int i)
+	{
+		const char name[4] = {(char)('a' + i % 26), (char)('a' + (i / 26) % 26), (char)('a' + (i / 676) % 26), 0};
+		return GxString(name) + Format(" item %i", i);
+	}
+};
+
+// Two droplists, one with 5,000 items and one backed by a model with 100,000 rows. Every 20
+// frames one of them is opened, searched by typing a few characters, and closed by a click.
+class DroplistScene : public Scene
+{
+public:
+	const char* GetName() const { return "droplist"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxFrame* frame = new GxFrame(new GxListLayout);
+		myLists[0] = new GxDroplist;
+		for(int i=0; i<5000; ++i)
+			myLists[0]->AddItem(NameModel::DroplistName(i));
+		myLists[1] = new GxDroplist;
+		myLists[1]->SetModel(&myModel);
+		frame->Add(myLists[0]);
+		frame->Add(myLists[1]);
+		return frame;
+	}
+
+	void Step(int frame, GxVec2i view)
+	{
+		// Clicks are sent to the widget that was hovered during the previous frame.
+		GxInput* input = GxInput::Get();
+		const GxRecti& r = myLists[(frame / 20) % 2]->GetRect();
+		const int t = frame % 20;
+		input->SetMousePos(r.x + r.w / 2, r.y + r.h / 2);
+		if(t == 1 || t == 10)
+		{
+			input->OnMousePress(GX_MC_LEFT, r.x + r.w / 2, r.y + r.h / 2);
+			input->OnMouseRelease(GX_MC_LEFT, r.x + r.w / 2, r.y + r.h / 2);
+		}
+		else if(t > 1 && t < 6)
+		{
+			input->OnTextInput(GxString((char)('a' + (frame * 7 + t) % 26), 1));
+		}
+	}
+
+private:
+	GxDroplist* myLists[2];
+	NameModel myModel;
+};
+
+// A multi-line text edit containing 2,500 lines (200,000 characters), more than the 2048 lines
+// that text drawn without a retained layout is limited to. The caret is moved to the end of the
+// text, which receives a typed character every frame and a new line every sixteen frames.
+class TextEditScene : public Scene
+{
+public:
+	const char* GetName() const { return "textedit"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxString text;
+		for(int i=0; i<2500; ++i)
+			text.Append(Format("%04i The quick brown fox jumps over the lazy dog; pack my box with liquor jugs!\n", i));
+
+		return new GxTextEdit(NULL, text);
+	}
+
+	void Start(GxContext* context, GxVec2i view)
+	{
+		Press(context, view.x / 2, view.y / 2);
+		GxInput* input = GxInput::Get();
+		input->OnMouseRelease(GX_MC_LEFT, view.x / 2, view.y / 2);
+		input->OnKeyPress(GX_KC_END);
+		input->OnKeyRelease(GX_KC_END);
+	}
+
+	void Step(int frame, GxVec2i view)
+	{
+		GxInput* input = GxInput::Get();
+		if(frame % 16 == 15)
+		{
+			input->OnKeyPress(GX_KC_RETURN);
+			input->OnKeyRelease(GX_KC_RETURN);
+		}
+		else
+		{
+			input->OnTextInput(GxString((char)('a' + frame % 26), 1));
+		}
+	}
+};
+
+// A dock area with eight docked and four floating docks; one floating dock is dragged
+// around by the mouse.
+class DockScene : public Scene
+{
+public:
+	const char* GetName() const { return "docks"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxDockArea* area = new GxDockArea;
+		area->SetDockBins(GxDockArea::DOCK_LR);
+		for(int i=0; i<12; ++i)
+		{
+			GxDock* dock = area->AddDock();
+			dock->SetTitle(Format("Dock %i", i));
+			dock->SetLayout(new GxListLayout);
+			for(int j=0; j<5; ++j)
+			{
+				dock->Add(new GxLabel(Format("Setting %i", j)));
+				dock->Add(new GxCheckbox(NULL, "Enabled"));
+				dock->Add(new GxSliderH);
+				dock->Add(new GxLineEdit(NULL, "Value"));
+			}
+			if(i < 8)
+			{
+				dock->Dock(i % 2 ? GxDock::BIN_RIGHT : GxDock::BIN_LEFT);
+			}
+			else
+			{
+				dock->SetFloatingPos(view.x / 4 + (i - 8) * 48, view.y / 8 + (i - 8) * 48);
+				dock->SetFloatingSize(240, 320);
+			}
+		}
+		myDragPos = GxVec2i(view.x / 4 + 3 * 48 + 64, view.y / 8 + 3 * 48 + 8);
+		return area;
+	}
+
+	void Start(GxContext* context, GxVec2i view)
+	{
+		Press(context, myDragPos.x, myDragPos.y);
+	}
+
+	void Step(int frame, GxVec2i view)
+	{
+		const int t = frame % 200;
+		const int offset = (t < 100) ? t : 200 - t;
+		GxInput::Get()->SetMousePos(myDragPos.x + offset * 2, myDragPos.y + offset);
+	}
+
+private:
+	GxVec2i myDragPos;
+};
+
+// 50,000 small buttons placed in a single free layout that covers the view, which the
+// mouse sweeps over to measure finding the hover widget among many siblings.
+class HitTestScene : public Scene
+{
+public:
+	const char* GetName() const { return "hittest"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		const int cols = 250, rows = 200;
+		GxFreeLayout* layout = new GxFreeLayout;
+		for(int i=0; i<cols * rows; ++i)
+		{
+			const int x = i % cols, y = i / cols;
+			const int x0 = x * view.x / cols, y0 = y * view.y / rows;
+			const int x1 = (x + 1) * view.x / cols, y1 = (y + 1) * view.y / rows;
+			GxButton* button = new GxButton(NULL, "");
+			button->SetSizeMin(1, 1);
+			layout->Add(button, x0, y0, x1 - x0, y1 - y0);
+		}
+		return new GxFrame(layout);
+	}
+};
+
+// A grid of buttons with tooltips of 2,000 characters. The mouse rests on a button for 120
+// frames, so its tooltip fades in and stays, and then moves on to the next button.
+class ToolTipScene : public Scene
+{
+public:
+	const char* GetName() const { return "tooltip"; }
+
+	GxWidget* Create(GxVec2i view)
+	{
+		GxString text;
+		for(int i=0; i<25; ++i)
+			text.Append(Format("Line %i of a long tooltip that describes the button in detail. ", i));
+
+		GxFrame* frame = new GxFrame(new GxListLayout);
+		for(int i=0; i<8; ++i)
+		{
+			GxFrameH* row = new GxFrameH;
+			for(int j=0; j<8; ++j)
+			{
+				GxButton* button = new GxButton(NULL, Format("Button %i, %i", i, j));
+				button->SetToolTip(text);
+				row->Add(button);
+			}
+			frame->Add(row);
+		}
+		return frame;
+	}
+
+	void Step(int frame, GxVec2i view)
+	{
+		const int button = frame / 120;
+		GxInput::Get()->SetMousePos((button % 8) * view.x / 8 + 32, (button / 8 % 8) * view.y / 8 + 16);
+	}
+};
+
+// ===================================================================================
+// Xml benchmark
+// ===================================================================================
+
+// Generates a localization style xml document of roughly size bytes. Categories hold a
+// thousand translations each, and are followed by layouts with a thousand elements that
+// have several attributes.
+static GxString GenerateXml(int size)
+{
+	GxString xml;
+	xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	xml += "<!-- Generated by the GuiX benchmark -->\n";
+	xml += "<localization>\n";
+	char line[256];
+	for(int block = 0; xml.Length() < size; ++block)
+	{
+		sprintf(line, "  <category id=\"category%i\">\n", block);
+		xml += line;
+		for(int i=0; i<1000; ++i)
+		{
+			sprintf(line, "    <tl id=\"text%i\">\n      Translation %i of &quot;category %i&quot; &amp; more\n    </tl>\n", i, i, block);
+			xml += line;
+		}
+		xml += "  </category>\n";
+		sprintf(line, "  <layout id=\"layout%i\">\n", block);
+		xml += line;
+		for(int i=0; i<1000; ++i)
+		{
+			sprintf(line, "    <button x=\"%i\" y=\"%i\" w=\"96\" h=\"24\" style=\"push\" visible=\"true\"/>\n", i % 40 * 100, i / 40 * 30);
+			xml += line;
+		}
+		xml += "  </layout>\n";
+	}
+	xml += "</localization>\n";
+	return xml;
+}
+
+static int CountElements(XmlNode* node)
+{
+	int count = node->ToElem() ? 1 : 0;
+	for(XmlNode* n = node->Child(); n; n = n->Next())
+		count += CountElements(n);
+	return count;
+}
+
+static int CountElements(XmlTreeNode* node)
+{
+	int count = (node->GetType() == XmlNode::ELEM) ? 1 : 0;
+	for(XmlTreeNode* n = node->Child(); n; n = n->Next())
+		count += CountElements(n);
+	return count;
+}
+
+// Loads the document with XmlDocument, XmlTree and XmlReader, and prints the average time
+// per load. The reader time includes copying the text into a buffer that it can modify.
+static int RunXmlBenchmark()
+{
+	const int XML_SIZE = 8 * 1024 * 1024, XML_RUNS = 5;
+	const XmlDocument::CondenseWhitespace cw = XmlDocument::CW_LEAD_AND_TRAIL;
+
+	GxString xml = GenerateXml(XML_SIZE);
+	const int len = xml.Length();
+	char* buffer = GxMalloc<char>(len + 1);
+
+	const char* names[] = {"XmlDocument", "XmlTree", "XmlReader"};
+	double times[3] = {0, 0, 0};
+	int elements[3] = {0, 0, 0};
+	bool failed = false;
+
+	for(int run=0; run<XML_RUNS; ++run)
+	{
+		double t0 = GetTime();
+		{
+			XmlDocument doc;
+			failed |= !doc.LoadString(xml.Raw(), cw);
+			times[0] += GetTime() - t0;
+			elements[0] = CountElements(&doc);
+		}
+
+		t0 = GetTime();
+		{
+			XmlTree tree;
+			failed |= !tree.LoadString(xml.Raw(), cw);
+			times[1] += GetTime() - t0;
+			elements[1] = CountElements(&tree);
+		}
+
+		t0 = GetTime();
+		{
+			memcpy(buffer, xml.Raw(), len + 1);
+			XmlReader reader;
+			reader.Reset(buffer, cw);
+			XmlReader::Event event;
+			int count = 0;
+			while((event = reader.Next()) < XmlReader::EV_END)
+				if(event == XmlReader::EV_ELEM_START) ++count;
+			failed |= (event == XmlReader::EV_ERROR);
+			times[2] += GetTime() - t0;
+			elements[2] = count;
+		}
+	}
+	GxFree(buffer);
+
+	const double mb = len / (1024.0 * 1024.0);
+	printf("GuiX xml benchmark: %.2f MB, %i loads per parser\n\n", mb, XML_RUNS);
+	printf("%-12s %9s %9s %10s\n", "parser", "load ms", "MB/s", "elements");
+	for(int i=0; i<3; ++i)
+	{
+		const double t = times[i] / XML_RUNS;
+		printf("%-12s %9.2f %9.1f %10i\n", names[i], t * 1000.0, mb / t, elements[i]);
+	}
+
+	if(failed || elements[1] != elements[0] || elements[2] != elements[0])
+	{
+		printf("\nThe parsers did not produce the same document\n");
+		return 1;
+	}
+	return 0;
+}
+
+// ===================================================================================
+// String benchmark
+// ===================================================================================
+
+// Measures a string workload; prints the time and the number of heap blocks allocated per operation.
+struct StringTimer
+{
+	StringTimer(const char* name, int ops) :name(name), ops(ops), allocs(GxStringHeapAllocations()), t0(GetTime()) {}
+	~StringTimer()
+	{
+		const double t = GetTime() - t0;
+		const double a = GxStringHeapAllocations() - allocs;
+		printf("%-20s %9.2f %9.1f %11.2f\n", name, t * 1000.0, t * 1e9 / ops, a / ops);
+	}
+	const char* name;
+	int ops, allocs;
+	double t0;
+};
+
+// Runs typical string operations of GuiX: creating ids and labels, copying them, building
+// text from small pieces, and looking strings up in std::map and GxStringMap.
+static int RunStringBenchmark()
+{
+	const int STRING_OPS = 1000000, MAP_KEYS = 100000;
+
+	std::vector<GxString> keys(MAP_KEYS);
+	char buffer[64];
+	for(int i=0; i<MAP_KEYS; ++i)
+	{
+		sprintf(buffer, "widget.button%i", i);
+		keys[i] = buffer;
+	}
+
+	printf("GuiX string benchmark: sizeof(GxString) = %i bytes\n\n", (int)sizeof(GxString));
+	printf("%-20s %9s %9s %11s\n", "operation", "total ms", "ns/op", "allocs/op");
+
+	uint check = 0;
+	{
+		StringTimer timer("construct short", STRING_OPS);
+		for(int i=0; i<STRING_OPS; ++i)
+		{
+			GxString str("GxButton:ePressed");
+			check += str.Length();
+		}
+	}
+	{
+		StringTimer timer("construct long", STRING_OPS);
+		for(int i=0; i<STRING_OPS; ++i)
+		{
+			GxString str("The quick brown fox jumps over the lazy dog");
+			check += str.Length();
+		}
+	}
+	{
+		GxString src("label.text");
+		StringTimer timer("copy", STRING_OPS);
+		for(int i=0; i<STRING_OPS; ++i)
+		{
+			GxString str(src);
+			check += str.Length();
+		}
+	}
+	{
+		StringTimer timer("append", STRING_OPS);
+		for(int i=0; i<STRING_OPS; ++i)
+		{
+			GxString str;
+			str << "x=" << (i & 255) << ", y=" << (i >> 8);
+			check += str.Length();
+		}
+	}
+
+	std::map<GxString, int> tree;
+	GxStringMap<int> table;
+	for(int i=0; i<MAP_KEYS; ++i)
+	{
+		tree[keys[i]] = i;
+		table[keys[i]] = i;
+	}
+
+	{
+		StringTimer timer("std::map find", STRING_OPS);
+		for(int i=0, k=0; i<STRING_OPS; ++i, k = (k + 7919) % MAP_KEYS)
+			check += tree.find(keys[k].Raw())->second;
+	}
+	{
+		StringTimer timer("GxStringMap find", STRING_OPS);
+		for(int i=0, k=0; i<STRING_OPS; ++i, k = (k + 7919) % MAP_KEYS)
+			check += *table.Find(keys[k].Raw());
+	}
+	{
+		StringTimer timer("GxStringMap hashed", STRING_OPS);
+		for(int i=0, k=0; i<STRING_OPS; ++i, k = (k + 7919) % MAP_KEYS)
+			check += *table.Find(keys[k]);
+	}
+
+	printf("\nchecksum %u\n", check);
+	return 0;
+}
+
+// ===================================================================================
+// Reference count benchmark
+// ===================================================================================
+
+// Runs func(data, i) for every i in [0, count) on its own thread, and waits for all of them.
+struct ThreadTask
+{
+	void (*func)(void* data, int index);
+	void* data;
+	int index;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI ThreadEntry(LPVOID arg)
+{
+	ThreadTask* task = (ThreadTask*)arg;
+	task->func(task->data, task->index);
+	return 0;
+}
+#else
+static void* ThreadEntry(void* arg)
+{
+	ThreadTask* task = (ThreadTask*)arg;
+	task->func(task->data, task->index);
+	return NULL;
+}
+#endif
+
+static void RunThreads(void (*func)(void*, int), void* data, int count)
+{
+	std::vector<ThreadTask> tasks(count);
+	for(int i=0; i<count; ++i)
+	{
+		tasks[i].func = func;
+		tasks[i].data = data;
+		tasks[i].index = i;
+	}
+#ifdef _WIN32
+	std::vector<HANDLE> threads(count);
+	for(int i=0; i<count; ++i)
+		threads[i] = CreateThread(NULL, 0, ThreadEntry, &tasks[i], 0, NULL);
+	for(int i=0; i<count; ++i)
+	{
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	}
+#else
+	std::vector<pthread_t> threads(count);
+	for(int i=0; i<count; ++i)
+		pthread_create(&threads[i], NULL, ThreadEntry, &tasks[i]);
+	for(int i=0; i<count; ++i)
+		pthread_join(threads[i], NULL);
+#endif
+}
+
+enum RefCountProperties
+{
+	REF_THREADS = 4,
+	REF_SOURCES = 16,
+	REF_HELD = 8,
+};
+
+// Strings and lists that are shared by every thread of the stress test. The sources are
+// only read by the threads, which copy, modify and release them in varying orders.
+struct RefCountData
+{
+	GxString strings[REF_SOURCES];
+	GxList<GxString> list;
+	int iterations;
+	int errors[REF_THREADS];
+};
+
+static GxString RefCountSource(int i)
+{
+	GxString str;
+	str << "Shared string number " << i << " that does not fit inline";
+	return str;
+}
+
+static void RefCountStressTask(void* arg, int thread)
+{
+	RefCountData& data = *(RefCountData*)arg;
+	GxString held[REF_HELD];
+	GxList<GxString> heldList;
+	int errors = 0;
+	for(int i=0; i<data.iterations; ++i)
+	{
+		const GxString& src = data.strings[(i * 7 + thread) % REF_SOURCES];
+		GxString copy(src);
+		held[(i + thread) % REF_HELD] = copy;
+		if(i % 3 == 0)
+		{
+			copy.Append('!');
+			errors += (copy.Length() != src.Length() + 1) || !copy.StartsWith(src);
+		}
+		if(i % 5 == 0)
+		{
+			heldList = data.list;
+		}
+		if(i % 7 == 0)
+		{
+			GxList<GxString> list(data.list);
+			list.Append(copy);
+			errors += (list.Size() != REF_SOURCES + 1) || !(list[thread] == data.strings[thread]);
+		}
+		errors += !(held[(i + thread) % REF_HELD] == src);
+	}
+	data.errors[thread] = errors;
+}
+
+static void RefCountCopyTask(void* arg, int thread)
+{
+	RefCountData& data = *(RefCountData*)arg;
+	int length = 0;
+	for(int i=0; i<data.iterations; ++i)
+	{
+		GxString copy(data.strings[0]);
+		length += copy.Length();
+	}
+	data.errors[thread] = (length != data.iterations * data.strings[0].Length());
+}
+
+// Prints the time per operation of a loop of ops operations that started at t0.
+static void PrintRefCountTime(const char* name, double t0, int ops)
+{
+	const double t = GetTime() - t0;
+	printf("%-24s %9.2f %9.2f\n", name, t * 1000.0, t * 1e9 / ops);
+}
+
+// Measures copying and releasing strings and lists, which changes their reference counts,
+// and runs a stress test that shares strings and lists between threads. The stress test is
+// only run if GuiX is built with GX_ATOMIC_REFCOUNT, since it is not valid otherwise.
+static int RunRefCountBenchmark()
+{
+	const int REF_OPS = 10000000, STRESS_ITERATIONS = 200000;
+
+	RefCountData data;
+	for(int i=0; i<REF_SOURCES; ++i)
+	{
+		data.strings[i] = RefCountSource(i);
+		data.list.Append(RefCountSource(i));
+	}
+
+#ifdef GX_ATOMIC_REFCOUNT
+	const bool atomic = true;
+#else
+	const bool atomic = false;
+#endif
+
+	printf("GuiX reference count benchmark: %s reference counts\n\n", atomic ? "atomic" : "plain");
+	printf("%-24s %9s %9s\n", "operation", "total ms", "ns/op");
+
+	int length = 0;
+	double t0 = GetTime();
+	for(int i=0; i<REF_OPS; ++i)
+	{
+		GxString copy(data.strings[i & (REF_SOURCES - 1)]);
+		length += copy.Length();
+	}
+	PrintRefCountTime("string copy", t0, REF_OPS);
+
+	t0 = GetTime();
+	for(int i=0; i<REF_OPS; ++i)
+	{
+		GxList<GxString> copy(data.list);
+		length += copy.Size();
+	}
+	PrintRefCountTime("list copy", t0, REF_OPS);
+
+	t0 = GetTime();
+	for(int i=0; i<REF_OPS / 10; ++i)
+	{
+		GxList<GxString> copy(data.list);
+		copy[i & (REF_SOURCES - 1)].Append('!');
+		length += copy.Size();
+	}
+	PrintRefCountTime("list detach", t0, REF_OPS / 10);
+
+	int errors = 0;
+	if(atomic)
+	{
+		data.iterations = REF_OPS / REF_THREADS;
+		t0 = GetTime();
+		RunThreads(RefCountCopyTask, &data, REF_THREADS);
+		PrintRefCountTime("string copy, 4 threads", t0, REF_OPS);
+
+		for(int i=0; i<REF_THREADS; ++i)
+			errors += data.errors[i];
+
+		data.iterations = STRESS_ITERATIONS;
+		t0 = GetTime();
+		RunThreads(RefCountStressTask, &data, REF_THREADS);
+		PrintRefCountTime("stress test, 4 threads", t0, STRESS_ITERATIONS * REF_THREADS);
+
+		for(int i=0; i<REF_THREADS; ++i)
+			errors += data.errors[i];
+
+		// Every copy has been released, so the sources must not be shared anymore; modifying a
+		// source in place would make a copy of it otherwise.
+		for(int i=0; i<REF_SOURCES; ++i)
+		{
+			errors += !(data.strings[i] == RefCountSource(i)) || !(data.list[i] == RefCountSource(i));
+
+			const int allocations = GxStringHeapAllocations();
+			data.strings[i].MakeUpper();
+			errors += (GxStringHeapAllocations() != allocations);
+		}
+		const GxString* elements = data.list.Data();
+		data.list[0].MakeUpper();
+		errors += (data.list.Data() != elements);
+	}
+
+	printf("\nchecksum %i\n", length);
+	if(atomic)
+		printf("Stress test: %s\n", errors ? "FAILED" : "passed");
+	else
+		printf("The stress test is skipped; build GuiX with GX_ATOMIC_REFCOUNT to run it.\n");
+
+	return errors ? 1 : 0;
+}
+
+// ===================================================================================
+// Localization benchmark
+// ===================================================================================
+
+enum LocalizeProperties
+{
+	LOC_CATEGORIES = 20,
+	LOC_NAMES = 1000,
+	LOC_LOOKUPS = 2000000,
+};
+
+// Measures a localization workload; prints the time, lookups per second, and the number of
+// heap blocks allocated per lookup.
+struct LookupTimer
+{
+	LookupTimer(const char* name) :name(name), allocs(GxStringHeapAllocations()), t0(GetTime()) {}
+	~LookupTimer()
+	{
+		const double t = GetTime() - t0;
+		const double a = GxStringHeapAllocations() - allocs;
+		printf("%-20s %9.2f %9.1f %9.2f %11.2f\n", name, t * 1000.0, t * 1e9 / LOC_LOOKUPS,
+			LOC_LOOKUPS / t / 1e6, a / LOC_LOOKUPS);
+	}
+	const char* name;
+	int allocs;
+	double t0;
+};
+
+static GxString LocalizeText(int category, int name)
+{
+	char text[128];
+	sprintf(text, "Translation %i of category %i, long enough to live on the heap", name, category);
+	return GxString(text);
+}
+
+// Writes a translations xml file, loads it, compiles it, and loads the compiled file. Then
+// measures lookups through GxTr, through GxLocalize::Find, and through the nested std::map
+// that GxLocalize used before, and checks that every lookup found the right text.
+static int RunLocalizeBenchmark()
+{
+	const char* xmlPath = "LocalizeBenchmark.xml";
+	const char* compiledPath = "LocalizeBenchmark.gxl";
+
+	std::vector<GxString> categories(LOC_CATEGORIES), names(LOC_NAMES);
+	char buffer[64];
+	for(int i=0; i<LOC_CATEGORIES; ++i)
+	{
+		sprintf(buffer, "category%i", i);
+		categories[i] = buffer;
+	}
+	for(int i=0; i<LOC_NAMES; ++i)
+	{
+		sprintf(buffer, "widget.label%i", i);
+		names[i] = buffer;
+	}
+
+	FILE* file = fopen(xmlPath, "wb");
+	if(!file)
+	{
+		printf("Unable to write %s\n", xmlPath);
+		return 1;
+	}
+	fprintf(file, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<translations>\n");
+	for(int c=0; c<LOC_CATEGORIES; ++c)
+	{
+		fprintf(file, "<category id=\"%s\">\n", categories[c].Raw());
+		for(int n=0; n<LOC_NAMES; ++n)
+			fprintf(file, "\t<tl id=\"%s\">%s</tl>\n", names[n].Raw(), LocalizeText(c, n).Raw());
+		fprintf(file, "</category>\n");
+	}
+	fprintf(file, "</translations>\n");
+	fclose(file);
+
+	GxLocalize* localize = GxLocalize::Get();
+
+	double t0 = GetTime();
+	bool failed = !localize->Load(xmlPath);
+	const double xmlTime = GetTime() - t0;
+
+	t0 = GetTime();
+	failed |= !localize->Save(compiledPath);
+	const double saveTime = GetTime() - t0;
+
+	localize->Clear();
+	t0 = GetTime();
+	failed |= !localize->Load(compiledPath);
+	const double compiledTime = GetTime() - t0;
+
+	remove(xmlPath);
+	remove(compiledPath);
+
+	printf("\nGuiX localization benchmark: %i categories, %i translations each\n\n", LOC_CATEGORIES, LOC_NAMES);
+	printf("load xml        %9.2f ms\n", xmlTime * 1000.0);
+	printf("save compiled   %9.2f ms\n", saveTime * 1000.0);
+	printf("load compiled   %9.2f ms\n\n", compiledTime * 1000.0);
+
+	// The translations as GxLocalize stored them before, in a map of categories.
+	typedef std::map<GxString, GxString> TranslationMap;
+	std::map<GxString, TranslationMap> tree;
+	for(int c=0; c<LOC_CATEGORIES; ++c)
+		for(int n=0; n<LOC_NAMES; ++n)
+			tree[categories[c]][names[n]] = LocalizeText(c, n);
+
+	int mismatches = 0;
+	for(int c=0; c<LOC_CATEGORIES; ++c)
+	{
+		for(int n=0; n<LOC_NAMES; ++n)
+		{
+			const GxString* text = localize->Find(categories[c].Raw(), names[n].Raw());
+			if(!text || !(*text == LocalizeText(c, n))) ++mismatches;
+		}
+	}
+	if(localize->Find("category0", "missing") || !(GxTr("category0", "missing") == "missing")) ++mismatches;
+
+	printf("%-20s %9s %9s %9s %11s\n", "lookup", "total ms", "ns/op", "M/s", "allocs/op");
+
+	uint check = 0;
+	{
+		LookupTimer timer("std::map (before)");
+		for(int i=0, k=0; i<LOC_LOOKUPS; ++i, k = (k + 7919) % (LOC_CATEGORIES * LOC_NAMES))
+		{
+			const std::map<GxString, TranslationMap>::const_iterator cat = tree.find(categories[k / LOC_NAMES].Raw());
+			const TranslationMap::const_iterator tl = cat->second.find(names[k % LOC_NAMES].Raw());
+			GxString text = tl->second;
+			check += text.Length();
+		}
+	}
+	{
+		LookupTimer timer("GxTr");
+		for(int i=0, k=0; i<LOC_LOOKUPS; ++i, k = (k + 7919) % (LOC_CATEGORIES * LOC_NAMES))
+		{
+			GxString text = GxTr(categories[k / LOC_NAMES].Raw(), names[k % LOC_NAMES].Raw());
+			check += text.Length();
+		}
+	}
+	{
+		LookupTimer timer("GxLocalize::Find");
+		for(int i=0, k=0; i<LOC_LOOKUPS; ++i, k = (k + 7919) % (LOC_CATEGORIES * LOC_NAMES))
+			check += localize->Find(categories[k / LOC_NAMES].Raw(), names[k % LOC_NAMES].Raw())->Length();
+	}
+
+	printf("\nchecksum %u\n", check);
+	if(failed || mismatches)
+	{
+		printf("Localization FAILED: %i translations did not match\n", mismatches);
+		return 1;
+	}
+	return 0;
+}
+
+// ===================================================================================
+// Resources benchmark
+// ===================================================================================
+
+enum ResourcesProperties
+{
+	RES_TEXTURES = 40000,
+	RES_FONTS = 5000,
+	RES_TRANSLATIONS = 5000,
+	RES_ENTRIES = RES_TEXTURES + RES_FONTS + RES_TRANSLATIONS,
+	RES_LOOKUPS = 2000000,
+};
+
+static GxString ResourceName(int i)
+{
+	char name[64];
+	     if(i < RES_TEXTURES)             sprintf(name, "ui.texture%i", i);
+	else if(i < RES_TEXTURES + RES_FONTS) sprintf(name, "ui.font%i", i);
+	else                                  sprintf(name, "ui.language%i", i);
+	return GxString(name);
+}
+
+static GxString ResourcePath(int i)
+{
+	char path[64];
+	sprintf(path, "Assets/Resource%i.dat", i);
+	return GxString(path);
+}
+
+// Looks up resource i by id, and returns the length of its path, or zero if it was not found.
+template <typename ID>
+static int LookupResource(GxResources* resources, const ID& id, int i)
+{
+	if(i < RES_TEXTURES)
+	{
+		GxResources::TextureRes res;
+		return resources->GetResource(id, res) ? res.path.Length() : 0;
+	}
+	if(i < RES_TEXTURES + RES_FONTS)
+	{
+		GxResources::FontRes res;
+		return resources->GetResource(id, res) ? res.path.Length() : 0;
+	}
+	GxResources::TranslationsRes res;
+	return resources->GetResource(id, res) ? res.paths[0].Length() : 0;
+}
+
+// Writes a resources file with 50k entries, loads it, and freezes it. Then measures lookups by
+// name with the hash maps, with the perfect hash, and with ids of which the hash was computed
+// in advance, compared to the map of resources that GxResources used before.
+static int RunResourcesBenchmark()
+{
+	const char* path = "ResourcesBenchmark.xml";
+
+	std::vector<GxString> names(RES_ENTRIES);
+	std::vector<GxResources::Id> ids;
+	ids.reserve(RES_ENTRIES);
+	for(int i=0; i<RES_ENTRIES; ++i)
+	{
+		names[i] = ResourceName(i);
+		ids.push_back(GxResources::Id(names[i]));
+	}
+
+	FILE* file = fopen(path, "wb");
+	if(!file)
+	{
+		printf("Unable to write %s\n", path);
+		return 1;
+	}
+	fprintf(file, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<resources>\n");
+	for(int i=0; i<RES_ENTRIES; ++i)
+	{
+		const char* type = (i < RES_TEXTURES) ? "texture" : (i < RES_TEXTURES + RES_FONTS) ? "font" : "translations";
+		fprintf(file, "<%s id=\"%s\">\n\t<path>%s</path>\n</%s>\n", type, names[i].Raw(), ResourcePath(i).Raw(), type);
+	}
+	fprintf(file, "</resources>\n");
+	fclose(file);
+
+	GxResources* resources = GxResources::Get();
+
+	double t0 = GetTime();
+	bool failed = !resources->Load(path);
+	const double loadTime = GetTime() - t0;
+	remove(path);
+
+	t0 = GetTime();
+	resources->SetFrozen(true);
+	const double freezeTime = GetTime() - t0;
+	resources->SetFrozen(false);
+
+	printf("\nGuiX resources benchmark: %i resources\n\n", RES_ENTRIES);
+	printf("load xml        %9.2f ms\n", loadTime * 1000.0);
+	printf("freeze          %9.2f ms\n\n", freezeTime * 1000.0);
+
+	// The textures as GxResources stored them before.
+	std::map<GxString, GxResources::TextureRes> tree;
+	for(int i=0; i<RES_TEXTURES; ++i)
+		tree[names[i]].path = ResourcePath(i);
+
+	int mismatches = 0;
+	for(int pass=0; pass<2; ++pass)
+	{
+		resources->SetFrozen(pass == 1);
+		for(int i=0; i<RES_ENTRIES; ++i)
+		{
+			if(LookupResource(resources, names[i].Raw(), i) != ResourcePath(i).Length()) ++mismatches;
+			if(LookupResource(resources, ids[i], i) != ResourcePath(i).Length()) ++mismatches;
+		}
+		if(LookupResource(resources, "ui.missing", 0) || LookupResource(resources, "ui.texture0", RES_ENTRIES - 1)) ++mismatches;
+	}
+
+	printf("%-20s %9s %9s %9s\n", "lookup", "total ms", "ns/op", "M/s");
+
+	uint check = 0;
+	const int step = 7919;
+	resources->SetFrozen(false);
+	{
+		double t = GetTime();
+		for(int i=0, k=0; i<RES_LOOKUPS; ++i, k = (k + step) % RES_TEXTURES)
+			check += tree.find(names[k].Raw())->second.path.Length();
+		t = GetTime() - t;
+		printf("%-20s %9.2f %9.1f %9.2f\n", "std::map (before)", t * 1000.0, t * 1e9 / RES_LOOKUPS, RES_LOOKUPS / t / 1e6);
+	}
+	for(int mode=0; mode<4; ++mode)
+	{
+		const char* labels[] = {"hash map", "hash map, hashed id", "frozen", "frozen, hashed id"};
+		resources->SetFrozen(mode >= 2);
+		double t = GetTime();
+		if(mode % 2 == 0)
+		{
+			for(int i=0, k=0; i<RES_LOOKUPS; ++i, k = (k + step) % RES_ENTRIES)
+				check += LookupResource(resources, names[k].Raw(), k);
+		}
+		else
+		{
+			for(int i=0, k=0; i<RES_LOOKUPS; ++i, k = (k + step) % RES_ENTRIES)
+				check += LookupResource(resources, ids[k], k);
+		}
+		t = GetTime() - t;
+		printf("%-20s %9.2f %9.1f %9.2f\n", labels[mode], t * 1000.0, t * 1e9 / RES_LOOKUPS, RES_LOOKUPS / t / 1e6);
+	}
+	resources->SetFrozen(false);
+
+	printf("\nchecksum %u\n", check);
+	if(failed || mismatches)
+	{
+		printf("Resources FAILED: %i lookups did not match\n", mismatches);
+		return 1;
+	}
+	return 0;
+}
+
+// ===================================================================================
+// Benchmark
+// ===================================================================================
+
+struct Options
+{
+	GxVec2i size;
+	int frames;
+	const char* scene;
+	bool software;
+	bool deferred;
+	bool cache;
+	bool xml;
+	bool strings;
+	bool refcount;
+	bool localize;
+	bool resources;
+};
+
+struct Result
+{
+	double build, tickAvg, tickMax, drawAvg, drawMax;
+	int vertices, triangles, drawCalls, relayouts;
+};
+
+static const int WARMUP_FRAMES = 10;
+
+static void EnableGeometryCache(GxWidget* widget)
+{
+	widget->SetCacheGeometry(true);
+	GxContextNode* node = widget->GetContextNode();
+	for(int i=0; i<node->childCount; ++i)
+		EnableGeometryCache(node->children[i]->owner);
+}
+
+static Result RunScene(Scene* scene, BenchmarkRenderer& renderer, const Options& options)
+{
+	Result r;
+	memset(&r, 0, sizeof(Result));
+
+	const GxVec2i view = options.size;
+	GxInput::Get()->SetMousePos(0, 0);
+
+	double t0 = GetTime();
+	GxContext* context = GxContext::New();
+	context->SetView(0, 0, view.x, view.y);
+	GxWidget* root = scene->Create(view);
+	context->SetRoot(root);
+	if(options.cache) EnableGeometryCache(root);
+	r.build = (GetTime() - t0) * 1000.0;
+
+	context->Tick(1 / 60.f);
+	scene->Start(context, view);
+
+	double vertices = 0, triangles = 0, drawCalls = 0, relayouts = 0;
+	for(int frame = -WARMUP_FRAMES; frame < options.frames; ++frame)
+	{
+		scene->Step(frame + WARMUP_FRAMES, view);
+		if(renderer.IsRasterizing())
+			renderer.Clear(GxColor(0, 0, 0));
+		renderer.ResetCounters();
+
+		t0 = GetTime();
+		context->Tick(1 / 60.f);
+		double t1 = GetTime();
+		context->Draw();
+		double t2 = GetTime();
+
+		if(frame < 0) continue;
+
+		const double tick = (t1 - t0) * 1000.0, draw = (t2 - t1) * 1000.0;
+		r.tickAvg += tick;
+		r.drawAvg += draw;
+		r.tickMax = GxMax(r.tickMax, tick);
+		r.drawMax = GxMax(r.drawMax, draw);
+		vertices += renderer.vertices;
+		triangles += renderer.triangles;
+		drawCalls += renderer.drawCalls;
+		relayouts += context->GetRelayoutCount();
+	}
+
+	GxContext::Delete(context);
+
+	const double n = (double)GxMax(options.frames, 1);
+	r.tickAvg /= n;
+	r.drawAvg /= n;
+	r.vertices = (int)(vertices / n + 0.5);
+	r.triangles = (int)(triangles / n + 0.5);
+	r.drawCalls = (int)(drawCalls / n + 0.5);
+	r.relayouts = (int)(relayouts / n + 0.5);
+	return r;
+}
+
+static void PrintUsage()
+{
+	printf("Usage: Benchmark [options]\n");
+	printf("  --frames n   Number of measured frames per scene (default 300).\n");
+	printf("  --size wxh   Size of the view in pixels (default 1280x720).\n");
+	printf("  --scene name Only runs the scene with the given name.\n");
+	printf("  --software   Rasterizes the geometry with the software renderer.\n");
+	printf("  --deferred   Enables deferred batching, which reorders the geometry by texture.\n");
+	printf("  --cache      Caches the geometry of every widget between frames.\n");
+	printf("  --xml        Measures the xml parsers instead of the widget scenes.\n");
+	printf("  --strings    Measures string operations instead of the widget scenes.\n");
+	printf("  --refcount   Measures reference counting and runs a stress test with threads.\n");
+	printf("  --localize   Measures loading and looking up translations.\n");
+	printf("  --resources  Measures loading, freezing and looking up resources.\n");
+}
+
+static bool ParseOptions(int argc, char** argv, Options& options)
+{
+	options.size = GxVec2i(1280, 720);
+	options.frames = 300;
+	options.scene = NULL;
+	options.software = false;
+	options.deferred = false;
+	options.cache = false;
+	options.xml = false;
+	options.strings = false;
+	options.refcount = false;
+	options.localize = false;
+	options.resources = false;
+
+	for(int i=1; i<argc; ++i)
+	{
+		const char* arg = argv[i];
+		const char* next = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if(!strcmp(arg, "--frames") && next)
+		{
+			options.frames = GxMax(atoi(next), 1);
+			++i;
+		}
+		else if(!strcmp(arg, "--size") && next)
+		{
+			if(sscanf(next, "%ix%i", &options.size.x, &options.size.y) != 2) return false;
+			options.size.x = GxMax(options.size.x, 64);
+			options.size.y = GxMax(options.size.y, 64);
+			++i;
+		}
+		else if(!strcmp(arg, "--scene") && next)
+		{
+			options.scene = next;
+			++i;
+		}
+		else if(!strcmp(arg, "--software"))
+		{
+			options.software = true;
+		}
+		else if(!strcmp(arg, "--deferred"))
+		{
+			options.deferred = true;
+		}
+		else if(!strcmp(arg, "--cache"))
+		{
+			options.cache = true;
+		}
+		else if(!strcmp(arg, "--xml"))
+		{
+			options.xml = true;
+		}
+		else if(!strcmp(arg, "--strings"))
+		{
+			options.strings = true;
+		}
+		else if(!strcmp(arg, "--refcount"))
+		{
+			options.refcount = true;
+		}
+		else if(!strcmp(arg, "--localize"))
+		{
+			options.localize = true;
+		}
+		else if(!strcmp(arg, "--resources"))
+		{
+			options.resources = true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if(!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	BenchmarkRenderer renderer(options.software);
+	renderer.SetViewSize(options.size);
+
+	GxCore::SetRenderInterface(&renderer);
+	GxCore::Initialize();
+
+	if(options.xml)
+	{
+		int result = RunXmlBenchmark();
+		GxCore::Shutdown();
+		return result;
+	}
+
+	if(options.strings)
+	{
+		int result = RunStringBenchmark();
+		GxCore::Shutdown();
+		return result;
+	}
+
+	if(options.refcount)
+	{
+		int result = RunRefCountBenchmark();
+		GxCore::Shutdown();
+		return result;
+	}
+
+	if(options.localize)
+	{
+		int result = RunLocalizeBenchmark();
+		GxCore::Shutdown();
+		return result;
+	}
+
+	if(options.resources)
+	{
+		int result = RunResourcesBenchmark();
+		GxCore::Shutdown();
+		return result;
+	}
+
+	GxDraw::Get()->SetDeferred(options.deferred);
+
+	LabelScene labels;
+	RowScene rows;
+	NestedScene nested;
+	SelectListScene selectList;
+	VirtualListScene virtualList;
+	DroplistScene droplist;
+	TextEditScene textEdit;
+	DockScene docks;
+	HitTestScene hitTest;
+	ToolTipScene toolTip;
+	Scene* scenes[] = {&labels, &rows, &nested, &selectList, &virtualList, &droplist, &textEdit, &docks, &hitTest, &toolTip};
+	const int sceneCount = sizeof(scenes) / sizeof(scenes[0]);
+
+	printf("GuiX benchmark: %ix%i, %i frames per scene, %s renderer%s%s\n\n",
+		options.size.x, options.size.y, options.frames, options.software ? "software" : "null",
+		options.deferred ? ", deferred batching" : "", options.cache ? ", geometry cache" : "");
+	printf("%-12s %9s %9s %9s %9s %9s %10s %10s %10s %10s\n", "scene", "build ms",
+		"tick ms", "tick max", "draw ms", "draw max", "vertices", "triangles", "drawcalls", "relayouts");
+
+	int ran = 0;
+	for(int i=0; i<sceneCount; ++i)
+	{
+		Scene* scene = scenes[i];
+		if(options.scene && strcmp(options.scene, scene->GetName())) continue;
+
+		Result r = RunScene(scene, renderer, options);
+		printf("%-12s %9.2f %9.3f %9.3f %9.3f %9.3f %10i %10i %10i %10i\n", scene->GetName(), r.build,
+			r.tickAvg, r.tickMax, r.drawAvg, r.drawMax, r.vertices, r.triangles, r.drawCalls, r.relayouts);
+		++ran;
+	}
+
+	GxCore::Shutdown();
+
+	if(!ran)
+	{
+		printf("\nUnknown scene: %s\n", options.scene);
+		return 1;
+	}
+	return 0;
+}
@@ -17,6 +17,10 @@ namespace graphics {
  a bitmap canvas. After all drawing operations are completed, the \c CreateTexture()
  function is used to create a texture from the bitmap.
 
+ Drawing operations are split into tiles; tiles that the shape does not touch are skipped,
+ the remaining tiles are processed several pixels at a time with SSE2 or AVX2 when available,
+ and large shapes are spread over multiple threads.
+
  @see GxTexture
 */
 class GUIX_API GxCanvas
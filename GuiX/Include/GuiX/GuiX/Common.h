@@ -52,6 +52,19 @@ template <typename T> int GxStrLen(const T* string);
 /// Returns the difference between the values of first mismatching characters, or zero if the strings are equal.
 template <typename T> int GxStrCmp(const T* a, const T* b);
 
+// Reference counting functions, used by the implicitly shared data of GxString and GxList.
+// If GX_ATOMIC_REFCOUNT is defined, they are atomic operations.
+
+/// Increments a reference count. The increment does not order any other memory accesses.
+inline void GxRefIncrement(long* count);
+
+/// Decrements a reference count and returns the result. The decrement has acquire-release ordering,
+/// so the owner that releases the last reference sees every change made by the other owners.
+inline long GxRefDecrement(long* count);
+
+/// Returns a reference count with acquire ordering. Shared data may only be modified in place if the count is one.
+inline long GxRefLoad(long* count);
+
 // Utility structs.
 
 /// The GxFlags struct contains a set of bits that represent generic flags.
@@ -86,6 +86,66 @@ int GxStrCmp(const T* a, const T* b)
 	return ((int)(*a) - (int)(*b));
 }
 
+// Reference counting functions
+
+// Data that is shared by several owners is copied before the owner that modifies it calls
+// GxRefDecrement. If the reference counts are atomic, another owner may release its reference
+// at the same time, and the data is freed as soon as the count reaches zero.
+
+#if defined(GX_ATOMIC_REFCOUNT) && defined(_MSC_VER)
+
+// The interlocked functions are full barriers, which includes the ordering that is required.
+inline void GxRefIncrement(long* count)
+{
+	_InterlockedIncrement(count);
+}
+
+inline long GxRefDecrement(long* count)
+{
+	return _InterlockedDecrement(count);
+}
+
+inline long GxRefLoad(long* count)
+{
+	return _InterlockedCompareExchange(count, 0, 0);
+}
+
+#elif defined(GX_ATOMIC_REFCOUNT)
+
+inline void GxRefIncrement(long* count)
+{
+	__atomic_fetch_add(count, 1, __ATOMIC_RELAXED);
+}
+
+inline long GxRefDecrement(long* count)
+{
+	return __atomic_sub_fetch(count, 1, __ATOMIC_ACQ_REL);
+}
+
+inline long GxRefLoad(long* count)
+{
+	return __atomic_load_n(count, __ATOMIC_ACQUIRE);
+}
+
+#else
+
+inline void GxRefIncrement(long* count)
+{
+	++*count;
+}
+
+inline long GxRefDecrement(long* count)
+{
+	return --*count;
+}
+
+inline long GxRefLoad(long* count)
+{
+	return *count;
+}
+
+#endif
+
 // GxFlags
 
 GxFlags::GxFlags()
@@ -6,11 +6,24 @@
 #include <stdlib.h>
 
 // Debugging with memory leak detection on windows.
-#define _CRTDBG_MAP_ALLOC
+#ifdef _MSC_VER
+	#define _CRTDBG_MAP_ALLOC
+#else
+	#include <stdint.h>
+#endif
 #ifdef _CRTDBG_MAP_ALLOC
 	#include <crtdbg.h>
 #endif
 
+// Define GX_ATOMIC_REFCOUNT to use atomic reference counts for the shared data of GxString and
+// GxList, so copies of the same string or list can be used and destroyed on different threads.
+// The setting has to be the same for GuiX and the application that uses it.
+//#define GX_ATOMIC_REFCOUNT
+
+#if defined(GX_ATOMIC_REFCOUNT) && defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
 /// The guix namespace is the root namespace of all GuiX classes and functions.
 namespace guix {
 
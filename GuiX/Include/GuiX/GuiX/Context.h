@@ -64,8 +64,8 @@ public:
 
 	/// Performs the following actions in order:
 	/// - Executes layer push/pop requests.
-	/// - Calls Adjust on all widgets.
-	/// - Calls SetRect on all widgets.
+	/// - Calls Adjust on all widgets of layers that were invalidated or resized.
+	/// - Calls SetRect on all widgets of layers that were invalidated or resized.
 	/// - Finds the current hover widget.
 	/// - Calls tick on all non-hidden widgets.
 	/// - Executes the callbacks from events that were emitted by widgets.
@@ -87,6 +87,10 @@ public:
 	/// Calculates the view size required to give the widgets their minimum size.
 	virtual GxVec2i GetMinimumSize() = 0;
 
+	/// Returns the number of widgets that were laid out during the last tick. Only widgets that were
+	/// invalidated or moved are laid out, so the count is zero when nothing changed.
+	virtual int GetRelayoutCount() = 0;
+
 	/// Returns true if the mouse cursor is currently on a GUI element or if the mouse
 	/// input is currently being captured by a GUI element.
 	virtual bool MouseOccupied() = 0;
@@ -22,6 +22,14 @@ namespace graphics {
  of this, make sure \c Flush() is called at the end of every frame to complete drawing
  operations that might not have executed yet due to batching.
 
+ In deferred mode, which is disabled by default, the batched geometry is recorded instead
+ of drawn as soon as the texture changes. When the recording is flushed, geometry that does
+ not overlap is grouped by texture, so interleaved text and images need fewer draw calls.
+ Geometry that overlaps is still drawn in the order in which it was batched. The scissor
+ region is recorded along with the geometry, and is left out for geometry that lies entirely
+ within it. Changing the blend mode flushes the recording, so geometry is never reordered
+ across blend modes.
+
  @see GxRenderInterface, GxSprite, GxTileBar, GxTileRect
 */
 class GUIX_API GxDraw
@@ -81,6 +89,82 @@ public:
 
 	/// Completes any drawing operations that have not yet been executed due to batching.
 	virtual void Flush() = 0;
+
+	/// Enables or disables deferred mode, in which batched geometry is reordered by texture
+	/// before it is drawn. Any recorded geometry is flushed before the mode changes.
+	virtual void SetDeferred(bool enable) = 0;
+
+	/// Returns true if deferred mode is enabled.
+	virtual bool IsDeferred() = 0;
+};
+
+// ===================================================================================
+// GxDrawList
+// ===================================================================================
+/** The GxDrawList class records drawing operations so they can be replayed later.
+
+ Drawing operations that are issued through GxDraw between \c Begin() and \c End() are
+ recorded by the draw list instead of drawn. This includes the vertices and textures of
+ batched and immediate geometry, scissor region pushes and pops, and blend mode changes.
+ Calling \c Draw() replays the recorded operations through GxDraw, optionally moved by
+ an offset, which only copies the vertices. This makes it cheap to draw parts of the
+ interface that do not change, such as static panels, without generating their
+ geometry again.
+
+ A draw list only stores texture handles, it does not keep the textures alive. It should
+ be recorded again when the recorded widgets change, and when \c IsOutdated() returns
+ true, which means that textures it might refer to were replaced, for example because
+ glyphs were evicted from the glyph atlas or because textures finished loading.
+
+ @see GxDraw
+*/
+class GUIX_API GxDrawList
+{
+public:
+	struct Data;
+
+	GxDrawList();
+	~GxDrawList();
+
+	/// Constructs a copy of the recorded drawing operations of another list.
+	GxDrawList(const GxDrawList& list);
+
+	/// Replaces the recorded drawing operations with a copy of those of another list.
+	GxDrawList& operator=(const GxDrawList& list);
+
+	/// Clears the list and starts recording drawing operations. Lists can be recorded while
+	/// another list is being recorded, in which case the outer list does not record them.
+	void Begin();
+
+	/// Stops recording drawing operations.
+	void End();
+
+	/// Removes all recorded drawing operations.
+	void Clear();
+
+	/// Replays the recorded drawing operations, moved by the offset (x, y). Scissor regions
+	/// are intersected with the current scissor region, like they are when drawn directly.
+	void Draw(int x = 0, int y = 0) const;
+
+	/// Works like \c Draw(x, y), but multiplies the alpha of every vertex by alpha, in [0, 1].
+	/// This allows geometry that fades in or out to be recorded once.
+	void Draw(int x, int y, float alpha) const;
+
+	/// Returns true if the list does not contain any drawing operations.
+	bool IsEmpty() const;
+
+	/// Returns true if the list is being recorded.
+	bool IsRecording() const;
+
+	/// Returns true if textures that the recorded geometry might refer to were replaced
+	/// after the list was recorded, in which case it should be recorded again.
+	bool IsOutdated() const;
+
+	/// Returns the number of recorded vertices.
+	int GetVertexCount() const;
+
+private:
+	Data* myData;
 };
 
 }; // namespace graphics
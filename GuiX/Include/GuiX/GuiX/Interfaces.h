@@ -68,6 +68,9 @@ GUIX_API void GxLog(const char* fmt, ...);
  Setting the file interface is optional. If no file interface is set, a default file
  interface is used that uses stdio functions from the standard C library.
 
+ Asynchronous texture loads read their image files on a background thread, so the file
+ interface has to support opening and reading files from more than one thread.
+
  @see GxCore, GxFileInterfaceStd
 */
 class GUIX_API GxFileInterface
@@ -126,6 +129,23 @@ public:
 	/// @return True if the end of the file is reached, false otherwise.
 	///
 	virtual bool EndOfFile(GxFileHandle file) = 0;
+
+	/// Called by GuiX to create a file, or to truncate an existing file, for writing.
+	/// The default implementation returns 0, which means that writing files is not supported.
+	///
+	/// @param [in] path : The path of the file to write.
+	/// @return A valid file handle that is closed by \c Close(), or 0 on failure.
+	///
+	virtual GxFileHandle OpenWrite(const char* path);
+
+	/// Called by GuiX to write data to a file that was opened by \c OpenWrite().
+	///
+	/// @param [in] file   : The handle of the file.
+	/// @param [in] buffer : The data to write.
+	/// @param [in] size   : The number of bytes to write.
+	/// @return The number of bytes successfully written to the file.
+	///
+	virtual size_t Write(GxFileHandle file, const void* buffer, size_t size);
 };
 
 // ===================================================================================
@@ -158,6 +178,12 @@ public:
 
 	/// Returns the end of the file using \c feof().
 	bool EndOfFile(GxFileHandle file);
+
+	/// Opens a file for writing using \c fopen().
+	GxFileHandle OpenWrite(const char* path);
+
+	/// Writes data to a file using \c fwrite().
+	size_t Write(GxFileHandle file, const void* buffer, size_t size);
 };
 
 // ===================================================================================
@@ -298,6 +324,42 @@ public:
 	/// @param [in] texture : A texture handle that was created by \c LoadTexture() or \c GenerateTexture().
 	///
 	virtual void ReleaseTexture(GxTextureHandle texture);
+
+	/// Called by GuiX to update a rectangular region of a texture. Implementing this function is
+	/// optional; GuiX uses it to add glyphs to the glyph atlas without uploading the entire atlas.
+	///
+	/// @param [in] texture   : A texture handle that was created by \c GenerateTexture().
+	/// @param [in] x         : The left-most pixel of the region to update.
+	/// @param [in] y         : The top-most pixel of the region to update.
+	/// @param [in] width     : The width of the region to update.
+	/// @param [in] height    : The height of the region to update.
+	/// @param [in] pixeldata : The array of pixels of the region; has 4 values per pixel in RGBA format.
+	/// @return True if the texture was updated, false if updating textures is not supported.
+	///
+	virtual bool UpdateTexture(GxTextureHandle texture, int x, int y, int width, int height, const uchar* pixeldata);
+
+	/// Called by GuiX to load the pixels of an image file. Implementing this function is optional;
+	/// GuiX uses it to load the glyph pages of fonts, so their glyphs can be packed into the glyph
+	/// atlas. If it is not implemented, fonts load their glyph pages with \c LoadTexture() instead.
+	///
+	/// Asynchronous texture loads call this function on a background thread, so it should only
+	/// use the file interface and no render state. If it is not implemented, asynchronous loads
+	/// fall back to \c LoadTexture() when they are applied.
+	///
+	/// @param [out] outPixels : The output pointer to write the pixel array to; has 4 values per pixel in RGBA format.
+	/// @param [out] outWidth  : The output value to write the width of the loaded image to.
+	/// @param [out] outHeight : The output value to write the height of the loaded image to.
+	/// @param [in]  path      : The path of the image file to load.
+	/// @return True if loading succeeded and the pixels and dimensions are valid, false otherwise.
+	///
+	virtual bool LoadPixels(uchar*& outPixels, int& outWidth, int& outHeight, const char* path);
+
+	/// Called by GuiX to destroy a pixel array that was loaded by \c LoadPixels(). Unlike
+	/// \c LoadPixels(), this function is always called on the main thread.
+	///
+	/// @param [in] pixels : The pixel array to destroy.
+	///
+	virtual void ReleasePixels(uchar* pixels);
 };
 
 }; // namespace core
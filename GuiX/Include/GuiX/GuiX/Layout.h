@@ -19,6 +19,15 @@ namespace gui {
  Layouts also provide information about the minimum size and preferred size required
  to arrange their children.
 
+ Layouts with many widgets keep a grid of the areas covered by their widgets, which is
+ updated after the context changes the layout of the widgets. \c FindHoverWidget() and
+ \c IsInWidgetRect() only visit the widgets in the grid cell under the position.
+
+ Layouts inside a scroll area are given the visible part of the view with \c SetVisibleRect().
+ Widgets whose rectangle lies completely outside of it are skipped by \c Draw(),
+ \c FindHoverWidget() and \c IsInWidgetRect(). Layouts that support lazy arrangement,
+ like GxListLayout, can also skip arranging those widgets; see \c SetLazyArrange().
+
  @see GxWidget, GxContainer
 */
 class GUIX_API GxLayout
@@ -52,8 +61,9 @@ public:
 	// ===================================================================================
 	// Member functions
 
-	/// Calls \c FindHoverWidget() on non-hidden widgets until a hover widget is found.
-	/// Returns NULL if no hover widget was find.
+	/// Calls \c FindHoverWidget() on non-hidden widgets until a hover widget is found, starting
+	/// at the last widget. Widgets are skipped if neither their rectangle nor the rectangles of
+	/// their children contain the position. Returns NULL if no hover widget was found.
 	GxWidget* FindHoverWidget(int x, int y);
 
 	/// Returns true if position (x, y) is within a widget rectangle inside the layout.
@@ -69,11 +79,21 @@ public:
 	/// is used by container widgets when a layout is assigned to them.
 	void SetOwner(GxWidget* owner);
 
-	// ===================================================================================
-	// Inline set functions
+	/// Invalidates the owner widget, so the layout is updated on the next tick.
+	void Invalidate();
 
-	void SetMargin(const GxMargini& margin)  {myMargin = margin;}
-	void SetSpacing(int spacing)             {mySpacing = spacing;}
+	/// Sets the part of the layout that is visible, in view coordinates. If the rectangle is not
+	/// empty, widgets that lie completely outside of it are not drawn or searched for hover.
+	/// The visible widgets are collected again after the layout is arranged.
+	void SetVisibleRect(const GxRecti& rect);
+
+	/// Enables or disables lazy arrangement. If enabled, and the visible rectangle is set, layouts
+	/// that support it only arrange the widgets within one visible rectangle size of it. The other
+	/// widgets keep their previous rectangle until they are arranged again.
+	void SetLazyArrange(bool enabled);
+
+	void SetMargin(const GxMargini& margin); ///< Sets the spacing between widgets and the edges of the layout.
+	void SetSpacing(int spacing);            ///< Sets the spacing in-between widgets inside the layout.
 
 	// ===================================================================================
 	// Inline get functions
@@ -90,6 +110,9 @@ public:
 
 	const WidgetList& GetWidgets() const     {return myWidgets;}
 
+	const GxRecti& GetVisibleRect() const    {return myVisibleRect;}
+	bool IsLazyArrange() const               {return myIsLazyArrange;}
+
 protected:
 	GxWidget* myOwner;       ///< The owner widget, see \c SetOwner().
 	GxVec2i myMinimumSize;   ///< The required size to give all widgets their minimum size.
@@ -99,6 +122,23 @@ protected:
 	WidgetList myWidgets;    ///< The list of widgets that are currently inside the layout.
 	GxMargini myMargin;      ///< The spacing between widgets and the edges of the layout.
 	int mySpacing;           ///< The spacing in-between widgets inside the layout.
+
+	GxRecti myVisibleRect;          ///< The visible part of the layout, or an empty rectangle if all of it is visible.
+	bool myIsLazyArrange;           ///< True if widgets outside of the visible rectangle do not have to be arranged.
+	WidgetList myVisibleWidgets;    ///< The widgets that overlap the visible rectangle, in layout order.
+	bool myIsVisibleWidgetsDirty;   ///< Set if myVisibleWidgets has to be collected from the widget rectangles.
+
+	/// Returns true if the visible rectangle is set.
+	bool IsCulling() const {return myVisibleRect.w > 0 && myVisibleRect.h > 0;}
+
+private:
+	struct HoverIndex;
+
+	int myGetLayoutGeneration() const;
+	const HoverIndex* myGetHoverIndex(int generation);
+	const WidgetList& myGetVisibleWidgets();
+
+	HoverIndex* myHoverIndex;
 };
 
 }; // namespace gui
@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include <GuiX/Config.h>
+#include <GuiX/Common.h>
 
 namespace guix {
 namespace core {
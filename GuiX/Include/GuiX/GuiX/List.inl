@@ -24,7 +24,7 @@ struct Ref
 	uint tag;
 #endif
 	size_t reserved;
-	size_t count;
+	long count;
 };
 
 // ===================================================================================
@@ -58,15 +58,33 @@ inline T* ReallocRef(Ref& src, size_t size)
 /// Utility functions
 
 template <typename T>
-void Detach(T*& data, size_t size)
+void AddRef(T* data)
+{
+	GxRefIncrement(&ToRef(data).count);
+}
+
+template <typename T>
+void Release(T* data, size_t size)
 {
 	Ref& ref = ToRef(data);
-	if(ref.count > 1)
+	if(GxRefDecrement(&ref.count) == 0)
+	{
+		for(size_t i=0; i<size; ++i)
+			data[i].~T();
+		free(&ref);
+	}
+}
+
+// Gives data its own copy of the elements if they are shared.
+template <typename T>
+void Detach(T*& data, size_t size)
+{
+	if(GxRefLoad(&ToRef(data).count) > 1)
 	{
-		--ref.count;
 		T* mem = NewRef<T>(size);
 		for(size_t i=0; i<size; ++i)
 			new (mem + i) T(data[i]);
+		Release(data, size);
 		data = mem;
 	}
 }
@@ -76,12 +94,12 @@ void Grow(T*& data, size_t size, size_t inc)
 {
 	size_t n = size + inc;
 	Ref& ref = ToRef(data);
-	if(ref.count > 1)
+	if(GxRefLoad(&ref.count) > 1)
 	{
-		--ref.count;
 		T* mem = NewRef<T>(n);
 		for(size_t i=0; i<size; ++i)
 			new (mem + i) T(data[i]);
+		Release(data, size);
 		data = mem;
 	}
 	else if(ref.reserved < n)
@@ -91,24 +109,6 @@ void Grow(T*& data, size_t size, size_t inc)
 	}
 }
 
-template <typename T>
-void AddRef(T* data)
-{
-	++ToRef(data).count;
-}
-
-template <typename T>
-void Release(T* data, size_t size)
-{
-	Ref& ref = ToRef(data);
-	if(--ref.count == 0)
-	{
-		for(size_t i=0; i<size; ++i)
-			data[i].~T();
-		free(&ref);
-	}
-}
-
 #ifdef GX_LIST_TAG
 	#undef GX_LIST_TAG
 #endif
@@ -15,6 +15,8 @@ namespace layouts {
  
  description.
 
+ The list layout supports lazy arrangement; see \c GxLayout::SetLazyArrange().
+
  @see GxLayout
 */
 class GUIX_API GxListLayout : public GxLayout
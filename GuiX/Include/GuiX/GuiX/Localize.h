@@ -27,6 +27,10 @@ namespace core {
  3. The application can now use the \c Translate() and global \c GxTr() functions to
     retrieve translations.
 
+ The translations that are loaded can be written to a compiled translations file with
+ \c Save(). \c Load() recognizes compiled files, and reads them without parsing XML,
+ so an application can compile its translation XML files in advance and ship those.
+
  @see GxCore
 */
 class GUIX_API GxLocalize
@@ -40,7 +44,7 @@ public:
 	/// Clears all translations that are currently loaded;
 	virtual void Clear() = 0;
 
-	/// Loads translations from a path or resource that points to a translations XML file.
+	/// Loads translations from a path or resource that points to a translations XML file or compiled translations file.
 	virtual bool Load(const char* path_or_resource) = 0;
 
 	/// Returns a translation, or the name argument if no translation was found.
@@ -49,6 +53,16 @@ public:
 	/// Returns a translation, or the name argument if no translation was found.
 	virtual GxString Translate(const char* category, const char* name) = 0;
 
+	/// Returns a translation, or NULL if no translation was found. The lookup does not allocate,
+	/// and the string remains valid until translations are loaded or cleared.
+	virtual const GxString* Find(const char* category, const char* name) const = 0;
+
+	/// Writes the translations that are currently loaded to a compiled translations file.
+	/// Compiled files store the values in the byte order of the machine that wrote them.
+	/// The file is written through GxFileInterface::OpenWrite(), so it fails if the file interface
+	/// does not support writing.
+	virtual bool Save(const char* path) const = 0;
+
 	/// GxLogs info about the loaded languages and translations.
 	virtual void LogInfo() const = 0;
 };
@@ -31,6 +31,19 @@ public:
 		GxList<GxString> paths;
 	};
 
+	/// Name of a resource, together with its hash. The hash is computed when the id is
+	/// constructed, so an id that is kept, for example in a static variable, looks up the
+	/// resource without hashing the name again.
+	struct GUIX_API Id
+	{
+		Id(const char* name);     ///< Computes the hash of name; name has to outlive the id.
+		Id(const GxString& name); ///< Uses the cached hash of name; name has to outlive the id.
+
+		const char* name;
+		int length;
+		uint hash;
+	};
+
 	virtual ~GxResources();
 
 	/// Returns the resources singleton.
@@ -39,14 +52,23 @@ public:
 	/// Loads a resource configuration file.
 	virtual bool Load(const char* path) = 0;
 
+	/// Enables or disables the frozen mode. In frozen mode, the resources are indexed by a
+	/// minimal perfect hash of their names, so a lookup maps the hash to a single entry and
+	/// compares one name. Building the index takes time, and \c Load() rebuilds it in frozen
+	/// mode, so it suits a resource set that is loaded once at startup.
+	virtual void SetFrozen(bool frozen) = 0;
+
+	/// Returns true if the frozen mode is enabled.
+	virtual bool IsFrozen() const = 0;
+
 	/// Retrieves a texture resource; returns false if the resource does not exist.
-	virtual bool GetResource(const char* id, TextureRes& out) = 0;
+	virtual bool GetResource(const Id& id, TextureRes& out) = 0;
 
 	/// Retrieves a font resource; returns false if the resource does not exist.
-	virtual bool GetResource(const char* id, FontRes& out) = 0;
+	virtual bool GetResource(const Id& id, FontRes& out) = 0;
 
 	/// Retrieves a translations resource; returns false if the resource does not exist.
-	virtual bool GetResource(const char* id, TranslationsRes& out) = 0;
+	virtual bool GetResource(const Id& id, TranslationsRes& out) = 0;
 };
 
 }; // namespace core
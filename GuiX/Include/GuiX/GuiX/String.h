@@ -17,7 +17,12 @@ namespace core {
  a null-terminated string of UTF-8 encoded characters. The main difference compared to
  \c std::string is that GxString avoids deep copies when it is assigned or copy
  constructed from another GxString. This is achieved by sharing string data and
- keeping a reference counter.
+ keeping a reference counter. Strings of up to 22 characters are stored inside the
+ GxString object itself and do not allocate memory at all.
+
+ The hash of the content is computed the first time \c Hash() is called, and is stored
+ until the string is modified. Hash-based containers can use it to look up strings
+ without comparing their characters, except for the final check of a match.
  
  Most of the functions accept C-strings as arguments, which are reinterpreted as
  UTF-8 strings. This will work as long as the string only contains ascii characters,
@@ -38,7 +43,7 @@ public:
 		static int _len(const char* s);
 		StringArg(const char* s)        :ptr(s),       len(_len(s)) {}
 		StringArg(const char* s, int n) :ptr(s),       len(n)       {}
-		StringArg(const GxString& s)    :ptr(s.myStr), len(s.myLen) {}
+		StringArg(const GxString& s)    :ptr(s.Raw()), len(s.myLen) {}
 		const char* ptr;
 		int len;
 	};
@@ -156,7 +161,13 @@ public:
 	/// Returns true if the string starts with the character sequence specified by str.
 	bool StartsWith(StringArg str, bool caseSensitive = true) const;
 
-	const char* Raw() const { return myStr;  } ///< Returns a pointer to the raw UTF-8 string content.
+	/// Returns a hash of the string content. The hash is computed on the first call, and is stored until the string is modified.
+	uint Hash() const { return myHash ? myHash : myComputeHash(); }
+
+	/// Returns the hash of the first n characters of a C-string, which is equal to the hash of a GxString with the same content.
+	static uint Hash(const char* str, int n);
+
+	const char* Raw() const { return myBuf[SSO_FLAG] ? myStr : myBuf; } ///< Returns a pointer to the raw UTF-8 string content.
 	int Length() const      { return myLen;  } ///< Returns the number of characters in the string, excluding the null-terminator.
 	bool Empty() const      { return !myLen; } ///< Returns true if the string has a length of zero.
 
@@ -182,8 +193,25 @@ public:
 	GxString& operator << (const GxString& str); ///< Calls \c Append().
 
 private:
-	char* myStr;
+	enum StringProperties
+	{
+		SSO_CAPACITY = 22,               // Maximum length of a string that is stored inline.
+		SSO_FLAG     = SSO_CAPACITY + 1, // Index of the byte that is non-zero if the content is on the heap.
+	};
+
+	char* myWrite();
+	char* myGrow(int n);
+	void myFree();
+	bool myContains(const char* str) const;
+	uint myComputeHash() const;
+
+	union
+	{
+		char* myStr;                  // Reference counted heap data, if myBuf[SSO_FLAG] is set.
+		char myBuf[SSO_CAPACITY + 2]; // Inline data of short strings.
+	};
 	int myLen;
+	mutable uint myHash; // Zero if the hash has not been computed yet.
 };
 
 // Shorthand for string arguments.
@@ -208,5 +236,54 @@ bool GUIX_API operator == (const GxString& a, const char* b);     ///< Returns t
 bool GUIX_API operator == (const char* a, const GxString& b);     ///< Returns true if the content of string a and b are equivalent.
 bool GUIX_API operator == (const GxString& a, const GxString& b); ///< Returns true if the content of string a and b are equivalent.
 
+// ===================================================================================
+// GxAtom
+// ===================================================================================
+/** The GxAtom class is a handle to an interned string.
+
+ Every distinct string is stored once in a global atom table, and all atoms of the same
+ string refer to the same entry. Comparing two atoms is a pointer comparison, and copying
+ an atom or reading its string does not allocate memory. Creating an atom from a string
+ looks the string up in the table, and only allocates memory the first time a string is
+ seen. The table only grows, so atoms remain valid until the program exits.
+
+ Atoms are used for widget ids, widget class names and event types, which are compared
+ far more often than they are created. The atom table is not thread-safe; create atoms on
+ the thread that runs the GUI.
+
+ @see GxString
+*/
+class GUIX_API GxAtom
+{
+public:
+	GxAtom() : myStr(0) {}         ///< Constructs the atom of the empty string.
+	GxAtom(const char* str);       ///< Constructs the atom of a C-string.
+	GxAtom(const char* str, int n);///< Constructs the atom of the first n characters of a C-string.
+	GxAtom(const GxString& str);   ///< Constructs the atom of a string.
+
+	const GxString& Str() const;   ///< Returns the interned string.
+
+	const char* Raw() const { return myStr ? myStr->Raw() : ""; }     ///< Returns a pointer to the raw UTF-8 string content.
+	int Length() const      { return myStr ? myStr->Length() : 0; }   ///< Returns the number of characters in the string.
+	bool Empty() const      { return !myStr; }                        ///< Returns true if this is the atom of the empty string.
+
+	bool operator == (const GxAtom& a) const { return myStr == a.myStr; } ///< Returns true if both atoms refer to the same string.
+	bool operator != (const GxAtom& a) const { return myStr != a.myStr; } ///< Returns true if the atoms refer to different strings.
+
+	/// Orders atoms by their entry in the atom table, which allows them to be used as keys in sorted containers.
+	/// The order is not lexicographical.
+	bool operator < (const GxAtom& a) const  { return myStr < a.myStr; }
+
+private:
+	const GxString* myStr;
+};
+
+bool GUIX_API operator == (const GxAtom& a, const char* b);     ///< Returns true if the string of atom a is equivalent to b.
+bool GUIX_API operator == (const char* a, const GxAtom& b);     ///< Returns true if the string of atom b is equivalent to a.
+bool GUIX_API operator == (const GxAtom& a, const GxString& b); ///< Returns true if the string of atom a is equivalent to b.
+bool GUIX_API operator == (const GxString& a, const GxAtom& b); ///< Returns true if the string of atom b is equivalent to a.
+bool GUIX_API operator != (const GxAtom& a, const char* b);     ///< Returns true if the string of atom a is different from b.
+bool GUIX_API operator != (const char* a, const GxAtom& b);     ///< Returns true if the string of atom b is different from a.
+
 }; // namespace core
 }; // namespace guix
\ No newline at end of file
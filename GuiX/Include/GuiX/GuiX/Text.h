@@ -5,6 +5,7 @@
 
 #include <GuiX/String.h>
 #include <GuiX/Texture.h>
+#include <GuiX/TextBuffer.h>
 
 namespace guix {
 namespace graphics {
@@ -12,6 +13,8 @@ namespace graphics {
 /// Handle to fonts loaded by the font database.
 typedef GxHandle GxFontHandle;
 
+struct GxTextLayoutData;
+
 // Enumeration of flags that can be set for rendering text.
 enum GxTextFlags
 {
@@ -40,6 +43,15 @@ enum GxTextAlignV
 	GX_TA_BOTTOM = 2, ///< Bottom-side aligned.
 };
 
+/// Contains statistics about the text layout cache, see \c GxText::GetCacheStats().
+struct GUIX_API GxTextCacheStats
+{
+	int hits;     ///< Number of text operations that reused a cached layout.
+	int misses;   ///< Number of text operations that had to compute a new layout.
+	int entries;  ///< Number of layouts currently stored in the cache.
+	int capacity; ///< Maximum number of layouts that can be stored in the cache.
+};
+
 // ===================================================================================
 // GxFont
 // ===================================================================================
@@ -49,6 +61,9 @@ enum GxTextAlignV
  fonts have a handle that is zero. Loaded fonts are tracked internally by TidyText in
  a database to avoid duplicates. Instances of the GxFont class are merely references
  to a GuiX font object; it is safe and cheap to copy them or pass them as arguments.
+
+ Fonts are loaded from the text files written by the FontBuilder, or from binary font
+ files created with \c GxFontDatabase::ConvertFont(), which load considerably faster.
 */
 class GUIX_API GxFont
 {
@@ -67,6 +82,11 @@ public:
 	/// Loads a font from either a font file, or a font ID in the font database.
 	bool Create(const char* path);
 
+	/// Works like \c Create(), but the glyph pages of a binary font are decoded on a background
+	/// thread if its glyphs are drawn from the glyph atlas. The font can be used immediately;
+	/// glyphs are not drawn until their page is applied by \c GxTextureDatabase::ApplyLoads().
+	bool CreateAsync(const char* path);
+
 	/// Releases the current font handle.
 	void Destroy();
 
@@ -113,6 +133,12 @@ public:
 	/// Returns the number currently loaded fonts.
 	virtual int GetLoadedFontCount() const = 0;
 
+	/// Converts a text font file to the binary font format, which is loaded with a single
+	/// read and without parsing the glyphs. The binary file refers to the same glyph page
+	/// images, so it has to be stored in the same directory as the text file. The binary file
+	/// is written through GxFileInterface::OpenWrite().
+	virtual bool ConvertFont(const char* textPath, const char* binaryPath) = 0;
+
 	/// GxLogs info about the loaded fonts.
 	virtual void LogInfo() const = 0;
 };
@@ -134,6 +160,19 @@ class GUIX_API GxText
 public:
 	static const int npos(); ///< An arbitrary large value; used to indicate end-of-range.
 
+	/// Sets the maximum number of text layouts kept in the layout cache. The layout of a string is reused as long as
+	/// the string, font, flags, tab width and maximum width stay the same. A capacity of zero disables the cache.
+	static void SetCacheCapacity(int layouts);
+
+	/// Returns the hit and miss counts of the layout cache, and the number of stored layouts.
+	static GxTextCacheStats GetCacheStats();
+
+	/// Resets the hit and miss counts of the layout cache to zero.
+	static void ResetCacheStats();
+
+	/// Removes all stored layouts from the layout cache.
+	static void ClearCache();
+
 	GxText(); ///< Constructs a text object with default settings, see individual members.
 
 	/// Draws a string of text at position (x,y).
@@ -189,5 +228,67 @@ public:
 	GxTextAlignV alignV; ///< Vertical alignment of the text rectangle and the lines, default is TT_TOP.
 };
 
+// ===================================================================================
+// GxTextLayout
+// ===================================================================================
+/** The GxTextLayout class keeps the layout of a string for repeated drawing and queries.
+
+ Where GxText computes or looks up the layout of a string on every call, the
+ GxTextLayout class stores a string in a GxTextBuffer together with its text settings
+ and lines. Character rectangle and index queries go straight to the line that
+ contains the character, and inserting or erasing text only recomputes the lines
+ around the edit. Drawing skips the lines outside of the scissor rectangle. This makes the
+ class suitable for long strings that are edited, such as the contents of a text edit.
+
+ @see GxText, GxTextBuffer
+*/
+class GUIX_API GxTextLayout
+{
+public:
+	~GxTextLayout();
+
+	/// Constructs an empty layout with default text settings.
+	GxTextLayout();
+
+	/// Constructs a copy of another layout.
+	GxTextLayout(const GxTextLayout& other);
+
+	/// Sets the text settings. The layout is only recomputed if the font, flags, maximum width or tab width changed.
+	void SetSettings(const GxText& settings);
+
+	/// Sets the string and computes the layout of the full string.
+	void SetText(GxStringArg text);
+
+	/// Inserts a string at position pos and recomputes the lines that are affected by the insertion.
+	void Insert(int pos, GxStringArg text);
+
+	/// Erases n characters at position pos and recomputes the lines that are affected by the removal.
+	void Erase(int pos, int n);
+
+	/// Draws the string at position (x,y), see \c GxText::Draw().
+	GxRecti Draw(int x, int y) const;
+
+	/// Draws highlight rectangles for the string at position (x,y), see \c GxText::DrawHighlight().
+	GxRecti DrawHighlight(int x, int y) const;
+
+	/// Returns the area of the drawn text, see \c GxText::GetTextRect().
+	GxRecti GetTextRect(int x, int y) const;
+
+	/// Returns the area of the drawn glyph for the character at index, see \c GxText::GetCharRect().
+	GxRecti GetCharRect(int x, int y, int index) const;
+
+	/// Returns the index of the character at position (cx,cy), see \c GxText::GetCharIndex().
+	int GetCharIndex(int x, int y, int cx, int cy) const;
+
+	int GetLineCount() const;              ///< Returns the number of lines in the layout.
+	const GxTextBuffer& GetText() const;   ///< Returns the string.
+	const GxText& GetSettings() const;     ///< Returns the text settings.
+
+	GxTextLayout& operator = (const GxTextLayout& other); ///< Copies the string, settings and layout of another layout.
+
+private:
+	GxTextLayoutData* myData;
+};
+
 }; // namespace graphics
 }; // namespace guix
\ No newline at end of file
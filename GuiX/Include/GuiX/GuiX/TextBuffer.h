@@ -0,0 +1,135 @@
+/// @file
+/// Contains the text buffer class.
+
+#pragma once
+
+#include <GuiX/String.h>
+
+namespace guix {
+namespace core {
+
+/// Describes a change to the content of a text buffer, see \c GxTextBuffer::Undo().
+struct GUIX_API GxTextChange
+{
+	int pos;      ///< Position of the first changed character.
+	int erased;   ///< Number of characters that were removed at pos.
+	int inserted; ///< Number of characters that were inserted at pos.
+};
+
+// ===================================================================================
+// GxTextBuffer
+// ===================================================================================
+/** The GxTextBuffer class is an editable UTF-8 string with an undo history.
+
+ The GxTextBuffer class stores its characters in a gap buffer: a single array with an
+ unused gap at the position of the most recent edit. Inserting or erasing characters
+ near the previous edit only moves the gap, instead of moving every character behind
+ the edit like GxString does. This keeps typing and pasting into large texts cheap.
+
+ Every edit is recorded in an undo history. Inserts only record the edited range and
+ erases record the removed characters, so the history never holds copies of the full
+ content. Consecutive typing is merged into a single undo step, and an insert that
+ directly follows an erase at the same position is undone together with the erase.
+
+ @see GxString, GxTextEditHelper
+*/
+class GUIX_API GxTextBuffer
+{
+public:
+	~GxTextBuffer();
+
+	/// Constructs an empty text buffer.
+	GxTextBuffer();
+
+	/// Constructs a copy of another text buffer, including its undo history.
+	GxTextBuffer(const GxTextBuffer& other);
+
+	/// Sets the content to a copy of a string and clears the undo history.
+	void Set(GxStringArg str);
+
+	/// Inserts a string at position pos.
+	void Insert(int pos, GxStringArg str);
+
+	/// Erases n characters at position pos.
+	void Erase(int pos, int n);
+
+	/// Erases the content and clears the undo history.
+	void Clear();
+
+	/// Reverts the most recent group of edits. Returns false if there is nothing to undo.
+	/// If outChange is not null, it receives the range of the content that was changed.
+	bool Undo(GxTextChange* outChange = NULL);
+
+	/// Reapplies the most recently reverted group of edits. Returns false if there is nothing to redo.
+	/// If outChange is not null, it receives the range of the content that was changed.
+	bool Redo(GxTextChange* outChange = NULL);
+
+	/// Ends the current undo group; the next edit is never merged with the previous edits.
+	void EndUndoGroup();
+
+	/// Removes all the edits from the undo history.
+	void ClearHistory();
+
+	/// Enables or disables the undo history, which is enabled by default. Disabling it clears the history.
+	void SetHistoryEnabled(bool enabled);
+
+	bool CanUndo() const;          ///< Returns true if there are edits that can be reverted.
+	bool CanRedo() const;          ///< Returns true if there are reverted edits that can be reapplied.
+	bool IsHistoryEnabled() const; ///< Returns true if edits are recorded in the undo history.
+
+	/// Returns the position of the UTF-8 character after the character at pos.
+	int NextChar(int pos) const;
+
+	/// Returns the position of the UTF-8 character before the character at pos.
+	int PrevChar(int pos) const;
+
+	/// Returns a string with n characters starting at position pos.
+	GxString Substr(int pos = 0, int n = GxString::npos()) const;
+
+	int Length() const { return myLen;  } ///< Returns the number of characters, excluding the null-terminator.
+	bool Empty() const { return !myLen; } ///< Returns true if the buffer has a length of zero.
+
+	/// Returns the character at position pos.
+	char operator [] (int pos) const { return myData[pos < myGapPos ? pos : pos + myGapSize]; }
+
+	/// Returns the raw storage. The character at position i is stored at index i if i is in front of the
+	/// gap, or at index i + \c GetGapSize() otherwise. The storage is null-terminated after the last character.
+	const char* GetData() const { return myData; }
+
+	int GetGapPos() const  { return myGapPos;  } ///< Returns the position of the gap in the content.
+	int GetGapSize() const { return myGapSize; } ///< Returns the number of unused characters in the gap.
+
+	GxTextBuffer& operator = (const GxTextBuffer& other); ///< Copies the content and undo history of another buffer.
+
+private:
+	struct Edit
+	{
+		int pos, len, bytes;
+		bool isInsert, joined;
+	};
+
+	struct History
+	{
+		Edit* edits;
+		char* bytes;
+		int editCount, editCapacity;
+		int byteCount, byteCapacity;
+	};
+
+	void myCopy(const GxTextBuffer& other);
+	void myRead(int pos, int n, char* out) const;
+	void myMoveGap(int pos);
+	void myReserve(int n);
+	void myInsert(int pos, const char* str, int n);
+	void myErase(int pos, int n);
+	void myRecord(bool isInsert, int pos, int n);
+	bool myRevert(History& from, History& to, bool undo, GxTextChange* outChange);
+
+	char* myData;
+	int myLen, myGapPos, myGapSize;
+	History myUndo, myRedo;
+	bool myIsHistoryEnabled, myIsMerging;
+};
+
+}; // namespace core
+}; // namespace guix
@@ -19,6 +19,11 @@ namespace graphics {
  counted) handle to a texture, so it is safe to copy them or pass them around as
  parameters.
 
+ Textures that are created with \c CreateAsync() are decoded on a background thread.
+ Until the image is uploaded, they are drawn as a transparent placeholder and have a
+ size of zero. Objects that store the size of a texture, like GxSprite, have to be
+ updated once \c IsLoading() returns false.
+
  @see GxTextureDatabase, GxDraw
 */
 class GUIX_API GxTexture
@@ -44,6 +49,10 @@ public:
 	/// Generates a texture through the GxRenderInterface with the specified parameters.
 	bool Create(int width, int height, const uchar* pixeldata);
 
+	/// Works like \c Create(path), but returns immediately and decodes the image on a background
+	/// thread. The image is uploaded by \c GxTextureDatabase::ApplyLoads().
+	bool CreateAsync(const char* path);
+
 	/// Releases the current texture.
 	void Destroy();
 
@@ -62,6 +71,9 @@ public:
 	/// Returns the height of the current UV region in pixels.
 	float GetHeightV() const;
 
+	/// Returns true if the texture is waiting for an asynchronous load to be applied.
+	bool IsLoading() const;
+
 	GxTextureHandle GetHandle() const; ///< Returns the texture handle.
 	int GetWidth() const;              ///< Returns the number of horizontal pixels.
 	int GetHeight() const;             ///< Returns the number of vertical pixels. 
@@ -71,11 +83,13 @@ public:
 	GxTexture& operator = (const GxTexture& other); ///< Calls \c Assign().
 
 private:
+	void myResolve() const;
 	void mySetUVs(const GxAreaf* uvs);
 
-	GxTextureHandle myHandle;
+	// The handle and size of an asynchronously loaded texture are updated when it is resolved.
+	mutable GxTextureHandle myHandle;
 	GxAreaf* myUVs;
-	GxVec2i mySize;
+	mutable GxVec2i mySize;
 };
 
 // ===================================================================================
@@ -104,6 +118,18 @@ public:
 	/// Returns the number currently loaded textures.
 	virtual int GetLoadedTextureCount() const = 0;
 
+	/// Returns the number of asynchronous loads of textures and glyph pages that are not applied yet.
+	virtual int GetPendingLoadCount() const = 0;
+
+	/// Returns the number of bytes of decoded images that are waiting to be uploaded.
+	virtual size_t GetPendingLoadBytes() const = 0;
+
+	/// Uploads the images that were decoded on the background thread since the last call,
+	/// and returns the number of textures and glyph pages that were applied. This is called
+	/// by every GxContext at the start of \c GxContext::Tick(). If wait is true, the function
+	/// waits until all pending images are decoded first.
+	virtual int ApplyLoads(bool wait = false) = 0;
+
 	/// GxLogs info about the loaded textures.
 	virtual void LogInfo() const = 0;
 };
@@ -23,14 +23,15 @@ class GxLayout;
  place, such as the user pressing a button or changing the contents of a input field.
  All events contain the id of the widget that sent the event and the type of event
  that occured. Some events also contain additional data, which is stored in the
- value field.
+ value field. The id and type are atoms, so comparing them with the event functions of
+ widget classes, such as \c GxButton::ePressed(), is a pointer comparison.
 
  @see GxCallback
 */
 struct GUIX_API GxWidgetEvent
 {
-	GxString id;     ///< The widget id of the widget that sent the event.
-	GxString type;   ///< A string identifying the type of the event that was sent.
+	GxAtom id;       ///< The widget id of the widget that sent the event.
+	GxAtom type;     ///< An atom identifying the type of the event that was sent.
 	GxVariant value; ///< Event data. Read the description of individual events for more info.
 };
 
@@ -148,11 +149,13 @@ struct GUIX_API GxSizePolicyResult
 /// Macro for declaring a widget class; use inside the widget class definition.
 #define GxDeclareWidgetClass(typeString) \
 	static const char* GetClassId() {return #typeString;} \
-	virtual const char* GetTypeId() const {return #typeString;}
+	static GxAtom GetClassAtom() {static const GxAtom atom(#typeString); return atom;} \
+	virtual const char* GetTypeId() const {return #typeString;} \
+	virtual GxAtom GetTypeAtom() const {return GetClassAtom();}
 
 /// Macro for defining a widget event; use in the widget class source file.
 #define GxDefineWidgetEvent(widgetClass, evt) \
-	const char* widgetClass::evt() {return #widgetClass ":" #evt;}
+	GxAtom widgetClass::evt() {static const GxAtom atom(#widgetClass ":" #evt); return atom;}
 
 /** The GxWidget class is the abstract base class from which all widgets are derived.
  
@@ -174,6 +177,12 @@ struct GUIX_API GxSizePolicyResult
  widget events to the context, which can trigger event callbacks that are attached to
  the widget by the application.
 
+ Widgets that rarely change can cache their geometry by calling \c SetCacheGeometry().
+ The geometry that the widget and its children draw is then recorded once, and replayed
+ on the following frames until the widget rectangle, layout, hover/focus/input state,
+ highlight or the global style changes. Widgets that change their appearance in other
+ ways should call \c InvalidateGeometry().
+
  @see GxWidgetEvent, GxContext
 */
 class GUIX_API GxWidget
@@ -187,8 +196,9 @@ public:
 		F_DISABLED    = F_HIDDEN | F_UNARRANGED, ///< Set if the widget is both hidden and unarranged.
 		F_CHANGED     = 1 << 3, ///< Set if the state of the widget was changed as a result of user interaction.
 		F_INTERACTED  = 1 << 4, ///< Set if the widget has received user interaction (even if it did not change the widget state).
+		F_CACHED      = 1 << 5, ///< Set if the geometry of the widget is cached between frames.
 
-		F_WBIT        = 1 << 5, ///< The first bit that can be used by specialized widget classes for flags.
+		F_WBIT        = 1 << 6, ///< The first bit that can be used by specialized widget classes for flags.
 		F_WMASK       = F_WBIT-1, ///< The mask that contains the flag bits for the GxWidget class.
 	};
 
@@ -204,6 +214,9 @@ public:
 	/// This function is overloaded by using the GxDeclareWidgetClass macro.
 	virtual const char* GetTypeId() const = 0;
 
+	/// Returns the atom of the type id. This function is overloaded by using the GxDeclareWidgetClass macro.
+	virtual GxAtom GetTypeAtom() const = 0;
+
 	virtual void OnKeyPress(GxKeyEvent& evt)        {} ///< Called by the context when a key is pressed.
 	virtual void OnKeyRelease(GxKeyEvent& evt)      {} ///< Called by the context when a key is released.
 	virtual void OnTextInput(GxTextEvent& evt)      {} ///< Called by the context when text input occurs.
@@ -251,10 +264,16 @@ public:
 	void SetToolTip(GxString text); ///< Sets the tooltip text, which is displayed on mouse over.
 
 	void SetParent(GxWidget* parent); ///< Sets this widget's parent widget.
+	void Invalidate(); ///< Marks the layout of this widget and its parent widgets as changed, so the context updates it on the next tick.
+	void InvalidateGeometry(); ///< Marks the cached geometry of this widget and its parent widgets as changed, so it is drawn again on the next frame.
+	void UpdateAdjust(); ///< Calls \c Adjust() if the layout of this widget or one of its children was invalidated. Layouts call this on their widgets.
+	void UpdateRect(const GxRecti& rect); ///< Calls \c SetRect() if the layout was invalidated or the rectangle changed, so unchanged subtrees are not arranged again.
+	void SetCacheGeometry(bool enabled); ///< Enables or disables caching of the geometry drawn by this widget and its children.
+	void DrawCached(); ///< Draws the widget, or replays its cached geometry if caching is enabled and the geometry is still valid.
 	void SetCallback(GxCallback* callback); ///< Sets a callback, which is called when the widget emits an event.
 
-	void EmitEvent(const char* type); ///< Emits an event that can be received by GxCallback objects. Fills in id and type.
-	void EmitEvent(const char* type, const GxVariant& value); ///< Similar to \c EmitEvent(type), but also fills in value.
+	void EmitEvent(GxAtom type); ///< Emits an event that can be received by GxCallback objects. Fills in id and type.
+	void EmitEvent(GxAtom type, const GxVariant& value); ///< Similar to \c EmitEvent(type), but also fills in value.
 	void EmitGroupEvent(); ///< Emits a group event to other widgets with the same group id.
 
 	void GrabFocus(); ///< Makes this widget the current focus widget.
@@ -278,27 +297,33 @@ public:
 	GxString GetGroupId() const; /// Returns the group id, or an empty string if there is none.
 	GxString GetToolTip() const; /// Returns the tooltip text, or an empty string if there is none.
 
+	GxAtom GetWidgetAtom() const; /// Returns the atom of the widget id.
+
 	// ===================================================================================
 	// Inline set functions
 
-	void SetSizeHint(int w, int h)        {myPolicy->hint.Set(w, h);}
-	void SetSizeMin(int w, int h)         {myPolicy->min.Set(w, h);}
-	void SetSizeMax(int w, int h)         {myPolicy->max.Set(w, h);}
+	void SetSizeHint(int w, int h)        {myPolicy->hint.Set(w, h); Invalidate();}
+	void SetSizeMin(int w, int h)         {myPolicy->min.Set(w, h); Invalidate();}
+	void SetSizeMax(int w, int h)         {myPolicy->max.Set(w, h); Invalidate();}
 
-	void SetAdjustHint(bool enabled)      {myPolicy->adjustHint = enabled;}
-	void SetAdjustMin(bool enabled)       {myPolicy->adjustMin = enabled;}
-	void SetAdjustFlags(bool enabled)     {myPolicy->adjustFlags = enabled;}
+	void SetAdjustHint(bool enabled)      {myPolicy->adjustHint = enabled; Invalidate();}
+	void SetAdjustMin(bool enabled)       {myPolicy->adjustMin = enabled; Invalidate();}
+	void SetAdjustFlags(bool enabled)     {myPolicy->adjustFlags = enabled; Invalidate();}
+
+	/// Replaces the size policy, and invalidates the layout of the widget.
+	void SetPolicy(const GxSizePolicy& policy) {*myPolicy = policy; Invalidate();}
 
 	void SetLocked(bool locked)           {myFlags.Set(F_LOCKED, locked);}
-	void SetHidden(bool hidden)           {myFlags.Set(F_HIDDEN, hidden);}
-	void SetUnarranged(bool unarranged)   {myFlags.Set(F_UNARRANGED, unarranged);}
-	void SetDisabled(bool disabled)       {myFlags.Set(F_DISABLED, disabled);}
+	void SetHidden(bool hidden)           {mySetLayoutFlags(F_HIDDEN, hidden);}
+	void SetUnarranged(bool unarranged)   {mySetLayoutFlags(F_UNARRANGED, unarranged);}
+	void SetDisabled(bool disabled)       {mySetLayoutFlags(F_DISABLED, disabled);}
 
 	// ===================================================================================
 	// Inline get functions
 
 	const GxRecti& GetRect() const        {return myRect;}
 
+	/// Returns the size policy. Call \c Invalidate() after changing it, or use \c SetPolicy(), so the layout is updated.
 	GxSizePolicy& GetPolicy()             {return *myPolicy;}
 	const GxSizePolicy& GetPolicy() const {return *myPolicy;}
 
@@ -310,17 +335,21 @@ public:
 	bool IsUnarranged() const             {return myFlags[F_UNARRANGED];}
 	bool IsChanged() const                {return myFlags[F_CHANGED];}
 	bool IsInteracted() const             {return myFlags[F_INTERACTED];}
+	bool IsCachingGeometry() const        {return myFlags[F_CACHED];}
 
 	GxFlags GetFlags() const              {return myFlags;}
 
 	template <typename T>
-		bool HasType() const              {return GxStrCmp(GetTypeId(), T::GetClassId()) == 0;}
+		bool HasType() const              {return GetTypeAtom() == T::GetClassAtom();}
 
 protected:
 	GxRecti myRect;               ///< The widget's position and size in view coordinates.
 	GxSizePolicy* myPolicy;       ///< The size policy data used for resizing the widget.
 	GxContextNode* myContextNode; ///< Contains internal context data for the widget.
 	GxFlags myFlags;              ///< Combination of widget flags. See Flags enumeration.
+
+private:
+	void mySetLayoutFlags(int flags, bool enabled);
 };
 
 }; // namespace gui
@@ -55,10 +55,10 @@ public:
 	// Events
 
 	/// Emitted when the user starts pressing a button.
-	static const char* ePressed();
+	static GxAtom ePressed();
 
 	/// Emitted when the user stops pressing a button.
-	static const char* eReleased();
+	static GxAtom eReleased();
 
 protected:
 	GxString myText;
@@ -72,7 +72,7 @@ public:
 
 	/// Emitted when the user checks or unchecks a checkbox.
 	/// value: boolean, is set to true if the checkbox is now checked.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	GxString myText;
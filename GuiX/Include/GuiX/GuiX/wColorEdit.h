@@ -52,7 +52,7 @@ public:
 
 	/// Emitted when the user selects a new color.
 	/// value: GxColorf, the color that is selected.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	void myInit(const GxVec4f& col, bool alpha);
@@ -67,7 +67,7 @@ public:
 
 	/// Emitted when the user selects a new color.
 	/// value: GxColorf, the color that is selected.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	void myInit();
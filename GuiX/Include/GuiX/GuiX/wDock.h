@@ -105,7 +105,7 @@ public:
 	// Events
  
 	/// Emitted when the user clicks on the dock's close button.
-	static const char* eClose();
+	static GxAtom eClose();
 
 private:
 	friend class GxDockArea;
@@ -131,6 +131,7 @@ private:
 	GxRecti myFloatRect;
 	GxString myTitle;
 	GxFlags myState;
+	Item myMouseItem;
 };
 
 // ===================================================================================
@@ -209,12 +210,12 @@ protected:
 	void myUndock(GxDock* d);
 	void myDock(GxDock* d, int bin);
 	int myGetBinAt(int x, int y) const;
+	GxDock* myGetHoverDock() const;
 
 	typedef GxList<GxDock*> DockList;
 
 	DockList myDocks;
 	GxDockBin* myBins[2];
-	GxDock* myHoverDock;
 	GxDock* myFocusDock;
 	GxVec2i myResizeDir;
 	GxRecti myActionDims;
@@ -13,6 +13,7 @@ namespace guix {
 namespace widgets {
 
 class GxSelectList;
+class GxListModel;
 
 // ===================================================================================
 // GxDroplist
@@ -26,7 +27,13 @@ class GxSelectList;
  select a new item. It emits an event whenever the selected item changes, which occurs
  when the user selects an item from the list that is different from the current item.
 
- @see GxWidget
+ Instead of storing its items, the droplist can display the rows of a GxListModel. The
+ expanded list reads the items from the model or from the droplist directly, and only
+ draws the visible ones, so droplists with thousands of items open without delay.
+ While the list is expanded, typing text selects the next item that begins with it,
+ and pressing return or escape closes the list.
+
+ @see GxWidget, GxListModel
 */
 class GUIX_API GxDroplist : public GxWidget
 {
@@ -44,8 +51,11 @@ public:
 	// ===================================================================================
 	// Overloaded widget functions
 
+	void OnKeyPress(GxKeyEvent& evt);
+	void OnTextInput(GxTextEvent& evt);
 	void OnMousePress(GxMouseEvent& evt);
 
+	void Tick(float dt);
 	void Draw();
 
 	// ===================================================================================
@@ -65,6 +75,14 @@ public:
 	/// Sets the selected item to the item at index.
 	void SetSelectedItem(int index);
 
+	/// Displays the rows of model instead of the items that were added to the droplist.
+	/// The value of a row is its index. The model is not owned by the droplist and must
+	/// outlive it; set it to NULL to display the items again.
+	void SetModel(GxListModel* model);
+
+	/// Returns the model that provides the items, or NULL if the droplist displays its own items.
+	GxListModel* GetModel() const;
+
 	/// Returns the value of the selected item.
 	GxVariant GetValue() const;
 
@@ -76,20 +94,26 @@ public:
 
 	/// Emitted when the user selects a different item on the list.
 	/// value: generic, the value of the item that was selected.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 	/// Emitted when the user selects any item on the list, including the item that is already selected.
 	/// value: generic, the value of the item that was selected.
-	static const char* eSelected();
+	static GxAtom eSelected();
 
 protected:
 	void myInit();
 	void myOpenList();
+	void myCloseList(bool select);
+	void mySearch(bool next);
 
 	GxList<GxString> myItems;
 	GxList<GxVariant> myValues;
+	GxListModel* myModel;
+	GxListModel* myItemModel;
 	GxSelectList* mySelectList;
 	int mySelectedItem;
+	GxString mySearchText;
+	float mySearchTimer;
 };
 
 }; // namespace widgets
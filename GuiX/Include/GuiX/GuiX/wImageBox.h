@@ -54,7 +54,7 @@ public:
 	/// Sets the background color of the area behind the image.
 	void SetBackgroundColor(GxColor c);
 
-	GxSprite& GetSprite();             ///< Returns the sprite.
+	GxSprite& GetSprite();             ///< Returns the sprite. Call \c Invalidate() after resizing it.
 	const GxSprite& GetSprite() const; ///< Returns the sprite.
 
 protected:
@@ -37,6 +37,7 @@ public:
 	// Overloaded widget functions
 
 	void Adjust();
+	void SetRect(const GxRecti& rect);
 	void Draw();
 
 	// ===================================================================================
@@ -79,7 +79,7 @@ public:
 
 	/// Event: emitted when the user selects a new radio button.
 	/// Value: int, the value associated with the selected button.
-	static const char* eSelected();
+	static GxAtom eSelected();
 
 protected:
 	GxString myText;
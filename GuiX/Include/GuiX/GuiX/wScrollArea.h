@@ -25,6 +25,12 @@ namespace widgets {
  If a scrollbar is disabled, the widgets will be shrunken in that direction if they
  exceed the available space.
 
+ Widgets whose rectangle lies completely outside of the view area are not drawn and
+ not searched for hover. Scroll areas with many widgets can also enable lazy arrangement
+ with SetLazyArrange(), so that only the widgets near the view area are arranged when
+ the view scrolls. Widgets should not draw outside of their own rectangle, because that
+ part is not drawn while the rectangle is outside of the view area.
+
  @see GxContainer
 */
 class GUIX_API GxScrollArea : public GxContainer
@@ -56,6 +62,10 @@ public:
 	void SetScrollH(bool enabled); ///< Enables or disables horizontal scrolling.
 	void SetScrollV(bool enabled); ///< Enables or disables vertical scrolling.
 
+	/// Enables or disables lazy arrangement. If enabled, only widgets that are within one view
+	/// size of the view area are arranged; see \c GxLayout::SetLazyArrange(). Disabled by default.
+	void SetLazyArrange(bool enabled);
+
 private:
 	void myInit(bool scrollH, bool scrollV);
 	bool myIsActiveH() const;
@@ -64,6 +74,7 @@ private:
 
 	GxScrollbarH* myScrollbarH;
 	GxScrollbarV* myScrollbarV;
+	bool myIsLazyArrange;
 };
 
 }; // namespace widgets
@@ -102,7 +102,7 @@ public:
  
 	/// Emitted when the user changes the position of the scrollbar.
 	/// value: double, the scrollbar position.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	void myUpdateValue(double value, bool emitEvent);
@@ -13,6 +13,38 @@
 namespace guix {
 namespace widgets {
 
+// ===================================================================================
+// GxListModel
+// ===================================================================================
+/** The GxListModel class provides the rows of a list widget on demand.
+
+ Implement the GxListModel class to display data that is not stored in the widget, such as
+ a large table or a directory listing. The widget only asks the model for the text of the
+ rows that are visible, so the cost of drawing a list does not depend on its number of rows.
+ The row count is queried every tick, which allows the model to grow or shrink at any time.
+ If the text of rows changes while the count stays the same, call GxWidget::InvalidateGeometry()
+ on the list when it caches its geometry. Models that can search their rows faster than by
+ reading them one by one, for example because the rows are sorted, can override FindRow.
+
+ @see GxSelectList
+*/
+class GUIX_API GxListModel
+{
+public:
+	virtual ~GxListModel() {}
+
+	/// Returns the number of rows in the list.
+	virtual int GetRowCount() const = 0;
+
+	/// Returns the text displayed on the row at index, where index is in [0, GetRowCount()).
+	virtual GxString GetRowText(int index) const = 0;
+
+	/// Returns the index of the first row at or after start whose text begins with prefix, ignoring
+	/// case, or -1 if no row does. The search wraps around to the first row after the last row.
+	/// The default implementation calls GetRowText for every row until a matching row is found.
+	virtual int FindRow(const GxString& prefix, int start) const;
+};
+
 // ===================================================================================
 // GxSelectList
 // ===================================================================================
@@ -24,6 +56,10 @@ namespace widgets {
  highlighted. Each item is displayed as a line of text, possibly with a sprite next to
  it (this is up to the widget style).
 
+ Instead of storing its items, the select list can display the rows of a GxListModel.
+ Only the visible items are drawn, and items are found from mouse positions arithmetically,
+ so lists with millions of rows are as cheap to draw and tick as short lists.
+
  @see GxWidget
 */
 class GUIX_API GxSelectList : public GxWidget
@@ -68,32 +104,48 @@ public:
 	/// Sets the selected item to the item at index.
 	void SetSelectedItem(int index);
 
+	/// Scrolls the list by the smallest amount that makes the item at index visible.
+	/// If the list has not been arranged yet, it scrolls when it is.
+	void ScrollToItem(int index);
+
 	/// Returns the text of the item at index.
 	GxString GetItem(int index) const;
 
+	/// Displays the rows of model instead of the items that were added to the list.
+	/// The model is not owned by the list and must outlive it; set it to NULL to display the items again.
+	void SetModel(GxListModel* model);
+
+	/// Returns the model that provides the items, or NULL if the list displays its own items.
+	GxListModel* GetModel() const;
+
 	int GetSelectedItem() const; ///< Returns the index of the selected item.
 	int GetItemCount() const;    ///< Returns the number of items in the droplist.
 
 	// ===================================================================================
 	// Events
 
-	/// Emitted when the user selects a different item on the list.
-	/// value: int, the index of the item that was selected.
-	static const char* eChanged();
+	/// Emitted when the user selects a different item on the list, or when the rows of the model
+	/// shrink below the selected item, which selects the last row instead.
+	/// value: int, the index of the item that was selected, or -1 if the model has no rows.
+	static GxAtom eChanged();
 
 	/// Emitted when the user selects any item on the list, including the current item.
 	/// value: int, the index of the item that was selected.
-	static const char* eSelected();
+	static GxAtom eSelected();
 
 protected:
 	int myGetItemAtPos(int x, int y) const;
 	GxRecti myGetListRect() const;
+	void myApplyScrollToItem();
 
 	GxTextAlignH myAlignH;
 	GxList<GxString> myItems;
+	GxListModel* myModel;
+	int myItemCount;
 	GxScrollbarV* myScrollbar;
 	int myMouseOverItem;
 	int mySelectedItem;
+	int myScrollToItem;
 };
 
 }; // namespace widgets
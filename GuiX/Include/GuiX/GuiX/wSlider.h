@@ -80,7 +80,7 @@ public:
 
 	/// Emitted when the user changes the position of the slider.
 	/// value: double, the new slider value.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	void myUpdateValue(double value, bool emitEvent);
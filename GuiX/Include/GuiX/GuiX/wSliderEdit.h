@@ -71,7 +71,7 @@ public:
 
 	/// Emitted when the user changes the slider or spinner value.
 	/// value: double, the new spinner/spinner value.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 private:
 	void myInit();
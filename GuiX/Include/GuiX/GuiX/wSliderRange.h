@@ -73,7 +73,7 @@ public:
 
 	/// Emitted when the user changes the position of the slider.
 	/// value: GxVec2f, the new slider value.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	void myUpdateValue(double value, bool left, bool emitEvent);
@@ -85,6 +85,7 @@ protected:
 
 	GxSpinner* mySpinners;
 	GxVec2d myValue, myRange;
+	bool myHlLeft;
 };
 
 }; // namespace widgets
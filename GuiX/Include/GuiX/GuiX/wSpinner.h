@@ -86,7 +86,7 @@ public:
 
 	/// Emitted when the user changes the spinner value.
 	/// value: double, the new spinner value.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	void myInit();
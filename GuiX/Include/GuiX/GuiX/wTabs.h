@@ -61,7 +61,7 @@ public:
 
 	/// Emitted when the user selects a new tab.
 	/// value: int, the index of the new tab that was selected.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 private:
 	GxRecti myGetTabRect(int index) const;
@@ -18,8 +18,9 @@ namespace widgets {
 
  The GxTextEditHelper class is used by text input widgets to create a rectangle in
  which the user can edit plain text. It supports a variety of features such as
- commonly used hotkeys for selection, copy and pasting to clipboard, multi-line
- editing, password setting, filtering for numerical input and custom fonts.
+ commonly used hotkeys for selection, copy and pasting to clipboard, undo and redo,
+ multi-line editing, password setting, filtering for numerical input and custom fonts.
+ The text is stored in a GxTextBuffer, so edits in large texts stay cheap.
 
  @see GxTextEditAbstract, GxSpinner
 */
@@ -39,6 +40,9 @@ public:
 	void Tick(int mouseX, int mouseY, float dt);
 	void Draw();
 
+	bool Undo();
+	bool Redo();
+
 	void SetNumerical(bool isNumerical);
 	void SetMultiLine(bool isMultiLine);
 	void SetPassword(bool isPassword, char replacement = '*');
@@ -60,16 +64,22 @@ public:
 
 private:
 	void myAdjustSettings();
+	void mySetContent(GxString text);
+	void myUpdateLayout();
+	void myApplyChange(const GxTextChange& change);
 	void myDeleteSelection();
 	int myAdvanceCursorLine(bool forward);
 	void myFilterText(GxString& text) const;
-	GxString myGetDisplayString() const;
+	GxString myGetDisplayString(int pos = 0, int n = GxString::npos()) const;
 	GxVec2i myGetScrollOffset() const;
 
 	GxRecti myRect;
 	GxVec2i myCursor;
-	GxString myContent;
+	GxTextBuffer myContent;
+	mutable GxString myText;
+	mutable bool myIsTextChanged;
 	GxText mySettings;
+	GxTextLayout myLayout;
 	GxColor myHlColor;
 	int myMaxLength;
 	float myBlinkTime, myScrollOffset;
@@ -133,7 +143,7 @@ public:
 
 	/// Emitted when the user changes the text.
 	/// value: string, the new contents of the text box.
-	static const char* eChanged();
+	static GxAtom eChanged();
 
 protected:
 	GxTextEditHelper myField;
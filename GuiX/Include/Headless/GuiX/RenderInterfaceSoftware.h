@@ -0,0 +1,64 @@
+#pragma once
+
+#include <GuiX/Interfaces.h>
+
+namespace guix {
+namespace framework {
+
+// ===================================================================================
+// GxRenderInterfaceSoftware
+// ===================================================================================
+/** The GxRenderInterfaceSoftware class renders into an RGBA framebuffer on the CPU.
+
+ It does not depend on a window or a graphics API, which makes it suitable for rendering
+ on machines without a GPU, for example to generate screenshots. Axis-aligned quads, which
+ make up most of the geometry drawn by GuiX, are filled as rectangles; other triangles are
+ rasterized with scanlines. Spans of pixels are blended with SSE2 or AVX2 when available.
+*/
+class GUIX_API GxRenderInterfaceSoftware : public GxRenderInterface
+{
+public:
+	GxRenderInterfaceSoftware();
+	~GxRenderInterfaceSoftware();
+
+	/// Resizes the framebuffer. The contents of the framebuffer are cleared to transparent black.
+	void SetViewSize(GxVec2i size);
+	GxVec2i GetViewSize();
+
+	/// Fills the entire framebuffer with a color, ignoring the scissor rectangle and blend mode.
+	void Clear(GxColor color);
+
+	/// Returns the framebuffer; has 4 values per pixel in RGBA format, stored row by row from the top.
+	const uchar* GetPixels() const;
+
+	void DrawTriangles(const GxVertex* vertices, int vertexCount, GxTextureHandle texture);
+	void DrawTriangles(const GxVertex* vertices, int vertexCount, const uint* indices, int indexCount, GxTextureHandle texture);
+
+	void SetBlendMode(GxBlendMode blendMode);
+	void EnableScissorRect(bool enable);
+	void SetScissorRect(int x, int y, int width, int height);
+
+	bool LoadTexture(GxTextureHandle& outTexture, int& outWidth, int& outHeight, const char* path);
+	bool GenerateTexture(GxTextureHandle& outTexture, int width, int height, const uchar* pixeldata);
+	void ReleaseTexture(GxTextureHandle texture);
+	bool UpdateTexture(GxTextureHandle texture, int x, int y, int width, int height, const uchar* pixeldata);
+
+	bool LoadPixels(uchar*& outPixels, int& outWidth, int& outHeight, const char* path);
+	void ReleasePixels(uchar* pixels);
+
+private:
+	void myUpdateClipRect();
+	void myDrawQuad(const GxVertex* v[4], GxTextureHandle texture);
+	void myDrawTriangle(const GxVertex& a, const GxVertex& b, const GxVertex& c, GxTextureHandle texture);
+
+	uint* myPixels;
+	uint* mySpan;
+	GxVec2i myViewSize;
+	GxRecti myScissorRect;
+	GxRecti myClipRect;
+	GxBlendMode myBlendMode;
+	bool myIsScissorEnabled;
+};
+
+}; // namespace framework
+}; // namespace guix
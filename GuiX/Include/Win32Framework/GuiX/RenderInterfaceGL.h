@@ -27,6 +27,10 @@ public:
 	bool LoadTexture(GxTextureHandle& outTexture, int& outWidth, int& outHeight, const char* path);
 	bool GenerateTexture(GxTextureHandle& outTexture, int width, int height, const uchar* pixeldata);
 	void ReleaseTexture(GxTextureHandle texture);
+	bool UpdateTexture(GxTextureHandle texture, int x, int y, int width, int height, const uchar* pixeldata);
+
+	bool LoadPixels(uchar*& outPixels, int& outWidth, int& outHeight, const char* path);
+	void ReleasePixels(uchar* pixels);
 
 private:
 	GxVec2i myViewSize;
@@ -5,22 +5,45 @@
 
 #include <GuiX/Canvas.h>
 
+#include <Src/WorkerPool.h>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define GX_CANVAS_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define GX_CANVAS_SSE2
+#endif
+
 namespace guix {
 namespace graphics {
 
 struct GxCanvas::DistFunc
 {
 	virtual float Get(float px, float py) const = 0;
+
+	// Writes the distances of n pixels on a row to out, starting at px in steps of one pixel.
+	virtual void GetSpan(float px, float py, float* out, int n) const
+	{
+		for(int i=0; i<n; ++i)
+			out[i] = Get(px + (float)i, py);
+	}
 };
 
 namespace {
 
+enum CanvasProperties
+{
+	TILE_SIZE = 64,             // Width and height of the tiles that a drawing operation is split into.
+	PARALLEL_MIN_AREA = 128*128 // Drawing operations that cover fewer pixels are not spread over threads.
+};
+
 // ===================================================================================
 // Blend functions
 // ===================================================================================
 
-typedef void(*BlendFunc)(uchar*, const uchar*, int sa);
-
 // Linear interpolation between destination and source.
 static void BlendNone(uchar* d, const uchar* s, int sa)
 {
@@ -118,6 +141,204 @@ static void BlendMul(uchar* d, const uchar* s, int sa)
 	}
 }
 
+// ===================================================================================
+// SIMD lane operations
+// ===================================================================================
+// The lane types wrap the intrinsics for four (SSE2) or eight (AVX2) pixels, so that the
+// distance and blend functions below are written once for both instruction sets. Integer
+// lanes hold one pixel each, or one channel of a pixel after unpacking.
+
+#if defined(GX_CANVAS_SSE2)
+
+struct LanesSSE2
+{
+	typedef __m128 F;
+	typedef __m128i I;
+	enum { N = 4, ALL = 0xF };
+
+	static inline F Set(float x)                { return _mm_set1_ps(x); }
+	static inline F Ramp(float x)               { return _mm_setr_ps(x, x + 1.f, x + 2.f, x + 3.f); }
+	static inline F Load(const float* p)        { return _mm_loadu_ps(p); }
+	static inline void Store(float* p, F x)     { _mm_storeu_ps(p, x); }
+	static inline F Add(F a, F b)               { return _mm_add_ps(a, b); }
+	static inline F Sub(F a, F b)               { return _mm_sub_ps(a, b); }
+	static inline F Mul(F a, F b)               { return _mm_mul_ps(a, b); }
+	static inline F Div(F a, F b)               { return _mm_div_ps(a, b); }
+	static inline F Min(F a, F b)               { return _mm_min_ps(a, b); }
+	static inline F Max(F a, F b)               { return _mm_max_ps(a, b); }
+	static inline F Sqrt(F a)                   { return _mm_sqrt_ps(a); }
+	static inline F Abs(F a)                    { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+	static inline F Neg(F a)                    { return _mm_xor_ps(_mm_set1_ps(-0.f), a); }
+	static inline F Less(F a, F b)              { return _mm_cmplt_ps(a, b); }
+	static inline F LessEqual(F a, F b)         { return _mm_cmple_ps(a, b); }
+	static inline F Equal(F a, F b)             { return _mm_cmpeq_ps(a, b); }
+	static inline F And(F a, F b)               { return _mm_and_ps(a, b); }
+	static inline F Select(F m, F a, F b)       { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+	static inline I Truncate(F a)               { return _mm_cvttps_epi32(a); }
+	static inline I Mask(F m)                   { return _mm_castps_si128(m); }
+
+	static inline I ISet(int x)                 { return _mm_set1_epi32(x); }
+	static inline I ILoad(const void* p)        { return _mm_loadu_si128((const __m128i*)p); }
+	static inline void IStore(void* p, I x)     { _mm_storeu_si128((__m128i*)p, x); }
+	static inline I IAdd(I a, I b)              { return _mm_add_epi32(a, b); }
+	static inline I ISub(I a, I b)              { return _mm_sub_epi32(a, b); }
+	static inline I IMul(I a, I b)              { return _mm_madd_epi16(a, b); }
+	static inline I IShr8(I a)                  { return _mm_srai_epi32(a, 8); }
+	static inline I IGreater(I a, I b)          { return _mm_cmpgt_epi32(a, b); }
+	static inline I IEqual(I a, I b)            { return _mm_cmpeq_epi32(a, b); }
+	static inline I ISelect(I m, I a, I b)      { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+	static inline I IMin(I a, I b)              { return ISelect(_mm_cmpgt_epi32(a, b), b, a); }
+	static inline I IMax(I a, I b)              { return ISelect(_mm_cmpgt_epi32(a, b), a, b); }
+	static inline I IAddSat8(I a, I b)          { return _mm_adds_epu8(a, b); }
+	static inline I ISubSat8(I a, I b)          { return _mm_subs_epu8(a, b); }
+	static inline int IBits(I m)                { return _mm_movemask_ps(_mm_castsi128_ps(m)); }
+
+	static inline void Unpack(I p, I c[4])
+	{
+		const __m128i mask = _mm_set1_epi32(0xFF);
+		c[0] = _mm_and_si128(p, mask);
+		c[1] = _mm_and_si128(_mm_srli_epi32(p, 8), mask);
+		c[2] = _mm_and_si128(_mm_srli_epi32(p, 16), mask);
+		c[3] = _mm_srli_epi32(p, 24);
+	}
+	static inline I Pack(const I c[4])
+	{
+		return _mm_or_si128(_mm_or_si128(c[0], _mm_slli_epi32(c[1], 8)),
+			_mm_or_si128(_mm_slli_epi32(c[2], 16), _mm_slli_epi32(c[3], 24)));
+	}
+};
+
+#endif // GX_CANVAS_SSE2
+
+#if defined(GX_CANVAS_AVX2)
+
+struct LanesAVX2
+{
+	typedef __m256 F;
+	typedef __m256i I;
+	enum { N = 8, ALL = 0xFF };
+
+	static inline F Set(float x)                { return _mm256_set1_ps(x); }
+	static inline F Ramp(float x)               { return _mm256_add_ps(_mm256_set1_ps(x), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)); }
+	static inline F Load(const float* p)        { return _mm256_loadu_ps(p); }
+	static inline void Store(float* p, F x)     { _mm256_storeu_ps(p, x); }
+	static inline F Add(F a, F b)               { return _mm256_add_ps(a, b); }
+	static inline F Sub(F a, F b)               { return _mm256_sub_ps(a, b); }
+	static inline F Mul(F a, F b)               { return _mm256_mul_ps(a, b); }
+	static inline F Div(F a, F b)               { return _mm256_div_ps(a, b); }
+	static inline F Min(F a, F b)               { return _mm256_min_ps(a, b); }
+	static inline F Max(F a, F b)               { return _mm256_max_ps(a, b); }
+	static inline F Sqrt(F a)                   { return _mm256_sqrt_ps(a); }
+	static inline F Abs(F a)                    { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+	static inline F Neg(F a)                    { return _mm256_xor_ps(_mm256_set1_ps(-0.f), a); }
+	static inline F Less(F a, F b)              { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static inline F LessEqual(F a, F b)         { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static inline F Equal(F a, F b)             { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+	static inline F And(F a, F b)               { return _mm256_and_ps(a, b); }
+	static inline F Select(F m, F a, F b)       { return _mm256_blendv_ps(b, a, m); }
+	static inline I Truncate(F a)               { return _mm256_cvttps_epi32(a); }
+	static inline I Mask(F m)                   { return _mm256_castps_si256(m); }
+
+	static inline I ISet(int x)                 { return _mm256_set1_epi32(x); }
+	static inline I ILoad(const void* p)        { return _mm256_loadu_si256((const __m256i*)p); }
+	static inline void IStore(void* p, I x)     { _mm256_storeu_si256((__m256i*)p, x); }
+	static inline I IAdd(I a, I b)              { return _mm256_add_epi32(a, b); }
+	static inline I ISub(I a, I b)              { return _mm256_sub_epi32(a, b); }
+	static inline I IMul(I a, I b)              { return _mm256_madd_epi16(a, b); }
+	static inline I IShr8(I a)                  { return _mm256_srai_epi32(a, 8); }
+	static inline I IGreater(I a, I b)          { return _mm256_cmpgt_epi32(a, b); }
+	static inline I IEqual(I a, I b)            { return _mm256_cmpeq_epi32(a, b); }
+	static inline I ISelect(I m, I a, I b)      { return _mm256_blendv_epi8(b, a, m); }
+	static inline I IMin(I a, I b)              { return _mm256_min_epi32(a, b); }
+	static inline I IMax(I a, I b)              { return _mm256_max_epi32(a, b); }
+	static inline I IAddSat8(I a, I b)          { return _mm256_adds_epu8(a, b); }
+	static inline I ISubSat8(I a, I b)          { return _mm256_subs_epu8(a, b); }
+	static inline int IBits(I m)                { return _mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+
+	static inline void Unpack(I p, I c[4])
+	{
+		const __m256i mask = _mm256_set1_epi32(0xFF);
+		c[0] = _mm256_and_si256(p, mask);
+		c[1] = _mm256_and_si256(_mm256_srli_epi32(p, 8), mask);
+		c[2] = _mm256_and_si256(_mm256_srli_epi32(p, 16), mask);
+		c[3] = _mm256_srli_epi32(p, 24);
+	}
+	static inline I Pack(const I c[4])
+	{
+		return _mm256_or_si256(_mm256_or_si256(c[0], _mm256_slli_epi32(c[1], 8)),
+			_mm256_or_si256(_mm256_slli_epi32(c[2], 16), _mm256_slli_epi32(c[3], 24)));
+	}
+};
+
+#endif // GX_CANVAS_AVX2
+
+// IMul multiplies the low 16 bits of each lane; a must fit in a short and b must be in [0, 32767].
+// The integer arithmetic matches the scalar blend functions exactly, including the rounding.
+template <int Mode, class L>
+static inline typename L::I BlendLanes(typename L::I d, typename L::I s, typename L::I sa)
+{
+	typedef typename L::I I;
+	const I zero = L::ISet(0), c255 = L::ISet(255);
+	const I w = L::IMax(sa, zero);
+
+	I dc[4], sc[4], out[4];
+	L::Unpack(d, dc);
+	L::Unpack(s, sc);
+
+	I full = s;
+	if(Mode == GxCanvas::BM_NONE)
+	{
+		for(int c=0; c<4; ++c)
+			out[c] = L::IAdd(dc[c], L::IShr8(L::IMul(L::ISub(sc[c], dc[c]), w)));
+	}
+	else
+	{
+		const I a = L::IAdd(L::ISet(1), L::IShr8(L::IMul(sc[3], L::IAdd(w, L::ISet(1)))));
+		for(int c=0; c<3; ++c)
+		{
+			if(Mode == GxCanvas::BM_ALPHA)
+				out[c] = L::IAdd(dc[c], L::IShr8(L::IMul(L::ISub(sc[c], dc[c]), a)));
+			else if(Mode == GxCanvas::BM_ADD)
+				out[c] = L::IMin(c255, L::IAdd(dc[c], L::IShr8(L::IMul(sc[c], a))));
+			else if(Mode == GxCanvas::BM_SUB)
+				out[c] = L::IMax(zero, L::ISub(dc[c], L::IShr8(L::IMul(sc[c], a))));
+			else
+			{
+				const I f = L::IAdd(L::ISet(256), L::IShr8(L::IMul(L::ISub(sc[c], c255), a)));
+				out[c] = L::IShr8(L::IMul(dc[c], f));
+			}
+		}
+		out[3] = L::ISub(L::IAdd(a, L::IShr8(L::IMul(dc[3], L::ISub(L::ISet(257), a)))), L::ISet(1));
+
+		if(Mode == GxCanvas::BM_ADD) full = L::IAddSat8(d, s);
+		if(Mode == GxCanvas::BM_SUB) full = L::ISubSat8(d, s);
+	}
+
+	const I part = L::Pack(out);
+	const I some = L::IGreater(sa, zero);
+	if(Mode == GxCanvas::BM_MUL)
+		return L::ISelect(some, part, L::ISelect(L::IEqual(sa, zero), zero, d));
+
+	return L::ISelect(L::IGreater(sa, L::ISet(254)), full, L::ISelect(some, part, d));
+}
+
+// Evaluates a distance function for a span of pixels, vectorized if the function supports it.
+template <class T>
+static void DistSpan(const T& func, float px, float py, float* out, int n)
+{
+	int i = 0;
+#if defined(GX_CANVAS_AVX2)
+	for(const __m256 y8 = LanesAVX2::Set(py); i + 8 <= n; i += 8)
+		LanesAVX2::Store(out + i, func.template GetLanes<LanesAVX2>(LanesAVX2::Ramp(px + (float)i), y8));
+#endif
+#if defined(GX_CANVAS_SSE2)
+	for(const __m128 y4 = LanesSSE2::Set(py); i + 4 <= n; i += 4)
+		LanesSSE2::Store(out + i, func.template GetLanes<LanesSSE2>(LanesSSE2::Ramp(px + (float)i), y4));
+#endif
+	for(; i < n; ++i)
+		out[i] = func.Get(px + (float)i, py);
+}
+
 // ===================================================================================
 // Distance functions
 // ===================================================================================
@@ -145,6 +366,32 @@ struct GetLineDist : public GxCanvas::DistFunc
 		float d2sq = (px-bx)*(px-bx) + (py-by)*(py-by);
 		return sqrt(d1sq < d2sq ? d1sq : d2sq) - size;
 	}
+
+	template <class L>
+	typename L::F GetLanes(typename L::F px, typename L::F py) const
+	{
+		typedef typename L::F F;
+		const float den = (bx-ax)*(bx-ax) + (by-ay)*(by-ay);
+		const F vax = L::Set(ax), vay = L::Set(ay), vbx = L::Set(bx), vby = L::Set(by);
+		const F dx = L::Set(bx-ax), dy = L::Set(by-ay), rden = L::Set(1.f / den), vsize = L::Set(size);
+
+		F num = L::Add(L::Mul(L::Sub(px, vax), dx), L::Mul(L::Sub(py, vay), dy));
+		F r   = L::Mul(num, rden);
+		F s   = L::Mul(L::Sub(L::Mul(L::Sub(vay, py), dx), L::Mul(L::Sub(vax, px), dy)), rden);
+		F onSegment = L::And(L::LessEqual(L::Set(0.f), r), L::LessEqual(r, L::Set(1.f)));
+		F lineDist = L::Sub(L::Abs(L::Mul(s, L::Set(sqrt(den)))), vsize);
+
+		F d1sq = L::Add(L::Mul(L::Sub(px, vax), L::Sub(px, vax)), L::Mul(L::Sub(py, vay), L::Sub(py, vay)));
+		F d2sq = L::Add(L::Mul(L::Sub(px, vbx), L::Sub(px, vbx)), L::Mul(L::Sub(py, vby), L::Sub(py, vby)));
+		F endDist = L::Sub(L::Sqrt(L::Min(d1sq, d2sq)), vsize);
+
+		return L::Select(onSegment, lineDist, endDist);
+	}
+
+	void GetSpan(float px, float py, float* out, int n) const
+	{
+		DistSpan(*this, px, py, out, n);
+	}
 };
 
 // Returns the distance from a point to a circle.
@@ -160,6 +407,19 @@ struct GetCircleDist : public GxCanvas::DistFunc
 		float dx = px-x, dy = py-y;
 		return sqrt(dx*dx + dy*dy) - r;
 	}
+
+	template <class L>
+	typename L::F GetLanes(typename L::F px, typename L::F py) const
+	{
+		typedef typename L::F F;
+		F dx = L::Sub(px, L::Set(x)), dy = L::Sub(py, L::Set(y));
+		return L::Sub(L::Sqrt(L::Add(L::Mul(dx, dx), L::Mul(dy, dy))), L::Set(r));
+	}
+
+	void GetSpan(float px, float py, float* out, int n) const
+	{
+		DistSpan(*this, px, py, out, n);
+	}
 };
 
 // Returns the distance from a point to a rectangle.
@@ -187,6 +447,28 @@ struct GetRectDist : public GxCanvas::DistFunc
 			return GxMax(dx, dy);
 		}
 	}
+
+	template <class L>
+	typename L::F GetLanes(typename L::F px, typename L::F py) const
+	{
+		typedef typename L::F F;
+		const F vx1 = L::Set(x1), vy1 = L::Set(y1), vx2 = L::Set(x2), vy2 = L::Set(y2);
+		F x = L::Min(L::Max(px, vx1), vx2);
+		F y = L::Min(L::Max(py, vy1), vy2);
+		F inside = L::And(L::Equal(x, px), L::Equal(y, py));
+
+		F dx = L::Min(L::Sub(x, vx1), L::Sub(vx2, x));
+		F dy = L::Min(L::Sub(y, vy1), L::Sub(vy2, y));
+		F insideDist = L::Neg(L::Min(dx, dy));
+		F outsideDist = L::Max(L::Abs(L::Sub(px, x)), L::Abs(L::Sub(py, y)));
+
+		return L::Select(inside, insideDist, outsideDist);
+	}
+
+	void GetSpan(float px, float py, float* out, int n) const
+	{
+		DistSpan(*this, px, py, out, n);
+	}
 };
 
 // Returns the distance from a point to a rectangle with rounded corners.
@@ -214,6 +496,31 @@ struct GetRoundRectDist : public GxCanvas::DistFunc
 			return sqrt(dx*dx + dy*dy) - r;
 		}
 	}
+
+	template <class L>
+	typename L::F GetLanes(typename L::F px, typename L::F py) const
+	{
+		typedef typename L::F F;
+		const F vx1 = L::Set(x1), vy1 = L::Set(y1), vx2 = L::Set(x2), vy2 = L::Set(y2);
+		F x = L::Min(L::Max(px, L::Set(x1+r)), L::Set(x2-r));
+		F y = L::Min(L::Max(py, L::Set(y1+r)), L::Set(y2-r));
+		F inside = L::And(L::Equal(x, px), L::Equal(y, py));
+
+		F dx = L::Min(L::Sub(x, vx1), L::Sub(vx2, x));
+		F dy = L::Min(L::Sub(y, vy1), L::Sub(vy2, y));
+		F insideDist = L::Neg(L::Min(dx, dy));
+
+		dx = L::Sub(px, x);
+		dy = L::Sub(py, y);
+		F outsideDist = L::Sub(L::Sqrt(L::Add(L::Mul(dx, dx), L::Mul(dy, dy))), L::Set(r));
+
+		return L::Select(inside, insideDist, outsideDist);
+	}
+
+	void GetSpan(float px, float py, float* out, int n) const
+	{
+		DistSpan(*this, px, py, out, n);
+	}
 };
 
 // Returns the distance from a point to a polygon.
@@ -247,6 +554,234 @@ struct GetPolyDist : public GxCanvas::DistFunc
 	}
 };
 
+// ===================================================================================
+// Tiled drawing
+// ===================================================================================
+// Drawing operations are split into tiles, which can be drawn in parallel. Each row of a
+// tile is processed as a span: first the distances, then the alpha values, then the colors,
+// and finally the span is blended onto the bitmap.
+
+struct DrawOp
+{
+	const GxCanvas::DistFunc* func;
+	uint* bitmap;
+	int width;
+	int x1, y1, x2, y2;
+	int tilesX;
+	int rH;
+	const int* weights; // Horizontal gradient weight of each column.
+	GxColor ctl, ctr, cbl, cbr;
+	float outerLimit, rog, rig, lineW, innerGlow;
+	bool fill, canFillSolid, canSkipInside;
+	int mode;
+};
+
+static inline uint ToPixel(const GxColor& c)
+{
+	uint p;
+	memcpy(&p, c.channels, 4);
+	return p;
+}
+
+// Converts a distance to the blend alpha, or -1 for pixels outside of the shape and its glow.
+static inline int GetAlpha(const DrawOp& op, float dist)
+{
+	if(!(dist < op.outerLimit)) return -1;
+
+	float t;
+	if(op.fill || !(dist < -0.5f))
+		t = op.rog * (dist + 0.5f);
+	else
+		t = op.rig * ((-dist - op.lineW) + 0.5f);
+
+	return GxClamp(255 - (int)GxClamp(t, -1.f, 256.f), 0, 255);
+}
+
+template <class L>
+static inline typename L::I GetAlphaLanes(const DrawOp& op, typename L::F dist)
+{
+	typedef typename L::F F;
+	typedef typename L::I I;
+
+	F t = L::Mul(L::Set(op.rog), L::Add(dist, L::Set(0.5f)));
+	if(!op.fill)
+	{
+		F inner = L::Mul(L::Set(op.rig), L::Add(L::Sub(L::Neg(dist), L::Set(op.lineW)), L::Set(0.5f)));
+		t = L::Select(L::Less(dist, L::Set(-0.5f)), inner, t);
+	}
+	t = L::Min(L::Max(t, L::Set(-1.f)), L::Set(256.f));
+
+	I alpha = L::IMin(L::IMax(L::ISub(L::ISet(255), L::Truncate(t)), L::ISet(0)), L::ISet(255));
+	return L::ISelect(L::Mask(L::Less(dist, L::Set(op.outerLimit))), alpha, L::ISet(-1));
+}
+
+// Returns false if none of the pixels in the span are affected.
+static bool AlphaSpan(const DrawOp& op, const float* dist, int* alpha, int n)
+{
+	int i = 0, visible = 0;
+#if defined(GX_CANVAS_AVX2)
+	for(; i + 8 <= n; i += 8)
+	{
+		const __m256i a = GetAlphaLanes<LanesAVX2>(op, LanesAVX2::Load(dist + i));
+		visible |= LanesAVX2::IBits(LanesAVX2::IGreater(a, LanesAVX2::ISet(-1)));
+		LanesAVX2::IStore(alpha + i, a);
+	}
+#endif
+#if defined(GX_CANVAS_SSE2)
+	for(; i + 4 <= n; i += 4)
+	{
+		const __m128i a = GetAlphaLanes<LanesSSE2>(op, LanesSSE2::Load(dist + i));
+		visible |= LanesSSE2::IBits(LanesSSE2::IGreater(a, LanesSSE2::ISet(-1)));
+		LanesSSE2::IStore(alpha + i, a);
+	}
+#endif
+	for(; i < n; ++i)
+	{
+		alpha[i] = GetAlpha(op, dist[i]);
+		visible |= (alpha[i] >= 0);
+	}
+	return visible != 0;
+}
+
+// Interpolates the gradient colors for a span of pixels on row y, starting at column x.
+static void ColorSpan(const DrawOp& op, int x, int y, uint* out, int n)
+{
+	const int wy = ((y - op.y1) * op.rH) >> 8;
+	GxColor cl = op.ctl, cr = op.ctr;
+	BlendAlpha(cl.channels, op.cbl.channels, wy);
+	BlendAlpha(cr.channels, op.cbr.channels, wy);
+
+	// Interpolating between equal colors only changes the alpha of translucent colors.
+	const uint pl = ToPixel(cl), pr = ToPixel(cr);
+	if(pl == pr && (cl.a == 0 || cl.a == 255))
+	{
+		for(int i=0; i<n; ++i) out[i] = pl;
+		return;
+	}
+
+	const int* weights = op.weights + (x - op.x1);
+	int i = 0;
+#if defined(GX_CANVAS_AVX2)
+	for(; i + 8 <= n; i += 8)
+	{
+		const __m256i w = LanesAVX2::ILoad(weights + i);
+		LanesAVX2::IStore(out + i, BlendLanes<GxCanvas::BM_ALPHA, LanesAVX2>(LanesAVX2::ISet((int)pl), LanesAVX2::ISet((int)pr), w));
+	}
+#endif
+#if defined(GX_CANVAS_SSE2)
+	for(; i + 4 <= n; i += 4)
+	{
+		const __m128i w = LanesSSE2::ILoad(weights + i);
+		LanesSSE2::IStore(out + i, BlendLanes<GxCanvas::BM_ALPHA, LanesSSE2>(LanesSSE2::ISet((int)pl), LanesSSE2::ISet((int)pr), w));
+	}
+#endif
+	for(; i < n; ++i)
+	{
+		GxColor col = cl;
+		BlendAlpha(col.channels, cr.channels, weights[i]);
+		out[i] = ToPixel(col);
+	}
+}
+
+template <int Mode>
+static inline void BlendPixel(uchar* d, const uchar* s, int sa)
+{
+	switch(Mode)
+	{
+		case GxCanvas::BM_NONE:  BlendNone(d, s, sa);  break;
+		case GxCanvas::BM_ALPHA: BlendAlpha(d, s, sa); break;
+		case GxCanvas::BM_ADD:   BlendAdd(d, s, sa);   break;
+		case GxCanvas::BM_SUB:   BlendSub(d, s, sa);   break;
+		case GxCanvas::BM_MUL:   BlendMul(d, s, sa);   break;
+	};
+}
+
+template <int Mode, class L>
+static inline void BlendGroup(uint* dst, const uint* src, const int* alpha)
+{
+	typedef typename L::I I;
+
+	const I sa = L::ILoad(alpha);
+	if(L::IBits(L::IGreater(sa, L::ISet(Mode == GxCanvas::BM_MUL ? -1 : 0))) == 0) return;
+
+	const I s = L::ILoad(src);
+	if((Mode == GxCanvas::BM_NONE || Mode == GxCanvas::BM_ALPHA) && L::IBits(L::IGreater(sa, L::ISet(254))) == L::ALL)
+		L::IStore(dst, s);
+	else
+		L::IStore(dst, BlendLanes<Mode, L>(L::ILoad(dst), s, sa));
+}
+
+// Blends a span of colors onto the bitmap; pixels with an alpha of -1 are left untouched.
+template <int Mode>
+static void BlendSpan(uint* dst, const uint* src, const int* alpha, int n)
+{
+	int i = 0;
+#if defined(GX_CANVAS_AVX2)
+	for(; i + 8 <= n; i += 8)
+		BlendGroup<Mode, LanesAVX2>(dst + i, src + i, alpha + i);
+#endif
+#if defined(GX_CANVAS_SSE2)
+	for(; i + 4 <= n; i += 4)
+		BlendGroup<Mode, LanesSSE2>(dst + i, src + i, alpha + i);
+#endif
+	for(; i < n; ++i)
+		if(alpha[i] >= 0)
+			BlendPixel<Mode>((uchar*)(dst + i), (const uchar*)(src + i), alpha[i]);
+}
+
+template <int Mode>
+static void DrawTile(const DrawOp& op, int tile)
+{
+	const int tx = op.x1 + (tile % op.tilesX) * TILE_SIZE;
+	const int ty = op.y1 + (tile / op.tilesX) * TILE_SIZE;
+	const int tw = GxMin((int)TILE_SIZE, op.x2 - tx);
+	const int th = GxMin((int)TILE_SIZE, op.y2 - ty);
+
+	// The distance changes by at most one per pixel, so the distance at the center of the tile
+	// tells whether the tile is entirely outside or inside the shape. One pixel is added to the
+	// radius to account for rounding errors.
+	const float radius = 0.5f * sqrt((float)(tw*tw + th*th)) + 1.f;
+	const float center = op.func->Get((float)tx + 0.5f * (float)tw, (float)ty + 0.5f * (float)th);
+	if(center - radius >= op.outerLimit)
+		return;
+
+	const float inside = -(center + radius);
+	if(op.canSkipInside && inside > 0.5f && inside - op.lineW + 0.5f >= op.innerGlow + 2.f)
+		return;
+
+	const bool solid = op.canFillSolid && inside > 0.5f;
+
+	float dist[TILE_SIZE];
+	int alpha[TILE_SIZE];
+	uint color[TILE_SIZE];
+	if(solid)
+		for(int i=0; i<tw; ++i) alpha[i] = 255;
+
+	for(int y=ty; y<ty + th; ++y)
+	{
+		if(!solid)
+		{
+			op.func->GetSpan((float)tx + 0.5f, (float)y + 0.5f, dist, tw);
+			if(!AlphaSpan(op, dist, alpha, tw)) continue;
+		}
+		ColorSpan(op, tx, y, color, tw);
+		BlendSpan<Mode>(op.bitmap + y * op.width + tx, color, alpha, tw);
+	}
+}
+
+static void DrawTileTask(void* data, int tile)
+{
+	const DrawOp& op = *(const DrawOp*)data;
+	switch(op.mode)
+	{
+		case GxCanvas::BM_NONE:  DrawTile<GxCanvas::BM_NONE>(op, tile);  break;
+		case GxCanvas::BM_ALPHA: DrawTile<GxCanvas::BM_ALPHA>(op, tile); break;
+		case GxCanvas::BM_ADD:   DrawTile<GxCanvas::BM_ADD>(op, tile);   break;
+		case GxCanvas::BM_SUB:   DrawTile<GxCanvas::BM_SUB>(op, tile);   break;
+		case GxCanvas::BM_MUL:   DrawTile<GxCanvas::BM_MUL>(op, tile);   break;
+	};
+}
+
 }; // anonymous namespace
 
 // ===================================================================================
@@ -406,73 +941,53 @@ uchar* GxCanvas::GetBitmap()
 
 void GxCanvas::myDrawOp(const GxAreaf& area, DistFunc* func)
 {
-	BlendFunc blendfunc = BlendAlpha;
-	switch(myBlendMode)
-	{
-		case BM_NONE:  blendfunc = BlendNone;  break;
-		case BM_ALPHA: blendfunc = BlendAlpha; break;
-		case BM_ADD:   blendfunc = BlendAdd;   break;
-		case BM_SUB:   blendfunc = BlendSub;   break;
-		case BM_MUL:   blendfunc = BlendMul;   break;
-	};
-
-	float rig = 255.f / (myInnerGlow + 1.f);
-	float rog = 255.f / (myOuterGlow + 1.f);
-
 	const int x1 = GxMax(0,   (int)(area.l - myOuterGlow - 1 + 0.5f));
 	const int y1 = GxMax(0,   (int)(area.t - myOuterGlow - 1 + 0.5f));
 	const int x2 = GxMin(myW, (int)(area.r + myOuterGlow + 1 + 0.5f));
 	const int y2 = GxMin(myH, (int)(area.b + myOuterGlow + 1 + 0.5f));
-
-	float oy = 0.5f + (float)y1;
-	float ox = 0.5f + (float)x1;
-
-	const int rH = 0xFFFF / GxMax(1, y2 - y1);
-	const int rW = 0xFFFF / GxMax(1, x2 - x1);
-	
-	float yf = oy;
-	for(int y=0; y<y2 - y1; ++y)
+	if(x1 >= x2 || y1 >= y2) return;
+
+	DrawOp op;
+	op.func = func;
+	op.bitmap = reinterpret_cast<uint*>(myBitmap);
+	op.width = myW;
+	op.x1 = x1, op.y1 = y1;
+	op.x2 = x2, op.y2 = y2;
+	op.tilesX = (x2 - x1 + TILE_SIZE - 1) / TILE_SIZE;
+	op.rH = 0xFFFF / GxMax(1, y2 - y1);
+	op.ctl = myCTL, op.ctr = myCTR;
+	op.cbl = myCBL, op.cbr = myCBR;
+	op.outerLimit = myOuterGlow + 1;
+	op.rog = 255.f / (myOuterGlow + 1.f);
+	op.rig = 255.f / (myInnerGlow + 1.f);
+	op.lineW = myLineW;
+	op.innerGlow = myInnerGlow;
+	op.fill = myHasFill;
+	op.mode = (myBlendMode >= BM_NONE && myBlendMode <= BM_MUL) ? myBlendMode : BM_ALPHA;
+
+	// Tiles inside the shape can be filled without evaluating distances, or skipped entirely
+	// inside of an outline, unless multiplicative blending clears the pixels that are skipped.
+	op.canFillSolid = myHasFill && op.rog > 0;
+	op.canSkipInside = !myHasFill && op.rig > 0 && op.mode != BM_MUL;
+
+	const int w = x2 - x1;
+	const int rW = 0xFFFF / w;
+	int* weights = GxMalloc<int>(w);
+	for(int x=0; x<w; ++x) weights[x] = (x * rW) >> 8;
+	op.weights = weights;
+
+	const int tiles = op.tilesX * ((y2 - y1 + TILE_SIZE - 1) / TILE_SIZE);
+	if(GxWorkerPool::singleton && w * (y2 - y1) >= PARALLEL_MIN_AREA)
 	{
-		uchar* dst = myBitmap + ((y1 + y)*myW + x1) * 4;
-
-		GxColor cl = myCTL, cr = myCTR;
-		BlendAlpha(cl.channels, myCBL.channels, (y * rH) >> 8);
-		BlendAlpha(cr.channels, myCBR.channels, (y * rH) >> 8);
-
-		float xf = ox;
-		for(int x=0; x<x2 - x1; ++x)
-		{
-			GxColor col = cl;
-			BlendAlpha(col.channels, cr.channels, (x * rW) >> 8);
-
-			float dist = func->Get(xf, yf);
-			if(dist < myOuterGlow + 1)
-			{
-				if(myHasFill)
-				{
-					const int alpha = 255 - (int)(rog * (dist + 0.5f));
-					blendfunc(dst, col.channels, alpha);
-				}
-				else
-				{
-					if(dist < -0.5f)
-					{
-						float absdist = -dist - myLineW;
-						const int alpha = 255 - (int)(rig * (absdist + 0.5f));
-						blendfunc(dst, col.channels, alpha);
-					}
-					else
-					{
-						const int alpha = 255 - (int)(rog * (dist + 0.5f));
-						blendfunc(dst, col.channels, alpha);
-					}
-				}
-			}
-			xf += 1.f;
-			dst += 4;
-		}
-		yf += 1.f;
+		GxWorkerPool::singleton->Run(DrawTileTask, &op, tiles);
 	}
+	else
+	{
+		for(int i=0; i<tiles; ++i)
+			DrawTileTask(&op, i);
+	}
+
+	GxFree(weights);
 }
 
 }; // namespace graphics
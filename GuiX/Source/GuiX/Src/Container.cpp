@@ -80,6 +80,7 @@ void GxTab::Add(GxWidget* widget)
 void GxTab::SetText(const GxString& text)
 {
 	myText = text;
+	myOwner->Invalidate();
 }
 
 void GxTab::Select()
@@ -128,6 +129,7 @@ void GxTabContainer::ClearTabs()
 
 	myTabs.Clear();
 	mySelectedTab = NULL;
+	Invalidate();
 }
 
 GxTab* GxTabContainer::AddTab()
@@ -138,6 +140,7 @@ GxTab* GxTabContainer::AddTab()
 	if(!mySelectedTab)
 		mySelectedTab = tab;
 
+	Invalidate();
 	return tab;
 }
 
@@ -153,12 +156,17 @@ void GxTabContainer::RemoveTab(int index)
 
 	if(mySelectedTab == NULL && !myTabs.Empty())
 		mySelectedTab = myTabs[0];
+
+	Invalidate();
 }
 
 void GxTabContainer::SelectTab(int index)
 {
-	if(index >= 0 && index < myTabs.Size())
+	if(index >= 0 && index < myTabs.Size() && mySelectedTab != myTabs[index])
+	{
 		mySelectedTab = myTabs[index];
+		Invalidate();
+	}
 }
 
 void GxTabContainer::RemoveTab(GxTab* tab)
@@ -9,6 +9,11 @@
 #include <GuiX/Context.h>
 
 #include <Src/ContextImp.h>
+#include <Src/DrawImp.h>
+#include <Src/GlyphAtlas.h>
+#include <Src/GuiUtils.h>
+#include <Src/StyleImp.h>
+#include <Src/TextureImp.h>
 
 namespace guix {
 namespace gui {
@@ -17,11 +22,14 @@ namespace {
 
 static const char* LOG_TAG = "Gui";
 
+// Shared by all contexts, so a widget that moves to another context never sees a generation it has seen before.
+static int layoutGeneration = 0;
+
 }; // anonymous namespace
 
 #define GX_LAYER_ITER(func) \
 	for(LayerVec::reverse_iterator it = myLayers.rbegin(); it != myLayers.rend(); ++it) \
-		it->root->GetContextNode()->##func;
+		it->root->GetContextNode()->func;
 
 class DefaultCallback : public GxCallback
 {
@@ -72,6 +80,14 @@ GxContextImp::GxContextImp()
 	,myInputWidget(NULL)
 	,myToolTipTimer(0)
 	,myToolTipDelay(0.5f)
+	,myToolTipWidget(NULL)
+	,myToolTipSize(0, 0)
+	,myToolTipPos(0, 0)
+	,myToolTipViewW(0)
+	,myToolTipStyle(0)
+	,myRelayoutCount(0)
+	,myLayoutGeneration(++layoutGeneration)
+	,myLoadGeneration(0)
 	,myCursor(GX_CI_ARROW)
 	,myInputEnabled(true)
 {
@@ -79,7 +95,10 @@ GxContextImp::GxContextImp()
 	if(input) input->AddListener(this);
 
 	for(int i=0; i<3; ++i)
+	{
 		myHlWidgets[i] = NULL;
+		myHlValues[i] = 0.f;
+	}
 
 	SetRoot(new GxFrame);
 }
@@ -106,8 +125,9 @@ void GxContextImp::SetRoot(GxWidget* root)
 {
 	myDestroyLayers();
 
-	Layer layer = {root, GxRecti(), 0.f};
+	Layer layer = {root, GxRecti(), GxRecti(), 0.f};
 	root->GetContextNode()->SetContext(this);
+	root->Invalidate();
 	myLayers.push_back(layer);
 }
 
@@ -141,10 +161,11 @@ void GxContextImp::Tick(float dt)
 
 	// Update the tooltip timer.
 	GxVec2i mpos = GxInput::Get()->GetMousePos();
-	if(mpos == myLastMousePos)
-		myToolTipTimer += dt;
-	else
+	const bool mouseMoved = !(mpos == myLastMousePos);
+	if(mouseMoved)
 		myToolTipTimer = 0.f;
+	else
+		myToolTipTimer += dt;
 	myLastMousePos = mpos;
 
 	// Push and pop layers that have been removed/added.
@@ -154,8 +175,9 @@ void GxContextImp::Tick(float dt)
 		if(act.root)
 		{
 			// Push a new layer.
-			Layer layer = {act.root, act.region, 0.f};
+			Layer layer = {act.root, act.region, GxRecti(), 0.f};
 			act.root->GetContextNode()->SetContext(this);
+			act.root->Invalidate();
 			myLayers.push_back(layer);
 		}
 		else
@@ -167,17 +189,47 @@ void GxContextImp::Tick(float dt)
 	}
 	myLayerActions.clear();
 
+	// Upload the textures that finished loading, and update the widgets that depend on their size.
+	GxTextureDatabaseImp* textures = GxTextureDatabaseImp::singleton;
+	if(textures)
+	{
+		textures->ApplyLoads(false);
+		if(myLoadGeneration != textures->GetLoadGeneration())
+		{
+			myLoadGeneration = textures->GetLoadGeneration();
+			for(size_t i=0; i<myLayers.size(); ++i)
+				myLayers[i].root->GetContextNode()->InvalidateAll();
+		}
+	}
+
+	// The input widget can change its appearance without receiving input events, e.g. when the caret blinks.
+	if(myInputWidget)
+		myInputWidget->InvalidateGeometry();
+
 	// Update all widget layers. 
+	myRelayoutCount = 0;
 	for(size_t i=0; i<myLayers.size(); ++i)
 	{
-		GxWidget* w = myLayers[i].root;
+		Layer& layer = myLayers[i];
+		GxWidget* w = layer.root;
+		GxRecti r = layer.region;
+		if(r.w <= 0 || r.h <= 0) r = myView;
+
+		// Only update the layout of a layer if it was invalidated or if the layer rectangle changed.
+		// Within the layer, only the widgets that were invalidated or moved are updated, and widgets
+		// that are invalidated during the update are updated again on the next tick.
+		GxContextNode* node = w->GetContextNode();
+		if(node->dirty || !SameRect(r, layer.rect))
+		{
+			myLayoutGeneration = ++layoutGeneration;
 
-		// Adjust the layout of widgets.
-		w->Adjust();
+			// Adjust the layout of widgets.
+			w->UpdateAdjust();
 
-		// Update the rectangles of widgets.
-		GxRecti r = myLayers[i].region;
-		w->SetRect((r.w > 0 && r.h > 0) ? r : myView);
+			// Update the rectangles of widgets.
+			w->UpdateRect(r);
+			layer.rect = r;
+		}
 
 		// Update the layer alpha.
 		float& fade = myLayers[i].fade;
@@ -195,6 +247,13 @@ void GxContextImp::Tick(float dt)
 		GxWidget* root = myLayers.back().root;
 		hover = root->FindHoverWidget(m.x, m.y);
 	}
+	// Widgets look different while they are hovered. Widgets that highlight the item under the
+	// mouse invalidate their own geometry when that item changes.
+	if(hover != myHoverWidget)
+	{
+		if(myHoverWidget) myHoverWidget->InvalidateGeometry();
+		if(hover) hover->InvalidateGeometry();
+	}
 	myHoverWidget = hover;
 
 	// Update widghet highlight values.
@@ -224,7 +283,7 @@ void GxContextImp::Draw()
 	// Draw all widgets
 	for(size_t i=0; i<myLayers.size(); ++i)
 	{
-		myLayers[i].root->Draw();
+		myLayers[i].root->DrawCached();
 		if(myLayers[i].fade > 0.01f)
 		{
 			GxRecti r(myView);
@@ -238,42 +297,63 @@ void GxContextImp::Draw()
 
 	// Flush any left over drawing operations
 	GxDraw::Get()->Flush();
+
+	// Pages of the glyph atlas that were changed during this frame can be regenerated again.
+	if(GxGlyphAtlas::singleton) GxGlyphAtlas::singleton->EndFrame();
 }
 
 void GxContextImp::OnKeyPress(GxKeyEvent& evt)
 {
 	if(myInputEnabled)
+	{
 		GX_LAYER_ITER(OnKeyPress(evt));
+		myInvalidateInputWidgets();
+	}
 }
 
 void GxContextImp::OnKeyRelease(GxKeyEvent& evt)
 {
 	if(myInputEnabled)
+	{
 		GX_LAYER_ITER(OnKeyRelease(evt));
+		myInvalidateInputWidgets();
+	}
 }
 
 void GxContextImp::OnMousePress(GxMouseEvent& evt)
 {
 	if(myInputEnabled)
+	{
 		GX_LAYER_ITER(OnMousePress(evt));
+		myInvalidateInputWidgets();
+	}
 }
 
 void GxContextImp::OnMouseRelease(GxMouseEvent& evt)
 {
 	if(myInputEnabled)
+	{
 		GX_LAYER_ITER(OnMouseRelease(evt));
+		myInvalidateInputWidgets();
+	}
 }
 
 void GxContextImp::OnMouseScroll(GxScrollEvent& evt)
 {
 	if(myInputEnabled)
+	{
 		GX_LAYER_ITER(OnMouseScroll(evt));
+		myInvalidateInputWidgets();
+	}
 }
 
 void GxContextImp::OnTextInput(GxTextEvent& evt)
 {
 	if(myInputEnabled && myInputWidget)
+	{
 		myInputWidget->OnTextInput(evt);
+		myInputWidget->InvalidateGeometry();
+	}
 }
 
 void GxContextImp::OnWindowInactive()
@@ -306,6 +386,16 @@ float GxContextImp::GetWidgetHighlight(const GxWidget* w)
 	return 0.f;
 }
 
+int GxContextImp::GetRelayoutCount()
+{
+	return myRelayoutCount;
+}
+
+int GxContextImp::GetLayoutGeneration()
+{
+	return myLayoutGeneration;
+}
+
 GxRecti GxContextImp::GetView()
 {
 	return myView;
@@ -371,6 +461,9 @@ void GxContextImp::Remove(GxWidget* w)
 	if(myHoverWidget == w) myHoverWidget = NULL;
 	if(myFocusWidget == w) myFocusWidget = NULL;
 	if(myInputWidget == w) myInputWidget = NULL;
+	if(myToolTipWidget == w) myToolTipWidget = NULL;
+	for(int i=0; i<3; ++i)
+		if(myHlWidgets[i] == w) myHlWidgets[i] = NULL;
 }
 
 void GxContextImp::GrabFocus(GxWidget* widget)
@@ -380,6 +473,8 @@ void GxContextImp::GrabFocus(GxWidget* widget)
 		if(myFocusWidget)
 			myFocusWidget->OnLoseFocus();
 
+		myInvalidateGeometry(myFocusWidget);
+		myInvalidateGeometry(widget);
 		myFocusWidget = widget;
 	}
 }
@@ -391,6 +486,7 @@ void GxContextImp::ReleaseFocus(GxWidget* widget)
 		if(myFocusWidget)
 			myFocusWidget->OnLoseFocus();
 
+		myInvalidateGeometry(myFocusWidget);
 		myFocusWidget = NULL;
 	}
 }
@@ -402,6 +498,8 @@ void GxContextImp::GrabInput(GxWidget* widget)
 		if(myInputWidget)
 			myInputWidget->OnLoseInput();
 
+		myInvalidateGeometry(myInputWidget);
+		myInvalidateGeometry(widget);
 		myInputWidget = widget;
 	}
 }
@@ -413,6 +511,7 @@ void GxContextImp::ReleaseInput(GxWidget* widget)
 		if(myInputWidget)
 			myInputWidget->OnLoseInput();
 
+		myInvalidateGeometry(myInputWidget);
 		myInputWidget = NULL;
 	}
 }
@@ -426,6 +525,20 @@ void GxContextImp::myDestroyLayers()
 	myLayers.clear();
 }
 
+// Input events are handled by the widgets under the mouse and the widgets with focus or input. Widgets
+// that change their layout in response to an event invalidate it themselves.
+void GxContextImp::myInvalidateInputWidgets()
+{
+	myInvalidateGeometry(myHoverWidget);
+	myInvalidateGeometry(myFocusWidget);
+	myInvalidateGeometry(myInputWidget);
+}
+
+void GxContextImp::myInvalidateGeometry(GxWidget* w)
+{
+	if(w) w->InvalidateGeometry();
+}
+
 void GxContextImp::myUpdateWidgetHighlights(float dt)
 {
 	// Update highlight widgets.
@@ -438,6 +551,7 @@ void GxContextImp::myUpdateWidgetHighlights(float dt)
 		if(w && w != h[0] && w != h[1] && w != h[2])
 		{
 			int j = (v[0] < v[1]) ? ((v[0] < v[2]) ? 0 : 2) : ((v[1] < v[2]) ? 1 : 2);
+			myInvalidateGeometry(myHlWidgets[j]);
 			myHlWidgets[j] = w;
 			myHlValues[j] = 0.5f;
 		}
@@ -446,56 +560,83 @@ void GxContextImp::myUpdateWidgetHighlights(float dt)
 	// Update highlight values.
 	for(int i=0; i<3; ++i)
 	{
+		const float old = v[i];
 		if(h[i] == myFocusWidget)
 			v[i] = 0.5f;
 		else if(h[i] == myHoverWidget)
 			v[i] = GxClamp(v[i] + dt*4, 0.5f, 1.0f);
 		else
 			v[i] = GxMax(0.f, v[i] - dt * 2);
+
+		if(h[i] && v[i] != old)
+			h[i]->InvalidateGeometry();
 	}
 }
 
 void GxContextImp::myDisplayToolTip()
 {
-	GxDraw* draw = GxDraw::Get();
-	GxStyle& style = *GxStyle::Get();
-
 	if(myHoverWidget && myToolTipTimer > myToolTipDelay)
 	{
 		GxString text = myHoverWidget->GetToolTip();
 		if(text.Empty()) return;
 
-		float alpha = GxMin(1.f, (myToolTipTimer - myToolTipDelay) * 4.f);
+		GxVec2i mpos = GxInput::Get()->GetMousePos();
 
-		GxText settings = style.d.text[0];
-		settings.SetAlign(GX_TA_LEFT, GX_TA_TOP);
-		settings.SetColor(settings.top.Alpha(alpha));
-		if(settings.shadow.a > 0)
+		// Strings that share their characters are equal without comparing them.
+		const bool sameText = (text.Raw() == myToolTipText.Raw() || text == myToolTipText);
+		if(myToolTipWidget != myHoverWidget || !sameText || myToolTipViewW != myView.w
+			|| myToolTipStyle != GxStyleImp::generation || myToolTipGeometry.IsOutdated())
 		{
-			uchar a = (uchar)((float)settings.shadow.a * alpha);
-			settings.shadow = settings.shadow.Alpha(a);
+			myToolTipWidget = myHoverWidget;
+			myToolTipText = text;
+			myRecordToolTip(text, mpos);
 		}
-		settings.maxWidth = GxMax(0, GxMin(256, myView.w - 8));
-		settings.flags = GX_TF_JUSTIFIED;
 
-		GxRecti r = settings.GetTextRect(0, 0, text);
+		// Only the position and the fade depend on the frame.
+		float alpha = GxMin(1.f, (myToolTipTimer - myToolTipDelay) * 4.f);
+		GxVec2i pos = myGetToolTipPos(mpos);
+		myToolTipGeometry.Draw(pos.x - myToolTipPos.x, pos.y - myToolTipPos.y, alpha);
+	}
+}
 
-		GxVec2i mpos = GxInput::Get()->GetMousePos();
-		r.x = GxMin(myView.x + mpos.x + 12, myView.x + myView.w - r.w - 8);
-		r.x = GxMax(r.x, 8);
-		r.y = mpos.y + 16;
-	
-		GxRecti br = r; br.Expand(6, 3, 6, 7);
-		GxColor bgPanel = style.c.bgPanel.Alpha(alpha);
-		GxColor bgFrame = style.c.frameOutline.Alpha(alpha);
+GxVec2i GxContextImp::myGetToolTipPos(GxVec2i mpos) const
+{
+	int x = GxMin(myView.x + mpos.x + 12, myView.x + myView.w - myToolTipSize.x - 8);
+	x = GxMax(x, 8);
+	return GxVec2i(x, mpos.y + 16);
+}
 
-		draw->Rect(br.x, br.y, br.w, br.h, bgFrame);
-		br.Shrink(1);
-		draw->Rect(br.x+2, br.y+2, br.w, br.h, GxColor(0.f, 0.f, 0.f, alpha*0.25f));
-		draw->Rect(br.x, br.y, br.w, br.h, bgPanel);
+void GxContextImp::myRecordToolTip(const GxString& text, GxVec2i mpos)
+{
+	GxDraw* draw = GxDraw::Get();
+	GxStyle& style = *GxStyle::Get();
 
-		settings.Draw(r.x, r.y, text);
-	}
+	myToolTipViewW = myView.w;
+	myToolTipStyle = GxStyleImp::generation;
+
+	GxText settings = style.d.text[0];
+	settings.SetAlign(GX_TA_LEFT, GX_TA_TOP);
+	settings.SetColor(settings.top.Alpha(1.f));
+	settings.maxWidth = GxMax(0, GxMin(256, myView.w - 8));
+	settings.flags = GX_TF_JUSTIFIED;
+
+	GxRecti r = settings.GetTextRect(0, 0, text);
+	myToolTipSize.Set(r.w, r.h);
+	myToolTipPos = myGetToolTipPos(mpos);
+	r.x = myToolTipPos.x;
+	r.y = myToolTipPos.y;
+
+	myToolTipGeometry.Begin();
+
+	GxRecti br = r; br.Expand(6, 3, 6, 7);
+	draw->Rect(br.x, br.y, br.w, br.h, style.c.frameOutline.Alpha(1.f));
+	br.Shrink(1);
+	draw->Rect(br.x+2, br.y+2, br.w, br.h, GxColor(0.f, 0.f, 0.f, 0.25f));
+	draw->Rect(br.x, br.y, br.w, br.h, style.c.bgPanel.Alpha(1.f));
+
+	settings.Draw(r.x, r.y, text);
+
+	myToolTipGeometry.End();
 }
 
 // ===================================================================================
@@ -505,12 +646,16 @@ void GxContextImp::myDisplayToolTip()
 GxContextNode::~GxContextNode()
 {
 	if(parent)
+	{
 		parent->GetContextNode()->RemoveChild(this);
+		parent->Invalidate();
+	}
 
 	if(context)
 		context->Remove(owner);
 
 	Clear();
+	delete geometry;
 }
 
 GxContextNode::GxContextNode(GxWidget* _owner)
@@ -520,6 +665,11 @@ GxContextNode::GxContextNode(GxWidget* _owner)
 	,context(NULL)
 	,children(NULL)
 	,childCount(0)
+	,dirty(true)
+	,hitGeneration(0)
+	,geometry(NULL)
+	,geometryStyle(0)
+	,geometryDirty(true)
 {
 }
 
@@ -590,6 +740,40 @@ void GxContextNode::RemoveChild(GxContextNode* child)
 	}
 }
 
+// Invalidates the layout and geometry of the node and all its children.
+void GxContextNode::InvalidateAll()
+{
+	for(int i=0; i<childCount; ++i)
+		children[i]->InvalidateAll();
+
+	dirty = true;
+	geometryDirty = true;
+}
+
+const GxAreai& GxContextNode::GetHitBounds(int layoutGeneration)
+{
+	if(hitGeneration != layoutGeneration)
+	{
+		hitGeneration = layoutGeneration;
+		hitBounds = GxAreai(owner->GetRect());
+		for(int i=0; i<childCount; ++i)
+		{
+			const GxAreai& c = children[i]->GetHitBounds(layoutGeneration);
+			if(c.r <= c.l || c.b <= c.t) continue;
+			if(hitBounds.r <= hitBounds.l || hitBounds.b <= hitBounds.t)
+			{
+				hitBounds = c;
+				continue;
+			}
+			hitBounds.l = GxMin(hitBounds.l, c.l);
+			hitBounds.t = GxMin(hitBounds.t, c.t);
+			hitBounds.r = GxMax(hitBounds.r, c.r);
+			hitBounds.b = GxMax(hitBounds.b, c.b);
+		}
+	}
+	return hitBounds;
+}
+
 void GxContextNode::OnKeyPress(GxKeyEvent& evt)
 {
 	for(int i=childCount-1; i>=0; --i)
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <GuiX/Context.h>
+#include <GuiX/Draw.h>
 
 namespace guix {
 namespace gui {
@@ -53,6 +54,11 @@ public:
 
 	float GetWidgetHighlight(const GxWidget* w);
 
+	int GetRelayoutCount();
+
+	// Incremented whenever the context updates the layout of a layer, after which widget rectangles may have changed.
+	int GetLayoutGeneration();
+
 	GxRecti GetView();
 
 	GxCursorImage GetCursor();
@@ -72,6 +78,8 @@ public:
 	void GrabInput(GxWidget* widget);
 	void ReleaseInput(GxWidget* widget);
 
+	void CountRelayout() {++myRelayoutCount;}
+
 private:
 	struct CallbackEvent
 	{
@@ -82,6 +90,7 @@ private:
 	{
 		GxWidget* root;
 		GxRecti region;
+		GxRecti rect; // The rectangle the root widget was arranged in.
 		float fade;
 	};
 	struct LayerAction
@@ -95,8 +104,12 @@ private:
 	typedef std::vector<Layer> LayerVec;
 
 	void myDestroyLayers();
+	void myInvalidateInputWidgets();
+	void myInvalidateGeometry(GxWidget* w);
 	void myUpdateWidgetHighlights(float dt);
 	void myDisplayToolTip();
+	void myRecordToolTip(const GxString& text, GxVec2i mpos);
+	GxVec2i myGetToolTipPos(GxVec2i mpos) const;
 
 	EventVec myReadEvents;
 	EventVec myWriteEvents;
@@ -112,7 +125,21 @@ private:
 	float myHlValues[3];
 	float myToolTipTimer;
 	float myToolTipDelay;
+
+	// The tooltip is recorded with full alpha, and recorded again when the widget, its tooltip
+	// text, the view width, the style or the glyph atlas changes. Otherwise it is replayed,
+	// moved from the position it was recorded at to the current position.
+	GxDrawList myToolTipGeometry;
+	GxWidget* myToolTipWidget;
+	GxString myToolTipText;
+	GxVec2i myToolTipSize;
+	GxVec2i myToolTipPos;
+	int myToolTipViewW;
+	int myToolTipStyle;
 	GxVec2i myLastMousePos;
+	int myRelayoutCount;
+	int myLayoutGeneration;
+	int myLoadGeneration;
 
 	GxCursorImage myCursor;
 	bool myInputEnabled;
@@ -135,6 +162,11 @@ public:
 	void SetCallback(GxCallback* callback);
 	void SetContext(GxContextImp* context);
 	void RemoveChild(GxContextNode* child);
+	void InvalidateAll();
+
+	// Returns the area covered by the rectangles of the widget and its descendants, which contains every
+	// position at which the widget can find a hover widget. It is computed once per layout generation.
+	const GxAreai& GetHitBounds(int layoutGeneration);
 
 	void OnKeyPress(GxKeyEvent& evt);
 	void OnKeyRelease(GxKeyEvent& evt);
@@ -148,6 +180,20 @@ public:
 	GxContextImp* context;
 	GxContextNode** children;
 	int childCount;
+	bool dirty; // True if the layout of the widget or one of its children has changed.
+
+	GxAtom widgetId;
+	GxAtom groupId;
+	GxString toolTip;
+
+	GxAreai hitBounds;
+	int hitGeneration; // The layout generation at which hitBounds was computed.
+
+	// Cached geometry of the widget and its children, if the widget caches its geometry.
+	GxDrawList::Data* geometry;
+	GxRecti geometryRect; // The widget rectangle at the time the geometry was recorded.
+	int geometryStyle;    // The style generation at the time the geometry was recorded.
+	bool geometryDirty;   // True if the appearance of the widget or one of its children has changed.
 };
 
 }; // namespace gui
@@ -7,6 +7,7 @@
 #include <Src/TextureImp.h>
 #include <Src/LocalizeImp.h>
 #include <Src/ResourcesImp.h>
+#include <Src/WorkerPool.h>
 
 #include <Src/StyleImp.h>
 #include <Src/WidgetDatabase.h>
@@ -31,9 +32,11 @@ void GxCore::Initialize()
 
 	GxLog(LOG_TAG, GX_LT_INFO, "Initializing...");
 
+	GxWorkerPool::Create();
 	GxInputImp::Create();
 	GxResourcesImp::Create();
 	GxTextureDatabaseImp::Create();
+	GxGlyphAtlas::Create();
 	GxFontDatabaseImp::Create();
 	GxLocalizeImp::Create();
 	GxDrawImp::Create();
@@ -57,9 +60,11 @@ void GxCore::Shutdown()
 	GxDrawImp::Destroy();
 	GxLocalizeImp::Destroy();
 	GxFontDatabaseImp::Destroy();
+	GxGlyphAtlas::Destroy();
 	GxTextureDatabaseImp::Destroy();
 	GxResourcesImp::Destroy();
 	GxInputImp::Destroy();
+	GxWorkerPool::Destroy();
 
 	SetRenderInterface();
 	SetFileInterface();
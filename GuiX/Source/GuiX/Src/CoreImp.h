@@ -23,5 +23,9 @@ public:
 	static GxSystemInterface* systemInterface;
 };
 
+// Reads the contents of a file through the file interface into a null-terminated buffer,
+// which has to be released with GxFree. Returns NULL if the file could not be opened.
+char* GxReadFile(const char* path, size_t& outSize);
+
 }; // namespace core
 }; // namespace guix
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include <GuiX/Config.h>
 
+#include <string.h>
 #include <vector>
 
 #include <GuiX/Core.h>
 
 #include <Src/DrawImp.h>
+#include <Src/GlyphAtlas.h>
+#include <Src/TextureImp.h>
 
 namespace guix {
 namespace graphics {
@@ -13,6 +16,36 @@ namespace {
 
 static const char* LOG_TAG = "Draw";
 
+enum DrawProperties
+{
+	// Maximum number of batches a recorded command can move back over in deferred mode.
+	MAX_BATCH_LOOKBACK = 32,
+
+	// Size in pixels of the grid cells that are used to find overlapping geometry.
+	GRID_CELL_SIZE = 32,
+};
+
+// Returns true if the interiors of the areas overlap; areas that only share an edge do not.
+static inline bool Intersects(const GxAreaf& a, const GxAreaf& b)
+{
+	return a.l < b.r && b.l < a.r && a.t < b.b && b.t < a.b;
+}
+
+static inline bool Contains(const GxAreaf& outer, const GxAreaf& inner)
+{
+	return inner.l >= outer.l && inner.r <= outer.r && inner.t >= outer.t && inner.b <= outer.b;
+}
+
+static inline GxAreaf Intersection(const GxAreaf& a, const GxAreaf& b)
+{
+	return GxAreaf(GxMax(a.l, b.l), GxMax(a.t, b.t), GxMin(a.r, b.r), GxMin(a.b, b.b));
+}
+
+static inline bool IsSameRect(const GxRecti& a, const GxRecti& b)
+{
+	return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
 }; // anonymous namespace
 
 // ===================================================================================
@@ -42,10 +75,12 @@ void GxDrawImp::Destroy()
 }
 
 GxDrawImp::GxDrawImp()
-	:myCurrentTexture(NULL)
+	:myCurrentTexture(0)
 	,myNumIndices(0)
 	,myNumVertices(0)
 	,myCurrentOp(DRAWOP_NONE)
+	,myIsDeferred(false)
+	,myRecording(NULL)
 {
 }
 
@@ -55,18 +90,17 @@ GxDrawImp::~GxDrawImp()
 
 void GxDrawImp::Flush()
 {
-	if(myNumVertices > 0)
+	if(myRecording)
 	{
-		GxRenderInterface* renderer = GxRenderInterface::Get();
-		switch(myCurrentOp)
-		{
-		case DRAWOP_TRIS:
-			renderer->DrawTriangles(&myVertices[0], (int)myNumVertices, myCurrentTexture);
-			break;
-		case DRAWOP_QUADS:
-			renderer->DrawTriangles(&myVertices[0], (int)myNumVertices, &myIndices[0], (int)myNumIndices, myCurrentTexture);
-			break;
-		};
+		return;
+	}
+	else if(myIsDeferred)
+	{
+		myFlushDeferred();
+	}
+	else if(myNumVertices > 0)
+	{
+		mySubmit(myCurrentOp, &myVertices[0], myNumVertices, myCurrentTexture);
 		myNumVertices = 0;
 		myNumIndices = 0;
 	}
@@ -119,6 +153,9 @@ void GxDrawImp::Rect(int x, int y, int w, int h, GxColor c, const GxTexture& tex
 
 GxVertex* GxDrawImp::BatchTriangles(int triangleCount, GxTextureHandle texture)
 {
+	if(myRecording) return myRecording->AddGeometry(GxDrawList::Data::CMD_TRIANGLES, triangleCount * 3, texture);
+	if(myIsDeferred) return myRecord(DRAWOP_TRIS, triangleCount * 3, texture);
+
 	if(myCurrentOp != DRAWOP_TRIS || myCurrentTexture != texture)
 	{
 		Flush();
@@ -137,6 +174,9 @@ GxVertex* GxDrawImp::BatchTriangles(int triangleCount, GxTextureHandle texture)
 
 GxVertex* GxDrawImp::BatchQuads(int quadCount, GxTextureHandle texture)
 {
+	if(myRecording) return myRecording->AddGeometry(GxDrawList::Data::CMD_QUADS, quadCount * 4, texture);
+	if(myIsDeferred) return myRecord(DRAWOP_QUADS, quadCount * 4, texture);
+
 	if(myCurrentOp != DRAWOP_QUADS || myCurrentTexture != texture)
 	{
 		Flush();
@@ -157,6 +197,12 @@ GxVertex* GxDrawImp::BatchQuads(int quadCount, GxTextureHandle texture)
 
 void GxDrawImp::DrawTriangles(const GxVertex* verts, int triangleCount, GxTextureHandle texture)
 {
+	if(myRecording)
+	{
+		memcpy(BatchTriangles(triangleCount, texture), verts, sizeof(GxVertex) * triangleCount * 3);
+		return;
+	}
+
 	Flush();
 
 	GxRenderInterface* renderer = GxRenderInterface::Get();
@@ -165,6 +211,12 @@ void GxDrawImp::DrawTriangles(const GxVertex* verts, int triangleCount, GxTextur
 
 void GxDrawImp::DrawQuads(const GxVertex* verts, int quadCount, GxTextureHandle texture)
 {
+	if(myRecording)
+	{
+		memcpy(BatchQuads(quadCount, texture), verts, sizeof(GxVertex) * quadCount * 4);
+		return;
+	}
+
 	Flush();
 
 	myNumIndices = quadCount * 6;
@@ -180,9 +232,13 @@ void GxDrawImp::DrawQuads(const GxVertex* verts, int quadCount, GxTextureHandle
 
 void GxDrawImp::PushScissorRect(int x, int y, int w, int h)
 {
-	Flush();
+	// In deferred mode, the scissor region is recorded along with the geometry. Draw lists
+	// record the push, but the stack is still updated so the scissor region can be queried.
+	if(myRecording)
+		myRecording->AddCommand(GxDrawList::Data::CMD_PUSH_SCISSOR, GxRecti(x, y, w, h), GX_BM_ALPHA);
 
-	GxRenderInterface* renderer = GxRenderInterface::Get();
+	GxRenderInterface* renderer = (myIsDeferred || myRecording) ? NULL : GxRenderInterface::Get();
+	if(renderer) Flush();
 
 	if(myScissorStack.size() < 256)
 	{
@@ -198,13 +254,16 @@ void GxDrawImp::PushScissorRect(int x, int y, int w, int h)
 			int nw = GxMax(0, GxMin(last.x+last.w, x+w) - nx);
 			int nh = GxMax(0, GxMin(last.y+last.h, y+h) - ny);
 			myScissorStack.push_back(GxRecti(nx, ny, nw, nh));
-			renderer->SetScissorRect(nx, ny, nw, nh);
+			if(renderer) renderer->SetScissorRect(nx, ny, nw, nh);
 		}
 		else
 		{
 			myScissorStack.push_back(GxRecti(x, y, w, h));
-			renderer->EnableScissorRect(true);
-			renderer->SetScissorRect(x, y, w, h);
+			if(renderer)
+			{
+				renderer->EnableScissorRect(true);
+				renderer->SetScissorRect(x, y, w, h);
+			}
 		}
 	}
 	else
@@ -215,9 +274,11 @@ void GxDrawImp::PushScissorRect(int x, int y, int w, int h)
 
 void GxDrawImp::PopScissorRect()
 {
-	Flush();
+	if(myRecording)
+		myRecording->AddCommand(GxDrawList::Data::CMD_POP_SCISSOR, GxRecti(), GX_BM_ALPHA);
 
-	GxRenderInterface* renderer = GxRenderInterface::Get();
+	GxRenderInterface* renderer = (myIsDeferred || myRecording) ? NULL : GxRenderInterface::Get();
+	if(renderer) Flush();
 
 	if(!myScissorStack.empty())
 	{
@@ -225,11 +286,11 @@ void GxDrawImp::PopScissorRect()
 		if(!myScissorStack.empty())
 		{
 			GxRecti& r = myScissorStack.back();
-			renderer->SetScissorRect(r.x, r.y, r.w, r.h);
+			if(renderer) renderer->SetScissorRect(r.x, r.y, r.w, r.h);
 		}
 		else
 		{
-			renderer->EnableScissorRect(false);
+			if(renderer) renderer->EnableScissorRect(false);
 		}
 	}
 	else
@@ -249,16 +310,241 @@ GxRecti GxDrawImp::GetScissorRect()
 	return myScissorStack.back();
 }
 
+// ===================================================================================
+// Deferred batching
+// ===================================================================================
+
+void GxDrawImp::SetDeferred(bool enable)
+{
+	Flush();
+	myIsDeferred = enable;
+}
+
+bool GxDrawImp::IsDeferred()
+{
+	return myIsDeferred;
+}
+
+GxVertex* GxDrawImp::myRecord(GxDrawOp op, uint vertexCount, GxTextureHandle texture)
+{
+	const uint baseIndex = myNumVertices;
+	if(vertexCount > 0)
+	{
+		const bool isClipped = !myScissorStack.empty();
+		Command cmd = {{op, texture, isClipped, isClipped ? myScissorStack.back() : GxRecti()}, baseIndex, vertexCount, GxAreaf(), -1, -1};
+		myCommands.push_back(cmd);
+	}
+
+	myNumVertices += vertexCount;
+	if(myNumVertices > myVertices.size())
+		myVertices.resize(myNumVertices);
+
+	return &myVertices[baseIndex];
+}
+
+void GxDrawImp::myFlushDeferred()
+{
+	// The geometry is sorted into a grid of cells that cover the view, so overlap tests are
+	// only done against the geometry that was recorded in the same cells.
+	const GxVec2i view = GxRenderInterface::Get()->GetViewSize();
+	const GxAreaf viewArea(0.f, 0.f, (float)view.x, (float)view.y);
+	const int cols = GxMax(1, (view.x + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE);
+	const int rows = GxMax(1, (view.y + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE);
+	if(!myCommands.empty())
+	{
+		myCellHeads.assign(cols * rows, -1);
+		myCellEntries.clear();
+	}
+
+	myBatches.clear();
+	for(int i=0; i<(int)myCommands.size(); ++i)
+	{
+		// The vertices are written after they are batched, so the bounds are computed here.
+		// The bounds are limited to the scissor region, and if the geometry lies entirely
+		// within the scissor region, it is drawn without it. Geometry outside of the scissor
+		// region or the view is skipped.
+		Command& cmd = myCommands[i];
+		const GxVertex* v = &myVertices[cmd.vertex];
+		GxAreaf a(v->pos.x, v->pos.y, v->pos.x, v->pos.y);
+		for(uint j=1; j<cmd.vertexCount; ++j)
+		{
+			const GxVec2f& p = v[j].pos;
+			a.l = GxMin(a.l, p.x), a.r = GxMax(a.r, p.x);
+			a.t = GxMin(a.t, p.y), a.b = GxMax(a.b, p.y);
+		}
+		if(cmd.state.isClipped)
+		{
+			const GxRecti& c = cmd.state.clip;
+			const GxAreaf clip((float)c.x, (float)c.y, (float)(c.x + c.w), (float)(c.y + c.h));
+			cmd.state.isClipped = !Contains(clip, a);
+			a = Intersection(a, clip);
+		}
+		a = Intersection(a, viewArea);
+		cmd.bounds = a;
+		if(!(a.l < a.r && a.t < a.b)) continue;
+
+		// Finds the last batch that contains geometry which overlaps the command.
+		const int x0 = (int)a.l / GRID_CELL_SIZE, x1 = GxMin(cols - 1, (int)a.r / GRID_CELL_SIZE);
+		const int y0 = (int)a.t / GRID_CELL_SIZE, y1 = GxMin(rows - 1, (int)a.b / GRID_CELL_SIZE);
+		int below = -1;
+		for(int y=y0; y<=y1; ++y)
+		{
+			for(int x=x0; x<=x1; ++x)
+			{
+				for(int e=myCellHeads[y * cols + x]; e>=0; e=myCellEntries[e].next)
+				{
+					const Command& other = myCommands[myCellEntries[e].command];
+					if(other.batch > below && Intersects(other.bounds, a)) below = other.batch;
+				}
+			}
+		}
+
+		// The command joins the most recent batch with the same render state, as long as that
+		// batch is not drawn before the overlapping geometry. Otherwise, it starts a new batch,
+		// so overlapping geometry keeps the order in which it was batched.
+		const int stop = GxMax(below, (int)myBatches.size() - MAX_BATCH_LOOKBACK);
+		int target = -1;
+		for(int j=(int)myBatches.size() - 1; j >= stop && j >= 0; --j)
+		{
+			const DrawState& bs = myBatches[j].state;
+			const DrawState& cs = cmd.state;
+			if(bs.op == cs.op && bs.texture == cs.texture && bs.isClipped == cs.isClipped
+				&& (!cs.isClipped || IsSameRect(bs.clip, cs.clip)))
+			{
+				target = j;
+				break;
+			}
+		}
+		if(target < 0)
+		{
+			target = (int)myBatches.size();
+			Batch batch = {cmd.state, cmd.vertexCount, i, i};
+			myBatches.push_back(batch);
+		}
+		else
+		{
+			Batch& batch = myBatches[target];
+			myCommands[batch.last].next = i;
+			batch.last = i;
+			batch.vertexCount += cmd.vertexCount;
+		}
+		cmd.batch = target;
+
+		for(int y=y0; y<=y1; ++y)
+		{
+			for(int x=x0; x<=x1; ++x)
+			{
+				CellEntry entry = {i, myCellHeads[y * cols + x]};
+				myCellHeads[y * cols + x] = (int)myCellEntries.size();
+				myCellEntries.push_back(entry);
+			}
+		}
+	}
+
+	// Batches of consecutive commands are drawn directly from the recorded vertices,
+	// the commands of other batches are gathered first.
+	for(size_t i=0; i<myBatches.size(); ++i)
+	{
+		const Batch& batch = myBatches[i];
+		const DrawState& state = batch.state;
+		if(i == 0 || state.isClipped != myBatches[i-1].state.isClipped
+			|| (state.isClipped && !IsSameRect(state.clip, myBatches[i-1].state.clip)))
+		{
+			mySetClip(state.isClipped, state.clip);
+		}
+
+		const Command& first = myCommands[batch.first];
+		const Command& last = myCommands[batch.last];
+		if(last.vertex + last.vertexCount - first.vertex == batch.vertexCount)
+		{
+			mySubmit(state.op, &myVertices[first.vertex], batch.vertexCount, state.texture);
+		}
+		else
+		{
+			if(batch.vertexCount > mySortedVertices.size())
+				mySortedVertices.resize(batch.vertexCount);
+			GxVertex* dst = &mySortedVertices[0];
+			for(int j=batch.first; j>=0; j=myCommands[j].next)
+			{
+				const Command& cmd = myCommands[j];
+				memcpy(dst, &myVertices[cmd.vertex], sizeof(GxVertex) * cmd.vertexCount);
+				dst += cmd.vertexCount;
+			}
+			mySubmit(state.op, &mySortedVertices[0], batch.vertexCount, state.texture);
+		}
+	}
+
+	// Restores the scissor region of the top of the stack, for drawing that is not recorded.
+	mySetClip(!myScissorStack.empty(), myScissorStack.empty() ? GxRecti() : myScissorStack.back());
+
+	myCommands.clear();
+	myNumVertices = 0;
+	myNumIndices = 0;
+}
+
+// ===================================================================================
+// Draw list recording
+// ===================================================================================
+
+void GxDrawImp::BeginRecording(GxDrawList::Data* list)
+{
+	Flush();
+	list->parent = myRecording;
+	list->isRecording = true;
+	myRecording = list;
+}
+
+void GxDrawImp::EndRecording(GxDrawList::Data* list)
+{
+	// Lists are normally ended in the reverse order in which they were begun, but a list
+	// that is destroyed while it is recording is removed from the middle of the chain.
+	GxDrawList::Data** link = &myRecording;
+	while(*link && *link != list) link = &(*link)->parent;
+	if(*link) *link = list->parent;
+
+	list->parent = NULL;
+	list->isRecording = false;
+}
+
 // ===================================================================================
 // Misc functionality
 // ===================================================================================
 
 void GxDrawImp::SetBlendMode(GxBlendMode blendMode)
 {
+	if(myRecording)
+	{
+		myRecording->AddCommand(GxDrawList::Data::CMD_BLEND_MODE, GxRecti(), blendMode);
+		return;
+	}
+
 	Flush();
 	GxRenderInterface::Get()->SetBlendMode(blendMode);
 }
 
+void GxDrawImp::mySetClip(bool enable, const GxRecti& r)
+{
+	GxRenderInterface* renderer = GxRenderInterface::Get();
+	renderer->EnableScissorRect(enable);
+	if(enable) renderer->SetScissorRect(r.x, r.y, r.w, r.h);
+}
+
+void GxDrawImp::mySubmit(GxDrawOp op, const GxVertex* vertices, uint vertexCount, GxTextureHandle texture)
+{
+	GxRenderInterface* renderer = GxRenderInterface::Get();
+	switch(op)
+	{
+	case DRAWOP_TRIS:
+		renderer->DrawTriangles(vertices, (int)vertexCount, texture);
+		break;
+	case DRAWOP_QUADS:
+		myNumIndices = vertexCount / 4 * 6;
+		myResizeIndexBuffer();
+		renderer->DrawTriangles(vertices, (int)vertexCount, &myIndices[0], (int)myNumIndices, texture);
+		break;
+	};
+}
+
 void GxDrawImp::myResizeIndexBuffer()
 {
 	if(myNumIndices > myIndices.size())
@@ -275,5 +561,225 @@ void GxDrawImp::myResizeIndexBuffer()
 	}
 }
 
+// ===================================================================================
+// GxDrawList
+// ===================================================================================
+
+GxDrawList::Data::Data()
+	:parent(NULL)
+	,atlasGeneration(0)
+	,loadGeneration(0)
+	,isRecording(false)
+	,isCached(false)
+	,isReplaying(false)
+{
+}
+
+GxDrawList::Data::~Data()
+{
+	End();
+}
+
+GxVertex* GxDrawList::Data::AddGeometry(CommandType type, uint vertexCount, GxTextureHandle texture)
+{
+	const uint baseIndex = (uint)vertices.size();
+	if(!commands.empty() && commands.back().type == type && commands.back().texture == texture)
+	{
+		commands.back().vertexCount += vertexCount;
+	}
+	else if(vertexCount > 0)
+	{
+		Command cmd = {type, texture, GX_BM_ALPHA, baseIndex, vertexCount, GxRecti(), NULL};
+		commands.push_back(cmd);
+	}
+
+	vertices.resize(baseIndex + vertexCount);
+	return vertices.empty() ? NULL : &vertices[0] + baseIndex;
+}
+
+void GxDrawList::Data::AddCommand(CommandType type, const GxRecti& rect, GxBlendMode blendMode)
+{
+	Command cmd = {type, 0, blendMode, 0, 0, rect, NULL};
+	commands.push_back(cmd);
+}
+
+void GxDrawList::Data::Begin()
+{
+	Clear();
+	if(!isRecording)
+		GxDrawImp::singleton->BeginRecording(this);
+
+	const GxGlyphAtlas* atlas = GxGlyphAtlas::singleton;
+	const GxTextureDatabaseImp* textures = GxTextureDatabaseImp::singleton;
+	atlasGeneration = atlas ? atlas->GetGeneration() : 0;
+	loadGeneration = textures ? textures->GetLoadGeneration() : 0;
+}
+
+void GxDrawList::Data::End()
+{
+	if(isRecording && GxDrawImp::singleton)
+		GxDrawImp::singleton->EndRecording(this);
+}
+
+void GxDrawList::Data::Clear()
+{
+	commands.clear();
+	vertices.clear();
+}
+
+bool GxDrawList::Data::IsOutdated() const
+{
+	const GxGlyphAtlas* atlas = GxGlyphAtlas::singleton;
+	const GxTextureDatabaseImp* textures = GxTextureDatabaseImp::singleton;
+	if(atlas && atlas->GetGeneration() != atlasGeneration) return true;
+	if(textures && textures->GetLoadGeneration() != loadGeneration) return true;
+	return false;
+}
+
+void GxDrawList::Data::Replay(int x, int y, float alpha) const
+{
+	if(isReplaying) return;
+	isReplaying = true;
+
+	GxDraw* draw = GxDraw::Get();
+	const float dx = (float)x, dy = (float)y;
+	const bool move = (x != 0 || y != 0);
+	const bool fade = (alpha < 1.f);
+	alpha = GxMax(alpha, 0.f);
+	for(size_t i=0; i<commands.size(); ++i)
+	{
+		const Command& cmd = commands[i];
+		switch(cmd.type)
+		{
+		case CMD_TRIANGLES:
+		case CMD_QUADS:
+			{
+				GxVertex* v = (cmd.type == CMD_QUADS)
+					? draw->BatchQuads((int)cmd.vertexCount / 4, cmd.texture)
+					: draw->BatchTriangles((int)cmd.vertexCount / 3, cmd.texture);
+				memcpy(v, &vertices[cmd.vertex], sizeof(GxVertex) * cmd.vertexCount);
+				if(move)
+				{
+					for(uint j=0; j<cmd.vertexCount; ++j)
+						v[j].pos.x += dx, v[j].pos.y += dy;
+				}
+				if(fade)
+				{
+					for(uint j=0; j<cmd.vertexCount; ++j)
+						v[j].color.a = (uchar)((float)v[j].color.a * alpha + 0.5f);
+				}
+			}
+			break;
+		case CMD_PUSH_SCISSOR:
+			draw->PushScissorRect(cmd.rect.x + x, cmd.rect.y + y, cmd.rect.w, cmd.rect.h);
+			break;
+		case CMD_POP_SCISSOR:
+			draw->PopScissorRect();
+			break;
+		case CMD_BLEND_MODE:
+			draw->SetBlendMode(cmd.blendMode);
+			break;
+		case CMD_DRAW_LIST:
+			cmd.list->Replay(x, y, alpha);
+			break;
+		};
+	}
+
+	isReplaying = false;
+}
+
+void GxDrawList::Data::DrawCached() const
+{
+	// A list that is being recorded would add its own geometry to itself.
+	if(isRecording) return;
+
+	// Nested cached widgets do not copy the geometry of their cached children at every level.
+	Data* recording = GxDrawImp::singleton->GetRecording();
+	if(recording && recording->isCached)
+	{
+		Command cmd = {CMD_DRAW_LIST, 0, GX_BM_ALPHA, 0, 0, GxRecti(), this};
+		recording->commands.push_back(cmd);
+		return;
+	}
+
+	Replay(0, 0, 1.f);
+}
+
+GxDrawList::GxDrawList()
+	:myData(new Data)
+{
+}
+
+GxDrawList::GxDrawList(const GxDrawList& list)
+	:myData(new Data)
+{
+	*this = list;
+}
+
+GxDrawList::~GxDrawList()
+{
+	delete myData;
+}
+
+GxDrawList& GxDrawList::operator=(const GxDrawList& list)
+{
+	if(this != &list)
+	{
+		myData->commands = list.myData->commands;
+		myData->vertices = list.myData->vertices;
+		myData->atlasGeneration = list.myData->atlasGeneration;
+		myData->loadGeneration = list.myData->loadGeneration;
+	}
+	return *this;
+}
+
+void GxDrawList::Begin()
+{
+	myData->Begin();
+}
+
+void GxDrawList::End()
+{
+	myData->End();
+}
+
+void GxDrawList::Clear()
+{
+	myData->Clear();
+}
+
+void GxDrawList::Draw(int x, int y) const
+{
+	Draw(x, y, 1.f);
+}
+
+void GxDrawList::Draw(int x, int y, float alpha) const
+{
+	// A list that is being recorded would add its own geometry to itself.
+	if(myData->isRecording) return;
+
+	myData->Replay(x, y, alpha);
+}
+
+bool GxDrawList::IsEmpty() const
+{
+	return myData->commands.empty();
+}
+
+bool GxDrawList::IsRecording() const
+{
+	return myData->isRecording;
+}
+
+bool GxDrawList::IsOutdated() const
+{
+	return myData->IsOutdated();
+}
+
+int GxDrawList::GetVertexCount() const
+{
+	return (int)myData->vertices.size();
+}
+
 }; // namespace graphics
 }; // namespace guix
\ No newline at end of file
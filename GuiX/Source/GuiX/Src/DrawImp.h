@@ -9,6 +9,72 @@
 namespace guix {
 namespace graphics {
 
+// ===================================================================================
+// GxDrawList data
+// ===================================================================================
+
+struct GxDrawList::Data
+{
+	enum CommandType
+	{
+		CMD_TRIANGLES,
+		CMD_QUADS,
+		CMD_PUSH_SCISSOR,
+		CMD_POP_SCISSOR,
+		CMD_BLEND_MODE,
+		CMD_DRAW_LIST,
+	};
+
+	struct Command
+	{
+		CommandType type;
+		GxTextureHandle texture;
+		GxBlendMode blendMode;
+		uint vertex, vertexCount;
+		GxRecti rect;
+		const Data* list; // The cached widget geometry that is referenced by CMD_DRAW_LIST.
+	};
+
+	Data();
+	~Data();
+
+	// Adds geometry to the list, and returns the vertices that should be filled in. Geometry
+	// that uses the same texture as the previous command is merged into that command.
+	GxVertex* AddGeometry(CommandType type, uint vertexCount, GxTextureHandle texture);
+
+	void AddCommand(CommandType type, const GxRecti& rect, GxBlendMode blendMode);
+
+	// Clears the list and starts or stops recording, see GxDrawList::Begin and GxDrawList::End.
+	void Begin();
+	void End();
+	void Clear();
+
+	// Returns true if the textures of the recorded geometry were replaced, see GxDrawList::IsOutdated.
+	bool IsOutdated() const;
+
+	// Replays the commands through GxDraw, see GxDrawList::Draw.
+	void Replay(int x, int y, float alpha) const;
+
+	// Replays the cached geometry of a widget. If the cached geometry of another widget is being
+	// recorded, a reference to this list is added to it instead of a copy of the geometry. The
+	// context nodes own both lists, and invalidate the geometry of the parent widgets whenever
+	// this list is deleted, so the reference is recorded again before it is replayed.
+	void DrawCached() const;
+
+	std::vector<Command> commands;
+	std::vector<GxVertex> vertices;
+	Data* parent; // List that was being recorded when this list started recording.
+	uint atlasGeneration;
+	int loadGeneration;
+	bool isRecording;
+	bool isCached; // The list holds the cached geometry of a widget, see DrawCached.
+	mutable bool isReplaying; // Prevents lists that reference each other from being replayed endlessly.
+};
+
+// ===================================================================================
+// GxDrawImp
+// ===================================================================================
+
 class GxDrawImp : public GxDraw
 {
 public:
@@ -51,7 +117,53 @@ public:
 	// Misc
 	void Flush();
 
+	// Deferred batching
+	void SetDeferred(bool enable);
+	bool IsDeferred();
+
+	// Draw list recording
+	void BeginRecording(GxDrawList::Data* list);
+	void EndRecording(GxDrawList::Data* list);
+	GxDrawList::Data* GetRecording() {return myRecording;}
+
 private:
+	// Render state of recorded geometry; isClipped is false if the scissor region is not needed.
+	struct DrawState
+	{
+		GxDrawOp op;
+		GxTextureHandle texture;
+		bool isClipped;
+		GxRecti clip;
+	};
+
+	// A range of recorded vertices that is drawn with one render state.
+	struct Command
+	{
+		DrawState state;
+		uint vertex, vertexCount;
+		GxAreaf bounds;
+		int batch, next;
+	};
+
+	// A group of commands with the same render state that is drawn at once.
+	struct Batch
+	{
+		DrawState state;
+		uint vertexCount;
+		int first, last;
+	};
+
+	// Entry in the linked list of commands that overlap a grid cell.
+	struct CellEntry
+	{
+		int command, next;
+	};
+
+	GxVertex* myRecord(GxDrawOp op, uint vertexCount, GxTextureHandle texture);
+	void myFlushDeferred();
+	void mySetClip(bool enable, const GxRecti& r);
+	void mySubmit(GxDrawOp op, const GxVertex* vertices, uint vertexCount, GxTextureHandle texture);
+
 	void myResizeIndexBuffer();
 	GxTextureHandle myCurrentTexture;
 
@@ -61,6 +173,14 @@ private:
 	uint myNumIndices, myNumVertices;
 
 	GxDrawOp myCurrentOp;
+
+	bool myIsDeferred;
+	GxDrawList::Data* myRecording;
+	std::vector<Command> myCommands;
+	std::vector<Batch> myBatches;
+	std::vector<GxVertex> mySortedVertices;
+	std::vector<int> myCellHeads;
+	std::vector<CellEntry> myCellEntries;
 };
 
 }; // namespace graphics
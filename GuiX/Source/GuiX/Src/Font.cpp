@@ -1,11 +1,17 @@
 #include <GuiX/Config.h>
+
+#include <stdio.h>
+#include <algorithm>
+
 #include <GuiX/Interfaces.h>
 #include <GuiX/Resources.h>
 
+#include <Src/CoreImp.h>
 #include <Src/TextImp.h>
+#include <Src/TextureImp.h>
 
 #if defined(_MSC_VER) && _MSC_VER >= 1400
-#pragma warning(disable: 4996) // fopen and sscanf warnings.
+#pragma warning(disable: 4996) // sscanf warnings.
 #endif
 
 namespace guix {
@@ -92,6 +98,44 @@ struct GlyphIndices
 	int indices[4];
 };
 
+// ===================================================================================
+// Binary font format
+//
+// A binary font file is an image of the tables that GxFontData builds when it loads a
+// text font, so the tables can be used in place after reading the file. All values are
+// 32-bit and stored in native byte order, and every table starts at a multiple of four
+// bytes. The file contains the following tables, in this order:
+//
+//   FontFileHeader  Font information, and the size and offset of every table.
+//   FontFilePage    The size of every glyph page, and the offset of its image path.
+//   Glyph           The glyphs, with uvs normalized to the size of their page.
+//   int             The BMP codepoint to glyph map, with styleCount entries per codepoint.
+//   uint, int       The sorted SMP codepoints, and their glyph indices.
+//   uint, float     The sorted kerning keys, and their x-deltas.
+//   char            The null-terminated image paths, relative to the font file.
+
+enum FontFileProperties
+{
+	FONT_FILE_MAGIC   = 0x42465847, // "GXFB"
+	FONT_FILE_VERSION = 1,
+};
+
+struct FontFileHeader
+{
+	uint magic, version, glyphSize;
+	int fontSize, styleCount;
+	float ellipsisW;
+	uint mapBegin, mapEnd;
+	int pageCount, glyphCount, smpCount, kernCount;
+	uint pages, glyphs, bmpMap, smpKeys, smpVals, kernKeys, kernVals, fileSize;
+};
+
+struct FontFilePage
+{
+	int width, height;
+	uint path;
+};
+
 
 // ===================================================================================
 // Utility functions
@@ -118,6 +162,21 @@ static bool LoadTexture(GxTextureHandle& handle, int& width, int& height, const
 	return renderer->LoadTexture(handle, width, height, path);
 }
 
+// Loads the pixels of an image file into memory allocated with GxMalloc.
+static uchar* LoadPixels(int& width, int& height, const char* path)
+{
+	GxRenderInterface* renderer = GxRenderInterface::Get();
+	uchar* pixels = NULL;
+	if(!renderer->LoadPixels(pixels, width, height, path) || !pixels)
+		return NULL;
+
+	const int bytes = width * height * 4;
+	uchar* copy = GxMalloc<uchar>(bytes);
+	memcpy(copy, pixels, bytes);
+	renderer->ReleasePixels(pixels);
+	return copy;
+}
+
 // Deletes an OpenGL texture.
 static void DeleteTexture(GxTextureHandle handle)
 {
@@ -125,6 +184,72 @@ static void DeleteTexture(GxTextureHandle handle)
 	renderer->ReleaseTexture(handle);
 }
 
+// Returns the directory part of a path, including the trailing slash.
+static GxString GetDirectory(const char* path)
+{
+	GxString dir = path;
+	dir.Replace('\\', '/');
+	dir.Erase(GxMax(dir.Last('/') + 1, 0));
+	return dir;
+}
+
+// Returns true if a table of count elements at offset lies within a file of the given size.
+static bool IsValidTable(uint offset, int count, int elemSize, int size)
+{
+	return (offset % 4) == 0 && offset <= (uint)size && count >= 0
+		&& (uint)count <= ((uint)size - offset) / (uint)elemSize;
+}
+
+// Returns true if the header of a binary font file matches the file and its tables.
+static bool IsValidFontFile(const char* data, int size)
+{
+	const FontFileHeader& h = *(const FontFileHeader*)data;
+	if(h.version != FONT_FILE_VERSION || h.glyphSize != sizeof(Glyph) || h.fileSize != (uint)size)
+		return false;
+	if(h.glyphCount <= 0 || h.pageCount <= 0 || h.styleCount < 1 || h.styleCount > 4)
+		return false;
+	if(h.mapEnd < h.mapBegin || h.mapEnd > 0x10000 || data[size - 1] != 0)
+		return false;
+
+	const int bmpCount = (int)(h.mapEnd - h.mapBegin) * h.styleCount;
+	if(!IsValidTable(h.pages,    h.pageCount,  sizeof(FontFilePage), size) ||
+	   !IsValidTable(h.glyphs,   h.glyphCount, sizeof(Glyph), size) ||
+	   !IsValidTable(h.bmpMap,   bmpCount,     sizeof(int),   size) ||
+	   !IsValidTable(h.smpKeys,  h.smpCount,   sizeof(uint),  size) ||
+	   !IsValidTable(h.smpVals,  h.smpCount * h.styleCount, sizeof(int), size) ||
+	   !IsValidTable(h.kernKeys, h.kernCount,  sizeof(uint),  size) ||
+	   !IsValidTable(h.kernVals, h.kernCount,  sizeof(float), size))
+		return false;
+
+	const FontFilePage* pages = (const FontFilePage*)(data + h.pages);
+	for(int i=0; i<h.pageCount; ++i)
+		if(pages[i].path >= (uint)size) return false;
+
+	// The tables are used in place, so every index they contain has to be checked as well.
+	const Glyph* glyphs = (const Glyph*)(data + h.glyphs);
+	for(int i=0; i<h.glyphCount; ++i)
+		if(glyphs[i].page < 0 || glyphs[i].page >= h.pageCount) return false;
+
+	const int* bmpMap = (const int*)(data + h.bmpMap);
+	for(int i=0; i<bmpCount; ++i)
+		if(bmpMap[i] < 0 || bmpMap[i] >= h.glyphCount) return false;
+
+	const int* smpVals = (const int*)(data + h.smpVals);
+	for(int i=0; i<h.smpCount * h.styleCount; ++i)
+		if(smpVals[i] < 0 || smpVals[i] >= h.glyphCount) return false;
+
+	// The codepoint and kerning lookups are binary searches, which need strictly ascending keys.
+	const uint* smpKeys = (const uint*)(data + h.smpKeys);
+	for(int i=1; i<h.smpCount; ++i)
+		if(smpKeys[i] <= smpKeys[i-1]) return false;
+
+	const uint* kernKeys = (const uint*)(data + h.kernKeys);
+	for(int i=1; i<h.kernCount; ++i)
+		if(kernKeys[i] <= kernKeys[i-1]) return false;
+
+	return true;
+}
+
 // Returns true if the line starts with the given word.
 static bool StartsWith(const char* l, const char* w)
 {
@@ -174,6 +299,8 @@ GxFontData::GxFontData()
 	,glyphPageCount(0)
 	,fontSize(DEFAULT_FONT_SIZE)
 	,ellipsisW(0)
+	,atlasId(0)
+	,myFileData(NULL)
 	,myStyle(0)
 	,myStyleIndex(0)
 	,myStyleCount(0)
@@ -187,28 +314,43 @@ GxFontData::~GxFontData()
 
 void GxFontData::Destroy()
 {
+	// Cancel the glyph pages that are still loading.
+	for(size_t i=0; i<myPageLoads.size(); ++i)
+		if(myPageLoads[i]) GxTextureDatabaseImp::singleton->CancelLoad(myPageLoads[i]);
+	myPageLoads.clear();
+
+	// The tables of a binary font are stored in the file data.
+	if(myFileData)
+	{
+		GxFree(myFileData);
+		myFileData = NULL;
+	}
+	else
+	{
+		GxFree(bmpGlyphMap);
+		GxFree(smpGlyphKey);
+		GxFree(smpGlyphVal);
+		GxFree(kernKey);
+		GxFree(kernVal);
+		GxFree(glyphs);
+	}
+
 	// BMP codepoint to glyph mapping.
-	GxFree(bmpGlyphMap);
 	bmpGlyphMap = NULL;
 	mapBegin = 0;
 	mapEnd = 0;
 
 	// SMP codepoint to glyph mapping.
-	GxFree(smpGlyphKey);
-	GxFree(smpGlyphVal);
 	smpGlyphKey = NULL;
 	smpGlyphVal = NULL;
 	smpGlyphCount = 0;
 
 	// Kerning data.
-	GxFree(kernKey);
-	GxFree(kernVal);
 	kernKey = NULL;
 	kernVal = NULL;
 	kernCount = 0;
 
 	// Glyph data.
-	GxFree(glyphs);
 	glyphs = NULL;
 	glyphCount = 0;
 
@@ -217,41 +359,62 @@ void GxFontData::Destroy()
 	myStyle = 0;
 	myStyleIndex = 0;
 
-	// Release glyph page textures.
+	// Release the glyphs in the glyph atlas.
+	if(atlasId && GxGlyphAtlas::singleton)
+		GxGlyphAtlas::singleton->RemoveFont(atlasId);
+	atlasId = 0;
+
+	// Release glyph page textures and pixels.
 	for(int i=0; i<glyphPageCount; ++i)
-		DeleteTexture(glyphPages[i].texture);
+	{
+		if(glyphPages[i].texture) DeleteTexture(glyphPages[i].texture);
+		GxFree(glyphPages[i].pixels);
+	}
 
 	// GlyphPage data.
 	GxFree(glyphPages);
 	glyphPages = NULL;
 	glyphPageCount = 0;
+	glyphPagePaths.clear();
 
 	// Font information.
 	fontSize = DEFAULT_FONT_SIZE;
 	ellipsisW = 0;
 }
 
-// Creates a font from a TidyText font file.
-bool GxFontData::Create(const char* path, const char* dir)
+// Creates a font from a TidyText font file, in either the text or the binary format.
+// If async is true, the glyph pages of a binary font are loaded on the background thread.
+bool GxFontData::Create(const char* path, const char* dir, bool async)
 {
 	Destroy();
 
-	// Parse file contents into the buffer.
-	FILE* fp = fopen(path, "rb");
-	if(!fp) return false;
-	char buf[256];
+	// Read the whole file at once.
+	size_t fileSize = 0;
+	char* data = GxReadFile(path, fileSize);
+	if(!data) return false;
+	const int size = (int)fileSize;
+
+	// Binary fonts use the file data in place.
+	if(size >= (int)sizeof(FontFileHeader) && ((const FontFileHeader*)data)->magic == FONT_FILE_MAGIC)
+		return myReadBinary(data, size, dir, async);
+
+	bool result = myParseText(data, dir);
+	GxFree(data);
+	return result;
+}
+
+// Parses the contents of a text font file.
+bool GxFontData::myParseText(const char* text, const char* dir)
+{
+	// Split the text into lines.
 	std::vector<std::string> lines(1);
-	for(size_t i; i=fread(buf, 1, 256, fp);)
+	for(const char* c = text; *c; ++c)
 	{
-		for(size_t j=0; j<i; ++j)
-		{
-			if(buf[j] == C_LINE_FEED)
-				lines.push_back(std::string());
-			else if(buf[j] != C_CARRIAGE_RET)
-				lines.back().push_back(buf[j]);
-		}
+		if(*c == C_LINE_FEED)
+			lines.push_back(std::string());
+		else if(*c != C_CARRIAGE_RET)
+			lines.back().push_back(*c);
 	}
-	fclose(fp);
 
 	// Count the number of pages, glyphs and kerning pairs.
 	for(size_t i=0; i<lines.size(); ++i)
@@ -338,19 +501,222 @@ bool GxFontData::Create(const char* path, const char* dir)
 			if(ql < qr)
 			{
 				// Load the image from the path between the quotation marks.
-				int imgW = 0, imgH = 0;
-				std::string imgpath = dir + lines[i].substr(ql+1, qr-ql-1);
-				bool result = LoadTexture(glyphPages[page].texture, imgW, imgH, imgpath.c_str());
-				rw = (float)(1.0 / GxMax((double)imgW, 1.0));
-				rh = (float)(1.0 / GxMax((double)imgH, 1.0));
+				glyphPagePaths.push_back(lines[i].substr(ql+1, qr-ql-1).c_str());
+				myLoadPage(page, (dir + glyphPagePaths[page]).Raw());
+				rw = (float)(1.0 / GxMax((double)glyphPages[page].width, 1.0));
+				rh = (float)(1.0 / GxMax((double)glyphPages[page].height, 1.0));
 			}
+			else glyphPagePaths.push_back(GxString());
 		}
 	}
 
+	myCreatePages();
 	myFinalize();
 	return true;
 }
 
+// Reads a font from the data of a binary font file. The tables are used in place, so
+// the font takes ownership of the data.
+bool GxFontData::myReadBinary(char* data, int size, const char* dir, bool async)
+{
+	myFileData = data;
+	if(!IsValidFontFile(data, size))
+	{
+		Destroy();
+		return false;
+	}
+
+	// Font information.
+	const FontFileHeader& h = *(const FontFileHeader*)data;
+	fontSize = h.fontSize;
+	ellipsisW = h.ellipsisW;
+	myStyleCount = h.styleCount;
+
+	// Point the glyph, map and kerning data into the file.
+	glyphs = (Glyph*)(data + h.glyphs);
+	glyphCount = h.glyphCount;
+	if(h.mapEnd > h.mapBegin)
+	{
+		bmpGlyphMap = (int*)(data + h.bmpMap);
+		mapBegin = h.mapBegin;
+		mapEnd = h.mapEnd;
+	}
+	if(h.smpCount > 0)
+	{
+		smpGlyphKey = (uint*)(data + h.smpKeys);
+		smpGlyphVal = (int*)(data + h.smpVals);
+		smpGlyphCount = h.smpCount;
+	}
+	if(h.kernCount > 0)
+	{
+		kernKey = (uint*)(data + h.kernKeys);
+		kernVal = (float*)(data + h.kernVals);
+		kernCount = h.kernCount;
+	}
+
+	// Load the glyph pages. Pages are only loaded asynchronously if the glyphs can be drawn
+	// from the glyph atlas, which skips the glyphs of pages that are not loaded yet.
+	const FontFilePage* pages = (const FontFilePage*)(data + h.pages);
+	glyphPageCount = h.pageCount;
+	glyphPages = Malloc<GlyphPage>(glyphPageCount);
+	if(async && GxGlyphAtlas::singleton && GxTextureDatabaseImp::singleton)
+		myPageLoads.resize(glyphPageCount, NULL);
+
+	for(int i=0; i<glyphPageCount; ++i)
+	{
+		glyphPagePaths.push_back(data + pages[i].path);
+		if(glyphPagePaths[i].Empty()) continue;
+
+		const GxString imgpath = dir + glyphPagePaths[i];
+		if(myPageLoads.empty())
+			myLoadPage(i, imgpath.Raw());
+		else
+			myPageLoads[i] = GxTextureDatabaseImp::singleton->QueueLoad(imgpath.Raw(), myApplyPage, this);
+	}
+
+	myCreatePages();
+	return true;
+}
+
+// The uvs of a binary font are normalized to the page size at conversion, which changes if the image is replaced.
+void GxFontData::myScalePage(int index)
+{
+	if(!myFileData) return;
+
+	const FontFileHeader& h = *(const FontFileHeader*)myFileData;
+	const FontFilePage& page = ((const FontFilePage*)(myFileData + h.pages))[index];
+	const GlyphPage& gp = glyphPages[index];
+	if(gp.width > 0 && gp.height > 0 && (gp.width != page.width || gp.height != page.height))
+	{
+		const float sx = (float)page.width / (float)gp.width;
+		const float sy = (float)page.height / (float)gp.height;
+		for(int i=0; i<glyphCount; ++i)
+		{
+			if(glyphs[i].page != index) continue;
+			GxAreaf& uvs = glyphs[i].uvs;
+			uvs = GxAreaf(uvs.l * sx, uvs.t * sy, uvs.r * sx, uvs.b * sy);
+		}
+	}
+}
+
+// Applies a glyph page that was decoded on the background thread. If the renderer could not
+// decode it, the remaining pages are loaded on the main thread instead.
+void GxFontData::myApplyPage(void* font, GxAsyncLoad* load)
+{
+	GxFontData* data = (GxFontData*)font;
+	const int index = (int)(std::find(data->myPageLoads.begin(), data->myPageLoads.end(), load) - data->myPageLoads.begin());
+	if(index >= data->glyphPageCount) return;
+	data->myPageLoads[index] = NULL;
+
+	if(load->pixels)
+	{
+		GlyphPage& gp = data->glyphPages[index];
+		const int bytes = load->width * load->height * 4;
+		gp.pixels = GxMalloc<uchar>(bytes);
+		memcpy(gp.pixels, load->pixels, bytes);
+		gp.width = load->width;
+		gp.height = load->height;
+		data->myScalePage(index);
+	}
+	else
+	{
+		data->myLoadPage(index, load->path.Raw());
+		data->myFinishPages();
+		if(data->atlasId)
+			GxGlyphAtlas::singleton->RemoveFont(data->atlasId);
+		data->atlasId = 0;
+		data->myCreatePages();
+	}
+}
+
+// Loads the glyph pages that are still queued on the main thread.
+void GxFontData::myFinishPages()
+{
+	for(size_t i=0; i<myPageLoads.size(); ++i)
+	{
+		GxAsyncLoad* load = myPageLoads[i];
+		if(!load) continue;
+		myPageLoads[i] = NULL;
+		myLoadPage((int)i, load->path.Raw());
+		GxTextureDatabaseImp::singleton->CancelLoad(load);
+	}
+}
+
+// Writes the font to a binary font file.
+bool GxFontData::SaveBinary(const char* path) const
+{
+	if(glyphCount == 0 || (int)glyphPagePaths.size() != glyphPageCount)
+		return false;
+
+	// Compute the offsets of the tables.
+	FontFileHeader h;
+	memset(&h, 0, sizeof(FontFileHeader));
+	h.magic      = FONT_FILE_MAGIC;
+	h.version    = FONT_FILE_VERSION;
+	h.glyphSize  = sizeof(Glyph);
+	h.fontSize   = fontSize;
+	h.styleCount = myStyleCount;
+	h.ellipsisW  = ellipsisW;
+	h.mapBegin   = mapBegin;
+	h.mapEnd     = mapEnd;
+	h.pageCount  = glyphPageCount;
+	h.glyphCount = glyphCount;
+	h.smpCount   = smpGlyphCount;
+	h.kernCount  = kernCount;
+
+	const int bmpCount = (int)(mapEnd - mapBegin) * myStyleCount;
+	uint offset = sizeof(FontFileHeader);
+	h.pages    = offset; offset += glyphPageCount * sizeof(FontFilePage);
+	h.glyphs   = offset; offset += glyphCount * sizeof(Glyph);
+	h.bmpMap   = offset; offset += bmpCount * sizeof(int);
+	h.smpKeys  = offset; offset += smpGlyphCount * sizeof(uint);
+	h.smpVals  = offset; offset += smpGlyphCount * myStyleCount * sizeof(int);
+	h.kernKeys = offset; offset += kernCount * sizeof(uint);
+	h.kernVals = offset; offset += kernCount * sizeof(float);
+
+	const uint strings = offset;
+	for(int i=0; i<glyphPageCount; ++i)
+		offset += glyphPagePaths[i].Length() + 1;
+	h.fileSize = offset;
+
+	// Fill in the tables.
+	char* data = Malloc<char>(h.fileSize);
+	memcpy(data, &h, sizeof(FontFileHeader));
+
+	FontFilePage* pages = (FontFilePage*)(data + h.pages);
+	for(int i=0, str=strings; i<glyphPageCount; ++i)
+	{
+		pages[i].width  = glyphPages[i].width;
+		pages[i].height = glyphPages[i].height;
+		pages[i].path   = str;
+		memcpy(data + str, glyphPagePaths[i].Raw(), glyphPagePaths[i].Length());
+		str += glyphPagePaths[i].Length() + 1;
+	}
+
+	Glyph* outGlyphs = (Glyph*)(data + h.glyphs);
+	memcpy(outGlyphs, glyphs, glyphCount * sizeof(Glyph));
+	for(int i=0; i<glyphCount; ++i)
+		outGlyphs[i].slot = -1;
+
+	memcpy(data + h.bmpMap,   bmpGlyphMap, bmpCount * sizeof(int));
+	memcpy(data + h.smpKeys,  smpGlyphKey, smpGlyphCount * sizeof(uint));
+	memcpy(data + h.smpVals,  smpGlyphVal, smpGlyphCount * myStyleCount * sizeof(int));
+	memcpy(data + h.kernKeys, kernKey,     kernCount * sizeof(uint));
+	memcpy(data + h.kernVals, kernVal,     kernCount * sizeof(float));
+
+	// Write the file.
+	GxFileInterface* file = GxFileInterface::Get();
+	GxFileHandle fp = file->OpenWrite(path);
+	bool result = (fp != 0);
+	if(fp)
+	{
+		result = (file->Write(fp, data, h.fileSize) == h.fileSize);
+		file->Close(fp);
+	}
+	GxFree(data);
+	return result;
+}
+
 // Creates a font from a RGBA bitmap and character set.
 bool GxFontData::Create(const uchar* rgba, int glyphW, int glyphH, int glyphsInW, int glyphsInH, int _fontSize, const uint* charset)
 {
@@ -391,9 +757,14 @@ bool GxFontData::Create(const uchar* rgba, int glyphW, int glyphH, int glyphsInW
 		++gl;
 	}
 
-	// Create texture.
-	CreateTexture(glyphPages[0].texture, bitmapW, bitmapH, rgba);
+	// Keep a copy of the pixels, the texture is created by myCreatePages if necessary.
+	const int bytes = bitmapW * bitmapH * 4;
+	glyphPages[0].pixels = GxMalloc<uchar>(bytes);
+	glyphPages[0].width = bitmapW;
+	glyphPages[0].height = bitmapH;
+	memcpy(glyphPages[0].pixels, rgba, bytes);
 
+	myCreatePages();
 	myFinalize();
 	return true;
 }
@@ -433,6 +804,16 @@ float GxFontData::GetKerning(int l, int r) const
 	return 0;
 }
 
+// Returns the texture of a glyph page. If the font is drawn from the glyph atlas, the texture is
+// created when it is first needed, for glyphs that the atlas textures do not contain yet.
+GxTextureHandle GxFontData::GetPageTexture(int page) const
+{
+	GlyphPage& gp = glyphPages[page];
+	if(!gp.texture && gp.pixels)
+		CreateTexture(gp.texture, gp.width, gp.height, gp.pixels);
+	return gp.texture;
+}
+
 // Does a binary search in the SMP codepoint map.
 int GxFontData::myGetSMPIndex(uint codepoint) const
 {
@@ -491,20 +872,83 @@ void GxFontData::myInsertBlankGlyph(uint codepoint, int traits)
 		if(glyphs[i].codepoint == codepoint) return;
 
 	glyphs = GxRealloc(glyphs, glyphCount + 1);
+	glyphs[glyphCount].coords    = GxAreaf(0, 0, 0, 0);
+	glyphs[glyphCount].uvs       = GxAreaf(0, 0, 0, 0);
 	glyphs[glyphCount].traits    = traits;
 	glyphs[glyphCount].xAdvance  = (float)(fontSize * 0.5f);
 	glyphs[glyphCount].codepoint = codepoint;
 	glyphs[glyphCount].page      = 0;
+	glyphs[glyphCount].slot      = -1;
 
 	++glyphCount;
 }
 
+// Loads the image of a glyph page. If the pixels can be loaded, the texture is created
+// later on, unless the glyphs use the glyph atlas.
+void GxFontData::myLoadPage(int index, const char* path)
+{
+	GlyphPage& gp = glyphPages[index];
+	int imgW = 0, imgH = 0;
+	if(!(gp.pixels = LoadPixels(imgW, imgH, path)))
+		LoadTexture(gp.texture, imgW, imgH, path);
+	gp.width = imgW;
+	gp.height = imgH;
+	myScalePage(index);
+}
+
+// Decides if the glyphs are drawn from the glyph atlas, which requires the pixels of all glyph pages.
+// Otherwise, textures are created for the glyph pages and the pixels are released.
+void GxFontData::myCreatePages()
+{
+	bool useAtlas = (GxGlyphAtlas::singleton != NULL);
+	for(int i=0; i<glyphPageCount; ++i)
+		useAtlas = useAtlas && (glyphPages[i].pixels || (!myPageLoads.empty() && myPageLoads[i]));
+
+	const float maxSize = (float)(ATLAS_PAGE_SIZE - ATLAS_PADDING * 2);
+	for(int i=0; i<glyphCount; ++i)
+	{
+		const GxAreaf& c = glyphs[i].coords;
+		useAtlas = useAtlas && (c.r - c.l <= maxSize) && (c.b - c.t <= maxSize);
+		glyphs[i].slot = -1;
+	}
+
+	if(useAtlas)
+	{
+		atlasId = GxGlyphAtlas::singleton->AddFont();
+		return;
+	}
+
+	myFinishPages();
+
+	for(int i=0; i<glyphPageCount; ++i)
+	{
+		GlyphPage& page = glyphPages[i];
+		if(page.pixels)
+		{
+			CreateTexture(page.texture, page.width, page.height, page.pixels);
+			GxFree(page.pixels);
+			page.pixels = NULL;
+		}
+	}
+}
+
 // Builds character maps based on the loaded glyphs.
 void GxFontData::myFinalize()
 {
-	// Sort kerning pairs map for look-up.
+	// Sort kerning pairs map for look-up, and keep one value for pairs that are listed twice.
 	if(kernCount > 0)
+	{
 		SortKerningMap(kernKey, kernVal, 0, kernCount-1);
+		int n = 1;
+		for(int i=1; i<kernCount; ++i)
+		{
+			if(kernKey[i] == kernKey[n-1]) continue;
+			kernKey[n] = kernKey[i];
+			kernVal[n] = kernVal[i];
+			++n;
+		}
+		kernCount = n;
+	}
 
 	// Make sure whitespace glyphs are available.
 	myInsertBlankGlyph(C_HTAB, GT_WHITESPACE);
@@ -616,23 +1060,27 @@ void GxFontDatabaseImp::AddGlyph(const char* id, const GxTexture& img, int dy, i
 		g.glyph.xAdvance  = (float)(advance ? advance : w + 1);
 		g.glyph.codepoint = myGlyphMap[id] = myGlyphs.size();
 		g.glyph.page      = -1;
+		g.glyph.slot      = -1;
 		myGlyphs.push_back(g);
+
+		// Cached layouts of formatted text might use the previous glyph with this id.
+		myClearLayoutCache();
 	}
 }
 
-bool GxFontDatabaseImp::Load(GxFontHandle& outHandle, const char* path_or_resource)
+bool GxFontDatabaseImp::Load(GxFontHandle& outHandle, const char* path_or_resource, bool async)
 {
 	outHandle = 0;
 	if(!path_or_resource) return false;
 
 	GxResources::FontRes res;
 	if(GxResources::Get()->GetResource(path_or_resource, res))
-		return myLoadFile(outHandle, res.path.Raw());
+		return myLoadFile(outHandle, res.path.Raw(), async);
 
-	return myLoadFile(outHandle, path_or_resource);
+	return myLoadFile(outHandle, path_or_resource, async);
 }
 
-bool GxFontDatabaseImp::myLoadFile(GxFontHandle& outHandle, const char* path)
+bool GxFontDatabaseImp::myLoadFile(GxFontHandle& outHandle, const char* path, bool async)
 {
 	FontMap::Ref* ref = myFontMap.GetData(path);
 	if(ref)
@@ -643,7 +1091,7 @@ bool GxFontDatabaseImp::myLoadFile(GxFontHandle& outHandle, const char* path)
 	else
 	{
 		GxFontData* font = NULL;
-		if(font = myLoadFontData(path))
+		if(font = myLoadFontData(path, async))
 		{
 			outHandle = (GxFontHandle)font;
 			myFontMap.Insert(outHandle, font, path);
@@ -656,17 +1104,22 @@ bool GxFontDatabaseImp::myLoadFile(GxFontHandle& outHandle, const char* path)
 	return outHandle != 0;
 }
 
-GxFontData* GxFontDatabaseImp::myLoadFontData(const char* path)
+bool GxFontDatabaseImp::ConvertFont(const char* textPath, const char* binaryPath)
 {
-	// Construct the directory string
-	GxString sdir = path;
-	sdir.Replace('\\', '/');
-	const int i = GxMax(sdir.Last('/') + 1, 0);
-	sdir.Erase(i);
+	GxFontData font;
+	if(!font.Create(textPath, GetDirectory(textPath).Raw()) || !font.SaveBinary(binaryPath))
+	{
+		GxLog(LOG_TAG, GX_LT_WARNING, "Failed to convert \"%s\"", textPath);
+		return false;
+	}
+	return true;
+}
 
+GxFontData* GxFontDatabaseImp::myLoadFontData(const char* path, bool async)
+{
 	// Load the font
 	GxFontData* data = new GxFontData();
-	if(!data->Create(path, sdir.Raw()))
+	if(!data->Create(path, GetDirectory(path).Raw(), async))
 	{
 		delete data;
 		data = NULL;
@@ -684,11 +1137,19 @@ void GxFontDatabaseImp::Release(GxFontHandle handle)
 	FontMap::Ref* ref = myFontMap.Release(handle);
 	if(ref)
 	{
+		// Cached layouts refer to the font data, which might be reused by a new font.
+		myClearLayoutCache();
 		delete ref->data;
 		myFontMap.Erase(handle);
 	}
 }
 
+void GxFontDatabaseImp::myClearLayoutCache()
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) renderer->ClearCache();
+}
+
 void GxFontDatabaseImp::MakeDefault(const GxFont& font)
 {
 	myDefaultFont = font;
@@ -727,13 +1188,12 @@ int GxFontDatabaseImp::GetLoadedFontCount() const
 
 void GxFontDatabaseImp::LogInfo() const
 {
-	GxLog("Loaded files: %i", myFontMap.files.size());
+	GxLog("Loaded files: %i", myFontMap.files.Size());
 	{
-		FontMap::FileMap::const_iterator it = myFontMap.files.begin();
-		for(; it != myFontMap.files.end(); ++it)
+		for(int i=0; i<myFontMap.files.Size(); ++i)
 			GxLog(" path=\"%s\" handle=%i",
-				it->first.Raw(),
-				it->second);
+				myFontMap.files.GetEntry(i).key.Raw(),
+				myFontMap.files.GetEntry(i).value);
 		GxLog("");
 	}
 	GxLog("Loaded fonts: %i", myFontMap.loaded.size());
@@ -746,6 +1206,8 @@ void GxFontDatabaseImp::LogInfo() const
 				it->second.data->fontSize);
 		GxLog("");
 	}
+	if(GxGlyphAtlas::singleton)
+		GxGlyphAtlas::singleton->LogInfo();
 }
 
 static uchar* CreateBitmap(const uint* src, uint bits)
@@ -776,6 +1238,7 @@ void GxFontDatabaseImp::myCreateFallbacks()
 	g.glyph.xAdvance  = FB_TAG_W + 1;
 	g.glyph.codepoint = 0;
 	g.glyph.page      = -1;
+	g.glyph.slot      = -1;
 	myGlyphs.push_back(g);
 
 	// Cleanup.
@@ -70,7 +70,7 @@ void GxFreeLayout::Adjust()
 	for(int i=0; i<myItems.Size(); ++i)
 	{
 		GxWidget* w = myItems[i].widget;
-		w->Adjust();
+		w->UpdateAdjust();
 		if(w->IsUnarranged()) continue;
 
 		GxSizePolicyResult pol(w);
@@ -103,7 +103,7 @@ void GxFreeLayout::Arrange(GxRecti rect)
 		r.w = GxClamp(pol.hint.x, pol.min.x, pol.max.x);
 		r.h = GxClamp(pol.hint.y, pol.min.y, pol.max.y);
 
-		w->SetRect(r);
+		w->UpdateRect(r);
 	}
 }
 
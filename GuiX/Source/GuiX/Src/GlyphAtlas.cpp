@@ -0,0 +1,403 @@
+#include <GuiX/Config.h>
+
+#include <string.h>
+
+#include <GuiX/Draw.h>
+
+#include <Src/GlyphAtlas.h>
+#include <Src/TextImp.h>
+
+namespace guix {
+namespace graphics {
+
+// ===================================================================================
+// GxGlyphAtlas
+// ===================================================================================
+
+GxGlyphAtlas* GxGlyphAtlas::singleton = NULL;
+
+void GxGlyphAtlas::Create()
+{
+	singleton = new GxGlyphAtlas();
+}
+
+void GxGlyphAtlas::Destroy()
+{
+	delete singleton;
+	singleton = NULL;
+}
+
+GxGlyphAtlas::GxGlyphAtlas()
+	:myNextFont(0)
+	,myStamp(0)
+	,myGeneration(0)
+	,myFrame(0)
+	,myUploads(0)
+	,myEvictions(0)
+{
+}
+
+GxGlyphAtlas::~GxGlyphAtlas()
+{
+	Clear();
+}
+
+uint GxGlyphAtlas::AddFont()
+{
+	return ++myNextFont;
+}
+
+// Frees the slots of the glyphs of a font. Their areas are reused for new glyphs before pages
+// are evicted, and pages that no longer contain any glyphs are cleared.
+void GxGlyphAtlas::RemoveFont(uint font)
+{
+	std::vector<int> glyphsOnPage(myPages.size(), 0);
+	bool removed = false;
+	for(int i=0; i<(int)mySlots.size(); ++i)
+	{
+		const AtlasSlot& s = mySlots[i];
+		if(s.font == font)
+		{
+			if(!removed)
+			{
+				// Batched geometry might still refer to the glyphs.
+				GxDraw* draw = GxDraw::Get();
+				if(draw) draw->Flush();
+				removed = true;
+			}
+			myPages[s.page].freeRects.push_back(s.rect);
+			myFreeSlot(i);
+		}
+		else if(s.font)
+		{
+			++glyphsOnPage[s.page];
+		}
+	}
+	if(!removed) return;
+
+	for(size_t i=0; i<myPages.size(); ++i)
+	{
+		if(glyphsOnPage[i] == 0)
+		{
+			AtlasPage& p = myPages[i];
+			p.shelves.clear();
+			p.freeRects.clear();
+			p.nextY = 0;
+		}
+	}
+	++myGeneration;
+}
+
+void GxGlyphAtlas::BeginDraw()
+{
+	++myStamp;
+}
+
+// Returns the slot of a glyph, and adds the glyph to the atlas if it is not available yet.
+// Pages that contain glyphs acquired since the last call to BeginDraw are never evicted.
+int GxGlyphAtlas::Acquire(const GxFontData* font, const Glyph& glyph)
+{
+	const int index = (int)(&glyph - font->glyphs);
+
+	// Check if the glyph still occupies the slot it was assigned to previously.
+	int slot = glyph.slot;
+	if(slot >= 0 && slot < (int)mySlots.size())
+	{
+		const AtlasSlot& s = mySlots[slot];
+		if(s.font == font->atlasId && s.glyph == index)
+		{
+			myPages[s.page].stamp = myStamp;
+			return slot;
+		}
+	}
+
+	// Find the pixels of the glyph in the glyph page of the font.
+	const GlyphPage& src = font->glyphPages[glyph.page];
+	const int sl = (int)(glyph.uvs.l * (float)src.width  + 0.5f);
+	const int st = (int)(glyph.uvs.t * (float)src.height + 0.5f);
+	const int sr = (int)(glyph.uvs.r * (float)src.width  + 0.5f);
+	const int sb = (int)(glyph.uvs.b * (float)src.height + 0.5f);
+	const int w = GxMin(sr, src.width) - sl;
+	const int h = GxMin(sb, src.height) - st;
+	if(!src.pixels || sl < 0 || st < 0 || w <= 0 || h <= 0) return -1;
+
+	// Allocate space for the glyph, surrounded by transparent pixels to prevent bleeding.
+	const int pw = w + ATLAS_PADDING * 2;
+	const int ph = h + ATLAS_PADDING * 2;
+	int page, x, y;
+	if(!myAllocate(pw, ph, page, x, y)) return -1;
+
+	myScratch.assign(pw * ph * 4, 0);
+	for(int row=0; row<h; ++row)
+	{
+		const uchar* in = src.pixels + ((st + row) * src.width + sl) * 4;
+		uchar* out = &myScratch[((row + ATLAS_PADDING) * pw + ATLAS_PADDING) * 4];
+		memcpy(out, in, w * 4);
+	}
+	myUpload(page, x, y, pw, ph, &myScratch[0]);
+	const AtlasPage& p = myPages[page];
+
+	// Assign the glyph to a slot.
+	if(myFreeSlots.empty())
+	{
+		slot = (int)mySlots.size();
+		mySlots.push_back(AtlasSlot());
+	}
+	else
+	{
+		slot = myFreeSlots.back();
+		myFreeSlots.pop_back();
+	}
+
+	const float r = 1.f / (float)ATLAS_PAGE_SIZE;
+	const float l = (float)(x + ATLAS_PADDING);
+	const float t = (float)(y + ATLAS_PADDING);
+
+	AtlasSlot& s = mySlots[slot];
+	s.uvs     = GxAreaf(l * r, t * r, (l + (float)w) * r, (t + (float)h) * r);
+	s.rect    = GxRecti(x, y, pw, ph);
+	s.page    = page;
+	s.font    = font->atlasId;
+	s.glyph   = index;
+	s.version = p.pixels ? p.version + 1 : p.version;
+
+	glyph.slot = slot;
+	myPages[page].stamp = myStamp;
+	return slot;
+}
+
+// Returns true if the texture of the page does not contain the glyph yet, because the glyph was
+// added after the page was regenerated during this frame. Such glyphs are drawn from the glyph
+// pages of their font until the page is regenerated in the next frame.
+bool GxGlyphAtlas::IsPending(int slot) const
+{
+	const AtlasSlot& s = mySlots[slot];
+	const AtlasPage& p = myPages[s.page];
+	return s.version > p.version && p.frame == myFrame;
+}
+
+// Regenerates the textures of pages that were changed, if the render interface can not update textures.
+// Each page is regenerated at most once per frame.
+void GxGlyphAtlas::Commit()
+{
+	GxRenderInterface* renderer = GxRenderInterface::Get();
+	for(size_t i=0; i<myPages.size(); ++i)
+	{
+		AtlasPage& page = myPages[i];
+		if(page.dirty && page.frame != myFrame)
+		{
+			GxDraw::Get()->Flush();
+			if(page.texture) renderer->ReleaseTexture(page.texture);
+			renderer->GenerateTexture(page.texture, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, page.pixels);
+			page.dirty = false;
+			page.frame = myFrame;
+			++page.version;
+			++myGeneration;
+		}
+	}
+}
+
+// Allows the pages that were regenerated during the current frame to be regenerated again.
+void GxGlyphAtlas::EndFrame()
+{
+	++myFrame;
+}
+
+void GxGlyphAtlas::Clear()
+{
+	GxDraw* draw = GxDraw::Get();
+	if(draw) draw->Flush();
+
+	GxRenderInterface* renderer = GxRenderInterface::Get();
+	for(size_t i=0; i<myPages.size(); ++i)
+	{
+		if(myPages[i].texture) renderer->ReleaseTexture(myPages[i].texture);
+		GxFree(myPages[i].pixels);
+	}
+	myPages.clear();
+	mySlots.clear();
+	myFreeSlots.clear();
+	++myGeneration;
+}
+
+void GxGlyphAtlas::LogInfo() const
+{
+	int glyphs = (int)(mySlots.size() - myFreeSlots.size());
+	GxLog("Glyph atlas: pages=%i glyphs=%i uploads=%i evictions=%i",
+		(int)myPages.size(), glyphs, myUploads, myEvictions);
+	GxLog("");
+}
+
+// ===================================================================================
+// Private functions
+
+bool GxGlyphAtlas::myAllocate(int w, int h, int& outPage, int& outX, int& outY)
+{
+	if(w > ATLAS_PAGE_SIZE || h > ATLAS_PAGE_SIZE) return false;
+
+	for(int i=0; i<(int)myPages.size(); ++i)
+	{
+		if(myAllocateOnPage(i, w, h, outX, outY))
+		{
+			outPage = i;
+			return true;
+		}
+	}
+
+	// All pages are full, so we add a new page or make room on the least recently used page.
+	// If every page is in use by the current draw, we go over the page limit.
+	int page = -1;
+	if((int)myPages.size() >= ATLAS_MAX_PAGES)
+		page = myEvictPage();
+	if(page < 0)
+		page = myAddPage();
+
+	outPage = page;
+	return myAllocateOnPage(page, w, h, outX, outY);
+}
+
+// Glyphs are packed on shelves; rows of glyphs with a similar height.
+bool GxGlyphAtlas::myAllocateOnPage(int page, int w, int h, int& outX, int& outY)
+{
+	if(myAllocateFreeRect(page, w, h, outX, outY)) return true;
+
+	AtlasPage& p = myPages[page];
+
+	// Look for the shelf with the least wasted height that still has room.
+	AtlasShelf* best = NULL;
+	for(size_t i=0; i<p.shelves.size(); ++i)
+	{
+		AtlasShelf& s = p.shelves[i];
+		if(s.height >= h && s.height <= h + h / 2 + 4 && s.x + w <= ATLAS_PAGE_SIZE)
+			if(!best || s.height < best->height) best = &s;
+	}
+
+	// If there is none, start a new shelf below the previous one.
+	if(!best)
+	{
+		const int height = GxMin((h + 3) & ~3, ATLAS_PAGE_SIZE - p.nextY);
+		if(height < h) return false;
+
+		AtlasShelf s = { p.nextY, height, 0 };
+		p.shelves.push_back(s);
+		p.nextY += height;
+		best = &p.shelves.back();
+	}
+
+	outX = best->x;
+	outY = best->y;
+	best->x += w;
+	return true;
+}
+
+// Reuses the area of a removed glyph with a similar height, and keeps the rest of its width free.
+bool GxGlyphAtlas::myAllocateFreeRect(int page, int w, int h, int& outX, int& outY)
+{
+	std::vector<GxRecti>& rects = myPages[page].freeRects;
+	int best = -1;
+	for(int i=0; i<(int)rects.size(); ++i)
+	{
+		const GxRecti& r = rects[i];
+		if(r.w >= w && r.h >= h && r.h <= h + h / 2 + 4)
+			if(best < 0 || r.w * r.h < rects[best].w * rects[best].h) best = i;
+	}
+	if(best < 0) return false;
+
+	GxRecti& r = rects[best];
+	outX = r.x;
+	outY = r.y;
+	r.x += w;
+	r.w -= w;
+	if(r.w <= 0) rects.erase(rects.begin() + best);
+	return true;
+}
+
+void GxGlyphAtlas::myFreeSlot(int slot)
+{
+	mySlots[slot].font = 0;
+	myFreeSlots.push_back(slot);
+}
+
+int GxGlyphAtlas::myAddPage()
+{
+	AtlasPage page;
+	page.texture = 0;
+	page.pixels = NULL;
+	page.nextY = 0;
+	page.stamp = myStamp;
+	page.version = 0;
+	page.frame = myFrame - 1;
+	page.dirty = false;
+
+	// Create a blank texture. If the render interface can not update the texture, we keep
+	// a copy of the pixels, and regenerate the texture after glyphs are added to it.
+	const int bytes = ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * 4;
+	uchar* pixels = GxMalloc<uchar>(bytes);
+	memset(pixels, 0, bytes);
+
+	GxRenderInterface* renderer = GxRenderInterface::Get();
+	renderer->GenerateTexture(page.texture, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, pixels);
+	if(page.texture && renderer->UpdateTexture(page.texture, 0, 0, 1, 1, pixels))
+		GxFree(pixels);
+	else
+		page.pixels = pixels;
+
+	myPages.push_back(page);
+	return (int)myPages.size() - 1;
+}
+
+// Clears the least recently used page, or returns -1 if all pages are used by the current draw.
+int GxGlyphAtlas::myEvictPage()
+{
+	int page = -1;
+	for(int i=0; i<(int)myPages.size(); ++i)
+	{
+		const uint stamp = myPages[i].stamp;
+		if(stamp != myStamp && (page < 0 || stamp < myPages[page].stamp))
+			page = i;
+	}
+	if(page >= 0)
+	{
+		myClearPage(page);
+		++myEvictions;
+	}
+	return page;
+}
+
+void GxGlyphAtlas::myClearPage(int page)
+{
+	// Batched geometry might still refer to the glyphs on the page.
+	GxDraw::Get()->Flush();
+
+	for(int i=0; i<(int)mySlots.size(); ++i)
+	{
+		const AtlasSlot& s = mySlots[i];
+		if(s.font && s.page == page)
+			myFreeSlot(i);
+	}
+
+	AtlasPage& p = myPages[page];
+	p.shelves.clear();
+	p.freeRects.clear();
+	p.nextY = 0;
+	++myGeneration;
+}
+
+void GxGlyphAtlas::myUpload(int page, int x, int y, int w, int h, const uchar* pixels)
+{
+	AtlasPage& p = myPages[page];
+	if(p.pixels)
+	{
+		for(int row=0; row<h; ++row)
+			memcpy(p.pixels + ((y + row) * ATLAS_PAGE_SIZE + x) * 4, pixels + row * w * 4, w * 4);
+		p.dirty = true;
+	}
+	else
+	{
+		GxRenderInterface::Get()->UpdateTexture(p.texture, x, y, w, h, pixels);
+	}
+	++myUploads;
+}
+
+}; // namespace graphics
+}; // namespace guix
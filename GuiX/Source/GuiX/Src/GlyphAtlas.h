@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+
+#include <GuiX/Interfaces.h>
+
+namespace guix {
+namespace graphics {
+
+class GxFontData;
+struct Glyph;
+
+// ===================================================================================
+// Utility types, structs and enums
+
+enum AtlasProperties
+{
+	ATLAS_PAGE_SIZE = 1024,
+	ATLAS_MAX_PAGES = 4,
+	ATLAS_PADDING   = 1,
+};
+
+struct AtlasShelf
+{
+	int y, height, x;
+};
+
+struct AtlasPage
+{
+	GxTextureHandle texture;
+	std::vector<AtlasShelf> shelves;
+	std::vector<GxRecti> freeRects; // Areas of removed fonts, which are reused before the shelves grow.
+	uchar* pixels; // Copy of the texture, if the render interface can not update textures.
+	int nextY;
+	uint stamp;
+	uint version;  // Number of times the texture was regenerated from the pixels.
+	uint frame;    // Frame in which the texture was last regenerated.
+	bool dirty;
+};
+
+struct AtlasSlot
+{
+	GxAreaf uvs;
+	GxRecti rect;  // Allocated area on the page, including the padding.
+	int page;
+	uint font;     // Atlas id of the font that owns the glyph, or 0 if the slot is free.
+	int glyph;     // Index of the glyph in the glyph array of the font.
+	uint version;  // Page version from which the texture contains the glyph.
+};
+
+// ===================================================================================
+// GxGlyphAtlas
+
+class GxGlyphAtlas
+{
+public:
+	static GxGlyphAtlas* singleton;
+
+	static void Create();
+	static void Destroy();
+
+	GxGlyphAtlas();
+	~GxGlyphAtlas();
+
+	uint AddFont();
+	void RemoveFont(uint font);
+
+	void BeginDraw();
+	int Acquire(const GxFontData* font, const Glyph& glyph);
+	bool IsPending(int slot) const;
+	void Commit();
+	void EndFrame();
+	void Clear();
+
+	inline const AtlasSlot& GetSlot(int slot) const { return mySlots[slot]; }
+	inline GxTextureHandle GetTexture(int page) const { return myPages[page].texture; }
+	inline int GetPageCount() const { return (int)myPages.size(); }
+
+	// Returns a number that changes whenever glyphs are removed or page textures are replaced.
+	inline uint GetGeneration() const { return myGeneration; }
+
+	void LogInfo() const;
+
+private:
+	bool myAllocate(int w, int h, int& outPage, int& outX, int& outY);
+	bool myAllocateOnPage(int page, int w, int h, int& outX, int& outY);
+	bool myAllocateFreeRect(int page, int w, int h, int& outX, int& outY);
+	void myFreeSlot(int slot);
+	int myAddPage();
+	int myEvictPage();
+	void myClearPage(int page);
+	void myUpload(int page, int x, int y, int w, int h, const uchar* pixels);
+
+	std::vector<AtlasPage> myPages;
+	std::vector<AtlasSlot> mySlots;
+	std::vector<int> myFreeSlots;
+	std::vector<uchar> myScratch;
+	uint myNextFont, myStamp, myGeneration, myFrame;
+	int myUploads, myEvictions;
+};
+
+}; // namespace graphics
+}; // namespace guix
@@ -87,7 +87,7 @@ void GxGridLayout::Adjust()
 			if(w != *it && *it)
 			{
 				w = *it;
-				w->Adjust();
+				w->UpdateAdjust();
 				if(!w->IsUnarranged())
 				{
 					GxSizePolicyResult pol(w);
@@ -242,7 +242,7 @@ void GxGridLayout::Arrange(GxRecti rect)
 					GxRecti r(GxInt(x), GxInt(y), width, row.size);
 					r.w = GxClamp(r.w, pol.min.x, pol.max.x);
 					r.h = GxClamp(r.h, pol.min.y, pol.max.y);
-					w->SetRect(r);
+					w->UpdateRect(r);
 				}
 			}
 			x += (float)(col.size + mySpacing);
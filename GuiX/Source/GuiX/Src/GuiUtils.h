@@ -29,5 +29,15 @@ inline GxRecti RectTr(bool tr, int x, int y, int w, int h)
 	return tr ? GxRecti(y, x, h, w) : GxRecti(x, y, w, h);
 }
 
+inline bool SameRect(const GxRecti& a, const GxRecti& b)
+{
+	return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+inline bool RectsOverlap(const GxRecti& a, const GxRecti& b)
+{
+	return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
 }; // namespace gui
 }; // namespace guix
\ No newline at end of file
@@ -38,7 +38,7 @@ public:
 
 	void OnWindowInactive();
 
-	bool GxInputImp::OnFileDrop(GxList<GxString> files, GxVec2i points);
+	bool OnFileDrop(GxList<GxString> files, GxVec2i points);
 
 	void SetMousePos(int x, int y);
 
@@ -83,6 +83,35 @@ GxFileInterface* GxFileInterface::Get()
 	return GxCoreImp::fileInterface;
 }
 
+GxFileHandle GxFileInterface::OpenWrite(const char* path)
+{
+	return 0;
+}
+
+size_t GxFileInterface::Write(GxFileHandle file, const void* buffer, size_t size)
+{
+	return 0;
+}
+
+char* GxReadFile(const char* path, size_t& outSize)
+{
+	GxFileInterface* file = GxFileInterface::Get();
+	GxFileHandle fp = file->Open(path);
+	if(!fp) return NULL;
+
+	file->Seek(fp, 0, GxFileInterface::SeekEnd());
+	size_t size = file->Tell(fp);
+	file->Seek(fp, 0, GxFileInterface::SeekSet());
+
+	char* buffer = GxMalloc<char>(size + 1);
+	size = file->Read(fp, buffer, size);
+	buffer[size] = 0;
+
+	file->Close(fp);
+	outSize = size;
+	return buffer;
+}
+
 // ===================================================================================
 // GxFileInterfaceStd
 // ===================================================================================
@@ -117,6 +146,16 @@ bool GxFileInterfaceStd::EndOfFile(GxFileHandle file)
 	return (feof(reinterpret_cast<FILE*>(file)) != 0);
 }
 
+GxFileHandle GxFileInterfaceStd::OpenWrite(const char* path)
+{
+	return reinterpret_cast<GxFileHandle>(fopen(path, "wb"));
+}
+
+size_t GxFileInterfaceStd::Write(GxFileHandle file, const void* buffer, size_t size)
+{
+	return fwrite(buffer, 1, size, reinterpret_cast<FILE*>(file));
+}
+
 // ===================================================================================
 // GxSystemInterface
 // ===================================================================================
@@ -199,5 +238,22 @@ void GxRenderInterface::ReleaseTexture(GxTextureHandle texture)
 {
 }
 
+bool GxRenderInterface::UpdateTexture(GxTextureHandle texture, int x, int y, int width, int height, const uchar* pixeldata)
+{
+	return false;
+}
+
+bool GxRenderInterface::LoadPixels(uchar*& outPixels, int& outWidth, int& outHeight, const char* path)
+{
+	outPixels = NULL;
+	outWidth = 0;
+	outHeight = 0;
+	return false;
+}
+
+void GxRenderInterface::ReleasePixels(uchar* pixels)
+{
+}
+
 }; // namespace core
 }; // namespace guix
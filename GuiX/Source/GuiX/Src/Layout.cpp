@@ -1,6 +1,12 @@
 #include <GuiX/Config.h>
 #include <GuiX/Layout.h>
 
+#include <Src/ContextImp.h>
+#include <Src/GuiUtils.h>
+
+#include <math.h>
+#include <vector>
+
 namespace guix {
 namespace gui {
 
@@ -10,6 +16,59 @@ namespace gui {
 #define GX_LAYOUT_ITER_R(i, condition) \
 	for(int i=myWidgets.Size()-1; i>=0 && (condition); --i)
 
+namespace {
+
+enum HoverIndexProperties
+{
+	MIN_INDEXED_WIDGETS = 32,  // Layouts with fewer widgets are searched linearly.
+	MAX_INDEX_CELLS = 1 << 16,
+};
+
+static bool IsEmptyArea(const GxAreai& a)
+{
+	return a.r <= a.l || a.b <= a.t;
+}
+
+static bool AreaContains(const GxAreai& a, int x, int y)
+{
+	return x >= a.l && x < a.r && y >= a.t && y < a.b;
+}
+
+}; // anonymous namespace
+
+// ===================================================================================
+// GxLayout::HoverIndex
+// ===================================================================================
+// A uniform grid over the hit bounds of the widgets in a layout. Each cell lists the widgets
+// that overlap it in reverse order, so a search visits them in the same order as a linear
+// search from the last widget would.
+
+struct GxLayout::HoverIndex
+{
+	HoverIndex() : generation(0), searched(0), cellsX(0), cellsY(0), cellW(1), cellH(1) {}
+
+	// Returns the range of widget indices in the cell that contains (x, y).
+	bool GetCell(int x, int y, const int*& begin, const int*& end) const
+	{
+		if(cellsX == 0 || !AreaContains(area, x, y)) return false;
+
+		const int cell = ((y - area.t) / cellH) * cellsX + (x - area.l) / cellW;
+		begin = &items[0] + cells[cell];
+		end = &items[0] + cells[cell + 1];
+		return true;
+	}
+
+	int generation;          // The layout generation of the context when the grid was built.
+	int searched;            // The layout generation of the context during the last search.
+	GxAreai area;            // The area covered by the grid.
+	int cellsX, cellsY;      // The number of grid cells.
+	int cellW, cellH;        // The size of a grid cell in pixels.
+	std::vector<GxAreai> bounds; // The hit bounds of each widget.
+	std::vector<int> cells;  // Offset of the first item of each cell, followed by the number of items.
+	std::vector<int> items;  // Widget indices, in descending order per cell.
+	std::vector<int> fill;   // Insert position of each cell, used while building.
+};
+
 // ===================================================================================
 // GxLayout
 // ===================================================================================
@@ -18,38 +77,88 @@ GxLayout::~GxLayout()
 {
 	for(int i=0; i<myWidgets.Size(); ++i)
 		delete myWidgets[i];
+
+	delete myHoverIndex;
 }
 
 GxLayout::GxLayout()
 	:mySpacing(2)
 	,myOwner(NULL)
+	,myIsLazyArrange(false)
+	,myIsVisibleWidgetsDirty(false)
+	,myHoverIndex(NULL)
 {
 }
 
+// Widgets that are added are not visible until the layout is arranged again.
 void GxLayout::Add(GxWidget* w)
 {
 	myWidgets.Append(w);
 
 	w->SetParent(myOwner);
+	Invalidate();
 }
 
 void GxLayout::Remove(GxWidget* widget)
 {
 	myWidgets.EraseValue(widget);
+	myVisibleWidgets.EraseValue(widget);
+	Invalidate();
 }
 
 void GxLayout::RemoveAll()
 {
 	myWidgets.Clear();
+	myVisibleWidgets.Clear();
+	Invalidate();
 }
 
 GxWidget* GxLayout::FindHoverWidget(int x, int y)
 {
 	GxWidget* h = NULL;
 
+	const int generation = myGetLayoutGeneration();
+
+	// Only the visible widgets are searched, and they are few enough to do without the grid.
+	if(IsCulling())
+	{
+		if(!myVisibleRect.Contains(x, y)) return NULL;
+
+		const WidgetList& visible = myGetVisibleWidgets();
+		for(int i=visible.Size()-1; i>=0 && !h; --i)
+		{
+			GxWidget* w = visible[i];
+			if(w->IsHidden()) continue;
+			if(generation && !AreaContains(w->GetContextNode()->GetHitBounds(generation), x, y)) continue;
+			h = w->FindHoverWidget(x, y);
+		}
+		return h;
+	}
+
+	const HoverIndex* index = myGetHoverIndex(generation);
+	if(index)
+	{
+		const int *it, *end;
+		if(index->GetCell(x, y, it, end))
+		{
+			for(; it != end && !h; ++it)
+			{
+				GxWidget* w = myWidgets[*it];
+				if(!w->IsHidden() && AreaContains(index->bounds[*it], x, y))
+					h = w->FindHoverWidget(x, y);
+			}
+		}
+		return h;
+	}
+
+	// Without a grid, the hit bounds still prevent searching widgets that are not under the position.
 	GX_LAYOUT_ITER_R(i, !h)
-		if(!myWidgets[i]->IsHidden())
-			h = myWidgets[i]->FindHoverWidget(x, y);
+	{
+		GxWidget* w = myWidgets[i];
+		if(w->IsHidden()) continue;
+		if(generation && !AreaContains(w->GetContextNode()->GetHitBounds(generation), x, y)) continue;
+		h = w->FindHoverWidget(x, y);
+	}
 
 	return h;
 }
@@ -58,6 +167,28 @@ bool GxLayout::IsInWidgetRect(int x, int y)
 {
 	bool r = false;
 
+	if(IsCulling())
+	{
+		if(!myVisibleRect.Contains(x, y)) return false;
+
+		const WidgetList& visible = myGetVisibleWidgets();
+		for(int i=visible.Size()-1; i>=0 && !r; --i)
+			r = visible[i]->GetRect().Contains(x, y);
+
+		return r;
+	}
+
+	const HoverIndex* index = myGetHoverIndex(myGetLayoutGeneration());
+	if(index)
+	{
+		const int *it, *end;
+		if(index->GetCell(x, y, it, end))
+			for(; it != end && !r; ++it)
+				r = myWidgets[*it]->GetRect().Contains(x, y);
+
+		return r;
+	}
+
 	GX_LAYOUT_ITER_R(i, !r)
 	{
 		const GxWidget* w = myWidgets[i];
@@ -78,10 +209,18 @@ void GxLayout::Tick(float dt)
 
 void GxLayout::Draw()
 {
+	if(IsCulling())
+	{
+		const WidgetList& visible = myGetVisibleWidgets();
+		for(int i=0; i<visible.Size(); ++i)
+			if(!visible[i]->IsHidden()) visible[i]->DrawCached();
+		return;
+	}
+
 	GX_LAYOUT_ITER(i)
 	{
 		GxWidget* w = myWidgets[i];
-		if(!w->IsHidden()) w->Draw();
+		if(!w->IsHidden()) w->DrawCached();
 	}
 }
 
@@ -103,6 +242,163 @@ void GxLayout::SetOwner(GxWidget* owner)
 		myWidgets[i]->SetParent(owner);
 
 	myOwner = owner;
+	Invalidate();
+}
+
+void GxLayout::Invalidate()
+{
+	if(myHoverIndex) myHoverIndex->generation = myHoverIndex->searched = 0;
+	if(myOwner) myOwner->Invalidate();
+}
+
+void GxLayout::SetVisibleRect(const GxRecti& rect)
+{
+	myVisibleRect = rect;
+	myIsVisibleWidgetsDirty = true;
+}
+
+void GxLayout::SetLazyArrange(bool enabled)
+{
+	if(myIsLazyArrange != enabled)
+	{
+		myIsLazyArrange = enabled;
+		Invalidate();
+	}
+}
+
+void GxLayout::SetMargin(const GxMargini& margin)
+{
+	const GxMargini& m = myMargin;
+	if(m.l != margin.l || m.t != margin.t || m.r != margin.r || m.b != margin.b)
+	{
+		myMargin = margin;
+		Invalidate();
+	}
+}
+
+void GxLayout::SetSpacing(int spacing)
+{
+	if(mySpacing != spacing)
+	{
+		mySpacing = spacing;
+		Invalidate();
+	}
+}
+
+// Returns the layout generation of the context of the owner, or 0 if the owner is not part of a context.
+int GxLayout::myGetLayoutGeneration() const
+{
+	GxContextImp* context = myOwner ? myOwner->GetContextNode()->context : NULL;
+	return context ? context->GetLayoutGeneration() : 0;
+}
+
+// Returns the widgets that overlap the visible rectangle. Layouts that arrange lazily collect them
+// while arranging, because the rectangles of the widgets they skip are out of date. Otherwise they
+// are collected here, after the visible rectangle was set and the layout was arranged.
+const GxLayout::WidgetList& GxLayout::myGetVisibleWidgets()
+{
+	if(myIsVisibleWidgetsDirty)
+	{
+		myIsVisibleWidgetsDirty = false;
+		myVisibleWidgets.Clear();
+		GX_LAYOUT_ITER(i)
+		{
+			GxWidget* w = myWidgets[i];
+			if(RectsOverlap(w->GetRect(), myVisibleRect))
+				myVisibleWidgets.Append(w);
+		}
+	}
+	return myVisibleWidgets;
+}
+
+// Returns the grid of the layout, or NULL if the layout should be searched linearly. After the
+// layout of the context changes, the grid is built again on the second search that sees the same
+// layout, so layouts that change every tick (while scrolling, for example) are not indexed.
+const GxLayout::HoverIndex* GxLayout::myGetHoverIndex(int generation)
+{
+	const int count = myWidgets.Size();
+	if(count < MIN_INDEXED_WIDGETS || !generation)
+		return NULL;
+
+	if(!myHoverIndex) myHoverIndex = new HoverIndex;
+	HoverIndex& index = *myHoverIndex;
+
+	if(index.generation == generation)
+		return &index;
+
+	if(index.searched != generation)
+	{
+		index.searched = generation;
+		return NULL;
+	}
+
+	index.generation = generation;
+	index.cellsX = index.cellsY = 0;
+
+	// Compute the hit bounds of the widgets, and the area that contains all of them.
+	GxAreai& area = index.area;
+	bool empty = true;
+	index.bounds.resize(count);
+	for(int i=0; i<count; ++i)
+	{
+		const GxAreai& b = index.bounds[i] = myWidgets[i]->GetContextNode()->GetHitBounds(generation);
+		if(IsEmptyArea(b)) continue;
+		if(empty)
+		{
+			area = b;
+			empty = false;
+			continue;
+		}
+		area.l = GxMin(area.l, b.l);
+		area.t = GxMin(area.t, b.t);
+		area.r = GxMax(area.r, b.r);
+		area.b = GxMax(area.b, b.b);
+	}
+	if(empty) return &index;
+
+	// Use about one cell per widget, with cells that are roughly square.
+	const int w = area.r - area.l, h = area.b - area.t;
+	const int target = GxMin(count, (int)MAX_INDEX_CELLS);
+	index.cellsX = GxClamp((int)(sqrt((double)target * w / h) + 0.5), 1, w);
+	index.cellsY = GxClamp(target / index.cellsX, 1, h);
+	index.cellW = (w + index.cellsX - 1) / index.cellsX;
+	index.cellH = (h + index.cellsY - 1) / index.cellsY;
+
+	// Count the widgets per cell, and turn the counts into offsets.
+	const int cellCount = index.cellsX * index.cellsY;
+	std::vector<int>& cells = index.cells;
+	cells.assign(cellCount + 1, 0);
+	for(int pass=0; pass<2; ++pass)
+	{
+		for(int i=count-1; i>=0; --i)
+		{
+			const GxAreai& b = index.bounds[i];
+			if(IsEmptyArea(b)) continue;
+
+			const int x0 = (b.l - area.l) / index.cellW, x1 = (b.r - 1 - area.l) / index.cellW;
+			const int y0 = (b.t - area.t) / index.cellH, y1 = (b.b - 1 - area.t) / index.cellH;
+			for(int y=y0; y<=y1; ++y)
+			{
+				for(int x=x0; x<=x1; ++x)
+				{
+					const int cell = y * index.cellsX + x;
+					if(pass == 0)
+						++cells[cell + 1];
+					else
+						index.items[index.fill[cell]++] = i;
+				}
+			}
+		}
+		if(pass == 0)
+		{
+			for(int c=0; c<cellCount; ++c)
+				cells[c + 1] += cells[c];
+			index.items.resize(cells[cellCount]);
+			index.fill.assign(cells.begin(), cells.end() - 1);
+		}
+	}
+
+	return &index;
 }
 
 }; // namespace gui
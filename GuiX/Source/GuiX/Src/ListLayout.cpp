@@ -35,7 +35,7 @@ void GxListLayout::Adjust()
 	for(int i=0; i<count; ++i)
 	{
 		GxWidget* w = myWidgets[i];
-		w->Adjust();
+		w->UpdateAdjust();
 		if(w->IsUnarranged()) continue;
 
 		GxSizePolicyResult pol(w, tr);
@@ -103,13 +103,30 @@ void GxListLayout::Arrange(GxRecti rect)
 		shrinkFactor = GxClamp(shrinkFactor, 0.f, 1.f);
 	}
 
+	// Collect the widgets that overlap the visible rectangle. In lazy mode, only the widgets
+	// within one visible rectangle size of it are arranged.
+	const bool culling = IsCulling();
+	const bool lazy = culling && myIsLazyArrange;
+	GxRecti arrangeRect = myVisibleRect;
+	arrangeRect.Expand(arrangeRect.w, arrangeRect.h, arrangeRect.w, arrangeRect.h);
+	if(culling)
+	{
+		myVisibleWidgets.Clear();
+		myIsVisibleWidgetsDirty = false;
+	}
+
 	// Assign rectangles to all children.
 	rect.Shrink(myMargin);
 	float y = (float)rect.y;
 	for(int i=0; i<count; ++i)
 	{
 		GxWidget* w = myWidgets[i];
-		if(w->IsUnarranged()) continue;
+		if(w->IsUnarranged())
+		{
+			if(culling && RectsOverlap(w->GetRect(), myVisibleRect))
+				myVisibleWidgets.Append(w);
+			continue;
+		}
 
 		GxSizePolicyResult pol(w, tr);
 
@@ -124,7 +141,12 @@ void GxListLayout::Arrange(GxRecti rect)
 		GxRecti r(rect.x, GxInt(y), rect.w, GxInt(h));
 		r.w = GxClamp(r.w, pol.min.x, pol.max.x);
 		r.h = GxClamp(r.h, pol.min.y, pol.max.y);
-		myWidgets[i]->SetRect(RectTr(tr, r));
+
+		const GxRecti widgetRect = RectTr(tr, r);
+		if(!lazy || RectsOverlap(widgetRect, arrangeRect))
+			w->UpdateRect(widgetRect);
+		if(culling && RectsOverlap(widgetRect, myVisibleRect))
+			myVisibleWidgets.Append(w);
 
 		y += h;
 		y += (float)mySpacing;
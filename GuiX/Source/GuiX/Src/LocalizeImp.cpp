@@ -1,7 +1,11 @@
 #include <GuiX/Config.h>
+
+#include <string.h>
+
 #include <GuiX/Interfaces.h>
 #include <GuiX/Resources.h>
 
+#include <Src/CoreImp.h>
 #include <Src/LocalizeImp.h>
 
 namespace {
@@ -18,6 +22,262 @@ static const char* LOC_CAT  = "category";
 namespace guix {
 namespace core {
 
+namespace {
+
+// Compiled translations files start with a header, followed by the buckets, the entries,
+// the key pool and the text pool. Every value is a 32-bit integer in native byte order.
+static const uint COMPILED_MAGIC   = 0x4C545847; // "GXTL"
+static const uint COMPILED_VERSION = 1;
+
+struct CompiledHeader
+{
+	uint magic;
+	uint version;
+	int entryCount;
+	int bucketCount;
+	int keySize;
+	int textSize;
+};
+
+struct CompiledEntry
+{
+	uint hash;
+	int key;
+	int categoryLen;
+	int nameLen;
+	int next;
+	int text;
+	int textLen;
+};
+
+// Writes size bytes to a file. Returns false if not all of them could be written.
+static bool WriteFile(GxFileHandle fp, const void* data, size_t size)
+{
+	return GxFileInterface::Get()->Write(fp, data, size) == size;
+}
+
+}; // anonymous namespace
+
+// ===================================================================================
+// GxTranslationTable
+// ===================================================================================
+
+void GxTranslationTable::Clear()
+{
+	myEntries.clear();
+	myTexts.clear();
+	myBuckets.clear();
+	myKeys.clear();
+}
+
+void GxTranslationTable::Insert(const char* category, const char* name, const GxString& text)
+{
+	const int categoryLen = GxStrLen(category), nameLen = GxStrLen(name);
+	const uint hash = Hash(category, categoryLen, name, nameLen);
+
+	const int index = myFind(category, categoryLen, name, nameLen, hash);
+	if(index >= 0)
+	{
+		myTexts[index] = text;
+		return;
+	}
+
+	if(myEntries.size() >= myBuckets.size())
+		myRehash(myBuckets.empty() ? 64 : myBuckets.size() * 2);
+
+	Entry e;
+	e.hash = hash;
+	e.key = (int)myKeys.size();
+	e.categoryLen = categoryLen;
+	e.nameLen = nameLen;
+
+	int& bucket = myBuckets[hash & (myBuckets.size() - 1)];
+	e.next = bucket;
+	bucket = (int)myEntries.size();
+
+	myKeys.insert(myKeys.end(), category, category + categoryLen + 1);
+	myKeys.insert(myKeys.end(), name, name + nameLen + 1);
+	myEntries.push_back(e);
+	myTexts.push_back(text);
+}
+
+const GxString* GxTranslationTable::Find(const char* category, const char* name) const
+{
+	if(myEntries.empty()) return NULL;
+
+	const int categoryLen = GxStrLen(category), nameLen = GxStrLen(name);
+	const int index = myFind(category, categoryLen, name, nameLen, Hash(category, categoryLen, name, nameLen));
+	return (index >= 0) ? &myTexts[index] : NULL;
+}
+
+bool GxTranslationTable::IsCompiled(const char* data, size_t size)
+{
+	uint magic;
+	if(size < sizeof(CompiledHeader)) return false;
+	memcpy(&magic, data, sizeof(uint));
+	return magic == COMPILED_MAGIC;
+}
+
+bool GxTranslationTable::LoadCompiled(const char* data, size_t size)
+{
+	CompiledHeader h;
+	if(size < sizeof(CompiledHeader)) return false;
+	memcpy(&h, data, sizeof(CompiledHeader));
+
+	// Check that every array fits in the data, before reading any of them.
+	if(h.magic != COMPILED_MAGIC || h.version != COMPILED_VERSION) return false;
+	if(h.entryCount < 0 || h.bucketCount < 0 || h.keySize < 0 || h.textSize < 0) return false;
+	if(h.bucketCount & (h.bucketCount - 1)) return false;
+	if(h.entryCount > 0 && h.bucketCount == 0) return false;
+
+	size_t remaining = size - sizeof(CompiledHeader);
+	if((size_t)h.bucketCount > remaining / sizeof(int)) return false;
+	remaining -= h.bucketCount * sizeof(int);
+	if((size_t)h.entryCount > remaining / sizeof(CompiledEntry)) return false;
+	remaining -= h.entryCount * sizeof(CompiledEntry);
+	if((size_t)h.keySize > remaining || (size_t)h.textSize > remaining - h.keySize) return false;
+
+	const int* buckets = (const int*)(data + sizeof(CompiledHeader));
+	const CompiledEntry* entries = (const CompiledEntry*)(buckets + h.bucketCount);
+	const char* keys = (const char*)(entries + h.entryCount);
+	const char* texts = keys + h.keySize;
+
+	// Every link points to an earlier entry, which guarantees that the chains end.
+	for(int i=0; i<h.bucketCount; ++i)
+		if(buckets[i] < -1 || buckets[i] >= h.entryCount) return false;
+	for(int i=0; i<h.entryCount; ++i)
+	{
+		const CompiledEntry& e = entries[i];
+		if(e.next < -1 || e.next >= i) return false;
+		if(e.key < 0 || e.key > h.keySize || e.categoryLen < 0 || e.nameLen < 0) return false;
+		const int room = h.keySize - e.key - 2;
+		if(e.categoryLen > room || e.nameLen > room - e.categoryLen) return false;
+		if(keys[e.key + e.categoryLen] || keys[e.key + e.categoryLen + e.nameLen + 1]) return false;
+		if(e.text < 0 || e.textLen < 0 || e.text > h.textSize - e.textLen) return false;
+
+		// The stored hash has to match the key, and the entry has to be in the chain of its bucket,
+		// otherwise lookups would not find it.
+		const char* category = keys + e.key;
+		if(e.hash != Hash(category, e.categoryLen, category + e.categoryLen + 1, e.nameLen)) return false;
+		if(e.next >= 0 && ((entries[e.next].hash ^ e.hash) & (h.bucketCount - 1))) return false;
+	}
+	for(int i=0; i<h.bucketCount; ++i)
+		if(buckets[i] >= 0 && (entries[buckets[i]].hash & (h.bucketCount - 1)) != (uint)i) return false;
+
+	// An empty table takes over the buckets and keys as they are; otherwise the translations are merged.
+	if(myEntries.empty())
+	{
+		myBuckets.assign(buckets, buckets + h.bucketCount);
+		myKeys.assign(keys, keys + h.keySize);
+		myEntries.resize(h.entryCount);
+		myTexts.resize(h.entryCount);
+		for(int i=0; i<h.entryCount; ++i)
+		{
+			const CompiledEntry& src = entries[i];
+			Entry& dst = myEntries[i];
+			dst.hash = src.hash;
+			dst.key = src.key;
+			dst.categoryLen = src.categoryLen;
+			dst.nameLen = src.nameLen;
+			dst.next = src.next;
+			myTexts[i].Set(texts + src.text, src.textLen);
+		}
+	}
+	else
+	{
+		for(int i=0; i<h.entryCount; ++i)
+		{
+			const CompiledEntry& e = entries[i];
+			const char* category = keys + e.key;
+			Insert(category, category + e.categoryLen + 1, GxString(texts + e.text, e.textLen));
+		}
+	}
+	return true;
+}
+
+bool GxTranslationTable::SaveCompiled(const char* path) const
+{
+	std::vector<CompiledEntry> entries(myEntries.size());
+	int textSize = 0;
+	for(size_t i=0; i<myEntries.size(); ++i)
+	{
+		const Entry& src = myEntries[i];
+		CompiledEntry& dst = entries[i];
+		dst.hash = src.hash;
+		dst.key = src.key;
+		dst.categoryLen = src.categoryLen;
+		dst.nameLen = src.nameLen;
+		dst.next = src.next;
+		dst.text = textSize;
+		dst.textLen = myTexts[i].Length();
+		textSize += dst.textLen;
+	}
+
+	CompiledHeader h;
+	h.magic = COMPILED_MAGIC;
+	h.version = COMPILED_VERSION;
+	h.entryCount = (int)myEntries.size();
+	h.bucketCount = (int)myBuckets.size();
+	h.keySize = (int)myKeys.size();
+	h.textSize = textSize;
+
+	GxFileInterface* file = GxFileInterface::Get();
+	GxFileHandle fp = file->OpenWrite(path);
+	if(!fp) return false;
+
+	bool ok = WriteFile(fp, &h, sizeof(CompiledHeader));
+	if(h.bucketCount) ok = ok && WriteFile(fp, &myBuckets[0], sizeof(int) * h.bucketCount);
+	if(h.entryCount)  ok = ok && WriteFile(fp, &entries[0], sizeof(CompiledEntry) * h.entryCount);
+	if(h.keySize)     ok = ok && WriteFile(fp, &myKeys[0], h.keySize);
+	for(size_t i=0; i<myTexts.size(); ++i)
+		ok = ok && WriteFile(fp, myTexts[i].Raw(), myTexts[i].Length());
+
+	file->Close(fp);
+	return ok;
+}
+
+uint GxTranslationTable::Hash(const char* category, int categoryLen, const char* name, int nameLen)
+{
+	// FNV-1a over the category, a null character and the name.
+	uint h = 2166136261u;
+	for(int i=0; i<categoryLen; ++i)
+		h = (h ^ (uchar)category[i]) * 16777619u;
+	h *= 16777619u;
+	for(int i=0; i<nameLen; ++i)
+		h = (h ^ (uchar)name[i]) * 16777619u;
+	return h;
+}
+
+int GxTranslationTable::myFind(const char* category, int categoryLen, const char* name, int nameLen, uint hash) const
+{
+	if(myBuckets.empty()) return -1;
+
+	int i = myBuckets[hash & (myBuckets.size() - 1)];
+	while(i >= 0)
+	{
+		const Entry& e = myEntries[i];
+		if(e.hash == hash && e.categoryLen == categoryLen && e.nameLen == nameLen)
+		{
+			const char* key = &myKeys[e.key];
+			if(memcmp(key, category, categoryLen) == 0 && memcmp(key + categoryLen + 1, name, nameLen) == 0)
+				return i;
+		}
+		i = e.next;
+	}
+	return -1;
+}
+
+void GxTranslationTable::myRehash(size_t size)
+{
+	myBuckets.assign(size, -1);
+	for(size_t i=0; i<myEntries.size(); ++i)
+	{
+		int& bucket = myBuckets[myEntries[i].hash & (size - 1)];
+		myEntries[i].next = bucket;
+		bucket = (int)i;
+	}
+}
+
 // ===================================================================================
 // GxLocalize
 // ===================================================================================
@@ -55,7 +315,7 @@ GxLocalizeImp::~GxLocalizeImp()
 
 void GxLocalizeImp::Clear()
 {
-	myCategories.clear();
+	myTable.Clear();
 }
 
 bool GxLocalizeImp::Load(const char* path_or_resource)
@@ -78,79 +338,102 @@ GxString GxLocalizeImp::Translate(const char* name)
 
 GxString GxLocalizeImp::Translate(const char* category, const char* name)
 {
-	CategoryMap::const_iterator it = myCategories.find(category);
-	if(it != myCategories.end())
+	const GxString* text = myTable.Find(category, name);
+	return text ? *text : GxString(name);
+}
+
+const GxString* GxLocalizeImp::Find(const char* category, const char* name) const
+{
+	return myTable.Find(category, name);
+}
+
+bool GxLocalizeImp::Save(const char* path) const
+{
+	if(!myTable.SaveCompiled(path))
 	{
-		TranslationMap::const_iterator jt = it->second.find(name);
-		if(jt != it->second.end())
-		{
-			return jt->second;
-		}
+		GxLog(LOG_TAG, GX_LT_ERROR, "Unable to write \"%s\"", path);
+		return false;
 	}
-	return GxString(name);
+	GxLog(LOG_TAG, GX_LT_INFO, "Saved \"%s\"", path);
+	return true;
 }
 
 bool GxLocalizeImp::myLoadFile(const char* path)
 {
-	XmlDocument doc;
-	if(!doc.Load(path, XmlDocument::CW_LEAD_AND_TRAIL))
+	size_t size = 0;
+	char* data = GxReadFile(path, size);
+	if(!data)
 	{
-		GxLog(LOG_TAG, GX_LT_ERROR, "Unable to parse xml \"%s\"", path);
+		GxLog(LOG_TAG, GX_LT_ERROR, "Unable to open \"%s\"", path);
 		return false;
 	}
 
-	myLoadDocument(&doc);
-	GxLog(LOG_TAG, GX_LT_INFO, "Loaded \"%s\"", path);
+	bool loaded;
+	if(GxTranslationTable::IsCompiled(data, size))
+	{
+		loaded = myTable.LoadCompiled(data, size);
+		if(!loaded) GxLog(LOG_TAG, GX_LT_ERROR, "Invalid compiled translations \"%s\"", path);
+	}
+	else
+	{
+		XmlTree doc;
+		loaded = doc.LoadString(data, XmlDocument::CW_LEAD_AND_TRAIL);
+		if(loaded) myLoadDocument(&doc);
+		else GxLog(LOG_TAG, GX_LT_ERROR, "Unable to parse xml \"%s\"", path);
+	}
+	GxFree(data);
 
-	return true;
+	if(loaded) GxLog(LOG_TAG, GX_LT_INFO, "Loaded \"%s\"", path);
+	return loaded;
 }
 
-void GxLocalizeImp::myLoadDocument(XmlDocument* doc)
+void GxLocalizeImp::myLoadDocument(XmlTree* doc)
 {
-	XmlElem* eLoc = doc->ChildElem(LOC_ROOT);
+	XmlTreeNode* eLoc = doc->ChildElem(LOC_ROOT);
 	if(eLoc)
 	{
-		XmlElem* eTl = eLoc->ChildElem(LOC_TL);
+		XmlTreeNode* eTl = eLoc->ChildElem(LOC_TL);
 		for(; eTl; eTl = eTl->NextElem(LOC_TL)) 
 			myParseElementTL("", eTl);
 
-		XmlElem* eCat = eLoc->ChildElem(LOC_CAT);
+		XmlTreeNode* eCat = eLoc->ChildElem(LOC_CAT);
 		for(; eCat; eCat = eCat->NextElem(LOC_CAT))
 			myParseElementCategory(eCat);
 	}
 }
 
-void GxLocalizeImp::myParseElementCategory(XmlElem* eCat)
+void GxLocalizeImp::myParseElementCategory(XmlTreeNode* eCat)
 {
 	const GxString category = eCat->GetAttribute(LOC_ID);
 	if(!category.Empty())
 	{
-		XmlElem* eTl = eCat->ChildElem(LOC_TL);
+		XmlTreeNode* eTl = eCat->ChildElem(LOC_TL);
 		for(; eTl; eTl = eTl->NextElem(LOC_TL)) 
 			myParseElementTL(category, eTl);
 	}
 }
 
-void GxLocalizeImp::myParseElementTL(const GxString& category, XmlElem* eTl)
+void GxLocalizeImp::myParseElementTL(const GxString& category, XmlTreeNode* eTl)
 {
 	const GxString name = eTl->GetAttribute(LOC_ID);
 	const GxString text = eTl->GetText();
 	if(!name.Empty() && !text.Empty())
-		myAddTranslation(category, name, text);
-}
-
-void GxLocalizeImp::myAddTranslation(const GxString& category, const GxString& name, const GxString& text)
-{
-	myCategories[category][name] = text;
+		myTable.Insert(category.Raw(), name.Raw(), text);
 }
 
 void GxLocalizeImp::LogInfo() const
 {
-	GxLog("Loaded categories: %i", myCategories.size());
+	GxStringMap<int> categories;
+	for(int i=0; i<myTable.Size(); ++i)
+		++categories[myTable.GetCategory(i)];
+
+	GxLog("Loaded categories: %i", categories.Size());
 	{
-		CategoryMap::const_iterator it = myCategories.begin();
-		for(int n=0; it != myCategories.end(); ++it, ++n)
-			GxLog("  name=\"%s\", translations=%i",  it->first.Raw(), it->second.size());
+		for(int i=0; i<categories.Size(); ++i)
+		{
+			const GxStringMap<int>::Entry& e = categories.GetEntry(i);
+			GxLog("  name=\"%s\", translations=%i",  e.key.Raw(), e.value);
+		}
 	}
 }
 
@@ -2,15 +2,74 @@
 
 #include <GuiX/Config.h>
 
-#include <map>
+#include <vector>
 
 #include <GuiX/Localize.h>
 
+#include <Src/StringMap.h>
 #include <Src/Xml.h>
 
 namespace guix {
 namespace core {
 
+// ===================================================================================
+// GxTranslationTable
+// ===================================================================================
+// Hash table that maps a category and a name to a translation. The keys of all entries
+// are stored in a single character pool, so that the table can be written to a compiled
+// translations file and read back as a few blocks of memory, without parsing xml.
+// A lookup hashes the category and name once, and does not allocate.
+
+class GxTranslationTable
+{
+public:
+	/// Removes all translations.
+	void Clear();
+
+	/// Adds a translation, or replaces the text of an existing translation.
+	void Insert(const char* category, const char* name, const GxString& text);
+
+	/// Returns the translation of name in category, or NULL if the table does not contain it.
+	const GxString* Find(const char* category, const char* name) const;
+
+	/// Returns the number of translations.
+	int Size() const {return (int)myEntries.size();}
+
+	/// Returns the category and name of the translation at index, in [0, Size()).
+	const char* GetCategory(int index) const {return &myKeys[myEntries[index].key];}
+	const char* GetName(int index) const {return &myKeys[myEntries[index].key + myEntries[index].categoryLen + 1];}
+
+	/// Returns true if data starts with the header of a compiled translations file.
+	static bool IsCompiled(const char* data, size_t size);
+
+	/// Adds the translations of a compiled translations file. Returns false if the data is not valid.
+	bool LoadCompiled(const char* data, size_t size);
+
+	/// Writes the table to a compiled translations file.
+	bool SaveCompiled(const char* path) const;
+
+	/// Returns the hash of a category and name.
+	static uint Hash(const char* category, int categoryLen, const char* name, int nameLen);
+
+private:
+	struct Entry
+	{
+		uint hash;
+		int key;
+		int categoryLen;
+		int nameLen;
+		int next;
+	};
+
+	int myFind(const char* category, int categoryLen, const char* name, int nameLen, uint hash) const;
+	void myRehash(size_t size);
+
+	std::vector<Entry> myEntries;
+	std::vector<GxString> myTexts;
+	std::vector<int> myBuckets;
+	std::vector<char> myKeys; // Category and name of every entry, both null-terminated.
+};
+
 // ===================================================================================
 // GxLocalize
 // ===================================================================================
@@ -32,19 +91,19 @@ public:
 	GxString Translate(const char* name);
 	GxString Translate(const char* category, const char* name);
 
+	const GxString* Find(const char* category, const char* name) const;
+
+	bool Save(const char* path) const;
+
 	void LogInfo() const;
 
 private:
-	typedef std::map<GxString, GxString> TranslationMap;
-	typedef std::map<GxString, TranslationMap> CategoryMap;
-	
 	bool myLoadFile(const char* path);
-	void myLoadDocument(XmlDocument* doc);
-	void myParseElementCategory(XmlElem* element);
-	void myParseElementTL(const GxString& category, XmlElem* element);
-	void myAddTranslation(const GxString& category, const GxString& name, const GxString& text);
+	void myLoadDocument(XmlTree* doc);
+	void myParseElementCategory(XmlTreeNode* element);
+	void myParseElementTL(const GxString& category, XmlTreeNode* element);
 
-	CategoryMap myCategories;
+	GxTranslationTable myTable;
 };
 
 }; // namespace core
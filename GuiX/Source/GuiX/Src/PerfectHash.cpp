@@ -0,0 +1,116 @@
+#include <GuiX/Config.h>
+
+#include <Src/PerfectHash.h>
+
+namespace guix {
+namespace core {
+
+namespace {
+
+// Bucket of hashes during the build; buckets with more hashes are placed first.
+struct Bucket
+{
+	int index, first, count;
+	bool operator < (const Bucket& b) const {return count > b.count;}
+};
+
+static const int MAX_SEED = 1 << 20;
+
+}; // anonymous namespace
+
+// ===================================================================================
+// GxPerfectHash
+// ===================================================================================
+
+GxPerfectHash::GxPerfectHash()
+	:mySize(0)
+{
+	Clear();
+}
+
+bool GxPerfectHash::Build(const uint* hashes, int count)
+{
+	Clear();
+	if(count <= 0) return true;
+
+	// Use a power of two number of buckets, with one to two hashes per bucket on average.
+	int bucketCount = 1;
+	while(bucketCount * 2 < count) bucketCount *= 2;
+	const uint mask = (uint)bucketCount - 1;
+
+	// Sort the hashes by bucket.
+	std::vector<Bucket> buckets(bucketCount);
+	for(int i=0; i<bucketCount; ++i)
+	{
+		buckets[i].index = i;
+		buckets[i].count = 0;
+	}
+	for(int i=0; i<count; ++i)
+		++buckets[Mix(hashes[i], 0) & mask].count;
+	for(int i=0, first=0; i<bucketCount; ++i)
+	{
+		buckets[i].first = first;
+		first += buckets[i].count;
+		buckets[i].count = 0;
+	}
+	std::vector<uint> sorted(count);
+	for(int i=0; i<count; ++i)
+	{
+		Bucket& b = buckets[Mix(hashes[i], 0) & mask];
+		sorted[b.first + b.count++] = hashes[i];
+	}
+	std::stable_sort(buckets.begin(), buckets.end());
+
+	mySize = count;
+	myDisplacements.assign(bucketCount, 0);
+	std::vector<char> used(count, 0);
+	std::vector<int> slots;
+
+	// Find a seed for every bucket that moves all of its hashes to free slots.
+	int b = 0;
+	for(; b<bucketCount && buckets[b].count > 1; ++b)
+	{
+		const Bucket& bucket = buckets[b];
+		const uint* h = &sorted[bucket.first];
+		int seed = 1;
+		for(; seed<MAX_SEED; ++seed)
+		{
+			slots.clear();
+			int i = 0;
+			for(; i<bucket.count; ++i)
+			{
+				const int slot = (int)(Mix(h[i], seed) % (uint)count);
+				if(used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) break;
+				slots.push_back(slot);
+			}
+			if(i == bucket.count) break;
+		}
+		if(seed == MAX_SEED)
+		{
+			Clear();
+			return false;
+		}
+		for(size_t i=0; i<slots.size(); ++i)
+			used[slots[i]] = 1;
+		myDisplacements[bucket.index] = seed;
+	}
+
+	// Buckets with a single hash take the remaining slots directly.
+	int slot = 0;
+	for(; b<bucketCount && buckets[b].count == 1; ++b)
+	{
+		while(used[slot]) ++slot;
+		used[slot] = 1;
+		myDisplacements[buckets[b].index] = -slot - 1;
+	}
+	return true;
+}
+
+void GxPerfectHash::Clear()
+{
+	myDisplacements.assign(1, 0);
+	mySize = 0;
+}
+
+}; // namespace core
+}; // namespace guix
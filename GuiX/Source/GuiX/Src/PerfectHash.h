@@ -0,0 +1,163 @@
+#pragma once
+
+#include <GuiX/Config.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <GuiX/Common.h>
+#include <GuiX/String.h>
+
+#include <Src/StringMap.h>
+
+namespace guix {
+namespace core {
+
+// ===================================================================================
+// GxPerfectHash
+// ===================================================================================
+// Minimal perfect hash function over a fixed set of distinct 32-bit hashes, built with
+// the hash and displace method. The hashes are divided over buckets, and every bucket
+// stores the displacement that moves its hashes to slots that no other hash uses.
+// Mapping a hash to its slot takes one bucket read and one integer mix.
+
+class GxPerfectHash
+{
+public:
+	GxPerfectHash();
+
+	/// Builds the function for count distinct hashes. Returns false if no function was found,
+	/// which only happens if the hashes are not distinct.
+	bool Build(const uint* hashes, int count);
+
+	/// Removes the function.
+	void Clear();
+
+	/// Returns the number of slots, which is the number of hashes the function was built for.
+	int Size() const {return mySize;}
+
+	/// Returns the slot of hash, in [0, Size()), if Size() is not zero. Hashes that were not in
+	/// the set map to an arbitrary slot, so the caller has to compare the hash stored in the slot.
+	int Slot(uint hash) const
+	{
+		const int d = myDisplacements[Mix(hash, 0) & (myDisplacements.size() - 1)];
+		return (d < 0) ? (-d - 1) : (int)(Mix(hash, d) % (uint)mySize);
+	}
+
+	/// Mixes the bits of hash with a seed.
+	static uint Mix(uint hash, uint seed)
+	{
+		hash ^= seed * 0x9E3779B9u;
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6Bu;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35u;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+private:
+	// Positive values are seeds for Mix, negative values store the slot of a single hash directly.
+	std::vector<int> myDisplacements;
+	int mySize;
+};
+
+// ===================================================================================
+// GxFrozenStringMap
+// ===================================================================================
+// Read-only copy of a GxStringMap, indexed by a minimal perfect hash of the key hashes.
+// A lookup maps the hash of the key to a slot, and compares the key of that slot only.
+// Keys that have the same 32-bit hash share a slot, and are linked to each other.
+
+template <typename T>
+class GxFrozenStringMap
+{
+public:
+	struct Entry
+	{
+		GxString key;
+		T value;
+		uint hash;
+		int next;
+	};
+
+	/// Builds the table from the entries of map. Returns false and leaves the table empty if no
+	/// perfect hash function was found for the key hashes.
+	bool Build(const GxStringMap<T>& map)
+	{
+		Clear();
+
+		std::vector<uint> hashes(map.Size());
+		for(int i=0; i<map.Size(); ++i)
+			hashes[i] = map.GetEntry(i).hash;
+		if(hashes.empty()) return true;
+
+		std::sort(hashes.begin(), hashes.end());
+		hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+		if(!myHash.Build(&hashes[0], (int)hashes.size()))
+			return false;
+
+		// The first key of every hash is stored in its slot, other keys are appended and linked.
+		myEntries.resize(hashes.size());
+		for(size_t i=0; i<myEntries.size(); ++i)
+			myEntries[i].next = EMPTY;
+		for(int i=0; i<map.Size(); ++i)
+		{
+			const typename GxStringMap<T>::Entry& src = map.GetEntry(i);
+			Entry e;
+			e.key = src.key;
+			e.value = src.value;
+			e.hash = src.hash;
+			e.next = -1;
+
+			Entry& first = myEntries[myHash.Slot(src.hash)];
+			if(first.next == EMPTY)
+			{
+				first = e;
+			}
+			else
+			{
+				e.next = first.next;
+				first.next = (int)myEntries.size();
+				myEntries.push_back(e);
+			}
+		}
+		return true;
+	}
+
+	/// Removes all entries.
+	void Clear()
+	{
+		myEntries.clear();
+		myHash.Clear();
+	}
+
+	/// Returns the value of the first n characters of key, using a hash computed in advance by
+	/// \c GxString::Hash(), or NULL if the map does not contain key.
+	const T* Find(const char* key, int n, uint hash) const
+	{
+		if(myEntries.empty()) return NULL;
+
+		const Entry* e = &myEntries[myHash.Slot(hash)];
+		if(e->hash != hash) return NULL;
+		while(true)
+		{
+			if(e->key.Length() == n && memcmp(e->key.Raw(), key, n) == 0) return &e->value;
+			if(e->next < 0) return NULL;
+			e = &myEntries[e->next];
+		}
+	}
+
+	int Size() const {return (int)myEntries.size();} ///< Returns the number of entries.
+
+private:
+	enum {EMPTY = -2};
+
+	GxPerfectHash myHash;
+	std::vector<Entry> myEntries;
+};
+
+}; // namespace core
+}; // namespace guix
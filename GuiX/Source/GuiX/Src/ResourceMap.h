@@ -6,6 +6,8 @@
 
 #include <GuiX/String.h>
 
+#include <Src/StringMap.h>
+
 namespace guix {
 namespace core {
 
@@ -23,7 +25,7 @@ public:
 		Handle handle;
 	};
 
-	typedef std::map<GxString, Handle> FileMap;
+	typedef GxStringMap<Handle> FileMap;
 	typedef std::map<Handle, Ref> LoadMap;
 
 	FileMap files;
@@ -41,7 +43,7 @@ public:
 
 	void Insert(Handle handle, Data data, const char* path)
 	{
-		if(!files.insert(std::make_pair(path, handle)).second)
+		if(!files.Insert(path, handle))
 			GxLog(logTag, GX_LT_WARNING, "Failed to insert file \"%s\"", path);
 
 		Insert(handle, data);
@@ -62,7 +64,7 @@ public:
 	{
 		if(handle)
 		{
-			LoadMap::iterator it = loaded.find(handle);
+			typename LoadMap::iterator it = loaded.find(handle);
 			if(it != loaded.end())
 				++it->second.count;
 			else
@@ -72,10 +74,10 @@ public:
 
 	Ref* GetData(const char* path)
 	{
-		FileMap::iterator itf = files.find(path);
-		if(itf != files.end())
+		const Handle* handle = files.Find(path);
+		if(handle)
 		{
-			LoadMap::iterator it = loaded.find(itf->second);
+			typename LoadMap::iterator it = loaded.find(*handle);
 			if(it != loaded.end())
 				return &it->second;
 		}
@@ -84,7 +86,7 @@ public:
 
 	Ref* GetData(Handle handle)
 	{
-		LoadMap::iterator it = loaded.find(handle);
+		typename LoadMap::iterator it = loaded.find(handle);
 		return (it == loaded.end()) ? NULL : &it->second;
 	}
 
@@ -92,7 +94,7 @@ public:
 	{
 		if(!handle) return NULL;
 
-		LoadMap::iterator it = loaded.find(handle);
+		typename LoadMap::iterator it = loaded.find(handle);
 		if(it != loaded.end())
 		{
 			--it->second.count;
@@ -108,7 +110,7 @@ public:
 
 	bool Erase(Handle handle)
 	{
-		LoadMap::iterator it = loaded.find(handle);
+		typename LoadMap::iterator it = loaded.find(handle);
 		if(it == loaded.end())
 		{
 			GxLog(logTag, GX_LT_WARNING, "Erasing invalid handle %i", handle);
@@ -116,12 +118,14 @@ public:
 		}
 		loaded.erase(it);
 
-		FileMap::const_iterator rem = files.begin();
-		while(rem != files.end() && rem->second != handle)
-			++rem;
-
-		if(rem != files.end())
-			files.erase(rem);
+		for(int i=0; i<files.Size(); ++i)
+		{
+			if(files.GetEntry(i).value == handle)
+			{
+				files.Erase(files.GetEntry(i).key);
+				break;
+			}
+		}
 
 		return true;
 	}
@@ -18,6 +18,24 @@ static const char* XML_RES_TRL   = "translations";
 
 }; // anonymous namespace
 
+// ===================================================================================
+// GxResources::Id
+// ===================================================================================
+
+GxResources::Id::Id(const char* name)
+	:name(name)
+	,length(GxStrLen(name))
+	,hash(GxString::Hash(name, length))
+{
+}
+
+GxResources::Id::Id(const GxString& name)
+	:name(name.Raw())
+	,length(name.Length())
+	,hash(name.Hash())
+{
+}
+
 // ===================================================================================
 // GxResourcesImp
 // ===================================================================================
@@ -45,6 +63,7 @@ void GxResourcesImp::Destroy()
 }
 
 GxResourcesImp::GxResourcesImp()
+	:myIsFrozen(false)
 {
 }
 
@@ -55,7 +74,7 @@ GxResourcesImp::~GxResourcesImp()
 bool GxResourcesImp::Load(const char* path)
 {
 	// Load the XML document.
-	XmlDocument doc;
+	XmlTree doc;
 	if(!doc.Load(path))
 	{
 		GxLog(LOG_TAG, GX_LT_ERROR, "Failed to open resources file \"%s\"", path);
@@ -63,7 +82,7 @@ bool GxResourcesImp::Load(const char* path)
 	}
 
 	// Check if the XML sturcture has a resources element.
-	XmlElem* resources = doc.ChildElem(XML_RESOURCES);
+	XmlTreeNode* resources = doc.ChildElem(XML_RESOURCES);
 	if(!resources)
 	{
 		GxLog(LOG_TAG, GX_LT_ERROR, "Resources file \"%s\" does not have a <%s> node", path, XML_RESOURCES);
@@ -71,12 +90,12 @@ bool GxResourcesImp::Load(const char* path)
 	}
 
 	// Load texture resources.
-	XmlElem* n = resources->ChildElem(XML_RES_TEX);
+	XmlTreeNode* n = resources->ChildElem(XML_RES_TEX);
 	for(; n; n = n->NextElem(XML_RES_TEX))
 	{
 		TextureRes res;
 		GxString id = n->GetAttribute("id");
-		XmlElem* path = n->ChildElem("path");
+		XmlTreeNode* path = n->ChildElem("path");
 		if(path) res.path = path->GetText();
 		myTextures[id] = res;
 	}
@@ -87,7 +106,7 @@ bool GxResourcesImp::Load(const char* path)
 	{
 		FontRes res;
 		GxString id = n->GetAttribute("id");
-		XmlElem* path = n->ChildElem("path");
+		XmlTreeNode* path = n->ChildElem("path");
 		if(path) res.path = path->GetText();
 		myFonts[id] = res;
 	}
@@ -99,7 +118,7 @@ bool GxResourcesImp::Load(const char* path)
 		TranslationsRes res;
 		GxString id = n->GetAttribute("id");
 
-		XmlElem* xmlpath = n->ChildElem("path");
+		XmlTreeNode* xmlpath = n->ChildElem("path");
 		while(xmlpath)
 		{
 			res.paths.Append(xmlpath->GetText());
@@ -109,33 +128,67 @@ bool GxResourcesImp::Load(const char* path)
 		myTranslations[id] = res;
 	}
 
+	if(myIsFrozen) myFreeze();
+
 	// Loading succesfully completes.
 	GxLog(LOG_TAG, GX_LT_INFO, "Loaded \"%s\"", path);
 	return true;
 }
 
-bool GxResourcesImp::GetResource(const char* id, TextureRes& out)
+void GxResourcesImp::SetFrozen(bool frozen)
+{
+	if(frozen == myIsFrozen) return;
+	myIsFrozen = frozen;
+	if(frozen)
+	{
+		myFreeze();
+	}
+	else
+	{
+		myFrozenTextures.Clear();
+		myFrozenFonts.Clear();
+		myFrozenTranslations.Clear();
+	}
+}
+
+bool GxResourcesImp::IsFrozen() const
+{
+	return myIsFrozen;
+}
+
+template <typename T>
+bool GxResourcesImp::myFind(const GxStringMap<T>& map, const GxFrozenStringMap<T>& frozen, bool isFrozen, const Id& id, T& out)
+{
+	// A frozen table without entries was built from an empty map or could not be built, see myFreeze.
+	const bool useFrozen = isFrozen && frozen.Size() > 0;
+	const T* res = useFrozen ? frozen.Find(id.name, id.length, id.hash) : map.Find(id.name, id.length, id.hash);
+	if(res) out = *res;
+	return res != NULL;
+}
+
+bool GxResourcesImp::GetResource(const Id& id, TextureRes& out)
+{
+	return myFind(myTextures, myFrozenTextures, myIsFrozen, id, out);
+}
+
+bool GxResourcesImp::GetResource(const Id& id, FontRes& out)
 {
-	TexMap::const_iterator it = myTextures.find(id);
-	bool valid = (it != myTextures.end());
-	if(valid) out = it->second;
-	return valid;
+	return myFind(myFonts, myFrozenFonts, myIsFrozen, id, out);
 }
 
-bool GxResourcesImp::GetResource(const char* id, FontRes& out)
+bool GxResourcesImp::GetResource(const Id& id, TranslationsRes& out)
 {
-	FntMap::const_iterator it = myFonts.find(id);
-	bool valid = (it != myFonts.end());
-	if(valid) out = it->second;
-	return valid;
+	return myFind(myTranslations, myFrozenTranslations, myIsFrozen, id, out);
 }
 
-bool GxResourcesImp::GetResource(const char* id, TranslationsRes& out)
+void GxResourcesImp::myFreeze()
 {
-	TrlMap::const_iterator it = myTranslations.find(id);
-	bool valid = (it != myTranslations.end());
-	if(valid) out = it->second;
-	return valid;
+	// Tables that could not be built are left empty, and their lookups use the regular maps.
+	bool built = myFrozenTextures.Build(myTextures);
+	built &= myFrozenFonts.Build(myFonts);
+	built &= myFrozenTranslations.Build(myTranslations);
+	if(!built)
+		GxLog(LOG_TAG, GX_LT_WARNING, "Could not build the frozen resource tables, using the regular tables");
 }
 
 }; // namespace core
@@ -2,7 +2,8 @@
 
 #include <GuiX/Resources.h>
 
-#include <map>
+#include <Src/StringMap.h>
+#include <Src/PerfectHash.h>
 
 namespace guix {
 namespace core {
@@ -23,18 +24,31 @@ public:
 	~GxResourcesImp();
 
 	bool Load(const char* path);
-	bool GetResource(const char* id, TextureRes& out);
-	bool GetResource(const char* id, FontRes& out);
-	bool GetResource(const char* id, TranslationsRes& out);
+	void SetFrozen(bool frozen);
+	bool IsFrozen() const;
+	bool GetResource(const Id& id, TextureRes& out);
+	bool GetResource(const Id& id, FontRes& out);
+	bool GetResource(const Id& id, TranslationsRes& out);
 
 private:
-	typedef std::map<GxString, TextureRes>      TexMap;
-	typedef std::map<GxString, FontRes>         FntMap;
-	typedef std::map<GxString, TranslationsRes> TrlMap;
+	typedef GxStringMap<TextureRes>      TexMap;
+	typedef GxStringMap<FontRes>         FntMap;
+	typedef GxStringMap<TranslationsRes> TrlMap;
+
+	template <typename T>
+	static bool myFind(const GxStringMap<T>& map, const GxFrozenStringMap<T>& frozen, bool isFrozen, const Id& id, T& out);
+
+	void myFreeze();
 
 	TexMap myTextures;
 	FntMap myFonts;
 	TrlMap myTranslations;
+
+	// Copies of the maps indexed by a perfect hash, which are only built in frozen mode.
+	GxFrozenStringMap<TextureRes>      myFrozenTextures;
+	GxFrozenStringMap<FontRes>         myFrozenFonts;
+	GxFrozenStringMap<TranslationsRes> myFrozenTranslations;
+	bool myIsFrozen;
 };
 
 }; // namespace graphics
@@ -88,7 +88,7 @@ static inline int iCmp(const char* a, const char* b)
 // ===================================================================================
 
 #ifdef GX_STRING_DEBUG
-	#define GX_ASSERT_VALID				if(s::Len(myStr) != myLen) __asm { int 3 };
+	#define GX_ASSERT_VALID				if(s::Len(Raw()) != myLen) __asm { int 3 };
 	#define GX_STRING_TAG(ref,a,b,c,d)	(ref->tag = (d<<24)|(c<<16)|(b<<8)|(a))
 #else
 	#define GX_ASSERT_VALID
@@ -101,11 +101,12 @@ struct Ref
 	uint tag;
 #endif
 	size_t reserved;
-	size_t count;
+	long count;
 };
 
-static char _null[sizeof(Ref) + 4] = {0};
-static char* null = _null + sizeof(Ref);
+// Number of heap blocks that have been allocated by strings; see GxStringHeapAllocations().
+// It is counted like a reference, so it is atomic when strings can be shared between threads.
+static long allocations = 0;
 
 /// Inline functions.
 
@@ -119,6 +120,7 @@ static inline char* NewRef(size_t len)
 	Ref* ref = static_cast<Ref*>(malloc(sizeof(Ref) + len + 1));
 	ref->reserved = len;
 	ref->count = 1;
+	GxRefIncrement(&allocations);
 	GX_STRING_TAG(ref, 'G','x','S','n');
 	return reinterpret_cast<char*>(ref + 1);
 }
@@ -127,69 +129,125 @@ static inline char* ReallocRef(Ref& src, size_t len)
 {
 	Ref* ref = static_cast<Ref*>(realloc(&src, sizeof(Ref) + len + 1));
 	ref->reserved = len;
+	GxRefIncrement(&allocations);
 	GX_STRING_TAG(ref, 'G','x','S','r');
 	return reinterpret_cast<char*>(ref + 1);
 }
 
 /// Utility functions.
 
-static void Detach(char*& str, size_t len)
+static void AddRef(char* str)
+{
+	Ref& ref = s::ToRef(str);
+	GxRefIncrement(&ref.count);
+}
+
+static void Release(char* str)
 {
 	Ref& ref = s::ToRef(str);
-	if(ref.count > 1)
+	if(GxRefDecrement(&ref.count) <= 0)
+		free(&ref);
+}
+
+}; // namespace s
+
+int GxStringHeapAllocations()
+{
+	return (int)GxRefLoad(&s::allocations);
+}
+
+// ===================================================================================
+// Storage functions
+// ===================================================================================
+
+// Returns a pointer to the content that can be modified, without changing the capacity.
+char* GxString::myWrite()
+{
+	myHash = 0;
+	if(!myBuf[SSO_FLAG]) return myBuf;
+
+	// Shared characters are copied before they are released.
+	if(GxRefLoad(&s::ToRef(myStr).count) > 1)
 	{
-		--ref.count;
-		char* mem = s::NewRef(len);
-		memcpy(mem, str, len + 1);
-		str = mem;
+		char* mem = s::NewRef(myLen);
+		memcpy(mem, myStr, myLen + 1);
+		s::Release(myStr);
+		myStr = mem;
 	}
+	return myStr;
 }
 
-static void Realloc(char*& str, size_t len, size_t n)
+// Returns a pointer to the content that can be modified, with room for at least n characters.
+// The first min(myLen, n) characters of the content are preserved.
+char* GxString::myGrow(int n)
 {
-	Ref& ref = s::ToRef(str);
-	if(ref.count == 1)
+	myHash = 0;
+	if(!myBuf[SSO_FLAG])
 	{
-		if(ref.reserved < n)
-		{
-			n = s::Max(n, ref.reserved << 1);
-			str = s::ReallocRef(ref, n);
-		}
+		if(n <= SSO_CAPACITY) return myBuf;
+
+		char* mem = s::NewRef(n);
+		memcpy(mem, myBuf, myLen + 1);
+		myStr = mem;
+		myBuf[SSO_FLAG] = 1;
+		return mem;
 	}
-	else if(ref.count == 0)
+
+	s::Ref& ref = s::ToRef(myStr);
+	if(GxRefLoad(&ref.count) == 1)
 	{
-		str = s::NewRef(n);
+		if(ref.reserved < (size_t)n)
+		{
+			const size_t reserve = s::Max(n, (int)(ref.reserved << 1));
+			myStr = s::ReallocRef(ref, reserve);
+		}
 	}
 	else
 	{
-		--ref.count;
-		len = s::Min(len, n);
+		const int len = s::Min(myLen, n);
 		char* mem = s::NewRef(n);
-		memcpy(mem, str, len + 1);
-		str = mem;
+		memcpy(mem, myStr, len);
+		mem[len] = 0;
+		s::Release(myStr);
+		myStr = mem;
 	}
+	return myStr;
 }
 
-static void AddRef(char* str)
+// Releases the heap data, if any, and sets the content to an empty string.
+void GxString::myFree()
 {
-	if(str != s::null)
+	if(myBuf[SSO_FLAG])
 	{
-		Ref& ref = s::ToRef(str);
-		++ref.count;
+		s::Release(myStr);
+		myBuf[SSO_FLAG] = 0;
 	}
+	myBuf[0] = 0;
+	myLen = 0;
+	myHash = 0;
 }
 
-static void Release(char* str)
+// Returns true if str points into the content, which is invalidated when the string grows.
+bool GxString::myContains(const char* str) const
 {
-	if(str != s::null)
-	{
-		Ref& ref = s::ToRef(str);
-		if(--ref.count <= 0)
-			free(&ref);
-	}
+	const char* raw = Raw();
+	return str >= raw && str <= raw + myLen;
 }
 
-}; // namespace s
+uint GxString::myComputeHash() const
+{
+	myHash = Hash(Raw(), myLen);
+	return myHash;
+}
+
+uint GxString::Hash(const char* str, int n)
+{
+	// FNV-1a; zero is reserved to mark a hash that has not been computed.
+	uint h = 2166136261u;
+	for(int i=0; i<n; ++i)
+		h = (h ^ (uchar)str[i]) * 16777619u;
+	return h ? h : 1;
+}
 
 // ===================================================================================
 // StringArg
@@ -214,70 +272,74 @@ const int GxString::npos()
 GxString::~GxString()
 {
 	GX_ASSERT_VALID;
-	s::Release(myStr);
+	if(myBuf[SSO_FLAG])
+		s::Release(myStr);
 }
 
 GxString::GxString()
-	:myStr(s::null)
-	,myLen(0)
+	:myLen(0)
+	,myHash(0)
 {
+	myBuf[0] = 0;
+	myBuf[SSO_FLAG] = 0;
 }
 
 GxString::GxString(int reserve)
-	:myStr(s::null)
-	,myLen(0)
+	:myLen(0)
+	,myHash(0)
 {
-	if(reserve > 0)
+	myBuf[0] = 0;
+	myBuf[SSO_FLAG] = 0;
+	if(reserve > SSO_CAPACITY)
 	{
 		myStr = s::NewRef(reserve);
 		myStr[0] = 0;
+		myBuf[SSO_FLAG] = 1;
 	}
 }
 
 GxString::GxString(char c, int n)
-	:myStr(s::null)
-	,myLen(0)
+	:myLen(0)
+	,myHash(0)
 {
+	myBuf[0] = 0;
+	myBuf[SSO_FLAG] = 0;
 	Set(c, n);
 }
 
 GxString::GxString(const char* str)
-	:myStr(s::null)
-	,myLen(0)
+	:myLen(0)
+	,myHash(0)
 {
-	const int len = s::Len(str);
-	if(len > 0)
-	{
-		myStr = s::NewRef(len);
-		memcpy(myStr, str, len + 1);
-		myLen = len;
-	}
+	myBuf[0] = 0;
+	myBuf[SSO_FLAG] = 0;
+	Set(str, s::Len(str));
 }
 
 GxString::GxString(const char* str, int n)
-	:myStr(s::null)
-	,myLen(0)
+	:myLen(0)
+	,myHash(0)
 {
-	if(n > 0)
-	{
-		myStr = s::NewRef(n);
-		memcpy(myStr, str, n);
-		myStr[n] = 0;
-		myLen = n;
-	}
+	myBuf[0] = 0;
+	myBuf[SSO_FLAG] = 0;
+	Set(str, n);
 }
 
 GxString::GxString(const GxString& str)
-	:myStr(str.myStr)
-	,myLen(str.myLen)
+	:myLen(str.myLen)
+	,myHash(str.myHash)
 {
-	s::AddRef(myStr);
+	memcpy(myBuf, str.myBuf, sizeof(myBuf));
+	if(myBuf[SSO_FLAG])
+		s::AddRef(myStr);
 }
 
 GxString::GxString(const GxString& str, int pos, int n)
-	:myStr(s::null)
-	,myLen(0)
+	:myLen(0)
+	,myHash(0)
 {
+	myBuf[0] = 0;
+	myBuf[SSO_FLAG] = 0;
 	if(pos < 0)
 	{
 		n += pos;
@@ -289,11 +351,7 @@ GxString::GxString(const GxString& str, int pos, int n)
 	}
 	else if(pos < str.myLen && n > 0)
 	{
-		const int len = s::Min(n, str.myLen - pos);
-		myStr = s::NewRef(len);
-		memcpy(myStr, str.myStr + pos, len);
-		myStr[len] = 0;
-		myLen = len;
+		Set(str.Raw() + pos, s::Min(n, str.myLen - pos));
 	}
 }
 
@@ -305,10 +363,10 @@ void GxString::Set(char c, int n)
 {
 	if(n > 0)
 	{
-		s::Realloc(myStr, myLen, n);
-		memset(myStr, c, n);
+		char* str = myGrow(n);
+		memset(str, c, n);
 		myLen = c ? n : 0;
-		myStr[n] = 0;
+		str[n] = 0;
 	}
 	else Clear();
 }
@@ -320,26 +378,49 @@ void GxString::Set(const char* str)
 
 void GxString::Set(const char* str, int n)
 {
-	if(myStr == str) return;
+	if(Raw() == str && myLen == n) return;
 
-	if(n > 0)
+	if(n <= 0)
+	{
+		Clear();
+	}
+	else if(myContains(str))
+	{
+		Set(GxString(str, n));
+	}
+	else if(n <= SSO_CAPACITY)
 	{
-		s::Realloc(myStr, myLen, n);
-		memcpy(myStr, str, n);
-		myStr[n] = 0;
+		// Short strings go inline, which releases any heap data.
+		char* heap = myBuf[SSO_FLAG] ? myStr : NULL;
+		memcpy(myBuf, str, n);
+		myBuf[n] = 0;
+		myBuf[SSO_FLAG] = 0;
+		myLen = n;
+		myHash = 0;
+		if(heap) s::Release(heap);
+	}
+	else
+	{
+		char* dst = myGrow(n);
+		memcpy(dst, str, n);
+		dst[n] = 0;
 		myLen = n;
 	}
-	else Clear();
 }
 
 void GxString::Set(const GxString& str)
 {
-	if(myStr == str.myStr) return;
+	if(this == &str) return;
+	if(myBuf[SSO_FLAG] && str.myBuf[SSO_FLAG] && myStr == str.myStr) return;
+
+	if(myBuf[SSO_FLAG])
+		s::Release(myStr);
 
-	s::Release(myStr);
-	myStr = str.myStr;
+	memcpy(myBuf, str.myBuf, sizeof(myBuf));
 	myLen = str.myLen;
-	s::AddRef(myStr);	
+	myHash = str.myHash;
+	if(myBuf[SSO_FLAG])
+		s::AddRef(myStr);
 }
 
 // ===================================================================================
@@ -351,21 +432,26 @@ void GxString::Append(char c)
 	if(c)
 	{
 		const int len = myLen + 1;
-		s::Realloc(myStr, myLen, len);
-		myStr[myLen] = c;
-		myStr[len] = 0;
+		char* str = myGrow(len);
+		str[myLen] = c;
+		str[len] = 0;
 		myLen = len;
 	}
 }
 
-void GxString::Append(GxStringArg str)
+void GxString::Append(GxStringArg arg)
 {
-	if(str.len > 0)
+	if(arg.len > 0)
 	{
-		const int len = myLen + str.len;
-		s::Realloc(myStr, myLen, len);
-		memcpy(myStr + myLen, str.ptr, str.len);
-		myStr[len] = 0;
+		if(myContains(arg.ptr))
+		{
+			Append(GxString(arg.ptr, arg.len));
+			return;
+		}
+		const int len = myLen + arg.len;
+		char* str = myGrow(len);
+		memcpy(str + myLen, arg.ptr, arg.len);
+		str[len] = 0;
 		myLen = len;
 	}
 }
@@ -379,21 +465,26 @@ void GxString::Prepend(char c)
 	if(c)
 	{
 		const int len = myLen + 1;
-		s::Realloc(myStr, myLen, len);
-		memmove(myStr + 1, myStr, myLen + 1);
-		myStr[0] = c;
+		char* str = myGrow(len);
+		memmove(str + 1, str, myLen + 1);
+		str[0] = c;
 		myLen = len;
 	}
 }
 
-void GxString::Prepend(GxStringArg str)
+void GxString::Prepend(GxStringArg arg)
 {
-	if(str.len > 0)
+	if(arg.len > 0)
 	{
-		const int len = myLen + str.len;
-		s::Realloc(myStr, myLen, len);
-		memmove(myStr + str.len, myStr, myLen + 1);
-		memcpy(myStr, str.ptr, str.len);
+		if(myContains(arg.ptr))
+		{
+			Prepend(GxString(arg.ptr, arg.len));
+			return;
+		}
+		const int len = myLen + arg.len;
+		char* str = myGrow(len);
+		memmove(str + arg.len, str, myLen + 1);
+		memcpy(str, arg.ptr, arg.len);
 		myLen = len;
 	}
 }
@@ -411,25 +502,30 @@ void GxString::Insert(int pos, char c)
 	else if(c)
 	{
 		const int len = myLen + 1;
-		s::Realloc(myStr, myLen, len);
-		memmove(myStr + pos + 1, myStr + pos, myLen + 1 - pos);
-		myStr[pos] = c;
+		char* str = myGrow(len);
+		memmove(str + pos + 1, str + pos, myLen + 1 - pos);
+		str[pos] = c;
 		myLen = len;
 	}
 }
 
-void GxString::Insert(int pos, GxStringArg str)
+void GxString::Insert(int pos, GxStringArg arg)
 {
 	if(pos >= myLen)
-		Append(str);
+		Append(arg);
 	else if(pos <= 0)
-		Prepend(str);
-	else if(str.len > 0)
+		Prepend(arg);
+	else if(arg.len > 0)
 	{
-		const int len = myLen + str.len;
-		s::Realloc(myStr, myLen, len);
-		memmove(myStr + pos + str.len, myStr + pos, myLen + 1 - pos);
-		memcpy(myStr + pos, str.ptr, str.len);
+		if(myContains(arg.ptr))
+		{
+			Insert(pos, GxString(arg.ptr, arg.len));
+			return;
+		}
+		const int len = myLen + arg.len;
+		char* str = myGrow(len);
+		memmove(str + pos + arg.len, str + pos, myLen + 1 - pos);
+		memcpy(str + pos, arg.ptr, arg.len);
 		myLen = len;
 	}
 }
@@ -593,7 +689,7 @@ GxString& GxString::Arg(GxStringArg v)
 
 int GxString::ToInt() const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	int num = 0;
 	ss >> num;
 	return num;
@@ -601,7 +697,7 @@ int GxString::ToInt() const
 
 uint GxString::ToUint() const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	uint num = 0;
 	ss >> num;
 	return num;
@@ -609,7 +705,7 @@ uint GxString::ToUint() const
 
 float GxString::ToFloat() const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	float num = 0;
 	ss >> num;
 	return num;
@@ -617,7 +713,7 @@ float GxString::ToFloat() const
 
 double GxString::ToDouble() const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	double num = 0;
 	ss >> num;
 	return num;
@@ -625,9 +721,9 @@ double GxString::ToDouble() const
 
 bool GxString::ToBool() const
 {
-	const char c = *myStr;
+	const char c = *Raw();
 
-	if(s::iEq(myStr, "true") || ((myLen==1) && (c=='T' || c=='t' || c=='1')))
+	if(s::iEq(Raw(), "true") || ((myLen==1) && (c=='T' || c=='t' || c=='1')))
 		return true;
 
 	return false;
@@ -635,40 +731,40 @@ bool GxString::ToBool() const
 
 bool GxString::ToInt(int& out) const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	ss >> out;
 	return !ss.fail();
 }
 
 bool GxString::ToUint(uint& out) const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	ss >> out;
 	return !ss.fail();
 }
 
 bool GxString::ToFloat(float& out) const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	ss >> out;
 	return !ss.fail();
 }
 
 bool GxString::ToDouble(double& out) const
 {
-	std::istringstream ss(myStr);
+	std::istringstream ss(Raw());
 	ss >> out;
 	return !ss.fail();
 }
 
 bool GxString::ToBool(bool& out) const
 {
-	const char c = *myStr;
+	const char c = *Raw();
 
-	if(s::iEq(myStr, "true") || ((myLen==1) && (c=='T' || c=='t' || c=='1')))
+	if(s::iEq(Raw(), "true") || ((myLen==1) && (c=='T' || c=='t' || c=='1')))
 		{out = true; return true;}
 
-	if(s::iEq(myStr, "false") || ((myLen==1) && (c=='F' || c=='f' || c=='0')))
+	if(s::iEq(Raw(), "false") || ((myLen==1) && (c=='F' || c=='f' || c=='0')))
 		{out = false; return true;}
 
 	return false;
@@ -680,9 +776,7 @@ bool GxString::ToBool(bool& out) const
 
 void GxString::Clear()
 {
-	s::Release(myStr);
-	myStr = s::null;
-	myLen = 0;
+	myFree();
 }
 
 void GxString::Chop(int n)
@@ -691,9 +785,9 @@ void GxString::Chop(int n)
 		Clear();
 	else if(n > 0)
 	{
-		s::Detach(myStr, myLen);
+		char* str = myWrite();
 		myLen -= n;
-		myStr[myLen] = 0;
+		str[myLen] = 0;
 	}
 }
 
@@ -703,23 +797,21 @@ void GxString::Truncate(int n)
 		Clear();
 	else if(myLen > n)
 	{
-		s::Detach(myStr, myLen);
+		char* str = myWrite();
 		myLen = n;
-		myStr[myLen] = 0;
+		str[myLen] = 0;
 	}
 }
 
 void GxString::MakeUpper()
 {
-	s::Detach(myStr, myLen);
-	for(char* p = myStr; *p; ++p)
+	for(char* p = myWrite(); *p; ++p)
 		*p = toupper(*p);
 }
 
 void GxString::MakeLower()
 {
-	s::Detach(myStr, myLen);
-	for(char* p = myStr; *p; ++p)
+	for(char* p = myWrite(); *p; ++p)
 		*p = tolower(*p);
 }
 
@@ -734,23 +826,23 @@ void GxString::Erase(int pos, int n)
 	}
 	else if(pos < myLen && n > 0)
 	{
-		s::Detach(myStr, myLen);
+		char* str = myWrite();
 		n = s::Min(n, myLen - pos);
-		memmove(myStr + pos, myStr + pos + n, myLen + 1 - pos - n);  
+		memmove(str + pos, str + pos + n, myLen + 1 - pos - n);  
 		myLen -= n;
 	}
 }
 
 void GxString::Replace(char find, char replace)
 {
-	s::Detach(myStr, myLen);
+	char* str = myWrite();
 
-	for(char* p = myStr; *p; ++p)
+	for(char* p = str; *p; ++p)
 		if(*p == find)
 			*p = replace;
 
 	if(replace == 0)
-		myLen = s::Len(myStr);
+		myLen = s::Len(str);
 }
 
 void GxString::Replace(GxStringArg find, GxStringArg replace)
@@ -758,7 +850,7 @@ void GxString::Replace(GxStringArg find, GxStringArg replace)
 	int offset = First(find);
 	if(offset != _npos)
 	{
-		GxString result(myStr, offset);
+		GxString result(Raw(), offset);
 		result.Append(replace);
 		offset += find.len;
 
@@ -767,12 +859,12 @@ void GxString::Replace(GxStringArg find, GxStringArg replace)
 			int pos = First(find, offset);
 			if(pos == _npos)
 			{
-				result.Append(myStr + offset);
+				result.Append(Raw() + offset);
 				offset = _npos;
 			}
 			else
 			{
-				result.Append(GxStringArg(myStr + offset, pos - offset));
+				result.Append(GxStringArg(Raw() + offset, pos - offset));
 				result.Append(replace);
 				offset = pos + find.len;
 			}
@@ -794,14 +886,14 @@ GxString GxString::Substr(int pos, int n) const
 int GxString::NextChar(int pos)
 {
 	if(pos < myLen)
-		do {++pos;} while(pos < myLen && (myStr[pos] & 0xC0) == 0x80);
+		do {++pos;} while(pos < myLen && (Raw()[pos] & 0xC0) == 0x80);
 	return pos;
 }
 
 int GxString::PrevChar(int pos)
 {
 	if(pos > 0)
-		do {--pos;} while(pos > 0 && (myStr[pos] & 0xC0) == 0x80);
+		do {--pos;} while(pos > 0 && (Raw()[pos] & 0xC0) == 0x80);
 	return pos;
 }
 
@@ -813,14 +905,14 @@ int GxString::First(GxStringArg key, int pos) const
 	const char* str = key.ptr;
 	if(pos < myLen && pos + key.len <= myLen)
 	{
-		const char* end = myStr + myLen - key.len + 1;
-		for(const char* ptr = myStr + pos; ptr != end; ++ptr)
+		const char* end = Raw() + myLen - key.len + 1;
+		for(const char* ptr = Raw() + pos; ptr != end; ++ptr)
 		{
 			if(*ptr == *str)
 			{
 				int i = 1;
 				while(i < key.len && ptr[i] == str[i]) ++i;
-				if(i == key.len) return (int)(ptr - myStr);
+				if(i == key.len) return (int)(ptr - Raw());
 			}
 		}
 	}
@@ -831,14 +923,14 @@ int GxString::First(GxStringArg key, int pos) const
 int GxString::First(char c, int pos) const
 {
 	pos = s::Max(pos, 0);
-	while(pos < myLen && myStr[pos] != c) ++pos;
+	while(pos < myLen && Raw()[pos] != c) ++pos;
 	return (pos < myLen) ? pos : _npos;
 }
 
 int GxString::Last(char c, int pos) const
 {
 	pos = s::Min(pos, myLen-1);
-	while(pos >= 0 && myStr[pos] != c) --pos;
+	while(pos >= 0 && Raw()[pos] != c) --pos;
 	return (pos >= 0) ? pos : -1;
 }
 
@@ -847,7 +939,7 @@ int GxString::FirstAny(const char* c, int pos) const
 	pos = s::Max(pos, 0);
 	while(pos < myLen)
 	{
-		const char a = myStr[pos];
+		const char a = Raw()[pos];
 		const char* b = c;
 		while(*b && *b != a) ++b;
 		if(*b) break;
@@ -861,7 +953,7 @@ int GxString::LastAny(const char* c, int pos) const
 	pos = s::Min(pos, myLen-1);
 	while(pos >= 0)
 	{
-		const char a = myStr[pos];
+		const char a = Raw()[pos];
 		const char* b = c;
 		while(*b && *b != a) ++b;
 		if(*b) break;
@@ -873,16 +965,16 @@ int GxString::LastAny(const char* c, int pos) const
 int GxString::Compare(GxStringArg str, bool caseSensitive) const
 {
 	if(caseSensitive)
-		return s::Cmp(myStr, str.ptr);
+		return s::Cmp(Raw(), str.ptr);
 	else
-		return s::iCmp(myStr, str.ptr);
+		return s::iCmp(Raw(), str.ptr);
 }
 
 bool GxString::EndsWith(GxStringArg key, bool caseSensitive) const
 {
 	if(myLen >= key.len)
 	{
-		const char* src = myStr + myLen - key.len;
+		const char* src = Raw() + myLen - key.len;
 		return s::Eq(src, key.ptr, key.len, caseSensitive);
 	}
 	return false;
@@ -892,7 +984,7 @@ bool GxString::StartsWith(GxStringArg key, bool caseSensitive) const
 {
 	if(myLen >= key.len)
 	{
-		const char* src = myStr;
+		const char* src = Raw();
 		return s::Eq(src, key.ptr, key.len, caseSensitive);
 	}
 	return false;
@@ -904,7 +996,7 @@ bool GxString::StartsWith(GxStringArg key, bool caseSensitive) const
 
 // Array operator
 char GxString::operator [] (int pos) const
-	{ return myStr[pos]; }
+	{ return Raw()[pos]; }
 
 // Addition operators
 GxString& GxString::operator += (char chr)
@@ -995,7 +1087,125 @@ bool operator == (const char* a, const GxString& b)
 	{ return s::Eq(a, b.Raw()); }
 
 bool operator == (const GxString& a, const GxString& b)
+	{ return (a.Length() == b.Length()) && memcmp(a.Raw(), b.Raw(), a.Length()) == 0; }
+
+// ===================================================================================
+// GxAtom
+// ===================================================================================
+
+namespace {
+
+enum AtomTableProperties
+{
+	ATOM_TABLE_MIN_SIZE = 256,
+};
+
+// The entries of the atom table are never freed, so the strings of atoms stay valid.
+struct AtomEntry
+{
+	GxString str;
+	uint hash;
+	AtomEntry* next;
+};
+
+// A hash table with separate chaining, which doubles in size when it is full. It is plain
+// data, so it is usable before static constructors have run.
+struct AtomTable
+{
+	AtomEntry** buckets;
+	uint mask;
+	uint count;
+};
+
+static AtomTable atomTable = {NULL, 0, 0};
+
+static void AtomGrow(AtomTable& t)
+{
+	const uint size = t.buckets ? (t.mask + 1) * 2 : (uint)ATOM_TABLE_MIN_SIZE;
+	AtomEntry** buckets = static_cast<AtomEntry**>(calloc(size, sizeof(AtomEntry*)));
+	for(uint i=0; t.buckets && i<=t.mask; ++i)
+	{
+		for(AtomEntry* e = t.buckets[i]; e; )
+		{
+			AtomEntry* next = e->next;
+			e->next = buckets[e->hash & (size - 1)];
+			buckets[e->hash & (size - 1)] = e;
+			e = next;
+		}
+	}
+	free(t.buckets);
+	t.buckets = buckets;
+	t.mask = size - 1;
+}
+
+// Returns the interned copy of the first n characters of str, or NULL for the empty string.
+// If the string is not in the table yet, it is added; if src is not NULL, its content is shared.
+static const GxString* AtomIntern(const char* str, int n, const GxString* src)
+{
+	if(n <= 0) return NULL;
+
+	AtomTable& t = atomTable;
+	const uint hash = src ? src->Hash() : GxString::Hash(str, n);
+	if(t.buckets)
+	{
+		for(AtomEntry* e = t.buckets[hash & t.mask]; e; e = e->next)
+			if(e->hash == hash && e->str.Length() == n && memcmp(e->str.Raw(), str, n) == 0)
+				return &e->str;
+	}
+
+	if(t.count >= (t.buckets ? t.mask + 1 : 0))
+		AtomGrow(t);
+
+	AtomEntry* e = new AtomEntry;
+	if(src) e->str = *src; else e->str.Set(str, n);
+	e->hash = hash;
+	e->next = t.buckets[hash & t.mask];
+	t.buckets[hash & t.mask] = e;
+	++t.count;
+	return &e->str;
+}
+
+}; // anonymous namespace
+
+GxAtom::GxAtom(const char* str)
+	:myStr(str ? AtomIntern(str, s::Len(str), NULL) : NULL)
+{
+}
+
+GxAtom::GxAtom(const char* str, int n)
+	:myStr(AtomIntern(str, n, NULL))
+{
+}
+
+GxAtom::GxAtom(const GxString& str)
+	:myStr(AtomIntern(str.Raw(), str.Length(), &str))
+{
+}
+
+const GxString& GxAtom::Str() const
+{
+	static const GxString empty;
+	return myStr ? *myStr : empty;
+}
+
+// Atom equality operators
+bool operator == (const GxAtom& a, const char* b)
+	{ return s::Eq(a.Raw(), b); }
+
+bool operator == (const char* a, const GxAtom& b)
+	{ return s::Eq(a, b.Raw()); }
+
+bool operator == (const GxAtom& a, const GxString& b)
 	{ return (a.Length() == b.Length()) && s::Eq(a.Raw(), b.Raw()); }
 
+bool operator == (const GxString& a, const GxAtom& b)
+	{ return (a.Length() == b.Length()) && s::Eq(a.Raw(), b.Raw()); }
+
+bool operator != (const GxAtom& a, const char* b)
+	{ return !s::Eq(a.Raw(), b); }
+
+bool operator != (const char* a, const GxAtom& b)
+	{ return !s::Eq(a, b.Raw()); }
+
 }; // namespace core
 }; // namespace guix
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <GuiX/Config.h>
+
+#include <string.h>
+
+#include <vector>
+
+#include <GuiX/Common.h>
+#include <GuiX/String.h>
+
+namespace guix {
+namespace core {
+
+/// Returns the number of heap blocks that strings have allocated or reallocated so far.
+/// The counter is not synchronized between threads; it is meant for profiling.
+int GxStringHeapAllocations();
+
+// ===================================================================================
+// GxStringMap
+// ===================================================================================
+// Hash table that maps strings to values. A lookup hashes the key once, and only compares
+// the characters of entries that have the same hash. Keys that are GxString objects use
+// their cached hash, so looking them up again does not hash them again either. Entries
+// are stored in an array in order of insertion, except that erasing an entry moves the
+// last entry into its place.
+
+template <typename T>
+class GxStringMap
+{
+public:
+	struct Entry
+	{
+		GxString key;
+		T value;
+		uint hash;
+		int next;
+	};
+
+	GxStringMap()
+	{
+	}
+
+	/// Returns the value of key, or NULL if the map does not contain it.
+	T* Find(const GxString& key)             {return myFind(key.Raw(), key.Length(), key.Hash());}
+	const T* Find(const GxString& key) const {return myFind(key.Raw(), key.Length(), key.Hash());}
+
+	/// Returns the value of key, or NULL if the map does not contain it.
+	T* Find(const char* key)             {const int n = GxStrLen(key); return myFind(key, n, GxString::Hash(key, n));}
+	const T* Find(const char* key) const {const int n = GxStrLen(key); return myFind(key, n, GxString::Hash(key, n));}
+
+	/// Returns the value of the first n characters of key, using a hash computed in advance by \c GxString::Hash().
+	T* Find(const char* key, int n, uint hash)             {return myFind(key, n, hash);}
+	const T* Find(const char* key, int n, uint hash) const {return myFind(key, n, hash);}
+
+	/// Returns the value of key; if the map does not contain key, it is inserted with a default value.
+	T& operator [] (const GxString& key)
+	{
+		T* value = Find(key);
+		return value ? *value : myInsert(key, T());
+	}
+
+	/// Inserts key with the given value. Returns false, and leaves the map unchanged, if the map already contains key.
+	bool Insert(const GxString& key, const T& value)
+	{
+		if(Find(key)) return false;
+		myInsert(key, value);
+		return true;
+	}
+
+	/// Removes key from the map. Returns false if the map does not contain key.
+	bool Erase(const GxString& key)
+	{
+		const uint hash = key.Hash();
+		int* link = myBucket(hash);
+		while(link && *link >= 0)
+		{
+			Entry& e = myEntries[*link];
+			if(e.hash == hash && e.key == key)
+			{
+				const int index = *link;
+				*link = e.next;
+				myMoveLast(index);
+				return true;
+			}
+			link = &e.next;
+		}
+		return false;
+	}
+
+	/// Removes all entries.
+	void Clear()
+	{
+		myEntries.clear();
+		myBuckets.clear();
+	}
+
+	int Size() const {return (int)myEntries.size();} ///< Returns the number of entries.
+
+	Entry& GetEntry(int index)             {return myEntries[index];} ///< Returns the entry at index, in [0, Size()).
+	const Entry& GetEntry(int index) const {return myEntries[index];} ///< Returns the entry at index, in [0, Size()).
+
+private:
+	int* myBucket(uint hash)
+	{
+		return myBuckets.empty() ? NULL : &myBuckets[hash & (myBuckets.size() - 1)];
+	}
+
+	T* myFind(const char* key, int n, uint hash) const
+	{
+		if(myBuckets.empty()) return NULL;
+
+		int i = myBuckets[hash & (myBuckets.size() - 1)];
+		while(i >= 0)
+		{
+			const Entry& e = myEntries[i];
+			if(e.hash == hash && e.key.Length() == n && memcmp(e.key.Raw(), key, n) == 0)
+				return const_cast<T*>(&e.value);
+			i = e.next;
+		}
+		return NULL;
+	}
+
+	T& myInsert(const GxString& key, const T& value)
+	{
+		if(myEntries.size() >= myBuckets.size())
+			myRehash(myBuckets.empty() ? 16 : myBuckets.size() * 2);
+
+		Entry e;
+		e.key = key;
+		e.value = value;
+		e.hash = key.Hash();
+
+		int* bucket = myBucket(e.hash);
+		e.next = *bucket;
+		*bucket = (int)myEntries.size();
+		myEntries.push_back(e);
+		return myEntries.back().value;
+	}
+
+	// Moves the last entry to index, which is no longer referenced, and removes the last entry.
+	void myMoveLast(int index)
+	{
+		const int last = (int)myEntries.size() - 1;
+		if(index != last)
+		{
+			int* link = myBucket(myEntries[last].hash);
+			while(*link != last) link = &myEntries[*link].next;
+			*link = index;
+			myEntries[index] = myEntries[last];
+		}
+		myEntries.pop_back();
+	}
+
+	void myRehash(size_t size)
+	{
+		myBuckets.assign(size, -1);
+		for(size_t i=0; i<myEntries.size(); ++i)
+		{
+			int* bucket = myBucket(myEntries[i].hash);
+			myEntries[i].next = *bucket;
+			*bucket = (int)i;
+		}
+	}
+
+	std::vector<Entry> myEntries;
+	std::vector<int> myBuckets;
+};
+
+}; // namespace core
+}; // namespace guix
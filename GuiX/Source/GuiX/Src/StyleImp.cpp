@@ -3,6 +3,9 @@
 
 #include <Src/StyleImp.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace guix {
 namespace gui {
 
@@ -19,6 +22,136 @@ static GxColor hueSlice[7] =
 	GxColor (255, 0,   0  ),
 };
 
+// Enumeration of the images of a style, which are packed into the style atlas.
+enum StyleImage
+{
+	SI_BAR,
+	SI_FIELD,
+	SI_BOX,
+	SI_BUTTON,
+	SI_TAB        = SI_BUTTON + 2,
+	SI_RADIO      = SI_TAB + 3,
+	SI_CHECKMARK  = SI_RADIO + 3,
+	SI_ARROW,
+	SI_GRAB,
+	SI_CLOSE,
+	SI_DOCK_BAR,
+	SI_DOCK_FRAME,
+	SI_HUE_MAP,
+	SI_DIR_DISC,
+	SI_COUNT,
+};
+
+enum StyleAtlasProperties
+{
+	ATLAS_WIDTH   = 512,
+	ATLAS_PADDING = 2,
+};
+
+// ===================================================================================
+// StyleAtlas
+// ===================================================================================
+// Packs the images of a style into a single texture, so the widgets of a style can be
+// drawn without switching textures. The images are placed on shelves, and the padding
+// around every image repeats its border pixels, so filtering does not sample from the
+// neighbouring images.
+
+class StyleAtlas
+{
+public:
+	void Add(int id, const GxCanvas& canvas);
+	void Create(GxTexture* outTextures);
+
+private:
+	struct Image
+	{
+		int id, w, h, x, y;
+		std::vector<uchar> pixels;
+	};
+
+	static bool IsTaller(const Image* a, const Image* b);
+	static void Copy(uchar* atlas, int atlasW, const Image& img);
+
+	std::vector<Image> myImages;
+};
+
+void StyleAtlas::Add(int id, const GxCanvas& canvas)
+{
+	Image img;
+	img.id = id;
+	img.w = canvas.GetWidth();
+	img.h = canvas.GetHeight();
+	img.x = img.y = 0;
+	img.pixels.assign(canvas.GetBitmap(), canvas.GetBitmap() + img.w * img.h * 4);
+	myImages.push_back(img);
+}
+
+void StyleAtlas::Create(GxTexture* outTextures)
+{
+	// Place the images on shelves, from the tallest to the shortest image.
+	std::vector<Image*> order;
+	for(size_t i=0; i<myImages.size(); ++i)
+		order.push_back(&myImages[i]);
+	std::stable_sort(order.begin(), order.end(), IsTaller);
+
+	int x = 0, y = 0, shelfH = 0;
+	for(size_t i=0; i<order.size(); ++i)
+	{
+		Image& img = *order[i];
+		const int w = img.w + ATLAS_PADDING * 2;
+		const int h = img.h + ATLAS_PADDING * 2;
+		if(x + w > ATLAS_WIDTH)
+		{
+			x = 0;
+			y += shelfH;
+			shelfH = 0;
+		}
+		img.x = x + ATLAS_PADDING;
+		img.y = y + ATLAS_PADDING;
+		x += w;
+		shelfH = GxMax(shelfH, h);
+	}
+
+	int atlasH = 1;
+	while(atlasH < y + shelfH) atlasH *= 2;
+
+	std::vector<uchar> pixels(ATLAS_WIDTH * atlasH * 4, 0);
+	for(size_t i=0; i<myImages.size(); ++i)
+		Copy(&pixels[0], ATLAS_WIDTH, myImages[i]);
+
+	const GxTexture atlas(ATLAS_WIDTH, atlasH, &pixels[0]);
+	const float rw = 1.f / (float)ATLAS_WIDTH;
+	const float rh = 1.f / (float)atlasH;
+	for(size_t i=0; i<myImages.size(); ++i)
+	{
+		const Image& img = myImages[i];
+		GxTexture& tex = outTextures[img.id];
+		tex = atlas;
+		tex.SetUVs(img.x * rw, img.y * rh, (img.x + img.w) * rw, (img.y + img.h) * rh);
+	}
+}
+
+bool StyleAtlas::IsTaller(const Image* a, const Image* b)
+{
+	return a->h > b->h;
+}
+
+// Copies an image into the atlas, and repeats its border pixels in the padding around it.
+void StyleAtlas::Copy(uchar* atlas, int atlasW, const Image& img)
+{
+	for(int y=-ATLAS_PADDING; y<img.h+ATLAS_PADDING; ++y)
+	{
+		const int sy = GxClamp(y, 0, img.h - 1);
+		uint* dst = (uint*)atlas + (img.y + y) * atlasW + img.x;
+		const uint* src = (const uint*)&img.pixels[0] + sy * img.w;
+		for(int x=-ATLAS_PADDING; x<img.w+ATLAS_PADDING; ++x)
+			dst[x] = src[GxClamp(x, 0, img.w - 1)];
+	}
+}
+
+// ===================================================================================
+// Style schemes
+
 static void GetBlackScheme(GxStyle::Colors& c)
 {
 	c.bgPanel = GxColor(65, 65, 65);
@@ -95,6 +228,11 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 	d.text[1].shadow = GxColor(0, 0);
 	d.text[1].SetColor(c.textLocked);
 
+	StyleAtlas atlas;
+
+	// Height of the title bar of docks.
+	const float bar = 20;
+
 	// Create bar frame
 	{
 		GxCanvas canvas(16, 16);
@@ -106,8 +244,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.bgBar);
 		canvas.Rect(2, 2, 14, 14);
 
-		d.bar.SetTexture(canvas.CreateTexture());
-		d.bar.SetBorderSize(3, 3, 3, 3);
+		atlas.Add(SI_BAR, canvas);
 	}
 
 	// Create field frame
@@ -123,8 +260,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.bgField);
 		canvas.Rect(2, 2, 14, 14);
 
-		d.field.SetTexture(canvas.CreateTexture());
-		d.field.SetBorderSize(3, 3, 3, 3);
+		atlas.Add(SI_FIELD, canvas);
 	}
 
 	// Create box frame
@@ -140,8 +276,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.bgPanel);
 		canvas.Rect(3, 3, 13, 13);
 
-		d.box.SetTexture(canvas.CreateTexture());
-		d.box.SetBorderSize(4, 4, 4, 4);
+		atlas.Add(SI_BOX, canvas);
 	}
 
 	// Create button texture
@@ -167,8 +302,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 			canvas.Rect(1, 1, 15, 15);
 		}
 
-		d.button[i].SetTexture(canvas.CreateTexture());
-		d.button[i].SetBorderSize(4, 4, 4, 4);
+		atlas.Add(SI_BUTTON + i, canvas);
 	}
 
 	// Create tabs texture
@@ -192,9 +326,8 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.frameOutline, panelFade);
 		canvas.SetFill(false);
 		canvas.Rect(0, 0, 16, 16);
-		
-		d.tab[i].SetTexture(canvas.CreateTexture());
-		d.tab[i].SetBorderSize(3, 3, 3, 3);
+
+		atlas.Add(SI_TAB + i, canvas);
 	}
 
 	// Create radio button images
@@ -224,8 +357,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 				canvas.Circle(8, 8, 6);
 			}
 
-			d.radio[i].SetTexture(canvas.CreateTexture());
-			d.radio[i].SetOrigin(0.5f, 0.5f);
+			atlas.Add(SI_RADIO + i, canvas);
 		}
 
 		// Button selection
@@ -234,8 +366,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.textColor);
 		canvas.Circle(8, 8, 3.5);
 
-		d.radio[2].SetTexture(canvas.CreateTexture());
-		d.radio[2].SetOrigin(0.5f, 0.5f);
+		atlas.Add(SI_RADIO + 2, canvas);
 	}
 
 	// Create checkmark
@@ -251,8 +382,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.textColor);
 		canvas.Polygon(verts, 6);
 
-		d.checkmark.SetTexture(canvas.CreateTexture());
-		d.checkmark.SetOrigin(0.5f, 0.5f);
+		atlas.Add(SI_CHECKMARK, canvas);
 	}
 
 	// Create arrow icon
@@ -264,8 +394,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		GxVec2f v[3] = {GxVec2f(1,3), GxVec2f(7,3), GxVec2f(4,6)};
 		canvas.Polygon(v, 3);
 
-		d.arrow.SetTexture(canvas.CreateTexture());
-		d.arrow.SetOrigin(0.5f, 0.5f);
+		atlas.Add(SI_ARROW, canvas);
 	}
 
 	// Create grab icon
@@ -277,8 +406,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.Rect(0, 3, 8, 4);
 		canvas.Rect(0, 5, 8, 6);
 
-		d.grab.SetTexture(canvas.CreateTexture());
-		d.grab.SetOrigin(0.5f, 0.5f);
+		atlas.Add(SI_GRAB, canvas);
 	}
 
 	// Create close icon
@@ -297,13 +425,11 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.Line(3, 3.5, 13, 13.5, 2);
 		canvas.Line(3, 13.5, 13, 3.5, 2);
 
-		d.close.SetTexture(canvas.CreateTexture());
-		d.close.SetOrigin(0.5f, 0.5f);
+		atlas.Add(SI_CLOSE, canvas);
 	}
 
 	// Create dock bar
 	{
-		float bar = 20;
 		GxCanvas canvas(16, (int)bar);
 
 		canvas.SetColor(c.frameOutline);
@@ -311,13 +437,11 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.dockBg[0], c.dockBg[1]);
 		canvas.Rect(1, 1, 15, bar-1);
 
-		d.dockBar.SetTexture(canvas.CreateTexture());
-		d.dockBar.SetBorderSize(6, 6);
+		atlas.Add(SI_DOCK_BAR, canvas);
 	}
 
 	// Create floating dock frame
 	{
-		float bar = 20;
 		GxCanvas canvas(64, 64 + (int)bar);
 
 		for(int i=0; i<2; ++i)
@@ -339,8 +463,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.bgPanel);
 		canvas.Rect(19, 17 + bar, 45, 45 + bar);
 
-		d.dockFrame.SetTexture(canvas.CreateTexture());
-		d.dockFrame.SetBorderSize(24, 24 + bar, 24, 24);
+		atlas.Add(SI_DOCK_FRAME, canvas);
 	}
 
 	// Create hue map
@@ -359,7 +482,7 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 			x += w;
 		}
 
-		d.hueMap = canvas.CreateTexture();
+		atlas.Add(SI_HUE_MAP, canvas);
 	}
 
 	// Create direction disc
@@ -374,8 +497,52 @@ static void CreateStyleData(const GxStyle::Colors& c, GxStyle::Data& d)
 		canvas.SetColor(c.bgBar);
 		canvas.Circle(24, 24, 22);
 
-		d.dirDisc = canvas.CreateTexture();
+		atlas.Add(SI_DIR_DISC, canvas);
 	}
+
+	// Pack the images into the style atlas, and assign their regions.
+	GxTexture tex[SI_COUNT];
+	atlas.Create(tex);
+
+	d.bar.SetTexture(tex[SI_BAR]);
+	d.bar.SetBorderSize(3, 3, 3, 3);
+	d.field.SetTexture(tex[SI_FIELD]);
+	d.field.SetBorderSize(3, 3, 3, 3);
+	d.box.SetTexture(tex[SI_BOX]);
+	d.box.SetBorderSize(4, 4, 4, 4);
+
+	for(int i=0; i<2; ++i)
+	{
+		d.button[i].SetTexture(tex[SI_BUTTON + i]);
+		d.button[i].SetBorderSize(4, 4, 4, 4);
+	}
+	for(int i=0; i<3; ++i)
+	{
+		d.tab[i].SetTexture(tex[SI_TAB + i]);
+		d.tab[i].SetBorderSize(3, 3, 3, 3);
+	}
+	for(int i=0; i<3; ++i)
+	{
+		d.radio[i].SetTexture(tex[SI_RADIO + i]);
+		d.radio[i].SetOrigin(0.5f, 0.5f);
+	}
+
+	d.checkmark.SetTexture(tex[SI_CHECKMARK]);
+	d.checkmark.SetOrigin(0.5f, 0.5f);
+	d.arrow.SetTexture(tex[SI_ARROW]);
+	d.arrow.SetOrigin(0.5f, 0.5f);
+	d.grab.SetTexture(tex[SI_GRAB]);
+	d.grab.SetOrigin(0.5f, 0.5f);
+	d.close.SetTexture(tex[SI_CLOSE]);
+	d.close.SetOrigin(0.5f, 0.5f);
+
+	d.dockBar.SetTexture(tex[SI_DOCK_BAR]);
+	d.dockBar.SetBorderSize(6, 6);
+	d.dockFrame.SetTexture(tex[SI_DOCK_FRAME]);
+	d.dockFrame.SetBorderSize(24, 24 + bar, 24, 24);
+
+	d.hueMap = tex[SI_HUE_MAP];
+	d.dirDisc = tex[SI_DIR_DISC];
 }
 
 }; // anonymous namespace
@@ -403,6 +570,7 @@ GxStyle::Colors::Colors(GxStyle::Scheme scheme)
 // ===================================================================================
 
 GxStyle* GxStyleImp::singleton = NULL;
+int GxStyleImp::generation = 0;
 
 GxStyle::~GxStyle()
 {
@@ -416,6 +584,7 @@ GxStyle* GxStyle::Get()
 void GxStyle::Set(const GxStyle& style)
 {
 	*GxStyleImp::singleton = style;
+	++GxStyleImp::generation;
 }
 
 void GxStyleImp::Create()
@@ -445,6 +614,7 @@ void GxStyle::SetFont(const GxFont& font)
 {
 	d.text[0].font = font;
 	d.text[1].font = font;
+	++GxStyleImp::generation;
 }
 
 void GxStyle::Label(const GxRecti& r, GxTextAlignH h, GxTextAlignV v, const GxString& text, bool lock)
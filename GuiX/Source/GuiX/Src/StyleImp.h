@@ -14,6 +14,9 @@ class GxStyleImp
 public:
 	static GxStyle* singleton;
 
+	// Incremented whenever the global style changes, so cached geometry can be updated.
+	static int generation;
+
 	static void Create();
 	static void Destroy();
 };
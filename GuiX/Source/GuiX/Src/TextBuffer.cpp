@@ -0,0 +1,352 @@
+#include <GuiX/Config.h>
+
+#include <string.h>
+#include <limits.h>
+
+#include <GuiX/Common.h>
+#include <GuiX/TextBuffer.h>
+
+namespace guix {
+namespace core {
+namespace {
+
+// Grows an array allocated with GxRealloc so it can hold at least the required number of elements.
+template <typename T>
+static void Reserve(T*& array, int& capacity, int required)
+{
+	if(required <= capacity) return;
+	capacity = GxMax(required, capacity * 2 + 16);
+	array = GxRealloc(array, capacity);
+}
+
+}; // anonymous namespace
+
+// ===================================================================================
+// GxTextBuffer
+// ===================================================================================
+
+GxTextBuffer::~GxTextBuffer()
+{
+	GxFree(myData);
+	GxFree(myUndo.edits);
+	GxFree(myUndo.bytes);
+	GxFree(myRedo.edits);
+	GxFree(myRedo.bytes);
+}
+
+GxTextBuffer::GxTextBuffer()
+	:myData(NULL)
+	,myLen(0)
+	,myGapPos(0)
+	,myGapSize(0)
+	,myIsHistoryEnabled(true)
+	,myIsMerging(false)
+{
+	memset(&myUndo, 0, sizeof(History));
+	memset(&myRedo, 0, sizeof(History));
+	myReserve(0);
+}
+
+GxTextBuffer::GxTextBuffer(const GxTextBuffer& other)
+	:myData(NULL)
+	,myLen(0)
+	,myGapPos(0)
+	,myGapSize(0)
+	,myIsHistoryEnabled(true)
+	,myIsMerging(false)
+{
+	memset(&myUndo, 0, sizeof(History));
+	memset(&myRedo, 0, sizeof(History));
+	myCopy(other);
+}
+
+void GxTextBuffer::Set(GxStringArg str)
+{
+	// The string might point into our own storage, in which case we copy it first.
+	if(str.ptr >= myData && str.ptr <= myData + myLen + myGapSize)
+	{
+		GxString copy(str.ptr, str.len);
+		Set(copy);
+		return;
+	}
+	myGapSize += myLen;
+	myGapPos = myLen = 0;
+	myInsert(0, str.ptr, GxMax(0, str.len));
+	ClearHistory();
+}
+
+void GxTextBuffer::Insert(int pos, GxStringArg str)
+{
+	if(str.len <= 0) return;
+	if(str.ptr >= myData && str.ptr <= myData + myLen + myGapSize)
+	{
+		GxString copy(str.ptr, str.len);
+		Insert(pos, copy);
+		return;
+	}
+	pos = GxClamp(pos, 0, myLen);
+	myInsert(pos, str.ptr, str.len);
+	myRecord(true, pos, str.len);
+}
+
+void GxTextBuffer::Erase(int pos, int n)
+{
+	pos = GxClamp(pos, 0, myLen);
+	n = GxMin(n, myLen - pos);
+	if(n <= 0) return;
+	myRecord(false, pos, n);
+	myErase(pos, n);
+}
+
+void GxTextBuffer::Clear()
+{
+	myGapSize += myLen;
+	myGapPos = myLen = 0;
+	ClearHistory();
+}
+
+bool GxTextBuffer::Undo(GxTextChange* outChange)
+{
+	return myRevert(myUndo, myRedo, true, outChange);
+}
+
+bool GxTextBuffer::Redo(GxTextChange* outChange)
+{
+	return myRevert(myRedo, myUndo, false, outChange);
+}
+
+void GxTextBuffer::EndUndoGroup()
+{
+	myIsMerging = false;
+}
+
+void GxTextBuffer::ClearHistory()
+{
+	myUndo.editCount = myUndo.byteCount = 0;
+	myRedo.editCount = myRedo.byteCount = 0;
+	myIsMerging = false;
+}
+
+void GxTextBuffer::SetHistoryEnabled(bool enabled)
+{
+	myIsHistoryEnabled = enabled;
+	if(!enabled) ClearHistory();
+}
+
+bool GxTextBuffer::CanUndo() const
+{
+	return myUndo.editCount > 0;
+}
+
+bool GxTextBuffer::CanRedo() const
+{
+	return myRedo.editCount > 0;
+}
+
+bool GxTextBuffer::IsHistoryEnabled() const
+{
+	return myIsHistoryEnabled;
+}
+
+int GxTextBuffer::NextChar(int pos) const
+{
+	if(pos < myLen)
+		do {++pos;} while(pos < myLen && ((*this)[pos] & 0xC0) == 0x80);
+	return pos;
+}
+
+int GxTextBuffer::PrevChar(int pos) const
+{
+	if(pos > 0)
+		do {--pos;} while(pos > 0 && ((*this)[pos] & 0xC0) == 0x80);
+	return pos;
+}
+
+GxString GxTextBuffer::Substr(int pos, int n) const
+{
+	pos = GxClamp(pos, 0, myLen);
+	n = GxClamp(n, 0, myLen - pos);
+
+	// If the characters are not split by the gap, they can be copied in one go.
+	if(pos >= myGapPos)
+		return GxString(myData + pos + myGapSize, n);
+	if(pos + n <= myGapPos)
+		return GxString(myData + pos, n);
+
+	const int front = myGapPos - pos;
+	GxString result(myData + pos, front);
+	result.Append(GxStringArg(myData + myGapPos + myGapSize, n - front));
+	return result;
+}
+
+GxTextBuffer& GxTextBuffer::operator = (const GxTextBuffer& other)
+{
+	if(this != &other) myCopy(other);
+	return *this;
+}
+
+// ===================================================================================
+// Private functions
+
+void GxTextBuffer::myCopy(const GxTextBuffer& other)
+{
+	const int size = other.myLen + other.myGapSize;
+	myData = GxRealloc(myData, size + 1);
+	memcpy(myData, other.myData, size + 1);
+	myLen = other.myLen;
+	myGapPos = other.myGapPos;
+	myGapSize = other.myGapSize;
+	myIsHistoryEnabled = other.myIsHistoryEnabled;
+	myIsMerging = other.myIsMerging;
+
+	const History* src[2] = {&other.myUndo, &other.myRedo};
+	History* dst[2] = {&myUndo, &myRedo};
+	for(int i=0; i<2; ++i)
+	{
+		History& h = *dst[i];
+		Reserve(h.edits, h.editCapacity, src[i]->editCount);
+		Reserve(h.bytes, h.byteCapacity, src[i]->byteCount);
+		if(src[i]->editCount) memcpy(h.edits, src[i]->edits, sizeof(Edit) * src[i]->editCount);
+		if(src[i]->byteCount) memcpy(h.bytes, src[i]->bytes, src[i]->byteCount);
+		h.editCount = src[i]->editCount;
+		h.byteCount = src[i]->byteCount;
+	}
+}
+
+// Copies n characters starting at pos to out.
+void GxTextBuffer::myRead(int pos, int n, char* out) const
+{
+	const int front = GxClamp(myGapPos - pos, 0, n);
+	memcpy(out, myData + pos, front);
+	memcpy(out + front, myData + pos + front + myGapSize, n - front);
+}
+
+// Moves the gap so that it starts at pos.
+void GxTextBuffer::myMoveGap(int pos)
+{
+	if(pos < myGapPos)
+		memmove(myData + pos + myGapSize, myData + pos, myGapPos - pos);
+	else if(pos > myGapPos)
+		memmove(myData + myGapPos, myData + myGapPos + myGapSize, pos - myGapPos);
+	myGapPos = pos;
+}
+
+// Makes sure the gap can hold at least n characters.
+void GxTextBuffer::myReserve(int n)
+{
+	if(myData && myGapSize >= n) return;
+
+	// Grow the storage, and move the characters behind the gap to the end of the new storage.
+	const int size = myLen + myGapSize;
+	const int newSize = GxMax(myLen + n, size * 2 + 16);
+	const int back = myLen - myGapPos;
+	myData = GxRealloc(myData, newSize + 1);
+	memmove(myData + newSize - back, myData + size - back, back);
+	myGapSize = newSize - myLen;
+	myData[newSize] = 0;
+}
+
+void GxTextBuffer::myInsert(int pos, const char* str, int n)
+{
+	myReserve(n);
+	myMoveGap(pos);
+	memcpy(myData + pos, str, n);
+	myGapPos += n;
+	myGapSize -= n;
+	myLen += n;
+}
+
+void GxTextBuffer::myErase(int pos, int n)
+{
+	myMoveGap(pos);
+	myGapSize += n;
+	myLen -= n;
+}
+
+// Adds an edit to the undo history. Erased characters have to be recorded before they are erased.
+void GxTextBuffer::myRecord(bool isInsert, int pos, int n)
+{
+	if(!myIsHistoryEnabled) return;
+
+	// A new edit makes the reverted edits unreachable.
+	myRedo.editCount = myRedo.byteCount = 0;
+
+	// Consecutive typing extends the previous insert, and an insert or erase next to a previous
+	// erase (selection replacement, repeated backspace or delete) joins the group of that erase.
+	History& h = myUndo;
+	bool joined = false;
+	if(myIsMerging && h.editCount > 0)
+	{
+		Edit& top = h.edits[h.editCount - 1];
+		if(isInsert && top.isInsert && top.pos + top.len == pos)
+		{
+			top.len += n;
+			return;
+		}
+		if(!top.isInsert)
+			joined = (pos == top.pos) || (!isInsert && pos + n == top.pos);
+	}
+
+	Edit edit = {pos, n, -1, isInsert, joined};
+	if(!isInsert)
+	{
+		Reserve(h.bytes, h.byteCapacity, h.byteCount + n);
+		myRead(pos, n, h.bytes + h.byteCount);
+		edit.bytes = h.byteCount;
+		h.byteCount += n;
+	}
+	Reserve(h.edits, h.editCapacity, h.editCount + 1);
+	h.edits[h.editCount++] = edit;
+	myIsMerging = true;
+}
+
+// Moves the most recent group of edits from one history to the other. Undoing reverts the edits
+// and redoing reapplies them. The characters of an edit are stored in the history only while
+// they are not part of the content: erases on the undo history and inserts on the redo history.
+bool GxTextBuffer::myRevert(History& from, History& to, bool undo, GxTextChange* outChange)
+{
+	if(from.editCount == 0) return false;
+
+	const int oldLen = myLen;
+	int begin = INT_MAX, tail = INT_MAX;
+	bool joined = true;
+	for(bool first = true; joined && from.editCount > 0; first = false)
+	{
+		const Edit edit = from.edits[--from.editCount];
+		Edit moved = {edit.pos, edit.len, -1, edit.isInsert, !first};
+		joined = edit.joined;
+
+		const bool insert = (edit.isInsert != undo);
+		if(insert)
+		{
+			myInsert(edit.pos, from.bytes + edit.bytes, edit.len);
+			from.byteCount = edit.bytes;
+		}
+		else
+		{
+			Reserve(to.bytes, to.byteCapacity, to.byteCount + edit.len);
+			myRead(edit.pos, edit.len, to.bytes + to.byteCount);
+			moved.bytes = to.byteCount;
+			to.byteCount += edit.len;
+			myErase(edit.pos, edit.len);
+		}
+		Reserve(to.edits, to.editCapacity, to.editCount + 1);
+		to.edits[to.editCount++] = moved;
+
+		// Keep track of the unchanged characters at the start and at the end of the content.
+		begin = GxMin(begin, edit.pos);
+		tail = GxMin(tail, myLen - edit.pos - (insert ? edit.len : 0));
+	}
+	myIsMerging = false;
+
+	if(outChange)
+	{
+		outChange->pos = begin;
+		outChange->erased = oldLen - tail - begin;
+		outChange->inserted = myLen - tail - begin;
+	}
+	return true;
+}
+
+}; // namespace core
+}; // namespace guix
@@ -2,10 +2,12 @@
 
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 
 #include <GuiX/Common.h>
 #include <GuiX/Localize.h>
 #include <GuiX/Interfaces.h>
+#include <GuiX/Draw.h>
 
 #include <Src/TextImp.h>
 
@@ -15,6 +17,9 @@ namespace {
 
 static const int _npos = INT_MAX;
 
+// Page of glyphs that are not on the glyph atlas textures yet, see GxGlyphAtlas::IsPending.
+static const int PENDING_PAGE = -2;
+
 // ===================================================================================
 // Utility types, structs and enums
 
@@ -70,6 +75,54 @@ static int GetOffsetY(GxTextAlignV align, int h)
 	return (-h * align) >> 1;
 }
 
+// Returns a FNV-1a hash of the string and the text settings that affect the text layout.
+static uint GetLayoutHash(const GxText& settings, const GxFontData* font, const char* str, int len)
+{
+	uint hash = 2166136261u;
+	for(int i=0; i<len; ++i)
+		hash = (hash ^ (uchar)str[i]) * 16777619u;
+
+	uint tabBits;
+	memcpy(&tabBits, &settings.tabWidth, sizeof(uint));
+	const uint keys[4] = {(uint)(uintptr_t)font, (uint)settings.flags, (uint)settings.maxWidth, tabBits};
+	for(int i=0; i<4; ++i)
+		hash = (hash ^ keys[i]) * 16777619u;
+
+	return hash;
+}
+
+// Returns the glyph page on which a glyph is drawn, and the texture coordinates of the glyph on that page.
+// If the font is drawn from the glyph atlas, the glyph is added to the atlas if necessary. Glyphs that
+// the atlas textures do not contain yet return PENDING_PAGE, and are drawn from the glyph page of the font.
+static int GetGlyphPage(GxGlyphAtlas* atlas, const GxFontData* font, const Glyph& glyph, GxAreaf& outUVs)
+{
+	if(!atlas)
+	{
+		outUVs = glyph.uvs;
+		return glyph.page;
+	}
+	const int slot = atlas->Acquire(font, glyph);
+	if(slot < 0) return -1;
+
+	if(atlas->IsPending(slot))
+	{
+		outUVs = glyph.uvs;
+		return PENDING_PAGE;
+	}
+
+	const AtlasSlot& s = atlas->GetSlot(slot);
+	outUVs = s.uvs;
+	return s.page;
+}
+
+// Adds a quad to the quad count of a glyph page.
+static void CountQuad(std::vector<PageQuads>& quads, int page)
+{
+	if(page >= (int)quads.size())
+		quads.resize(page + 1);
+	++quads[page].count;
+}
+
 }; // anonymous namespace
 
 // ===================================================================================
@@ -111,6 +164,19 @@ bool GxFont::Create(const char* path)
 	return myHandle != 0;
 }
 
+bool GxFont::CreateAsync(const char* path)
+{
+	GxFontDatabaseImp* database = GxFontDatabaseImp::singleton;
+	if(database)
+	{
+		GxFontHandle old = myHandle;
+		database->Load(myHandle, path, true);
+		database->Release(old);
+	}
+	else myHandle = 0;
+	return myHandle != 0;
+}
+
 void GxFont::Destroy()
 {
 	GxFontDatabaseImp* database = GxFontDatabaseImp::singleton;
@@ -176,7 +242,18 @@ GxTextRenderer::~GxTextRenderer()
 GxTextRenderer::GxTextRenderer()
 	:myStr(NULL)
 	,myFont(NULL)
+	,myGapPos(0)
+	,myGapSize(0)
+	,myLines(&myLineBuffer)
+	,myIsClipped(false)
+	,mySyncEnd(0)
+	,mySyncDelta(0)
+	,myCacheSets(0)
+	,myCacheHits(0)
+	,myCacheMisses(0)
+	,myCacheStamp(0)
 {
+	SetCacheCapacity(LAYOUT_CACHE_SIZE);
 }
 
 GxRecti GxTextRenderer::DrawText(int x, int y)
@@ -214,40 +291,138 @@ int GxTextRenderer::GetCharIndex(int x, int y, int cx, int cy)
 	return myGetCharIndex(x, y, cx, cy);
 }
 
+// ===================================================================================
+// Layout cache functions
+
+// The layout cache is set-associative; each set holds LAYOUT_CACHE_WAYS layouts and the
+// least recently used layout of a set is replaced when a new layout has to be stored.
+void GxTextRenderer::SetCacheCapacity(int layouts)
+{
+	int sets = 0;
+	if(layouts > 0)
+	{
+		sets = 1;
+		while(sets * LAYOUT_CACHE_WAYS < layouts) sets <<= 1;
+	}
+	myCacheSets = sets;
+	myCache.clear();
+	myCache.resize(sets * LAYOUT_CACHE_WAYS);
+}
+
+void GxTextRenderer::ClearCache()
+{
+	for(size_t i=0; i<myCache.size(); ++i)
+	{
+		CachedLayout& entry = myCache[i];
+		entry.font = NULL;
+		entry.stamp = 0;
+		entry.text.Clear();
+		entry.lines.clear();
+	}
+}
+
+void GxTextRenderer::ResetCacheStats()
+{
+	myCacheHits = myCacheMisses = 0;
+}
+
+GxTextCacheStats GxTextRenderer::GetCacheStats() const
+{
+	GxTextCacheStats stats = {myCacheHits, myCacheMisses, 0, (int)myCache.size()};
+	for(size_t i=0; i<myCache.size(); ++i)
+		if(myCache[i].font) ++stats.entries;
+	return stats;
+}
+
+// Returns the cached layout that matches the current string and settings, or the entry
+// that should be replaced by the new layout if there is no match.
+CachedLayout* GxTextRenderer::myFindLayout(const GxText& settings, uint hash, bool& outHit)
+{
+	outHit = false;
+	if(myCacheSets == 0) return NULL;
+
+	CachedLayout* set = &myCache[(hash & (myCacheSets - 1)) * LAYOUT_CACHE_WAYS];
+	CachedLayout* oldest = set;
+	for(int i=0; i<LAYOUT_CACHE_WAYS; ++i)
+	{
+		CachedLayout* entry = set + i;
+		if(entry->font == myFont && entry->hash == hash
+			&& entry->flags == settings.flags && entry->maxWidth == settings.maxWidth
+			&& entry->tabWidth == settings.tabWidth && entry->text.Length() == myLen
+			&& memcmp(entry->text.Raw(), myStr, myLen) == 0)
+		{
+			entry->stamp = ++myCacheStamp;
+			outHit = true;
+			return entry;
+		}
+		if(entry->stamp < oldest->stamp) oldest = entry;
+	}
+	return oldest;
+}
+
+// Stores the layout that was computed by the most recent call to SetText.
+void GxTextRenderer::myStoreLayout(CachedLayout* entry, const GxText& settings, uint hash)
+{
+	entry->text.Set((const char*)myStr, myLen);
+	entry->font     = myFont;
+	entry->flags    = settings.flags;
+	entry->maxWidth = settings.maxWidth;
+	entry->tabWidth = settings.tabWidth;
+	entry->textW    = myTextW;
+	entry->textH    = myTextH;
+	entry->hash     = hash;
+	entry->stamp    = ++myCacheStamp;
+	entry->lines.swap(*myLines);
+	myLines = &entry->lines;
+}
+
 // ===================================================================================
 // Character reading functions
 
 #define F_TAG1(x)		(x)
 #define F_TAG2(x,y)		((y) | ((x) << 8))
 
-void GxTextRenderer::myResetPos()
+// Returns the formatting state in front of the next character that will be read.
+int GxTextRenderer::myGetState() const
+{
+	return myFont->GetStyle() | (myInUnderline ? LS_UNDERLINE : 0);
+}
+
+// Moves the read position to pos and restores the formatting state at that position.
+void GxTextRenderer::mySeek(int pos, int state)
 {
-	myPos = myReadPos = 0;
+	myPos = myReadPos = pos;
 	myKPL = myKPR = -1;
-	myFont->SetBold(false);
-	myFont->SetItalic(false);
-	myHasUnderlines = false;
-	myInUnderline = false;
+	myFont->SetBold((state & GT_BOLD) != 0);
+	myFont->SetItalic((state & GT_ITALIC) != 0);
+	myInUnderline = (state & LS_UNDERLINE) != 0;
+	if(myInUnderline) myHasUnderlines = true;
 }
 
-void GxTextRenderer::mySkipTo(int pos)
+// Returns a pointer to len characters starting at pos, which are copied if they are split by the gap.
+const uchar* GxTextRenderer::myGetChars(int pos, int len)
 {
-	while(myReadPos < pos) myNextChar();
+	if(pos >= myGapPos) return myStr + pos + myGapSize;
+	if(pos + len <= myGapPos) return myStr + pos;
+
+	myScratch.resize(len);
+	for(int i=0; i<len; ++i) myScratch[i] = myAt(pos + i);
+	return &myScratch.front();
 }
 
 int GxTextRenderer::myReadMultibyte(int c)
 {
-	const uchar* p = myStr + myReadPos;
+	int p = myReadPos;
 	int numBytes = utf8TrailingBytes[c];
 	if(myReadPos + numBytes <= myLen)
 	{
 		switch(numBytes)
 		{
-			case 5: c <<= 6; c += *p++;
-			case 4: c <<= 6; c += *p++;
-			case 3: c <<= 6; c += *p++;
-			case 2: c <<= 6; c += *p++;
-			case 1: c <<= 6; c += *p++;
+			case 5: c <<= 6; c += myAt(p++);
+			case 4: c <<= 6; c += myAt(p++);
+			case 3: c <<= 6; c += myAt(p++);
+			case 2: c <<= 6; c += myAt(p++);
+			case 1: c <<= 6; c += myAt(p++);
 		};
 		c -= utf8Offsets[numBytes];
 		myReadPos += numBytes;
@@ -261,7 +436,7 @@ const Glyph& GxTextRenderer::myNextChar()
 	myKPL = myKPR;
 
 	// Read the current character.
-	int c = myStr[myReadPos++];
+	int c = myAt(myReadPos++);
 	if(c >= 0x80) c = myReadMultibyte(c);
 
 	// Check if the current character is the start of a formatting tag.
@@ -277,17 +452,17 @@ const Glyph& GxTextRenderer::myReadTag()
 	// Keep reading tags until a character is returned.
 	int c = 0;
 	--myReadPos;
-	while(myStr[myReadPos] == '{' && !c)
+	while(myAt(myReadPos) == '{' && !c)
 	{
 		// Read the tag contents.
-		++myReadPos;
+		const int tag = ++myReadPos;
 		uint tag4 = 0;
-		const uchar* tag = myStr + myReadPos, *p = tag;
-		while(*p != '}' && *p) tag4 = (tag4 << 8) + *p++;
+		int p = tag;
+		for(uchar ch; (ch = myAt(p)) != '}' && ch; ++p) tag4 = (tag4 << 8) + ch;
 		const int len = p - tag;
 		if(len > 4) tag4 = 0;
 		myReadPos += len;
-		if(*p) ++myReadPos;
+		if(myAt(p)) ++myReadPos;
 
 		// Perform the action associated with the tag.
 		GxFontDatabaseImp* database = GxFontDatabaseImp::singleton;
@@ -303,14 +478,16 @@ const Glyph& GxTextRenderer::myReadTag()
 			case F_TAG2('r','b'): c =  '}'; break;
 			case F_TAG2('n','l'): c = '\n'; break;
 			case F_TAG2('h','t'): c = '\t'; break;
-			default: myKPR=-1; return database->GetCustomGlyph(tag, len);
+			default: myKPR=-1; return database->GetCustomGlyph(myGetChars(tag, len), len);
 		};
 	}
 
 	// If the tags did not return a character, we read the next character.
+	// Tags at the end of the string are treated as part of the terminator.
 	if(!c)
 	{
-		c = myStr[myReadPos++];
+		if(myReadPos >= myLen) myPos = myLen;
+		c = myAt(myReadPos++);
 		if(c >= 0x80) c = myReadMultibyte(c);
 	}
 
@@ -352,9 +529,84 @@ void GxTextRenderer::myAdvance(Pen& pen, const Glyph& g)
 
 // Sets the string and text settings used for rendering, and breaks the string into lines.
 void GxTextRenderer::SetText(const GxText& settings, const char* text)
+{
+	myApplySettings(settings, text, GxStrLen(text));
+	myGapPos = myLen;
+	myGapSize = 0;
+	myIsClipped = false;
+
+	// Reuse the layout of an earlier call with the same string and settings, if possible.
+	bool cacheHit = false;
+	const uint hash = GetLayoutHash(settings, myFont, text, myLen);
+	CachedLayout* entry = myFindLayout(settings, hash, cacheHit);
+	if(cacheHit)
+	{
+		myLines = &entry->lines;
+		myTextW = entry->textW;
+		myTextH = entry->textH;
+		++myCacheHits;
+		return;
+	}
+	++myCacheMisses;
+
+	myLines = &myLineBuffer;
+	myLines->clear();
+	myProcess(0);
+
+	if(entry) myStoreLayout(entry, settings, hash);
+}
+
+// Sets the string, text settings and lines of a retained layout used for rendering.
+void GxTextRenderer::SetLayout(GxTextLayoutData& layout)
+{
+	const GxTextBuffer& text = layout.text;
+	myApplySettings(layout.settings, text.GetData(), text.Length());
+	myGapPos = text.GetGapPos();
+	myGapSize = text.GetGapSize();
+	myIsClipped = true;
+	myMaxLines = INT_MAX; // Retained layouts hold every line, they are only drawn in part.
+	myLines = &layout.lines;
+	myTextW = layout.textW;
+	myTextH = layout.textH;
+}
+
+// Breaks the full string of a retained layout into lines.
+void GxTextRenderer::Layout(GxTextLayoutData& layout)
+{
+	SetLayout(layout);
+	myLines->clear();
+	myProcess(0);
+	layout.textW = myTextW;
+	layout.textH = myTextH;
+}
+
+// Updates the lines of a retained layout after the characters in the range [pos, oldEnd) were
+// replaced by the characters in the range [pos, newEnd). Only the lines from the one in front
+// of the edit up to the first line break that matches a line break of the old layout are redone.
+void GxTextRenderer::Relayout(GxTextLayoutData& layout, int pos, int oldEnd, int newEnd)
+{
+	SetLayout(layout);
+
+	// Find the line on which the edit starts; a word wrapped line can move back to the previous line.
+	std::vector<Line>& lines = *myLines;
+	const int lineIndex = lines.empty() ? 0 : GxMax(0, myFindLine(pos) - 1);
+
+	// Keep the old lines after the edit, they can be reused once the new line breaks match up.
+	mySyncTail.assign(lines.begin() + lineIndex, lines.end());
+	mySyncEnd = oldEnd;
+	mySyncDelta = newEnd - oldEnd;
+	myProcess(lineIndex);
+	mySyncTail.clear();
+
+	layout.textW = myTextW;
+	layout.textH = myTextH;
+}
+
+// Copies the text settings and looks up the font data.
+void GxTextRenderer::myApplySettings(const GxText& settings, const char* text, int len)
 {
 	myStr = (const uchar*)text;
-	myLen = GxStrLen(text);
+	myLen = len;
 
 	GxFontDatabaseImp* database = GxFontDatabaseImp::singleton;
 	myRangeBegin   = GxMax(0, settings.rangeBegin);
@@ -373,35 +625,111 @@ void GxTextRenderer::SetText(const GxText& settings, const char* text)
 	myIsKerning    = settings.HasFlag(GX_TF_KERNING) && myFont->kernCount > 0;
 	myAlignH       = settings.alignH;
 	myAlignV       = settings.alignV;
+	myMaxLines     = MAX_TEXT_LINES;
+}
+
+// Breaks the string into lines, starting at the line with the given index. The lines in front of it are kept.
+void GxTextRenderer::myProcess(int lineIndex)
+{
+	std::vector<Line>& lines = *myLines;
+	int begin = 0, state = GT_NORMAL;
+	if(lineIndex < (int)lines.size())
+	{
+		begin = lines[lineIndex].begin;
+		state = lines[lineIndex].state;
+	}
+	lines.resize(GxMin(lineIndex, (int)lines.size()));
 
-	myTextW = myTextH = 0;
-	myLines.clear();
-	myResetPos();
+	mySeek(begin, state);
 
 	bool softBreaks = myMaxWidth >= 0 && !myIsEllipsis && !myIsSingleLine;
-	softBreaks ? myProcessWithBreaks() : myProcessWithoutBreaks();
-	myTextH = GxMax(1, (int)myLines.size()) * myFont->fontSize;
+	softBreaks ? myProcessWithBreaks(begin, state) : myProcessWithoutBreaks(begin, state);
+	myFinishLayout();
+}
+
+// Computes the size of the text rectangle from the lines.
+void GxTextRenderer::myFinishLayout()
+{
+	const std::vector<Line>& lines = *myLines;
+	myTextW = 0;
+	for(size_t l=0; l<lines.size(); ++l)
+		myTextW = GxMax(myTextW, (int)lines[l].textW);
+	myTextH = GxMax(1, (int)lines.size()) * myFont->fontSize;
+}
+
+// Called by Relayout after a line was added. If the next line starts at the same position and with the same
+// formatting state as one of the old lines after the edit, the remaining old lines are moved into the layout.
+bool GxTextRenderer::mySyncLines(int nextBegin, int nextState)
+{
+	const int oldBegin = nextBegin - mySyncDelta;
+	if(mySyncTail.empty() || oldBegin < mySyncEnd) return false;
+
+	// The old lines are sorted on their start position, so we can use a binary search.
+	int lo = 0, hi = (int)mySyncTail.size();
+	while(lo < hi)
+	{
+		const int mid = (lo + hi) >> 1;
+		if(mySyncTail[mid].begin < oldBegin) lo = mid + 1; else hi = mid;
+	}
+	if(lo == (int)mySyncTail.size() || mySyncTail[lo].begin != oldBegin || mySyncTail[lo].state != nextState)
+		return false;
+
+	std::vector<Line>& lines = *myLines;
+	for(size_t l=lo; l<mySyncTail.size(); ++l)
+	{
+		Line line = mySyncTail[l];
+		line.begin += mySyncDelta;
+		line.end += mySyncDelta;
+		lines.push_back(line);
+	}
+	return true;
+}
+
+// Returns the index of the line on which the character at charIndex resides.
+int GxTextRenderer::myFindLine(int charIndex) const
+{
+	const std::vector<Line>& lines = *myLines;
+	int lo = 0, hi = (int)lines.size();
+	while(hi - lo > 1)
+	{
+		const int mid = (lo + hi) >> 1;
+		if(lines[mid].begin <= charIndex) lo = mid; else hi = mid;
+	}
+	return lo;
+}
+
+// Returns the range of lines that overlap the scissor rectangle, or all lines if the text is not clipped.
+void GxTextRenderer::myGetVisibleLines(float y, int& first, int& last) const
+{
+	first = 0, last = (int)myLines->size();
+	if(!myIsClipped) return;
+
+	const GxRecti clip = GxDraw::Get()->GetScissorRect();
+	const int fontSize = myFont->fontSize;
+	first = GxClamp((clip.y - (int)y) / fontSize - 1, 0, last);
+	last = GxClamp((clip.y + clip.h - (int)y) / fontSize + 2, first, last);
 }
 
 // Pre-processes the text and breaks it down into horizontal lines.
 // This variant breaks on a newline character, or if the line width exceeds the maximum width.
-void GxTextRenderer::myProcessWithBreaks()
+void GxTextRenderer::myProcessWithBreaks(int begin, int beginState)
 {
-	int begin = 0;
 	Pen pen = { 0, 0, 1.f };
-	BreakInfo cur = {0, 0, 0};
-	BreakInfo brk = {0, 0, 0};
+	BreakInfo cur = {0, 0, 0, 0, 0};
+	BreakInfo brk = {0, 0, 0, 0, 0};
 	bool inWhitespace = false;
 	bool validBreak = false;
 	bool newline = false;
 
 	// Make a list of every horizontal line of text.
-	while(myLines.size() < 2048) // Prevents absurd amount of lines, should be enough...
+	while((int)myLines->size() < myMaxLines)
 	{
 		// Get the next character in the string.
+		const int state = myGetState();
 		const Glyph& glyph = myNextChar();
 		if(myPos == myLen) break;
 		cur.end = myPos;
+		cur.state = state;
 
 		// Advance to the start of this character.
 		pen.x = cur.lineW;
@@ -420,19 +748,23 @@ void GxTextRenderer::myProcessWithBreaks()
 			// If we don't have a valid break or hit a newline, we break in front of this character.
 			if(newline || !validBreak)
 			{
-				myAddLine(begin, cur, false);
+				myAddLine(begin, beginState, cur, false);
 				cur.lineW = cur.spaceW = 0.f;
+				if(glyph.codepoint == C_HTAB) pen.advance = myTabWidth; // Tabs align to the start of the new line.
 				begin = cur.end;
+				beginState = cur.state;
 			}
 			else // Otherwise, we break at the last suitable break position (word wrap).
 			{
 				cur.spaceW -= brk.spaceW;
 				cur.lineW -= brk.lineW;
-				myAddLine(begin, brk, myIsJustified);
+				myAddLine(begin, beginState, brk, myIsJustified);
 				begin = brk.end;
+				beginState = brk.state;
 			}
 			inWhitespace = validBreak = newline = false;
 			cur.trailW = 0.f;
+			if(mySyncLines(begin, beginState)) return;
 		}
 
 		// Process the current character.
@@ -453,19 +785,18 @@ void GxTextRenderer::myProcessWithBreaks()
 	// Finally, add left over characters to the last line.
 	cur.end = myLen;
 	cur.lineW += pen.advance;
-	if(begin < myLen) myAddLine(begin, cur, false);
+	if(begin < myLen) myAddLine(begin, beginState, cur, false);
 }
 
 // Pre-processes the text and breaks it down into horizontal lines.
 // This variant only breaks on a newline character.
-void GxTextRenderer::myProcessWithoutBreaks()
+void GxTextRenderer::myProcessWithoutBreaks(int begin, int beginState)
 {
-	int begin = 0;
 	Pen pen = { 0, 0, 1.f };
 	Ellipsis ellipsis = { 0, 0, false };
 
 	// Make a list of every horizontal line of text.
-	while(myLines.size() < 2048) // Prevents absurd amount of lines, should be enough...
+	while((int)myLines->size() < myMaxLines)
 	{
 		// Get the next character in the string.
 		const Glyph& glyph = myNextChar();
@@ -485,24 +816,26 @@ void GxTextRenderer::myProcessWithoutBreaks()
 		// Check if we are forced to break the line and continue on a new line.
 		if(glyph.codepoint == C_LINE_FEED && !myIsSingleLine)
 		{
-			myAddLine(begin, myReadPos, pen.x, ellipsis);
+			myAddLine(begin, beginState, myReadPos, pen.x, ellipsis);
 			ellipsis.x = pen.x = pen.advance = 0.f;
 			ellipsis.end = begin = myReadPos;
 			ellipsis.add = false;
+			beginState = myGetState();
+			if(mySyncLines(begin, beginState)) return;
 		}
 	}
 
 	// Finally, add left over characters to the last line.
 	pen.x += pen.advance;
-	if(begin < myLen) myAddLine(begin, myLen, pen.x, ellipsis);
+	if(begin < myLen) myAddLine(begin, beginState, myLen, pen.x, ellipsis);
 }
 
 // This line adding function is used by myProcessWithBreaks.
-void GxTextRenderer::myAddLine(int begin, const BreakInfo& b, bool justify)
+void GxTextRenderer::myAddLine(int begin, int state, const BreakInfo& b, bool justify)
 {
 	float lineW  = b.lineW - b.trailW;
 	float spaceW = b.spaceW - b.trailW;
-	Line line = { begin, b.end, lineW, 1.f, false, justify };
+	Line line = { begin, b.end, lineW, 1.f, false, justify, state, lineW };
 
 	// If the line is justified, we calculate the whitespace scalar.
 	if(justify && spaceW > 0)
@@ -512,14 +845,13 @@ void GxTextRenderer::myAddLine(int begin, const BreakInfo& b, bool justify)
 		line.width = textW + spaceW * line.spacemul;
 	}
 
-	myTextW = GxMax(myTextW, (int)lineW);
-	myLines.push_back(line);
+	myLines->push_back(line);
 }
 
 // This line adding function is used by myProcessWithoutBreaks.
-void GxTextRenderer::myAddLine(int begin, int end, float width, const Ellipsis& ellipsis)
+void GxTextRenderer::myAddLine(int begin, int state, int end, float width, const Ellipsis& ellipsis)
 {
-	Line line = { begin, end, width, 1.f, ellipsis.add, false };
+	Line line = { begin, end, width, 1.f, ellipsis.add, false, state, width };
 
 	// Adjust the line if ellipsis are inserted somewhere.
 	if(ellipsis.add)
@@ -528,8 +860,7 @@ void GxTextRenderer::myAddLine(int begin, int end, float width, const Ellipsis&
 		line.width = ellipsis.x + myFont->ellipsisW;
 	}
 
-	myTextW = GxMax(myTextW, (int)width);
-	myLines.push_back(line);
+	myLines->push_back(line);
 }
 
 // ===================================================================================
@@ -541,36 +872,22 @@ void GxTextRenderer::myAddLine(int begin, int end, float width, const Ellipsis&
 // Used by the rendering functions to reserve vertices for rendering quads.
 void GxTextRenderer::myResizeBuffers(int quadCount)
 {
-	if(quadCount*4 <= (int)myVertexBuffer.size()) return;
-
-	// Resize vertex buffer.
-	size_t numVertices = (size_t)(quadCount * 4);
-	myVertexBuffer.resize(numVertices);
-
-	// Resize index buffer.
-	size_t numIndices = (size_t)(quadCount * 6);
-	size_t begin = myIndexBuffer.size();
-	myIndexBuffer.resize(numIndices);
-	uint* ptr = (uint*)(&myIndexBuffer[begin]);
-	for(size_t i=begin, j=begin/6*4; i<numIndices; i+=6, j+=4)
-	{
-		*ptr++ = j, *ptr++ = j+1, *ptr++ = j+3;
-		*ptr++ = j, *ptr++ = j+3, *ptr++ = j+2;
-	}
+	if(quadCount*4 > (int)myVertexBuffer.size())
+		myVertexBuffer.resize((size_t)(quadCount * 4));
 }
 
 // Used by the rendering functions to render a single glyph quad.
-void GxTextRenderer::myEmitQuad(const Glyph& glyph, int& index, float x, float y)
+void GxTextRenderer::myEmitQuad(const Glyph& glyph, const GxAreaf& uvs, int& index, float x, float y)
 {
 	const float a = floor(x + glyph.coords.l);
 	const float b = floor(y + glyph.coords.t);
 	const float c = floor(x + glyph.coords.r);
 	const float d = floor(y + glyph.coords.b);
 
-	const float e = glyph.uvs.l;
-	const float f = glyph.uvs.t;
-	const float g = glyph.uvs.r;
-	const float h = glyph.uvs.b;
+	const float e = uvs.l;
+	const float f = uvs.t;
+	const float g = uvs.r;
+	const float h = uvs.b;
 
 	const GxColor ct = myColorT;
 	const GxColor cb = myColorB;
@@ -594,13 +911,12 @@ void GxTextRenderer::myEmitQuad(const Glyph& glyph, int& index, float x, float y
 
 #undef SetVertex
 
+// Adds the quads to the batch of GxDraw, so consecutive text that uses the same texture is drawn at once.
 void GxTextRenderer::myRenderQuads(int begin, int count, GxTextureHandle tex)
 {
-	GxDraw::Get()->Flush();
-	GxRenderInterface* renderer = GxRenderInterface::Get();
-	const uint* i = &myIndexBuffer.front() + begin;
-	const GxVertex* v = &myVertexBuffer.front();
-	renderer->DrawTriangles(v, (int)myVertexBuffer.size(), i, count, tex);
+	const int quadCount = count / 6;
+	GxVertex* v = GxDraw::Get()->BatchQuads(quadCount, tex);
+	memcpy(v, &myVertexBuffer.front() + begin / 6 * 4, sizeof(GxVertex) * quadCount * 4);
 }
 
 // ===================================================================================
@@ -608,41 +924,58 @@ void GxTextRenderer::myRenderQuads(int begin, int count, GxTextureHandle tex)
 
 void GxTextRenderer::myDrawText(float x, float y)
 {
-	const int lineCount = (int)myLines.size();
+	int first, last;
+	myGetVisibleLines(y, first, last);
+
+	// If the font is drawn from the glyph atlas, the glyph pages are the pages of the atlas.
+	GxGlyphAtlas* atlas = myFont->atlasId ? GxGlyphAtlas::singleton : NULL;
+	if(atlas) atlas->BeginDraw();
+
+	int page;
+	GxAreaf uvs, periodUVs;
 	const Glyph& period = myFont->GetGlyph('.');
+	const int periodPage = GetGlyphPage(atlas, myFont, period, periodUVs);
 
 	// Count the total number of quads and the number of quads per glyph page.
-	const int pageCount = myFont->glyphPageCount;
-	std::vector<PageQuads> quads(pageCount);
+	std::vector<PageQuads> quads(atlas ? atlas->GetPageCount() : myFont->glyphPageCount);
 
-	myResetPos();
+	myHasUnderlines = false;
 	int quadTotal = 0;
-	for(int l=0; l<lineCount; ++l)
+	for(int l=first; l<last; ++l)
 	{
 		// Count the number of glyph quads.
-		const Line& line = myLines[l];
-		mySkipTo(line.begin);
+		const Line& line = (*myLines)[l];
+		mySeek(line.begin, line.state);
 		while(myReadPos < line.end)
 		{
 			const Glyph& glyph = myNextChar();
 			if(myInRange() && NonWhitespace(glyph))
 			{
-				if(glyph.page >= 0)
-					++quads[glyph.page].count;
-				++quadTotal;
+				if(glyph.page < 0)
+					++quadTotal;
+				else if((page = GetGlyphPage(atlas, myFont, glyph, uvs)) >= 0)
+					CountQuad(quads, page), ++quadTotal;
+				else if(page == PENDING_PAGE)
+					++quadTotal;
 			}
 		}
 
 		// If there are ellipsis, count three extra quads.
-		if(line.ellipsis)
+		if(line.ellipsis && periodPage >= 0)
+		{
+			for(int j=0; j<3; ++j)
+				CountQuad(quads, periodPage);
+			quadTotal += 3;
+		}
+		else if(line.ellipsis && periodPage == PENDING_PAGE)
 		{
-			quads[period.page].count += 3;
 			quadTotal += 3;
 		}
 	}
 	if(quadTotal == 0) return;
 
 	// If there is a shadow effect, each quad has an additional shadow quad.
+	const int pageCount = (int)quads.size();
 	if(myColorS.a)
 	{
 		for(int i=0; i<pageCount; ++i)
@@ -662,16 +995,16 @@ void GxTextRenderer::myDrawText(float x, float y)
 	}
 
 	// Fill in the vertex data and make a list of custom glyphs, which are rendered afterwards.
-	myResetPos();
 	myCustomGlyphs.clear();
-	for(int l=0; l<lineCount; ++l)
+	myPendingGlyphs.clear();
+	for(int l=first; l<last; ++l)
 	{
-		const Line& line = myLines[l];
+		const Line& line = (*myLines)[l];
 		Pen pen = { 0, 0, line.spacemul };
 		const float ox = x + GetOffsetX(myAlignH, line.width);
 		const float oy = y + (float)((l+1) * myFont->fontSize);
 
-		mySkipTo(line.begin);
+		mySeek(line.begin, line.state);
 		while(myReadPos < line.end)
 		{
 			// If this is a printable character, we will emit a quad for it.
@@ -679,31 +1012,51 @@ void GxTextRenderer::myDrawText(float x, float y)
 			myAdvance(pen, glyph);
 			if(myInRange() && NonWhitespace(glyph))
 			{
-				if(glyph.page >= 0)
-					myEmitQuad(glyph, quads[glyph.page].index, ox + pen.x, oy);
-				else
+				if(glyph.page < 0)
 					myCustomGlyphs.push_back(CGGxRecti(&glyph, ox + pen.x, oy));
+				else if((page = GetGlyphPage(atlas, myFont, glyph, uvs)) >= 0)
+					myEmitQuad(glyph, uvs, quads[page].index, ox + pen.x, oy);
+				else if(page == PENDING_PAGE)
+					myPendingGlyphs.push_back(CGGxRecti(&glyph, ox + pen.x, oy));
 			}
 		}
 
 		// If there are ellipsis, emit quads for them.
-		if(line.ellipsis)
+		if(line.ellipsis && periodPage >= 0)
 		{
 			pen.x += pen.advance;
-			int& index = quads[period.page].index;
+			int& index = quads[periodPage].index;
 			for(int j=0; j<3; ++j, pen.x += period.xAdvance)
-				myEmitQuad(period, index, ox + pen.x, oy);
+				myEmitQuad(period, periodUVs, index, ox + pen.x, oy);
+		}
+		else if(line.ellipsis && periodPage == PENDING_PAGE)
+		{
+			pen.x += pen.advance;
+			for(int j=0; j<3; ++j, pen.x += period.xAdvance)
+				myPendingGlyphs.push_back(CGGxRecti(&period, ox + pen.x, oy));
 		}
 	}
 
 	// Finally it's time to render the glyph vertices.
+	if(atlas) atlas->Commit();
 	for(int i=0, idx=0, count=0; i<pageCount; ++i)
 	{
+		GxTextureHandle texture = atlas ? atlas->GetTexture(i) : myFont->glyphPages[i].texture;
 		if(count = quads[i].count*6)
-			myRenderQuads(idx, count, myFont->glyphPages[i].texture);
+			myRenderQuads(idx, count, texture);
 		idx += count;
 	}
 
+	// Glyphs that were added to atlas pages which can not be regenerated again during this frame
+	// are drawn from the glyph pages of the font. They fit in the vertices of the glyphs above.
+	for(size_t i=0; i<myPendingGlyphs.size(); ++i)
+	{
+		int idx = 0;
+		const CGGxRecti& r = myPendingGlyphs[i];
+		myEmitQuad(*r.glyph, r.glyph->uvs, idx, r.x, r.y);
+		myRenderQuads(0, idx*6, myFont->GetPageTexture(r.glyph->page));
+	}
+
 	// And after that, render the custom glyphs.
 	if(myCustomGlyphs.size() > 0)
 	{
@@ -714,7 +1067,7 @@ void GxTextRenderer::myDrawText(float x, float y)
 		{
 			int idx = 0;
 			const CGGxRecti& r = myCustomGlyphs[i];
-			myEmitQuad(*myCustomGlyphs[i].glyph, idx, r.x, r.y);
+			myEmitQuad(*r.glyph, r.glyph->uvs, idx, r.x, r.y);
 			myRenderQuads(0, idx*6, database->GetCustomGlyphTexture(r.glyph));
 		}
 	}
@@ -724,18 +1077,18 @@ void GxTextRenderer::myDrawUnderlines(float x, float y)
 {
 	// Fill in the vertex data by rendering out the lines of rects.	
 	Glyph rect = { GxAreaf(0,1,0,2), GxAreaf(), 0, 0, 0, 0 };
-	myResetPos();
-	int index = 0;
-	for(size_t l=0; l<myLines.size(); ++l)
+	int first, last, index = 0;
+	myGetVisibleLines(y, first, last);
+	for(int l=first; l<last; ++l)
 	{
-		const Line& line = myLines[l];
+		const Line& line = (*myLines)[l];
 		Pen pen = { 0, 0, line.spacemul };
 		const float ox = x + GetOffsetX(myAlignH, line.width);
 		const float oy = y + (int)((l+1) * myFont->fontSize);
 
 		// Emit underline quads for the current line.
 		bool drawing = false;
-		mySkipTo(line.begin);
+		mySeek(line.begin, line.state);
 		while(myReadPos < line.end)
 		{
 			const Glyph& glyph = myNextChar();
@@ -750,7 +1103,7 @@ void GxTextRenderer::myDrawUnderlines(float x, float y)
 				if(!myInUnderline)
 				{
 					myResizeBuffers(index + 2);
-					myEmitQuad(rect, index, ox, oy);
+					myEmitQuad(rect, rect.uvs, index, ox, oy);
 					drawing = false;
 				}
 				else if(NonWhitespace(glyph))
@@ -762,7 +1115,7 @@ void GxTextRenderer::myDrawUnderlines(float x, float y)
 		if(drawing)
 		{
 			myResizeBuffers(index + 2);
-			myEmitQuad(rect, index, ox, oy);
+			myEmitQuad(rect, rect.uvs, index, ox, oy);
 		}
 	}
 
@@ -775,23 +1128,23 @@ void GxTextRenderer::myDrawUnderlines(float x, float y)
 
 void GxTextRenderer::myDrawHighlight(float x, float y)
 {
-	const int lineCount = (int)myLines.size();
-	myResizeBuffers(lineCount * 2);
+	int first, last;
+	myGetVisibleLines(y, first, last);
+	myResizeBuffers((last - first) * 2);
 
 	// Fill in the vertex data by rendering out the lines of rects.	
 	Glyph rect = { GxAreaf(0,(float)-myFont->fontSize,0,0), GxAreaf(), 0, 0, 0, 0 };
-	myResetPos();
 	int index = 0;
-	for(int l=0; l<lineCount; ++l)
+	for(int l=first; l<last; ++l)
 	{
-		const Line& line = myLines[l];
+		const Line& line = (*myLines)[l];
 		Pen pen = { 0, 0, line.spacemul };
 		const float ox = x + GetOffsetX(myAlignH, line.width);
 		const float oy = y + (float)((l+1) * myFont->fontSize);
 
 		// Find the x-position of the start and end of the highlight rectangle.
 		bool started = false;
-		mySkipTo(line.begin);
+		mySeek(line.begin, line.state);
 		while(myReadPos < line.end)
 		{
 			const Glyph& glyph = myNextChar();
@@ -805,7 +1158,7 @@ void GxTextRenderer::myDrawHighlight(float x, float y)
 		}
 
 		// Emit a quad for the highlight rectangle.
-		if(started) myEmitQuad(rect, index, ox, oy);
+		if(started) myEmitQuad(rect, rect.uvs, index, ox, oy);
 	}
 
 	// Finally it's time to render the vertices.
@@ -818,16 +1171,14 @@ void GxTextRenderer::myDrawHighlight(float x, float y)
 GxRecti GxTextRenderer::myGetCharRect(float x, float y, int charIndex)
 {
 	// Empty string.
-	if(myLines.empty())
+	if(myLines->empty())
 		return GxRecti((int)x, (int)y, 0, myFont->fontSize);
 
 	// Find the correct line number.
-	int lineIndex = 0;
-	for(int l=0; l<(int)myLines.size() && myLines[l].begin <= charIndex; ++l)
-		lineIndex = l;
+	const int lineIndex = myFindLine(charIndex);
 
 	// Process the line on which the character resides.
-	const Line& line = myLines[lineIndex];
+	const Line& line = (*myLines)[lineIndex];
 	const float ox = x + GetOffsetX(myAlignH, line.width);
 	const float oy = y + (float)(lineIndex * myFont->fontSize);
 
@@ -837,8 +1188,7 @@ GxRecti GxTextRenderer::myGetCharRect(float x, float y, int charIndex)
 
 	// Go through the line until we reach the character at the index.
 	Pen pen = { 0, 0, line.spacemul };
-	myResetPos();
-	mySkipTo(line.begin);
+	mySeek(line.begin, line.state);
 	while(myReadPos < line.end)
 	{
 		const Glyph& glyph = myNextChar();
@@ -848,7 +1198,7 @@ GxRecti GxTextRenderer::myGetCharRect(float x, float y, int charIndex)
 	}
 
 	// If the final line ends with a line feed, we return the start of the next line.
-	if(myReadPos == myLen && myStr[myPos] == C_LINE_FEED)
+	if(myReadPos == myLen && myAt(myPos) == C_LINE_FEED)
 		return GxRecti((int)ox, (int)oy + myFont->fontSize, 0, myFont->fontSize);
 
 	// If not, we just return the end of the final line.
@@ -861,23 +1211,20 @@ GxRecti GxTextRenderer::myGetCharRect(float x, float y, int charIndex)
 int GxTextRenderer::myGetCharIndex(int x, int y, int cx, int cy)
 {
 	// Check if the character is before the start or after the end of the text.
-	if(cy <= y || myLines.empty()) return 0;
+	if(cy <= y || myLines->empty()) return 0;
 	if(cy >= y + myTextH) return myLen;
 
-	// Find the correct line number.
-	int lineIndex = 0;
-	for(int l=0, ly=y; l<(int)myLines.size() && cy>=ly; ly += myFont->fontSize, ++l)
-		lineIndex = l;
+	// Find the correct line number; all lines have the same height.
+	const int lineIndex = GxMin((cy - y) / myFont->fontSize, (int)myLines->size() - 1);
 
 	// Process the line on which the character resides.
-	const Line& line = myLines[lineIndex];
+	const Line& line = (*myLines)[lineIndex];
 	const float ox = (float)x + GetOffsetX(myAlignH, line.width);
 	const float px = (float)cx;
 
 	// Go through each character.
 	Pen pen = { 0, 0, line.spacemul };
-	myResetPos();
-	mySkipTo(line.begin);
+	mySeek(line.begin, line.state);
 	while(myReadPos < line.end)
 	{
 		const Glyph& glyph = myNextChar();
@@ -886,7 +1233,7 @@ int GxTextRenderer::myGetCharIndex(int x, int y, int cx, int cy)
 	}
 
 	// Only the last line is allowed to return one beyond the last character.
-	if(myReadPos == myLen && myStr[myPos] != C_LINE_FEED) return myLen;
+	if(myReadPos == myLen && myAt(myPos) != C_LINE_FEED) return myLen;
 
 	// Otherwise, just return the last character.
 	return myPos;
@@ -900,6 +1247,32 @@ const int GxText::npos()
 	return _npos;
 }
 
+void GxText::SetCacheCapacity(int layouts)
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) renderer->SetCacheCapacity(layouts);
+}
+
+GxTextCacheStats GxText::GetCacheStats()
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) return renderer->GetCacheStats();
+	GxTextCacheStats stats = {0, 0, 0, 0};
+	return stats;
+}
+
+void GxText::ResetCacheStats()
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) renderer->ResetCacheStats();
+}
+
+void GxText::ClearCache()
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) renderer->ClearCache();
+}
+
 GxText::GxText()
 	:shadow     (0, 0, 0, 0)
 	,top        (255, 255, 255, 255)
@@ -986,5 +1359,120 @@ bool GxText::HasFlag(GxTextFlags f) const
 	return (flags & f) == f;
 }
 
+// ===================================================================================
+// GxTextLayout
+
+GxTextLayout::~GxTextLayout()
+{
+	delete myData;
+}
+
+GxTextLayout::GxTextLayout()
+	:myData(new GxTextLayoutData)
+{
+}
+
+GxTextLayout::GxTextLayout(const GxTextLayout& other)
+	:myData(new GxTextLayoutData(*other.myData))
+{
+}
+
+void GxTextLayout::SetSettings(const GxText& settings)
+{
+	const GxText& old = myData->settings;
+	const bool relayout = old.font.GetHandle() != settings.font.GetHandle()
+		|| old.flags != settings.flags || old.maxWidth != settings.maxWidth || old.tabWidth != settings.tabWidth
+		|| (myData->lines.empty() && !myData->text.Empty());
+
+	myData->settings = settings;
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer && relayout) renderer->Layout(*myData);
+}
+
+void GxTextLayout::SetText(GxStringArg text)
+{
+	myData->text.Set(text);
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) renderer->Layout(*myData);
+}
+
+void GxTextLayout::Insert(int pos, GxStringArg text)
+{
+	pos = GxClamp(pos, 0, myData->text.Length());
+	myData->text.Insert(pos, text);
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) renderer->Relayout(*myData, pos, pos, pos + text.len);
+}
+
+void GxTextLayout::Erase(int pos, int n)
+{
+	pos = GxClamp(pos, 0, myData->text.Length());
+	n = GxClamp(n, 0, myData->text.Length() - pos);
+	myData->text.Erase(pos, n);
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(renderer) renderer->Relayout(*myData, pos, pos + n, pos);
+}
+
+GxRecti GxTextLayout::Draw(int x, int y) const
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(!renderer) return GxRecti(x, y, 0, 0);
+	renderer->SetLayout(*myData);
+	return renderer->DrawText(x, y);
+}
+
+GxRecti GxTextLayout::DrawHighlight(int x, int y) const
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(!renderer) return GxRecti(x, y, 0, 0);
+	renderer->SetLayout(*myData);
+	return renderer->DrawHighlight(x, y);
+}
+
+GxRecti GxTextLayout::GetTextRect(int x, int y) const
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(!renderer) return GxRecti(x, y, 0, 0);
+	renderer->SetLayout(*myData);
+	return renderer->GetTextRect(x, y);
+}
+
+GxRecti GxTextLayout::GetCharRect(int x, int y, int charIndex) const
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(!renderer) return GxRecti(x, y, 0, 0);
+	renderer->SetLayout(*myData);
+	return renderer->GetCharRect(x, y, charIndex);
+}
+
+int GxTextLayout::GetCharIndex(int x, int y, int cx, int cy) const
+{
+	GxTextRenderer* renderer = GxTextRenderer::singleton;
+	if(!renderer) return 0;
+	renderer->SetLayout(*myData);
+	return renderer->GetCharIndex(x, y, cx, cy);
+}
+
+int GxTextLayout::GetLineCount() const
+{
+	return (int)myData->lines.size();
+}
+
+const GxTextBuffer& GxTextLayout::GetText() const
+{
+	return myData->text;
+}
+
+const GxText& GxTextLayout::GetSettings() const
+{
+	return myData->settings;
+}
+
+GxTextLayout& GxTextLayout::operator = (const GxTextLayout& other)
+{
+	*myData = *other.myData;
+	return *this;
+}
+
 }; // namespace graphics
 }; // namespace guix
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <GuiX/Text.h>
 #include <GuiX/Draw.h>
 
+#include <Src/GlyphAtlas.h>
 #include <Src/ResourceMap.h>
 
 namespace guix {
@@ -18,6 +19,9 @@ namespace graphics {
 enum MiscProperties
 {
 	DEFAULT_FONT_SIZE = 13,
+	LAYOUT_CACHE_WAYS = 4,
+	LAYOUT_CACHE_SIZE = 2048,
+	MAX_TEXT_LINES    = 2048, // Lines that are laid out for text that is drawn without a retained layout.
 };
 
 enum GlyphTraits
@@ -34,6 +38,11 @@ enum GlyphTraits
 	GT_ALNUM       = GT_ALPHA | GT_DIGIT,
 };
 
+enum LineStates
+{
+	LS_UNDERLINE   = 0x04, // The low bits hold the GT_STYLE_MASK font style.
+};
+
 enum SpecialChars
 {
 	C_TERMINATOR   = 0x0000,
@@ -47,6 +56,8 @@ enum SpecialChars
 struct GlyphPage
 {
 	GxTextureHandle texture;
+	uchar* pixels; // Kept in memory if the glyphs are drawn from the glyph atlas.
+	int width, height;
 };
 
 struct Glyph
@@ -57,6 +68,7 @@ struct Glyph
 	float xAdvance;
 	uint codepoint;
 	int page;
+	mutable int slot; // Most recent glyph atlas slot.
 };
 
 struct CustomGlyph
@@ -75,6 +87,8 @@ struct Line
 	int begin, end;
 	float width, spacemul;
 	bool ellipsis, justified;
+	int state;   // Formatting state at the start of the line.
+	float textW; // Width of the line as it counts towards the text rectangle.
 };
 
 struct CGGxRecti
@@ -90,7 +104,7 @@ struct CGGxRecti
 struct BreakInfo
 {
 	float spaceW, lineW, trailW;
-	int end;
+	int end, state;
 };
 
 struct Ellipsis
@@ -100,6 +114,32 @@ struct Ellipsis
 	bool add;
 };
 
+class GxFontData;
+struct GxAsyncLoad;
+
+struct CachedLayout
+{
+	CachedLayout() : font(NULL), flags(0), maxWidth(0), tabWidth(0), textW(0), textH(0), hash(0), stamp(0) {}
+
+	GxString text;
+	const GxFontData* font;
+	int flags, maxWidth;
+	float tabWidth;
+	int textW, textH;
+	uint hash, stamp;
+	std::vector<Line> lines;
+};
+
+struct GxTextLayoutData
+{
+	GxTextLayoutData() : textW(0), textH(0) { text.SetHistoryEnabled(false); }
+
+	GxText settings;
+	GxTextBuffer text;
+	int textW, textH;
+	std::vector<Line> lines;
+};
+
 // ===================================================================================
 // GxFontData
 
@@ -111,12 +151,15 @@ public:
 
 	void Destroy();
 
-	bool Create(const char* path, const char* dir);
+	bool Create(const char* path, const char* dir, bool async = false);
 	bool Create(const uchar* rgba, int glyphW, int glyphH, int glyphsInW, int glyphsInH, int fontSize, const uint* charset);
+	bool SaveBinary(const char* path) const;
 
 	void SetBold(bool enabled) const;
 	void SetItalic(bool enabled) const;
+	inline int GetStyle() const { return myStyle; }
 	float GetKerning(int leftGlyphIndex, int rightGlyphIndex) const;
+	GxTextureHandle GetPageTexture(int page) const;
 
 	inline int GetGlyphIndex(uint codepoint) const
 	{
@@ -151,17 +194,34 @@ public:
 	// GlyphPage data.
 	GlyphPage* glyphPages;
 	int glyphPageCount;
+	std::vector<GxString> glyphPagePaths;
 
 	// Font information.
 	int fontSize;
 	float ellipsisW;
 
+	// Glyph atlas id, or 0 if the glyphs are drawn from the glyph page textures.
+	uint atlasId;
+
 private:
+	bool myParseText(const char* text, const char* dir);
+	bool myReadBinary(char* data, int size, const char* dir, bool async);
 	int myGetSMPIndex(uint character) const;
 	void mySetSlot(int* map, int pos, const int* indices);
 	void myInsertBlankGlyph(uint codepoint, int traits);
+	void myLoadPage(int index, const char* path);
+	void myScalePage(int index);
+	void myFinishPages();
+	void myCreatePages();
+	static void myApplyPage(void* font, GxAsyncLoad* load);
 	void myFinalize();
 
+	// Memory of a binary font file, which contains the glyph, map and kerning data.
+	char* myFileData;
+
+	// Glyph pages that are loaded on the background thread, or an empty vector.
+	std::vector<GxAsyncLoad*> myPageLoads;
+
 	int myStyleCount;
 	mutable int myStyle, myStyleIndex;
 };
@@ -182,9 +242,10 @@ public:
 
 	void AddGlyph(const char* id, const GxTexture& img, int dy, int dx, int advance);
 	int GetLoadedFontCount() const;
+	bool ConvertFont(const char* textPath, const char* binaryPath);
 	void LogInfo() const;
 
-	bool Load(GxFontHandle& outHandle, const char* path_or_resource);
+	bool Load(GxFontHandle& outHandle, const char* path_or_resource, bool async = false);
 	void AddReference(GxFontHandle handle);
 	void Release(GxFontHandle handle);
 	void MakeDefault(const GxFont& font);
@@ -196,8 +257,9 @@ public:
 
 private:
 	void myCreateFallbacks();
-	bool myLoadFile(GxFontHandle& outHandle, const char* path);
-	GxFontData* myLoadFontData(const char* path);
+	void myClearLayoutCache();
+	bool myLoadFile(GxFontHandle& outHandle, const char* path, bool async);
+	GxFontData* myLoadFontData(const char* path, bool async);
 
 	typedef ResourceMap<GxTextureHandle, GxFontData*> FontMap;
 	typedef std::vector<CustomGlyph> GlyphVec;
@@ -225,15 +287,35 @@ public:
 	~GxTextRenderer();
 
 	void SetText(const GxText& settings, const char* string);
+	void SetLayout(GxTextLayoutData& layout);
+	void Layout(GxTextLayoutData& layout);
+	void Relayout(GxTextLayoutData& layout, int pos, int oldEnd, int newEnd);
+
 	GxRecti DrawText(int x, int y);
 	GxRecti DrawHighlight(int x, int y);
 	GxRecti GetTextRect(int x, int y);
 	GxRecti GetCharRect(int x, int y, int charIndex);
 	int GetCharIndex(int x, int y, int cx, int cy);
 
+	void SetCacheCapacity(int layouts);
+	void ClearCache();
+	void ResetCacheStats();
+	GxTextCacheStats GetCacheStats() const;
+
 private:
-	void myResetPos();
-	void mySkipTo(int pos);
+	CachedLayout* myFindLayout(const GxText& settings, uint hash, bool& outHit);
+	void myStoreLayout(CachedLayout* entry, const GxText& settings, uint hash);
+
+	void myApplySettings(const GxText& settings, const char* string, int len);
+	void myProcess(int lineIndex);
+	void myFinishLayout();
+	bool mySyncLines(int nextBegin, int nextState);
+	int myFindLine(int charIndex) const;
+	void myGetVisibleLines(float y, int& first, int& last) const;
+
+	int myGetState() const;
+	void mySeek(int pos, int state);
+	const uchar* myGetChars(int pos, int len);
 	int myReadMultibyte(int c);
 	const Glyph& myNextChar();
 	const Glyph& myReadTag();
@@ -241,13 +323,13 @@ private:
 	void myAdvanceBare(Pen& pen, const Glyph& g);
 	void myAdvance(Pen& pen, const Glyph& g);
 
-	void myProcessWithBreaks();
-	void myProcessWithoutBreaks();
-	void myAddLine(int, int, float, const Ellipsis&);
-	void myAddLine(int, const BreakInfo&, bool);
+	void myProcessWithBreaks(int begin, int state);
+	void myProcessWithoutBreaks(int begin, int state);
+	void myAddLine(int, int, int, float, const Ellipsis&);
+	void myAddLine(int, int, const BreakInfo&, bool);
 
 	void myResizeBuffers(int quadCount);
-	void myEmitQuad(const Glyph& glyph, int& index, float x, float y);
+	void myEmitQuad(const Glyph& glyph, const GxAreaf& uvs, int& index, float x, float y);
 	void myRenderQuads(int begin, int count, GxTextureHandle tex);
 
 	void myDrawText(float x, float y);
@@ -260,27 +342,44 @@ private:
 	inline bool myInRange() const
 		{ return myPos >= myRangeBegin && myPos < myRangeEnd; }
 
+	// Characters behind the gap of a text buffer are stored myGapSize characters further.
+	inline uchar myAt(int pos) const
+		{ return myStr[pos < myGapPos ? pos : pos + myGapSize]; }
+
 	const GxFontData* myFont;
 	const uchar* myStr;
 
 	int myPos, myReadPos, myLen;
+	int myGapPos, myGapSize;
 	int myKPL, myKPR;
 
 	int myTextW, myTextH;
 	int myRangeBegin, myRangeEnd;
+	int myMaxLines;
 	float myTabWidth, myMaxWidth;
 	GxColor myColorT, myColorB, myColorS;
 	bool myIsWordWrap, myIsJustified;
 	bool myIsFormatted, myIsEllipsis;
 	bool myIsSingleLine, myIsKerning;
 	bool myInUnderline, myHasUnderlines;
+	bool myIsClipped;
 	GxTextAlignH myAlignH;
 	GxTextAlignV myAlignV;
 
-	std::vector<uint> myIndexBuffer;
 	std::vector<GxVertex> myVertexBuffer;
 	std::vector<CGGxRecti> myCustomGlyphs;
-	std::vector<Line> myLines;
+	std::vector<CGGxRecti> myPendingGlyphs;
+	std::vector<uchar> myScratch;
+	std::vector<Line>* myLines;
+	std::vector<Line> myLineBuffer;
+
+	// Old lines of a layout that is being updated by Relayout.
+	std::vector<Line> mySyncTail;
+	int mySyncEnd, mySyncDelta;
+
+	std::vector<CachedLayout> myCache;
+	int myCacheSets, myCacheHits, myCacheMisses;
+	uint myCacheStamp;
 };
 
 }; // namespace graphics
@@ -3,6 +3,7 @@
 #include <GuiX/Resources.h>
 
 #include <Src/TextureImp.h>
+#include <Src/WorkerPool.h>
 
 namespace guix {
 namespace graphics {
@@ -11,6 +12,12 @@ namespace {
 
 static const char* LOG_TAG = "TextureDB";
 
+// Reads the state of an asynchronous load, which is written by the background thread.
+static long GetLoadState(GxAsyncLoad* load)
+{
+	return GxWorkerPool::AtomicAdd(&load->state, 0);
+}
+
 }; // anonymous namespace
 
 // ===================================================================================
@@ -72,6 +79,20 @@ bool GxTexture::Create(const char* path)
 	return (myHandle != 0);
 }
 
+bool GxTexture::CreateAsync(const char* path)
+{
+	GxTextureDatabaseImp* database = GxTextureDatabaseImp::singleton;
+	if(database)
+	{
+		GxTextureHandle oldHandle = myHandle;
+		database->LoadAsync(myHandle, mySize, path);
+		database->Release(oldHandle);
+	}
+	else Destroy();
+
+	return (myHandle != 0);
+}
+
 bool GxTexture::Create(int width, int height, const uchar* pixeldata)
 {
 	GxTextureDatabaseImp* database = GxTextureDatabaseImp::singleton;
@@ -127,8 +148,15 @@ void GxTexture::SetUVs(const GxAreaf& uvs)
 	mySetUVs(&uvs);
 }
 
+bool GxTexture::IsLoading() const
+{
+	myResolve();
+	return (myHandle != 0 && mySize.x == 0);
+}
+
 float GxTexture::GetWidthU() const
 {
+	myResolve();
 	if(myUVs)
 		return (myUVs->r - myUVs->l) * (float)mySize.x;
 	return (float)mySize.x;
@@ -136,6 +164,7 @@ float GxTexture::GetWidthU() const
 
 float GxTexture::GetHeightV() const
 {
+	myResolve();
 	if(myUVs)
 		return (myUVs->b - myUVs->t) * (float)mySize.y;
 	return (float)mySize.y;
@@ -143,16 +172,19 @@ float GxTexture::GetHeightV() const
 
 int GxTexture::GetWidth() const
 {
+	myResolve();
 	return mySize.x;
 }
 
 int GxTexture::GetHeight() const
 {
+	myResolve();
 	return mySize.y;
 }
 
 GxVec2i GxTexture::GetSize() const
 {
+	myResolve();
 	return mySize;
 }
 
@@ -163,6 +195,7 @@ GxAreaf GxTexture::GetUVs() const
 
 GxTextureHandle GxTexture::GetHandle() const
 {
+	myResolve();
 	return myHandle;
 }
 
@@ -172,6 +205,17 @@ GxTexture& GxTexture::operator = (const GxTexture& other)
 	return *this;
 }
 
+// Textures that are loaded asynchronously have a placeholder handle and no size, until
+// the texture database has uploaded the image and they are resolved to the loaded texture.
+void GxTexture::myResolve() const
+{
+	if(myHandle && mySize.x == 0)
+	{
+		GxTextureDatabaseImp* database = GxTextureDatabaseImp::singleton;
+		if(database) database->Resolve(myHandle, mySize);
+	}
+}
+
 void GxTexture::mySetUVs(const GxAreaf* uvs)
 {
 	if(uvs)
@@ -219,6 +263,8 @@ void GxTextureDatabaseImp::Destroy()
 }
 
 GxTextureDatabaseImp::GxTextureDatabaseImp()
+	:myLoadBytes(0)
+	,myLoadGeneration(0)
 {
 }
 
@@ -226,6 +272,20 @@ GxTextureDatabaseImp::~GxTextureDatabaseImp()
 {
 	GxRenderInterface* render = GxRenderInterface::Get();
 
+	// Wait for the background thread to finish the queued loads, and discard them.
+	GxWorkerPool::singleton->WaitQueue();
+	for(size_t i=0; i<myLoads.size(); ++i)
+	{
+		if(myLoads[i]->pixels)
+			render->ReleasePixels(myLoads[i]->pixels);
+		delete myLoads[i];
+	}
+
+	// Placeholders of loads that have completed are no longer in the texture map.
+	PendingMap::iterator itp = myPending.begin();
+	for(; itp != myPending.end(); ++itp)
+		if(!itp->second.isLoading) render->ReleaseTexture(itp->first);
+
 	TexMap::LoadMap::iterator it = myMap.loaded.begin();
 	for(; it != myMap.loaded.end(); ++it)
 		render->ReleaseTexture(it->second.handle);
@@ -243,6 +303,32 @@ bool GxTextureDatabaseImp::Load(GxTextureHandle& outHandle, GxVec2i& outSize, co
 	return myLoadFile(outHandle, outSize, path_or_resource);
 }
 
+bool GxTextureDatabaseImp::LoadAsync(GxTextureHandle& outHandle, GxVec2i& outSize, const char* path_or_resource)
+{
+	outHandle = outSize.x = outSize.y = 0;
+	if(!path_or_resource) return false;
+
+	const char* path = path_or_resource;
+	GxResources::TextureRes res;
+	if(GxResources::Get()->GetResource(path_or_resource, res))
+		path = res.path.Raw();
+
+	if(myMap.GetData(path))
+		return myLoadFile(outHandle, outSize, path);
+
+	// Until the image is decoded and uploaded, the texture is drawn as a transparent pixel.
+	const uchar transparent[4] = {0, 0, 0, 0};
+	if(!GxRenderInterface::Get()->GenerateTexture(outHandle, 1, 1, transparent) || !outHandle)
+		return myLoadFile(outHandle, outSize, path);
+
+	myMap.Insert(outHandle, GxVec2i(0, 0), path);
+
+	Pending pending = {QueueLoad(path, myApplyTexture, this), 0, GxVec2i(0, 0), 0, true};
+	myPending[outHandle] = pending;
+
+	return true;
+}
+
 bool GxTextureDatabaseImp::myLoadFile(GxTextureHandle& outHandle, GxVec2i& outSize, const char* path)
 {
 	TexMap::Ref* ref = myMap.GetData(path);
@@ -283,13 +369,64 @@ bool GxTextureDatabaseImp::Create(GxTextureHandle& outHandle, int width, int hei
 	return (outHandle != 0);
 }
 
+bool GxTextureDatabaseImp::Resolve(GxTextureHandle& handle, GxVec2i& outSize)
+{
+	if(myPending.empty()) return false;
+
+	PendingMap::iterator it = myPending.find(handle);
+	if(it == myPending.end() || it->second.isLoading)
+		return false;
+
+	handle = it->second.handle;
+	outSize = it->second.size;
+	if(--it->second.unresolved == 0)
+		myResolved(it);
+
+	return true;
+}
+
 void GxTextureDatabaseImp::AddReference(GxTextureHandle handle)
 {
+	// A copy of an unresolved texture has to be resolved as well.
+	if(!myPending.empty())
+	{
+		PendingMap::iterator it = myPending.find(handle);
+		if(it != myPending.end() && !it->second.isLoading)
+		{
+			++it->second.unresolved;
+			handle = it->second.handle;
+		}
+	}
 	myMap.AddReference(handle);
 }
 
 void GxTextureDatabaseImp::Release(GxTextureHandle handle)
 {
+	if(!myPending.empty())
+	{
+		PendingMap::iterator it = myPending.find(handle);
+		if(it != myPending.end())
+		{
+			if(it->second.isLoading)
+			{
+				// If the last reference to a texture that is still loading is released, the load is cancelled.
+				TexMap::Ref* ref = myMap.GetData(handle);
+				if(ref && ref->count == 1)
+				{
+					CancelLoad(it->second.load);
+					myPending.erase(it);
+				}
+			}
+			else
+			{
+				GxTextureHandle resolved = it->second.handle;
+				if(--it->second.unresolved == 0)
+					myResolved(it);
+				handle = resolved;
+			}
+		}
+	}
+
 	TexMap::Ref* ref = myMap.Release(handle);
 	if(ref)
 	{
@@ -298,6 +435,151 @@ void GxTextureDatabaseImp::Release(GxTextureHandle handle)
 	}
 }
 
+// Releases the placeholder of a completed load, after every texture that referred to it is resolved.
+void GxTextureDatabaseImp::myResolved(PendingMap::iterator it)
+{
+	GxRenderInterface::Get()->ReleaseTexture(it->first);
+	myPending.erase(it);
+}
+
+GxAsyncLoad* GxTextureDatabaseImp::QueueLoad(const char* path, GxAsyncLoad::Callback callback, void* owner)
+{
+	GxAsyncLoad* load = new GxAsyncLoad;
+	load->path = path;
+	load->callback = callback;
+	load->owner = owner;
+	load->pixels = NULL;
+	load->width = load->height = 0;
+	load->state = GxAsyncLoad::QUEUED;
+
+	myLoads.push_back(load);
+	GxWorkerPool::singleton->Queue(myDecode, load);
+	return load;
+}
+
+void GxTextureDatabaseImp::CancelLoad(GxAsyncLoad* load)
+{
+	load->callback = NULL;
+	load->owner = NULL;
+}
+
+// Decodes an image on the background thread.
+void GxTextureDatabaseImp::myDecode(void* data, int)
+{
+	GxAsyncLoad* load = (GxAsyncLoad*)data;
+
+	uchar* pixels = NULL;
+	int w = 0, h = 0;
+	if(GxRenderInterface::Get()->LoadPixels(pixels, w, h, load->path.Raw()) && pixels)
+	{
+		load->pixels = pixels;
+		load->width = w;
+		load->height = h;
+		GxWorkerPool::AtomicAdd(&singleton->myLoadBytes, w * h * 4);
+	}
+	GxWorkerPool::AtomicAdd(&load->state, pixels ? GxAsyncLoad::DECODED : GxAsyncLoad::FAILED);
+}
+
+// Uploads the image of a texture that was loaded asynchronously. The texture map refers to the
+// loaded texture from now on, and the references to the placeholder are resolved one by one.
+void GxTextureDatabaseImp::myApplyTexture(void* data, GxAsyncLoad* load)
+{
+	GxTextureDatabaseImp* database = (GxTextureDatabaseImp*)data;
+	GxRenderInterface* render = GxRenderInterface::Get();
+
+	TexMap::Ref* ref = database->myMap.GetData(load->path.Raw());
+	PendingMap::iterator it = database->myPending.find(ref ? ref->handle : 0);
+	if(it == database->myPending.end()) return;
+
+	// If the renderer can not decode images on the background thread, the texture is loaded here.
+	GxTextureHandle handle = 0;
+	GxVec2i size(0, 0);
+	if(load->pixels)
+	{
+		if(render->GenerateTexture(handle, load->width, load->height, load->pixels))
+			size.Set(load->width, load->height);
+	}
+	else
+	{
+		render->LoadTexture(handle, size.x, size.y, load->path.Raw());
+	}
+	if(!handle || size.x <= 0 || size.y <= 0)
+	{
+		GxLog(LOG_TAG, GX_LT_WARNING, "Failed to load \"%s\"", load->path.Raw());
+		if(handle) render->ReleaseTexture(handle);
+		handle = 0;
+		size.Set(0, 0);
+	}
+
+	const int count = ref->count;
+	database->myMap.Erase(it->first);
+	if(handle)
+	{
+		database->myMap.Insert(handle, size, load->path.Raw());
+		database->myMap.GetData(handle)->count = count;
+	}
+
+	Pending& pending = it->second;
+	pending.handle = handle;
+	pending.size = size;
+	pending.unresolved = count;
+	pending.isLoading = false;
+	pending.load = NULL;
+}
+
+int GxTextureDatabaseImp::ApplyLoads(bool wait)
+{
+	if(myLoads.empty()) return 0;
+	if(wait) GxWorkerPool::singleton->WaitQueue();
+
+	// Loads are applied in the order in which they were queued.
+	int applied = 0;
+	size_t count = 0;
+	for(size_t i=0; i<myLoads.size(); ++i)
+	{
+		GxAsyncLoad* load = myLoads[i];
+		if(GetLoadState(load) == GxAsyncLoad::QUEUED)
+		{
+			myLoads[count++] = load;
+			continue;
+		}
+		if(load->callback)
+		{
+			load->callback(load->owner, load);
+			++applied;
+		}
+		if(load->width > 0)
+			GxWorkerPool::AtomicAdd(&myLoadBytes, -(load->width * load->height * 4));
+		if(load->pixels)
+			GxRenderInterface::Get()->ReleasePixels(load->pixels);
+		delete load;
+	}
+	myLoads.resize(count);
+
+	if(applied > 0)
+		++myLoadGeneration;
+
+	return applied;
+}
+
+int GxTextureDatabaseImp::GetLoadGeneration() const
+{
+	return myLoadGeneration;
+}
+
+int GxTextureDatabaseImp::GetPendingLoadCount() const
+{
+	int count = 0;
+	for(size_t i=0; i<myLoads.size(); ++i)
+		if(myLoads[i]->callback) ++count;
+	return count;
+}
+
+size_t GxTextureDatabaseImp::GetPendingLoadBytes() const
+{
+	return (size_t)GxWorkerPool::AtomicAdd(const_cast<volatile long*>(&myLoadBytes), 0);
+}
+
 int GxTextureDatabaseImp::GetLoadedTextureCount() const
 {
 	return myMap.GetLoadedCount();
@@ -305,13 +587,12 @@ int GxTextureDatabaseImp::GetLoadedTextureCount() const
 
 void GxTextureDatabaseImp::LogInfo() const
 {
-	GxLog("Loaded files: %i", myMap.files.size());
+	GxLog("Loaded files: %i", myMap.files.Size());
 	{
-		TexMap::FileMap::const_iterator it = myMap.files.begin();
-		for(; it != myMap.files.end(); ++it)
+		for(int i=0; i<myMap.files.Size(); ++i)
 			GxLog(" path=\"%s\" handle=%i",
-				it->first.Raw(),
-				it->second);
+				myMap.files.GetEntry(i).key.Raw(),
+				myMap.files.GetEntry(i).value);
 		GxLog("");
 	}
 	GxLog("Loaded textures: %i", myMap.loaded.size());
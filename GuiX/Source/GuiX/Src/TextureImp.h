@@ -4,9 +4,39 @@
 
 #include <Src/ResourceMap.h>
 
+#include <vector>
+
 namespace guix {
 namespace graphics {
 
+// ===================================================================================
+// GxAsyncLoad
+// ===================================================================================
+// An image file that is decoded by the background thread of the worker pool. The pixels
+// and state are written by the background thread; the other members are only used by the
+// main thread. When the load is applied, the callback is called with the decoded pixels.
+// The callback can take ownership of the pixels by setting them to NULL; otherwise, the
+// pixels are released with GxRenderInterface::ReleasePixels afterwards.
+
+struct GxAsyncLoad
+{
+	typedef void (*Callback)(void* owner, GxAsyncLoad* load);
+
+	enum State
+	{
+		QUEUED,
+		DECODED,
+		FAILED,
+	};
+
+	GxString path;
+	Callback callback;
+	void* owner;
+	uchar* pixels;
+	int width, height;
+	volatile long state;
+};
+
 // ===================================================================================
 // GxTextureDatabaseImp
 // ===================================================================================
@@ -23,19 +53,49 @@ public:
 	~GxTextureDatabaseImp();
 	
 	int GetLoadedTextureCount() const;
+	int GetPendingLoadCount() const;
+	size_t GetPendingLoadBytes() const;
+	int ApplyLoads(bool wait);
+	int GetLoadGeneration() const;
 	void LogInfo() const;
 
 	bool Load(GxTextureHandle& outHandle, GxVec2i& outSize, const char* path_or_resource);
+	bool LoadAsync(GxTextureHandle& outHandle, GxVec2i& outSize, const char* path_or_resource);
 	bool Create(GxTextureHandle& outHandle, int width, int height, const uchar* pixeldata);
+	bool Resolve(GxTextureHandle& handle, GxVec2i& outSize);
 	void AddReference(GxTextureHandle handle);
 	void Release(GxTextureHandle handle);
 
+	// Queues an image file to be decoded on the background thread. The load is applied
+	// by ApplyLoads, or discarded if it is cancelled before it is applied.
+	GxAsyncLoad* QueueLoad(const char* path, GxAsyncLoad::Callback callback, void* owner);
+	void CancelLoad(GxAsyncLoad* load);
+
 private:
+	// A texture that is loaded asynchronously. GxTexture objects refer to it by a one pixel
+	// placeholder texture, until they are resolved to the loaded texture.
+	struct Pending
+	{
+		GxAsyncLoad* load;
+		GxTextureHandle handle;
+		GxVec2i size;
+		int unresolved;
+		bool isLoading;
+	};
+
+	static void myDecode(void* load, int);
+	static void myApplyTexture(void* database, GxAsyncLoad* load);
 	bool myLoadFile(GxTextureHandle& outHandle, GxVec2i& outSize, const char* path);
+	void myResolved(std::map<GxTextureHandle, Pending>::iterator it);
 
 	typedef ResourceMap<GxTextureHandle, GxVec2i> TexMap;
+	typedef std::map<GxTextureHandle, Pending> PendingMap;
 
 	TexMap myMap;
+	PendingMap myPending;
+	std::vector<GxAsyncLoad*> myLoads;
+	volatile long myLoadBytes;
+	int myLoadGeneration;
 };
 
 }; // namespace graphics
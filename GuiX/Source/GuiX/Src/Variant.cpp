@@ -103,19 +103,19 @@ static void vFunc(GxVariant::ValueType type, Func& f)
 {
 	switch(type)
 	{
-		case GxVariant::T_DOUBLE: f.func<double>(); break;
-		case GxVariant::T_STRING: f.func<GxString>(); break;
-		case GxVariant::T_VEC2I:  f.func<GxVec2i>(); break;
-		case GxVariant::T_VEC2F:  f.func<GxVec2f>(); break;
-		case GxVariant::T_VEC3I:  f.func<GxVec3i>(); break;
-		case GxVariant::T_VEC3F:  f.func<GxVec3f>(); break;
-		case GxVariant::T_VEC4I:  f.func<GxVec4i>(); break;
-		case GxVariant::T_VEC4F:  f.func<GxVec4f>(); break;
-		case GxVariant::T_RECTI:  f.func<GxRecti>(); break;
-		case GxVariant::T_RECTF:  f.func<GxRectf>(); break;
-		case GxVariant::T_AREAI:  f.func<GxAreai>(); break;
-		case GxVariant::T_AREAF:  f.func<GxAreaf>(); break;
-		case GxVariant::T_COLOR:  f.func<GxColor>(); break;
+		case GxVariant::T_DOUBLE: f.template func<double>(); break;
+		case GxVariant::T_STRING: f.template func<GxString>(); break;
+		case GxVariant::T_VEC2I:  f.template func<GxVec2i>(); break;
+		case GxVariant::T_VEC2F:  f.template func<GxVec2f>(); break;
+		case GxVariant::T_VEC3I:  f.template func<GxVec3i>(); break;
+		case GxVariant::T_VEC3F:  f.template func<GxVec3f>(); break;
+		case GxVariant::T_VEC4I:  f.template func<GxVec4i>(); break;
+		case GxVariant::T_VEC4F:  f.template func<GxVec4f>(); break;
+		case GxVariant::T_RECTI:  f.template func<GxRecti>(); break;
+		case GxVariant::T_RECTF:  f.template func<GxRectf>(); break;
+		case GxVariant::T_AREAI:  f.template func<GxAreai>(); break;
+		case GxVariant::T_AREAF:  f.template func<GxAreaf>(); break;
+		case GxVariant::T_COLOR:  f.template func<GxColor>(); break;
 	};
 }
 
@@ -315,7 +315,7 @@ GxRecti GxVariant::ToRecti() const
 		case T_RECTI: return vCast<GxRecti>(myData);
 		case T_RECTF: return vCast<GxRectf>(myData);
 		case T_AREAI: return vCast<GxAreai>(myData);
-		case T_AREAF: return vCast<GxAreaf>(myData);
+		case T_AREAF: return GxRectf(vCast<GxAreaf>(myData));
 	};
 	return GxRecti();
 }
@@ -327,7 +327,7 @@ GxRectf GxVariant::ToRectf() const
 		case T_RECTF: return vCast<GxRectf>(myData);
 		case T_RECTI: return vCast<GxRecti>(myData);
 		case T_AREAF: return vCast<GxAreaf>(myData);
-		case T_AREAI: return vCast<GxAreai>(myData);
+		case T_AREAI: return GxRecti(vCast<GxAreai>(myData));
 	};
 	return GxRectf();
 }
@@ -339,7 +339,7 @@ GxAreai GxVariant::ToAreai() const
 		case T_AREAI: return vCast<GxAreai>(myData);
 		case T_AREAF: return vCast<GxAreaf>(myData);
 		case T_RECTI: return vCast<GxRecti>(myData);
-		case T_RECTF: return vCast<GxRectf>(myData);
+		case T_RECTF: return GxAreaf(vCast<GxRectf>(myData));
 	};
 	return GxAreai();
 }
@@ -351,7 +351,7 @@ GxAreaf GxVariant::ToAreaf() const
 		case T_AREAF: return vCast<GxAreaf>(myData);
 		case T_AREAI: return vCast<GxAreai>(myData);
 		case T_RECTF: return vCast<GxRectf>(myData);
-		case T_RECTI: return vCast<GxRecti>(myData);
+		case T_RECTI: return GxAreai(vCast<GxRecti>(myData));
 	};
 	return GxAreaf();
 }
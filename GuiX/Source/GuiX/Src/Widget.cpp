@@ -1,8 +1,12 @@
 #include <GuiX/Config.h>
 
 #include <GuiX/Widget.h>
+#include <GuiX/Draw.h>
 
 #include <Src/ContextImp.h>
+#include <Src/DrawImp.h>
+#include <Src/GuiUtils.h>
+#include <Src/StyleImp.h>
 #include <Src/WidgetDatabase.h>
 
 namespace guix {
@@ -78,8 +82,11 @@ GxSizePolicyResult::GxSizePolicyResult(const GxWidget* w, bool transpose)
 
 GxWidget::~GxWidget()
 {
-	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	database->Remove(this);
+	if(!myContextNode->groupId.Empty())
+	{
+		GxWidgetDatabase* database = GxWidgetDatabase::singleton;
+		database->RemoveFromGroup(this, myContextNode->groupId);
+	}
 
 	delete myContextNode;
 	delete myPolicy;
@@ -101,25 +108,113 @@ GxWidget::GxWidget(const char* id)
 
 void GxWidget::SetWidgetId(const char* id)
 {
-	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	database->SetWidgetId(this, id ? id : "");
+	myContextNode->widgetId = GxAtom(id);
 }
 
 void GxWidget::SetGroupId(const char* id)
 {
 	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	database->SetGroupId(this, id ? id : "");
+	database->RemoveFromGroup(this, myContextNode->groupId);
+	myContextNode->groupId = GxAtom(id);
+	database->AddToGroup(this, myContextNode->groupId);
 }
 
 void GxWidget::SetToolTip(GxString text)
 {
-	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	database->SetToolTip(this, text);
+	myContextNode->toolTip = text;
 }
 
 void GxWidget::SetParent(GxWidget* parent)
 {
-	myContextNode->SetParent(parent);
+	GxWidget* oldParent = myContextNode->parent;
+	if(oldParent != parent)
+	{
+		if(oldParent) oldParent->Invalidate();
+		myContextNode->SetParent(parent);
+		Invalidate();
+	}
+}
+
+void GxWidget::Invalidate()
+{
+	for(GxContextNode* node = myContextNode; node; )
+	{
+		node->dirty = true;
+		node->geometryDirty = true;
+		node = node->parent ? node->parent->myContextNode : NULL;
+	}
+}
+
+void GxWidget::InvalidateGeometry()
+{
+	for(GxContextNode* node = myContextNode; node; )
+	{
+		node->geometryDirty = true;
+		node = node->parent ? node->parent->myContextNode : NULL;
+	}
+}
+
+void GxWidget::UpdateAdjust()
+{
+	if(myContextNode->dirty)
+		Adjust();
+}
+
+void GxWidget::UpdateRect(const GxRecti& rect)
+{
+	GxContextNode* node = myContextNode;
+	if(node->dirty || !SameRect(rect, myRect))
+	{
+		// The flag is reset first, so widgets that are invalidated while they are arranged stay dirty.
+		// A widget that was invalidated after it was drawn is arranged in the next frame, so the
+		// geometry of the cached widgets that contain it is invalidated again.
+		node->dirty = false;
+		if(node->context) node->context->CountRelayout();
+		InvalidateGeometry();
+		SetRect(rect);
+	}
+}
+
+void GxWidget::SetCacheGeometry(bool enabled)
+{
+	myFlags.Set(F_CACHED, enabled);
+	if(!enabled)
+	{
+		delete myContextNode->geometry;
+		myContextNode->geometry = NULL;
+	}
+	// The lists of cached parent widgets refer to the list of this widget, so they are recorded again.
+	InvalidateGeometry();
+}
+
+void GxWidget::DrawCached()
+{
+	if(!myFlags[F_CACHED])
+	{
+		Draw();
+		return;
+	}
+
+	GxContextNode* node = myContextNode;
+	if(!node->geometry)
+	{
+		node->geometry = new GxDrawList::Data;
+		node->geometry->isCached = true;
+	}
+
+	// The geometry is recorded again if anything it depends on might have changed. The dirty
+	// flag is reset before drawing, so widgets that change while they are drawn stay dirty.
+	if(node->geometryDirty || !SameRect(node->geometryRect, myRect) || node->geometryStyle != GxStyleImp::generation
+		|| node->geometry->IsOutdated())
+	{
+		node->geometryDirty = false;
+		node->geometryRect = myRect;
+		node->geometryStyle = GxStyleImp::generation;
+		node->geometry->Begin();
+		Draw();
+		node->geometry->End();
+	}
+	node->geometry->DrawCached();
 }
 
 void GxWidget::SetCallback(GxCallback* callback)
@@ -127,18 +222,18 @@ void GxWidget::SetCallback(GxCallback* callback)
 	myContextNode->SetCallback(callback);
 }
 
-void GxWidget::EmitEvent(const char* type)
+void GxWidget::EmitEvent(GxAtom type)
 {
 	EmitEvent(type, GxVariant());
 }
 
-void GxWidget::EmitEvent(const char* type, const GxVariant& value)
+void GxWidget::EmitEvent(GxAtom type, const GxVariant& value)
 {
 	GxContextImp* context = myContextNode->context;
 	if(context)
 	{
 		GxWidgetEvent evt;
-		evt.id = GetWidgetId();
+		evt.id = myContextNode->widgetId;
 		evt.type = type;
 		evt.value = value;
 		context->ReceiveEvent(this, evt);
@@ -172,7 +267,7 @@ void GxWidget::ReleaseInput()
 void GxWidget::EmitGroupEvent()
 {
 	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	database->SendGroupEvent(this);
+	database->SendGroupEvent(this, myContextNode->groupId);
 }
 
 bool GxWidget::IsHoverWidget() const
@@ -237,20 +332,34 @@ GxCallback* GxWidget::GetCallback() const
 
 GxString GxWidget::GetWidgetId() const
 {
-	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	return database->GetWidgetId(this);
+	return myContextNode->widgetId.Str();
 }
 
 GxString GxWidget::GetGroupId() const
 {
-	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	return database->GetGroupId(this);
+	return myContextNode->groupId.Str();
 }
 
 GxString GxWidget::GetToolTip() const
 {
-	GxWidgetDatabase* database = GxWidgetDatabase::singleton;
-	return database->GetToolTip(this);
+	return myContextNode->toolTip;
+}
+
+GxAtom GxWidget::GetWidgetAtom() const
+{
+	return myContextNode->widgetId;
+}
+
+// ===================================================================================
+// Private functions
+
+void GxWidget::mySetLayoutFlags(int flags, bool enabled)
+{
+	// Only invalidate the layout if the flags actually change, since container widgets
+	// hide and show their children while they are being arranged.
+	const GxFlags old = myFlags;
+	myFlags.Set(flags, enabled);
+	if(myFlags.bits != old.bits) Invalidate();
 }
 
 }; // namespace gui
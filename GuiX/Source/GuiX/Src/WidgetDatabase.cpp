@@ -30,74 +30,33 @@ GxWidgetDatabase::~GxWidgetDatabase()
 {
 }
 
-void GxWidgetDatabase::Remove(GxWidget* w)
+void GxWidgetDatabase::AddToGroup(GxWidget* w, GxAtom group)
 {
-	myWidgetIdMap.erase(w);
-	myGroupIdMap.erase(w);
-	myToolTipMap.erase(w);
-	myRemoveFromGroupMap(w);
+	if(!group.Empty())
+		myGroupMap.insert(std::make_pair(group, w));
 }
 
-void GxWidgetDatabase::SetWidgetId(GxWidget* w, const GxString& id)
+void GxWidgetDatabase::RemoveFromGroup(GxWidget* w, GxAtom group)
 {
-	myWidgetIdMap.insert(std::make_pair(w, id));
-}
-
-void GxWidgetDatabase::SetGroupId(GxWidget* w, const GxString& id)
-{
-	myRemoveFromGroupMap(w);
-	myGroupMap.insert(std::make_pair(id, w));
-	myGroupIdMap.insert(std::make_pair(w, id));
-}
-
-void GxWidgetDatabase::SetToolTip(GxWidget* w, const GxString& text)
-{
-	myToolTipMap.insert(std::make_pair(w, text));
-}
-
-GxString GxWidgetDatabase::GetWidgetId(const GxWidget* widget) const
-{
-	return myGetString(myWidgetIdMap, widget);
-}
-
-GxString GxWidgetDatabase::GetGroupId(const GxWidget* widget) const
-{
-	return myGetString(myGroupIdMap, widget);
-}
-
-GxString GxWidgetDatabase::GetToolTip(const GxWidget* widget) const
-{
-	return myGetString(myToolTipMap, widget);
-}
-
-void GxWidgetDatabase::SendGroupEvent(GxWidget* sender)
-{
-	StringMap::const_iterator i = myGroupIdMap.find(sender);
-	if(i != myGroupIdMap.end())
+	std::pair<GroupMap::iterator, GroupMap::iterator> range = myGroupMap.equal_range(group);
+	for(GroupMap::iterator it = range.first; it != range.second; ++it)
 	{
-		std::pair<GroupMap::iterator, GroupMap::iterator> range;
-		range = myGroupMap.equal_range(i->second);
-
-		for(GroupMap::iterator j = range.first; j != range.second; ++j)
-			if(j->second != sender)
-				j->second->OnGroupEvent(sender);
+		if(it->second == w)
+		{
+			myGroupMap.erase(it);
+			break;
+		}
 	}
 }
 
-GxString GxWidgetDatabase::myGetString(const StringMap& map, const GxWidget* w) const
-{
-	StringMap::const_iterator i = map.find(w);
-	if(i != map.end()) return i->second;
-	return GxString();
-}
-
-void GxWidgetDatabase::myRemoveFromGroupMap(GxWidget* w)
+void GxWidgetDatabase::SendGroupEvent(GxWidget* sender, GxAtom group)
 {
-	GroupMap::const_iterator it = myGroupMap.begin();
-	GroupMap::const_iterator end = myGroupMap.end();
+	if(group.Empty()) return;
 
-	while(it != end && it->second != w) ++it;
-	if(it != end) myGroupMap.erase(it);
+	std::pair<GroupMap::iterator, GroupMap::iterator> range = myGroupMap.equal_range(group);
+	for(GroupMap::iterator j = range.first; j != range.second; ++j)
+		if(j->second != sender)
+			j->second->OnGroupEvent(sender);
 }
 
 }; // namespace gui
@@ -3,7 +3,6 @@
 #include <GuiX/Widget.h>
 
 #include <map>
-#include <vector>
 
 namespace guix {
 namespace gui {
@@ -22,30 +21,17 @@ public:
 
 	GxWidgetDatabase();
 	~GxWidgetDatabase();
-	
-	void Remove(GxWidget* widget);
 
-	void SetWidgetId(GxWidget* widget, const GxString& id);
-	void SetGroupId(GxWidget* widget, const GxString& id);
-	void SetToolTip(GxWidget* widget, const GxString& text);
+	// Widget ids and tooltips are stored in the context node of the widget; the database
+	// only keeps track of which widgets belong to each group.
+	void AddToGroup(GxWidget* widget, GxAtom group);
+	void RemoveFromGroup(GxWidget* widget, GxAtom group);
 
-	GxString GetWidgetId(const GxWidget* widget) const;
-	GxString GetGroupId(const GxWidget* widget) const;
-	GxString GetToolTip(const GxWidget* widget) const;
-
-	void SendGroupEvent(GxWidget* sender);
+	void SendGroupEvent(GxWidget* sender, GxAtom group);
 
 private:
-	typedef std::map<const GxWidget*, GxString> StringMap;
-	typedef std::multimap<GxString, GxWidget*> GroupMap;
-
-	GxString myGetString(const StringMap& map, const GxWidget* w) const;
-	void myRemoveFromGroupMap(GxWidget* w);
-	void myDisplayToolTip();
+	typedef std::multimap<GxAtom, GxWidget*> GroupMap;
 
-	StringMap myWidgetIdMap;
-	StringMap myGroupIdMap;
-	StringMap myToolTipMap;
 	GroupMap myGroupMap;
 };
 
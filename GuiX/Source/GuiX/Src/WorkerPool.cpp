@@ -0,0 +1,420 @@
+#include <GuiX/Config.h>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <unistd.h>
+#endif
+
+#include <GuiX/Common.h>
+
+#include <Src/WorkerPool.h>
+
+namespace guix {
+namespace core {
+
+namespace {
+
+enum WorkerPoolProperties
+{
+	MAX_THREADS = 8,
+};
+
+#ifdef _WIN32
+
+static inline long AtomicIncrement(volatile long* x) { return InterlockedIncrement(x); }
+static inline long AtomicDecrement(volatile long* x) { return InterlockedDecrement(x); }
+static inline long AtomicAddValue(volatile long* x, long v) { return InterlockedExchangeAdd(x, v) + v; }
+
+static int GetProcessorCount()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+}
+
+#else
+
+static inline long AtomicIncrement(volatile long* x) { return __sync_add_and_fetch(x, 1); }
+static inline long AtomicDecrement(volatile long* x) { return __sync_sub_and_fetch(x, 1); }
+static inline long AtomicAddValue(volatile long* x, long v) { return __sync_add_and_fetch(x, v); }
+
+static int GetProcessorCount()
+{
+	return (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+// Counting semaphore; unnamed POSIX semaphores are not available on every platform.
+struct Semaphore
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int count;
+
+	void Init()
+	{
+		pthread_mutex_init(&mutex, NULL);
+		pthread_cond_init(&cond, NULL);
+		count = 0;
+	}
+	void Free()
+	{
+		pthread_cond_destroy(&cond);
+		pthread_mutex_destroy(&mutex);
+	}
+	void Post(int n)
+	{
+		pthread_mutex_lock(&mutex);
+		count += n;
+		pthread_cond_broadcast(&cond);
+		pthread_mutex_unlock(&mutex);
+	}
+	void Wait()
+	{
+		pthread_mutex_lock(&mutex);
+		while(count == 0) pthread_cond_wait(&cond, &mutex);
+		--count;
+		pthread_mutex_unlock(&mutex);
+	}
+};
+
+#endif
+
+}; // anonymous namespace
+
+// ===================================================================================
+// Platform specific thread handles and synchronization objects
+
+#ifdef _WIN32
+
+struct GxWorkerPool::Platform
+{
+	CRITICAL_SECTION runLock, queueLock;
+	HANDLE wake, done, queued, flushed;
+	HANDLE threads[MAX_THREADS];
+	HANDLE loader;
+
+	Platform()
+	{
+		InitializeCriticalSection(&runLock);
+		InitializeCriticalSection(&queueLock);
+		wake = CreateSemaphore(NULL, 0, MAX_THREADS, NULL);
+		done = CreateSemaphore(NULL, 0, 1, NULL);
+		queued = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+		flushed = CreateSemaphore(NULL, 0, 1, NULL);
+	}
+	~Platform()
+	{
+		CloseHandle(flushed);
+		CloseHandle(queued);
+		CloseHandle(done);
+		CloseHandle(wake);
+		DeleteCriticalSection(&queueLock);
+		DeleteCriticalSection(&runLock);
+	}
+
+	static DWORD WINAPI Entry(LPVOID pool)
+	{
+		GxWorkerPool::myWorkerMain(pool);
+		return 0;
+	}
+	static DWORD WINAPI QueueEntry(LPVOID pool)
+	{
+		GxWorkerPool::myQueueMain(pool);
+		return 0;
+	}
+
+	bool StartThread(int i, GxWorkerPool* pool)
+	{
+		threads[i] = CreateThread(NULL, 0, Entry, pool, 0, NULL);
+		return threads[i] != NULL;
+	}
+	void JoinThread(int i)
+	{
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	}
+	bool StartLoader(GxWorkerPool* pool)
+	{
+		loader = CreateThread(NULL, 0, QueueEntry, pool, 0, NULL);
+		return loader != NULL;
+	}
+	void JoinLoader()
+	{
+		WaitForSingleObject(loader, INFINITE);
+		CloseHandle(loader);
+	}
+
+	bool TryLock()  { return TryEnterCriticalSection(&runLock) != 0; }
+	void Unlock()   { LeaveCriticalSection(&runLock); }
+	void Wake(int n) { ReleaseSemaphore(wake, n, NULL); }
+	void WaitWake() { WaitForSingleObject(wake, INFINITE); }
+	void Done()     { ReleaseSemaphore(done, 1, NULL); }
+	void WaitDone() { WaitForSingleObject(done, INFINITE); }
+
+	void LockQueue()     { EnterCriticalSection(&queueLock); }
+	void UnlockQueue()   { LeaveCriticalSection(&queueLock); }
+	void Queued()        { ReleaseSemaphore(queued, 1, NULL); }
+	void WaitQueued()    { WaitForSingleObject(queued, INFINITE); }
+	void Flushed()       { ReleaseSemaphore(flushed, 1, NULL); }
+	void WaitFlushed()   { WaitForSingleObject(flushed, INFINITE); }
+};
+
+#else
+
+struct GxWorkerPool::Platform
+{
+	pthread_mutex_t runLock, queueLock;
+	Semaphore wake, done, queued, flushed;
+	pthread_t threads[MAX_THREADS];
+	pthread_t loader;
+
+	Platform()
+	{
+		pthread_mutex_init(&runLock, NULL);
+		pthread_mutex_init(&queueLock, NULL);
+		wake.Init();
+		done.Init();
+		queued.Init();
+		flushed.Init();
+	}
+	~Platform()
+	{
+		flushed.Free();
+		queued.Free();
+		done.Free();
+		wake.Free();
+		pthread_mutex_destroy(&queueLock);
+		pthread_mutex_destroy(&runLock);
+	}
+
+	static void* Entry(void* pool)
+	{
+		GxWorkerPool::myWorkerMain(pool);
+		return NULL;
+	}
+	static void* QueueEntry(void* pool)
+	{
+		GxWorkerPool::myQueueMain(pool);
+		return NULL;
+	}
+
+	bool StartThread(int i, GxWorkerPool* pool)
+	{
+		return pthread_create(&threads[i], NULL, Entry, pool) == 0;
+	}
+	void JoinThread(int i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	bool StartLoader(GxWorkerPool* pool)
+	{
+		return pthread_create(&loader, NULL, QueueEntry, pool) == 0;
+	}
+	void JoinLoader()
+	{
+		pthread_join(loader, NULL);
+	}
+
+	bool TryLock()  { return pthread_mutex_trylock(&runLock) == 0; }
+	void Unlock()   { pthread_mutex_unlock(&runLock); }
+	void Wake(int n) { wake.Post(n); }
+	void WaitWake() { wake.Wait(); }
+	void Done()     { done.Post(1); }
+	void WaitDone() { done.Wait(); }
+
+	void LockQueue()     { pthread_mutex_lock(&queueLock); }
+	void UnlockQueue()   { pthread_mutex_unlock(&queueLock); }
+	void Queued()        { queued.Post(1); }
+	void WaitQueued()    { queued.Wait(); }
+	void Flushed()       { flushed.Post(1); }
+	void WaitFlushed()   { flushed.Wait(); }
+};
+
+#endif
+
+// ===================================================================================
+// GxWorkerPool
+// ===================================================================================
+
+GxWorkerPool* GxWorkerPool::singleton = NULL;
+
+void GxWorkerPool::Create()
+{
+	singleton = new GxWorkerPool();
+}
+
+void GxWorkerPool::Destroy()
+{
+	delete singleton;
+	singleton = NULL;
+}
+
+GxWorkerPool::GxWorkerPool()
+	:myPlatform(new Platform)
+	,myTask(NULL)
+	,myData(NULL)
+	,myCount(0)
+	,myNext(0)
+	,myActive(0)
+	,myThreadCount(1)
+	,myIsStarted(false)
+	,myIsQuitting(false)
+	,myJobCount(0)
+	,myIsQueueStarted(false)
+	,myIsFlushing(false)
+{
+}
+
+GxWorkerPool::~GxWorkerPool()
+{
+	// The background thread completes the queued tasks, and stops when it is woken without a task.
+	if(myIsQueueStarted)
+	{
+		myPlatform->Queued();
+		myPlatform->JoinLoader();
+	}
+	if(myThreadCount > 1)
+	{
+		myIsQuitting = true;
+		myPlatform->Wake(myThreadCount - 1);
+		for(int i=1; i<myThreadCount; ++i)
+			myPlatform->JoinThread(i);
+	}
+	delete myPlatform;
+}
+
+void GxWorkerPool::Run(Task task, void* data, int count)
+{
+	if(count <= 0) return;
+
+	if(count == 1 || !myPlatform->TryLock())
+	{
+		for(int i=0; i<count; ++i) task(data, i);
+		return;
+	}
+
+	if(!myIsStarted) myStartThreads();
+
+	myTask = task;
+	myData = data;
+	myCount = count;
+	myNext = 0;
+
+	const int workers = GxMin(myThreadCount - 1, count - 1);
+	myActive = workers;
+	if(workers > 0) myPlatform->Wake(workers);
+
+	myExecute();
+
+	if(workers > 0) myPlatform->WaitDone();
+	myPlatform->Unlock();
+}
+
+int GxWorkerPool::GetThreadCount() const
+{
+	return myIsStarted ? myThreadCount : GxClamp(GetProcessorCount(), 1, (int)MAX_THREADS);
+}
+
+void GxWorkerPool::Queue(Task task, void* data)
+{
+	if(!myIsQueueStarted)
+	{
+		myIsQueueStarted = myPlatform->StartLoader(this);
+		if(!myIsQueueStarted)
+		{
+			task(data, 0);
+			return;
+		}
+	}
+
+	Job job = {task, data};
+	myPlatform->LockQueue();
+	myJobs.push_back(job);
+	++myJobCount;
+	myPlatform->UnlockQueue();
+	myPlatform->Queued();
+}
+
+void GxWorkerPool::WaitQueue()
+{
+	if(!myIsQueueStarted) return;
+
+	myPlatform->LockQueue();
+	const bool wait = (myJobCount > 0);
+	myIsFlushing = wait;
+	myPlatform->UnlockQueue();
+
+	if(wait) myPlatform->WaitFlushed();
+}
+
+long GxWorkerPool::AtomicAdd(volatile long* x, long value)
+{
+	return AtomicAddValue(x, value);
+}
+
+void GxWorkerPool::myWorkerMain(void* data)
+{
+	GxWorkerPool* pool = (GxWorkerPool*)data;
+	while(true)
+	{
+		pool->myPlatform->WaitWake();
+		if(pool->myIsQuitting) break;
+		pool->myExecute();
+		if(AtomicDecrement(&pool->myActive) == 0)
+			pool->myPlatform->Done();
+	}
+}
+
+void GxWorkerPool::myQueueMain(void* data)
+{
+	GxWorkerPool* pool = (GxWorkerPool*)data;
+	Platform* platform = pool->myPlatform;
+	while(true)
+	{
+		platform->WaitQueued();
+		platform->LockQueue();
+		if(pool->myJobs.empty())
+		{
+			platform->UnlockQueue();
+			break;
+		}
+		Job job = pool->myJobs.front();
+		pool->myJobs.pop_front();
+		platform->UnlockQueue();
+
+		job.task(job.data, 0);
+
+		platform->LockQueue();
+		if(--pool->myJobCount == 0 && pool->myIsFlushing)
+		{
+			pool->myIsFlushing = false;
+			platform->Flushed();
+		}
+		platform->UnlockQueue();
+	}
+}
+
+void GxWorkerPool::myStartThreads()
+{
+	myIsStarted = true;
+	const int count = GxClamp(GetProcessorCount(), 1, (int)MAX_THREADS);
+	for(myThreadCount = 1; myThreadCount < count; ++myThreadCount)
+		if(!myPlatform->StartThread(myThreadCount, this)) break;
+}
+
+void GxWorkerPool::myExecute()
+{
+	while(true)
+	{
+		const int i = (int)AtomicIncrement(&myNext) - 1;
+		if(i >= myCount) break;
+		myTask(myData, i);
+	}
+}
+
+}; // namespace core
+}; // namespace guix
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <GuiX/Config.h>
+
+#include <deque>
+
+namespace guix {
+namespace core {
+
+// ===================================================================================
+// GxWorkerPool
+// ===================================================================================
+// Runs batches of independent tasks on a set of worker threads. The threads are started
+// the first time a batch is run, and sleep while there is no work. The calling thread
+// takes part in the batch as well, and Run returns when every task has completed.
+// Tasks that should not hold up the calling thread, like loading files, can be queued
+// on a separate background thread instead.
+
+class GxWorkerPool
+{
+public:
+	static GxWorkerPool* singleton;
+
+	static void Create();
+	static void Destroy();
+
+	typedef void (*Task)(void* data, int index);
+
+	GxWorkerPool();
+	~GxWorkerPool();
+
+	/// Calls task(data, i) for every i in [0, count), spread over the worker threads.
+	/// If another batch is already running, for example when called from a task,
+	/// the tasks are executed on the calling thread instead.
+	void Run(Task task, void* data, int count);
+
+	/// Returns the number of threads that take part in a batch, including the calling thread.
+	int GetThreadCount() const;
+
+	/// Queues task(data, 0) to run on the background thread, which is started the first time
+	/// a task is queued. Queued tasks run one at a time, in the order in which they were queued.
+	void Queue(Task task, void* data);
+
+	/// Waits until every task that was queued by \c Queue() has completed.
+	void WaitQueue();
+
+	/// Adds a value to a variable as an atomic operation, and returns the new value.
+	/// The operation is a full memory barrier, so it can be used to publish results.
+	static long AtomicAdd(volatile long* x, long value);
+
+private:
+	struct Job
+	{
+		Task task;
+		void* data;
+	};
+
+	static void myWorkerMain(void* pool);
+	static void myQueueMain(void* pool);
+	void myStartThreads();
+	void myExecute();
+
+	struct Platform;
+	Platform* myPlatform;
+
+	Task myTask;
+	void* myData;
+	int myCount;
+	volatile long myNext;
+	volatile long myActive;
+	int myThreadCount;
+	bool myIsStarted;
+	volatile bool myIsQuitting;
+
+	std::deque<Job> myJobs;
+	int myJobCount;
+	bool myIsQueueStarted;
+	bool myIsFlushing;
+};
+
+}; // namespace core
+}; // namespace guix
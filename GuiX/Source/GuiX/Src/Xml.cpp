@@ -4,9 +4,12 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <new>
+
 #include <GuiX/Common.h>
 #include <GuiX/Interfaces.h>
 
+#include <Src/CoreImp.h>
 #include <Src/Xml.h>
 
 namespace guix {
@@ -47,454 +50,492 @@ static bool IsTag(const char* p, const char* tag)
 	return (*tag == 0);
 }
 
-static const char* SkipWhiteSpace(const char* p)
+inline bool IsNameChar(char c)
 {
-	while(IsWhiteSpace(*p)) ++p;
-	return p;
+	return IsAlphaNum(c) || c=='_' || c=='-' || c=='.' || c==':';
 }
 
-// ===================================================================================
-// XmlParser
-// ===================================================================================
-
-class XmlParser
-{
-public:
-	enum { ENTITY_COUNT = 5 };
-	struct Entity { const char* str; int chr; };
-
-	XmlParser(XmlDocument::CondenseWhitespace cw);
-
-	const char* Error(const char* p, const GxString& desc);
-	XmlNode* Identify(const char* p);
-	const char* Parse(const char* p, XmlNode* n);
-
-	const char* ParseElem   (const char* p, XmlElem* n);
-	const char* ParseText   (const char* p, XmlText* n);
-	const char* ParseComment(const char* p, XmlComment* n);
-	const char* ParseDecl   (const char* p, XmlDeclaration* n);
-	const char* ParseDoc    (const char* p, XmlDocument* n);
-	const char* ParseNode   (const char* p, XmlNode* n);
-
-	const char* ReadElemBody(const char* p, XmlElem* elem);
-	const char* ReadAttrib  (const char* p, GxString& name, GxString& value);
-	const char* ReadName    (const char* p, GxString& name);
-	const char* ReadText    (const char* p, GxString& text, bool trim, const char* end);
-	const char* ReadChar    (const char* p, GxString& str);
-	const char* ReadEntity  (const char* p, GxString& str);
-
-private:
-	static Entity myEntities[ENTITY_COUNT];
-	const char myErr;
-	XmlDocument* myDoc;
-	XmlDocument::CondenseWhitespace myCw;
-};
-
-XmlParser::Entity XmlParser::myEntities[XmlParser::ENTITY_COUNT] =
-{
-	{"&quot;", '\"'},
-	{"&amp;" , '&' },
-	{"&apos;", '\''},
-	{"&lt;"  , '<' },
-	{"&gt;"  , '>' },
-};
-
-XmlParser::XmlParser(XmlDocument::CondenseWhitespace cw)
-	:myDoc(NULL)
-	,myErr(0)
-	,myCw(cw)
+static char* SkipWhiteSpace(char* p)
 {
+	while(IsWhiteSpace(*p)) ++p;
+	return p;
 }
 
-const char* XmlParser::Error(const char* p, const GxString& desc)
+static char* SkipName(char* p)
 {
-	myDoc->SetError(desc);
-	return &myErr;
+	while(IsNameChar(*p)) ++p;
+	return p;
 }
 
-XmlNode* XmlParser::Identify(const char* p)
+// Writes the UTF-8 encoding of character ucs at w, and returns the position after it.
+static char* WriteUtf8(char* w, uint ucs)
 {
-	p = SkipWhiteSpace(p);
-	if(*p == 0 || *p != '<')
-		return NULL;
-
-		 if(IsTag(p, "<?xml"    )) return new XmlDeclaration();
-	else if(IsTag(p, "<!--"     )) return new XmlComment();
-	else if(IsTag(p, "<![CDATA[")) return new XmlText();
-	else if(*p=='<' && IsIdentifier(p[1])) return new XmlElem();
-
-	return new XmlNode();
+	if(ucs < 0x80)
+	{
+		*w++ = (char)ucs;
+	}
+	else if(ucs < 0x800)
+	{
+		*w++ = (char)(0xC0 | (ucs >> 6));
+		*w++ = (char)(0x80 | (ucs & 0x3F));
+	}
+	else if(ucs < 0x10000)
+	{
+		*w++ = (char)(0xE0 | (ucs >> 12));
+		*w++ = (char)(0x80 | ((ucs >> 6) & 0x3F));
+		*w++ = (char)(0x80 | (ucs & 0x3F));
+	}
+	else
+	{
+		*w++ = (char)(0xF0 | (ucs >> 18));
+		*w++ = (char)(0x80 | ((ucs >> 12) & 0x3F));
+		*w++ = (char)(0x80 | ((ucs >> 6) & 0x3F));
+		*w++ = (char)(0x80 | (ucs & 0x3F));
+	}
+	return w;
 }
 
-const char* XmlParser::Parse(const char* p, XmlNode* node)
-{
-	     if(node->ToElem())        return ParseElem(p, node->ToElem());
-	else if(node->ToText())        return ParseText(p, node->ToText());
-	else if(node->ToComment())     return ParseComment(p, node->ToComment());
-	else if(node->ToDeclaration()) return ParseDecl(p, node->ToDeclaration());
-	else if(node->ToDocument())	   return ParseDoc(p, node->ToDocument());
+// ===================================================================================
+// In-place entity decoding
+// ===================================================================================
 
-	return ParseNode(p, node);
-}
+struct XmlEntity { const char* str; int len; char chr; };
 
-const char* XmlParser::ParseElem(const char* p, XmlElem* elem)
+static const XmlEntity XML_ENTITIES[] =
 {
-	// Read the beginning of the start tag
-	p = SkipWhiteSpace(p);
-	if(*p != '<')
-		return Error(p, "Could not find element start");
+	{"&quot;", 6, '\"'},
+	{"&amp;" , 5, '&' },
+	{"&apos;", 6, '\''},
+	{"&lt;"  , 4, '<' },
+	{"&gt;"  , 4, '>' },
+};
 
-	// Try to read the element name
-	p = SkipWhiteSpace(p + 1);
-	const char* err = p;
-	GxString elemName;
-	p = ReadName(p, elemName);
-	if(*p == 0)
-		return Error(err, "Could not read element name");
-	elem->SetValue(elemName);
-
-	// Create the matching end tag
-	const GxString name = elem->Value();
-	const GxString end = "</" + name;
-
-	// Keep reading until the element is completed
-	while(*p)
+// Reads a character reference at p, which points to the character after "&#". Returns
+// the position after the terminating ';', or NULL if the reference is not valid.
+static char* ReadCharRef(char* p, uint& ucs)
+{
+	ucs = 0;
+	char* start;
+	if(*p == 'x')
 	{
-		p = SkipWhiteSpace(p);
-
-		// Check if the element is an empty element
-		if(*p == '/')
-		{
-			if(p[1] != '>')
-				return Error(p, "Invalid tag of element '" + name + '\'');
-			return p + 2;
-		}
-		// Check if the start tag ends
-		else if(*p == '>')
-		{
-			// Read all the content inside the element
-			p = ReadElemBody(p + 1, elem);
-
-			// Read the matching element end tag
-			if(!IsTag(p, end.Raw()))
-				return Error(p, "Could not find end of element '" + name + '\'');
-			p = SkipWhiteSpace(p + end.Length());
-			if(*p != '>')
-				return Error(p, "Invalid end tag of element '" + name + '\'');
-			return p + 1;
-		}
-		else
+		for(start = ++p; ucs <= 0x10FFFF; ++p)
 		{
-			err = p;
-
-			// Try to read an attribute
-			GxString aName, aValue;
-			p = ReadAttrib(p, aName, aValue);
-			if(*p == 0)
-				Error(err, "Invalid attribute of element '" + name + '\'');
-
-			// Store the attribute
-			elem->AddAttribute(aName, aValue);
+			     if(*p>='0' && *p<='9') ucs = ucs * 16 + (*p-'0');
+			else if(*p>='a' && *p<='f') ucs = ucs * 16 + (*p-'a'+10);
+			else if(*p>='A' && *p<='F') ucs = ucs * 16 + (*p-'A'+10);
+			else break;
 		}
 	}
-	return p;
+	else
+	{
+		for(start = p; ucs <= 0x10FFFF && *p>='0' && *p<='9'; ++p)
+			ucs = ucs * 10 + (*p-'0');
+	}
+	if(p == start || *p != ';' || ucs == 0 || ucs > 0x10FFFF)
+		return NULL;
+	return p + 1;
 }
 
-const char* XmlParser::ParseText(const char* p, XmlText* text)
+// Decodes the entity at p, which points to a '&', and writes the result at w. The result
+// is never longer than the entity, so w can point into the text that is being decoded.
+// Custom entities are passed through, and invalid entities are copied as plain text.
+static char* DecodeEntity(char* p, char*& w)
 {
-	const char* start = "<![CDATA[";
-	const char* end   = "]]>";
+	// Try to match any of the predefined entities
+	for(int i=0; i<5; ++i)
+	if(IsTag(p, XML_ENTITIES[i].str))
+	{
+		*w++ = XML_ENTITIES[i].chr;
+		return p + XML_ENTITIES[i].len;
+	}
 
-	if(IsTag(p, start))
+	// Try to read a character reference entity
+	if(p[1] == '#')
 	{
-		// Read a CDATA section
-		GxString value(8);
-		const char* first = p;
-		p += GxStrLen(start);
-		while(*p && !IsTag(p, end)) 
-			value += *p++;
-		if(*p == 0)
-			return Error(p, "Could not find CDATA end");
-		text->SetValue(value);
-		p += GxStrLen(end);
+		uint ucs;
+		char* q = ReadCharRef(p + 2, ucs);
+		if(q)
+		{
+			w = WriteUtf8(w, ucs);
+			return q;
+		}
 	}
-	else
+
+	// Pass through any custom entities
+	else if(IsIdentifier(p[1]))
 	{
-		// Read regular text
-		GxString value(8);
-		p = ReadText(p, value, true, "<");
-		text->SetValue(value);
-		if(*p) --p;
+		char* q = SkipName(p + 1);
+		if(*q == ';')
+		{
+			while(p <= q) *w++ = *p++;
+			return p;
+		}
 	}
-	return p;
-}
 
-const char* XmlParser::ParseComment(const char* p, XmlComment* comment)
-{
-	const char* start = "<!--";
-	const char* end   = "-->";
+	// Reading the entity failed, just copy the character
+	*w++ = *p;
+	return p + 1;
+}
 
-	// Read the comment start
-	p = SkipWhiteSpace(p);
-	if(!IsTag(p, start))
-		return Error(p, "Invalid comment start");
-	p += GxStrLen(start);
-
-	// Keep reading until comment ends
-	GxString value(8);
-	while(*p && !IsTag(p, end))
-		value += *p++;
-	if(*p == 0)
-		return Error(p, "Could not find comment end");
-	comment->SetValue(value);
-	p += GxStrLen(end);
+// ===================================================================================
+// XmlReader
+// ===================================================================================
 
-	return p;
+XmlReader::XmlReader()
+	:myPos(NULL)
+	,myName("")
+	,myText("")
+	,myAttributes(NULL)
+	,myAttributeCount(0)
+	,myAttributeCapacity(0)
+	,myStack(NULL)
+	,myDepth(0)
+	,myStackCapacity(0)
+	,myEvent(EV_END)
+	,myCw(XmlDocument::CW_FULL)
+	,myAtTag(false)
+	,myIsEmptyElem(false)
+{
 }
 
-const char* XmlParser::ParseDecl(const char* p, XmlDeclaration* decl)
+XmlReader::~XmlReader()
 {
-	// Read declaration start
-	const char* start = "<?xml";
-	p = SkipWhiteSpace(p);
-	if(!IsTag(p, start))
-		return Error(p, "Invalid declaration start");
-	p += GxStrLen(start);
-
-	// Read declaration attributes
-	GxString aValue[3], dummy;
-	while(*p && *p != '>')
-	{
-		p = SkipWhiteSpace(p);
-		     if(IsTag(p, "version"   )) p = ReadAttrib(p, dummy, aValue[0]);
-		else if(IsTag(p, "encoding"  )) p = ReadAttrib(p, dummy, aValue[1]);
-		else if(IsTag(p, "standalone"))	p = ReadAttrib(p, dummy, aValue[2]);
-		++p;
-	}
-	if(*p == 0)
-		return Error("Could not find declaration end", p);
-
-	decl->Set(aValue[0], aValue[1], aValue[2]);
-	return p + 1;
+	GxFree(myAttributes);
+	GxFree(myStack);
 }
 
-const char* XmlParser::ParseDoc(const char* p, XmlDocument* doc)
+void XmlReader::Reset(char* buffer, XmlDocument::CondenseWhitespace cw)
 {
-	myDoc = doc;
-	XmlNode* node;
-
-	// Parse all xml nodes in the document root
-	p = SkipWhiteSpace(p);
-	while(*p && (node = Identify(p)) != NULL)
+	// Convert all carriage returns to line feeds
+	char* read = strchr(buffer, 0xD);
+	if(read)
 	{
-		p = Parse(p, node);
-		doc->AddChild(node);
-		p = SkipWhiteSpace(p);
+		char* write = read;
+		while(*read)
+		{
+			if(*read == 0xD) // CR
+			{
+				*write++ = 0xA; // LF
+				if(*++read == 0xA) ++read; // LF
+			}
+			else
+			{
+				*write++ = *read++;
+			}
+		}
+		*write = 0;
 	}
-	return p;
+
+	// Skip BOM character
+	if(IsTag(buffer, "\xEF\xBB\xBF")) buffer += 3;
+
+	myPos = buffer;
+	myName = myText = "";
+	myAttributeCount = 0;
+	myDepth = 0;
+	myEvent = EV_UNKNOWN;
+	myCw = cw;
+	myError.Clear();
+	myAtTag = false;
+	myIsEmptyElem = false;
 }
 
-const char* XmlParser::ParseNode(const char* p, XmlNode* node)
+XmlReader::Event XmlReader::Next()
 {
-	// Read the start of the tag
-	p = SkipWhiteSpace(p);
-	if(*p == 0 || *p != '<')
-		return Error("Invalid unknown data", p);
-	++p;
+	if(myEvent == EV_END || myEvent == EV_ERROR)
+		return myEvent;
 
-	// Keep reading until tag ends
-	GxString value(8);
-	while(*p && *p != '>')
-	{
-		value += *p++;
+	myText = "";
+	myAttributeCount = 0;
 
-		// If there is a [, read until the matching ] is encoundered
-		if(*p == '[')
-		while(*p && *p != ']')
-			value += *p++;
+	// An empty element ends directly after it starts
+	if(myIsEmptyElem)
+	{
+		myIsEmptyElem = false;
+		--myDepth;
+		return myEvent = EV_ELEM_END;
 	}
-	if(*p == 0)
-		return Error("Could not find unknown data end", p);
-	node->SetValue(value);
-	return p + 1;
-}
+	myName = "";
 
-const char* XmlParser::ReadElemBody(const char* p, XmlElem* elem)
-{
-	// Read in text and elements in any order.
-	const char* pText = p;
-	p = SkipWhiteSpace(p);
-	while(*p)
+	// When text ends at a tag, the '<' is overwritten by the text terminator
+	char* p = myPos;
+	if(!myAtTag)
 	{
-		if(*p == '<')
+		char* text = p;
+		p = SkipWhiteSpace(p);
+		if(*p == 0)
 		{
-			// Read a nested xml element
-			if(IsTag(p, "</")) return p;
-			XmlNode* node = Identify(p);
-			if(!node) return &myErr;
-			p = Parse(p, node);
-			elem->AddChild(node);
+			myPos = p;
+			if(myDepth > 0)
+				return myFail(GxString("Could not find end of element '") + myStack[myDepth - 1] + '\'');
+			return myEvent = EV_END;
 		}
-		else
+		if(*p != '<')
 		{
-			// Read a section of text
-			XmlText* text = new XmlText();
-			p = ParseText(pText, text);
-			if(text->Value().Empty())
-				delete text;
-			else
-				elem->AddChild(text);
+			// Text outside of the elements ends the document
+			if(myDepth == 0)
+				return myEvent = EV_END;
+			return myReadText(text);
 		}
-		pText = p;
-		p = SkipWhiteSpace(p);
 	}
-	return p;
+	myAtTag = false;
+	++p;
+
+	if(*p == '/')
+	{
+		return myReadEndTag(p + 1);
+	}
+	if(IsIdentifier(*p))
+	{
+		return myReadElem(p);
+	}
+	if(IsTag(p, "?xml") && (IsWhiteSpace(p[4]) || p[4] == '?'))
+	{
+		return myReadDecl(p + 4);
+	}
+	if(IsTag(p, "!--"))
+	{
+		// Read a comment
+		char* end = strstr(p + 3, "-->");
+		if(!end) return myFail("Could not find comment end");
+		*end = 0;
+		myText = p + 3;
+		myPos = end + 3;
+		return myEvent = EV_COMMENT;
+	}
+	if(IsTag(p, "![CDATA["))
+	{
+		// Read a CDATA section
+		char* end = strstr(p + 8, "]]>");
+		if(!end) return myFail("Could not find CDATA end");
+		*end = 0;
+		myText = p + 8;
+		myPos = end + 3;
+		return myEvent = EV_TEXT;
+	}
+
+	// Read an unknown tag, if there is a [, read until the matching ] is encountered
+	char* end = p;
+	while(*end && *end != '>')
+	{
+		++end;
+		if(*end == '[')
+		while(*end && *end != ']')
+			++end;
+	}
+	if(*end == 0)
+		return myFail("Could not find unknown data end");
+	*end = 0;
+	myText = p;
+	myPos = end + 1;
+	return myEvent = EV_UNKNOWN;
 }
 
-const char* XmlParser::ReadAttrib(const char* p, GxString& name, GxString& value)
+XmlReader::Event      XmlReader::GetEvent() const          {return myEvent;}
+const char*           XmlReader::GetName() const           {return myName;}
+const char*           XmlReader::GetText() const           {return myText;}
+int                   XmlReader::GetAttributeCount() const {return myAttributeCount;}
+int                   XmlReader::GetDepth() const          {return myDepth;}
+const GxString&       XmlReader::GetError() const          {return myError;}
+
+const char* XmlReader::GetAttributeName(int index) const
 {
-	// Read the attribute name and '='
-	p = SkipWhiteSpace(p);
-	p = ReadName(p, name);
-	p = SkipWhiteSpace(p);
-	if(*p != '=') return &myErr;
+	return (index >= 0 && index < myAttributeCount) ? myAttributes[index * 2] : NULL;
+}
 
-	// Read the attribute value
-	p = SkipWhiteSpace(p + 1);
-	     if(*p == '\'')	p = ReadText(p + 1, value, false, "\'");
-	else if(*p == '\"')	p = ReadText(p + 1, value, false, "\"");
-	else return &myErr;
+const char* XmlReader::GetAttributeValue(int index) const
+{
+	return (index >= 0 && index < myAttributeCount) ? myAttributes[index * 2 + 1] : NULL;
+}
 
-	return p;
+const char* XmlReader::GetAttribute(const char* name) const
+{
+	for(int i=0; i<myAttributeCount; ++i)
+		if(!strcmp(myAttributes[i * 2], name))
+			return myAttributes[i * 2 + 1];
+	return NULL;
 }
 
-const char* XmlParser::ReadName(const char* p, GxString& out)
+XmlReader::Event XmlReader::myFail(const GxString& description)
 {
-	out.Clear();
-	if(!IsIdentifier(*p))
-		return &myErr;
-	while(IsAlphaNum(*p) || *p=='_' || *p=='-' || *p=='.' || *p==':')
-		out += *p++;
-	return p;
+	myError = description;
+	myName = myText = "";
+	myAttributeCount = 0;
+	return myEvent = EV_ERROR;
 }
 
-const char* XmlParser::ReadText(const char* p, GxString& out, bool trim, const char* end)
+XmlReader::Event XmlReader::myReadText(char* p)
 {
-	out.Clear();
-	if(trim == false || myCw == XmlDocument::CW_NONE)
-	{
-		// Keep all the white space
-		while(*p && !IsTag(p, end))
-			p = ReadChar(p, out);
-	}
-	else if(myCw == XmlDocument::CW_FULL)
+	char* text = p;
+	char* w = p;
+	if(myCw == XmlDocument::CW_FULL)
 	{
 		// Condense all white space
 		p = SkipWhiteSpace(p);
 		bool ws = false;
-		while(*p && !IsTag(p, end))
+		while(*p && *p != '<')
 		{
 			if(IsWhiteSpace(*p))
 			{
 				ws = true;
 				++p;
+				continue;
 			}
-			else
+			if(ws)
 			{
-				if(ws)
-				{
-					out += ' ';
-					ws = false;
-				}
-				p = ReadChar(p, out);
+				*w++ = ' ';
+				ws = false;
 			}
+			if(*p == '&') p = DecodeEntity(p, w);
+			else *w++ = *p++;
 		}
 	}
-	else if(myCw == XmlDocument::CW_LEAD_AND_TRAIL)
+	else
 	{
-		// Remove leading and trailing whitespace
-		p = SkipWhiteSpace(p);
-		while(*p && !IsTag(p, end))
-			p = ReadChar(p, out);
+		// Remove leading whitespace, or keep all the white space
+		if(myCw == XmlDocument::CW_LEAD_AND_TRAIL)
+			p = SkipWhiteSpace(p);
+		while(*p && *p != '<')
+		{
+			if(*p == '&') p = DecodeEntity(p, w);
+			else *w++ = *p++;
+		}
 	}
-	if(IsTag(p, end))
-		p += GxStrLen(end);
-	return p;
-}
 
-const char* XmlParser::ReadChar(const char* p, GxString& str)
-{
-	if(*p == 0)	return &myErr;
-	if(*p == '&') return ReadEntity(p, str);
-	str.Append(*p);
-	return p + 1;
+	// If the text did not shrink, the terminator overwrites the '<' of the next tag
+	myAtTag = (w == p && *p == '<');
+	*w = 0;
+
+	myText = text;
+	myPos = p;
+	return myEvent = EV_TEXT;
 }
 
-const char* XmlParser::ReadEntity(const char* p, GxString& str)
+XmlReader::Event XmlReader::myReadElem(char* p)
 {
-	// Try to match any of the predefined entities
-	for(int i=0; i<ENTITY_COUNT; ++i)
-	if(IsTag(p, myEntities[i].str))
-	{
-		str.Append(myEntities[i].chr);
-		return p + GxStrLen(myEntities[i].str);
-	}
-	
-	// Try to read a character reference entity
-	if(p[1] == '#' && p[2])
+	// Read the element name, it is terminated when the start tag has been read
+	char* name = p;
+	char* nameEnd = p = SkipName(p);
+
+	// Keep reading until the start tag is completed
+	while(true)
 	{
-		int ucs = 0;
-		int delta = 0;
-		if(p[2] == 'x')
-		{
-			// Read a hexadecimal character reference
-			const char* q = strchr(p + 3, ';');
-			if(*q == 0) return &myErr;
-			delta = q - p; --q;
+		p = SkipWhiteSpace(p);
 
-			int mul = 1;
-			while(*q != 'x')
+		// Check if the element is an empty element
+		if(*p == '/')
+		{
+			if(p[1] != '>')
 			{
-				     if(*q>='0' && *q<='9') ucs += mul * (*q-'0');
-				else if(*q>='a' && *q<='f') ucs += mul * (*q-'a'+10);
-				else if(*q>='A' && *q<='F') ucs += mul * (*q-'A'+10);
-				else return &myErr;
-				mul *= 16;
-				--q;
+				*nameEnd = 0;
+				return myFail(GxString("Invalid tag of element '") + name + '\'');
 			}
+			myIsEmptyElem = true;
+			p += 2;
+			break;
 		}
-		else
+		// Check if the start tag ends
+		else if(*p == '>')
 		{
-			// Read a decimal character reference
-			const char* q = strchr(p + 2, ';');
-			if(*q == 0) return &myErr;
-			delta = q - p; --q;
+			++p;
+			break;
+		}
 
-			int mul = 1;
-			while(*q != '#')
-			{
-				if(*q>='0' && *q<='9') ucs += mul * (*q-'0');
-				else return &myErr;
-				mul *= 10;
-				--q;
-			}
+		// Try to read an attribute
+		if(IsIdentifier(*p)) p = myReadAttribute(p);
+		else p = NULL;
+		if(!p)
+		{
+			*nameEnd = 0;
+			return myFail(GxString("Invalid attribute of element '") + name + '\'');
 		}
-		str.Append(ucs);
-		return p + delta + 1;
 	}
+	*nameEnd = 0;
 
-	// Pass through any custom entities
-	if(IsIdentifier(p[1]))
+	// Push the element on the stack of open elements
+	if(myDepth == myStackCapacity)
+	{
+		myStackCapacity = GxMax(myStackCapacity * 2, 16);
+		myStack = GxRealloc(myStack, myStackCapacity);
+	}
+	myStack[myDepth++] = name;
+
+	myName = name;
+	myPos = p;
+	return myEvent = EV_ELEM_START;
+}
+
+XmlReader::Event XmlReader::myReadEndTag(char* p)
+{
+	if(myDepth == 0)
+		return myFail("Could not find start of end tag");
+
+	// Check that the end tag matches the open element
+	const char* name = myStack[myDepth - 1];
+	char* end = SkipName(p);
+	const int len = (int)(end - p);
+	if(strncmp(name, p, len) != 0 || name[len] != 0)
+		return myFail(GxString("Could not find end of element '") + name + '\'');
+	p = SkipWhiteSpace(end);
+	if(*p != '>')
+		return myFail(GxString("Invalid end tag of element '") + name + '\'');
+
+	--myDepth;
+	myName = name;
+	myPos = p + 1;
+	return myEvent = EV_ELEM_END;
+}
+
+XmlReader::Event XmlReader::myReadDecl(char* p)
+{
+	// Read declaration attributes until the declaration ends
+	while(true)
+	{
+		p = SkipWhiteSpace(p);
+		if(p[0] == '?' && p[1] == '>')
+			break;
+		if(IsIdentifier(*p)) p = myReadAttribute(p);
+		else p = NULL;
+		if(!p)
+			return myFail("Could not find declaration end");
+	}
+	myPos = p + 2;
+	return myEvent = EV_DECLARATION;
+}
+
+char* XmlReader::myReadAttribute(char* p)
+{
+	// Read the attribute name and '='
+	char* name = p;
+	char* nameEnd = p = SkipName(p);
+	p = SkipWhiteSpace(p);
+	if(*p != '=') return NULL;
+	*nameEnd = 0;
+
+	// Read the attribute value, decoding entities in place
+	p = SkipWhiteSpace(p + 1);
+	const char quote = *p;
+	if(quote != '\"' && quote != '\'') return NULL;
+	char* value = ++p;
+	char* w = p;
+	while(*p && *p != quote)
+	{
+		if(*p == '&') p = DecodeEntity(p, w);
+		else *w++ = *p++;
+	}
+	if(*p == 0) return NULL;
+	*w = 0;
+
+	// Store the attribute
+	if(myAttributeCount == myAttributeCapacity)
 	{
-		const char* q = p + 1;
-		while(IsAlphaNum(*q) || *q=='_' || *q=='-' || *q=='.' || *q==':') q++;
-		if(*q != ';') return &myErr;
-		str.Append(GxStringArg(p, (int)(q - p + 1)));
-		return q + 1;
+		myAttributeCapacity = GxMax(myAttributeCapacity * 2, 8);
+		myAttributes = GxRealloc(myAttributes, myAttributeCapacity * 2);
 	}
+	myAttributes[myAttributeCount * 2] = name;
+	myAttributes[myAttributeCount * 2 + 1] = value;
+	++myAttributeCount;
 
-	// Reading the entity failed, just append the character
-	str.Append(*p);
 	return p + 1;
 }
 
@@ -668,6 +709,7 @@ XmlNode::XmlNode()
 	:myNext(NULL)
 	,myParent(NULL)
 	,myChild(NULL)
+	,myLastChild(NULL)
 {
 }
 
@@ -686,19 +728,17 @@ void XmlNode::ClearChildren()
 		delete temp;
 	}
 	myChild = NULL;
+	myLastChild = NULL;
 }
 
 void XmlNode::AddChild(XmlNode* child)
 {
 	child->myParent = this;
-	if(myChild)
-	{
-		XmlNode* last = myChild;
-		while(last->myNext)
-			last = last->myNext;
-		last->myNext = child;
-	}
-	else myChild = child;
+	if(myLastChild)
+		myLastChild->myNext = child;
+	else
+		myChild = child;
+	myLastChild = child;
 }
 
 void XmlNode::SetValue(GxString value)
@@ -775,12 +815,14 @@ XmlNode::Type   XmlNode::GetType() const  {return UNKNOWN;}
 XmlElem::XmlElem()
 	:myAttributes(NULL)
 	,myAttributeCount(0)
+	,myAttributeCapacity(0)
 {
 }
 
 XmlElem::XmlElem(GxString name)
 	:myAttributes(NULL)
 	,myAttributeCount(0)
+	,myAttributeCapacity(0)
 {
 	myValue = name;
 }
@@ -792,20 +834,28 @@ XmlElem::~XmlElem()
 
 void XmlElem::ClearAttributes()
 {
-	for(int i=0; i<myAttributeCount; ++i)
-		delete myAttributes[i];
-	GxFree(myAttributes);
+	delete[] myAttributes;
 
 	myAttributeCount = 0;
+	myAttributeCapacity = 0;
 	myAttributes = NULL;
 }
 
 void XmlElem::AddAttribute(GxString name, GxString value)
 {
-	Attribute a = {name, value};
-	int count = ++myAttributeCount;
-	myAttributes = GxRealloc(myAttributes, count);
-	myAttributes[count - 1] = new Attribute(a);
+	if(myAttributeCount == myAttributeCapacity)
+	{
+		// Grow the attribute array, the strings are shared with the old array
+		myAttributeCapacity = GxMax(myAttributeCapacity * 2, 4);
+		Attribute* attributes = new Attribute[myAttributeCapacity];
+		for(int i=0; i<myAttributeCount; ++i)
+			attributes[i] = myAttributes[i];
+		delete[] myAttributes;
+		myAttributes = attributes;
+	}
+	Attribute& a = myAttributes[myAttributeCount++];
+	a.name = name;
+	a.value = value;
 }
 
 int XmlElem::GetAttributeCount() const
@@ -816,46 +866,46 @@ int XmlElem::GetAttributeCount() const
 XmlElem::Attribute* XmlElem::GetAttribute(int index)
 {
 	return (index >= 0 && index < myAttributeCount) ? 
-		myAttributes[index] : NULL;
+		myAttributes + index : NULL;
 }
 
 GxString XmlElem::GetAttribute(const char* name) const
 {
 	for(int i=0; i<myAttributeCount; ++i)
-		if(myAttributes[i]->name == name)
-			return myAttributes[i]->value;
+		if(myAttributes[i].name == name)
+			return myAttributes[i].value;
 	return GxString();
 }
 
 bool XmlElem::GetAttribute(const char* name, int& v) const
 {
 	for(int i=0; i<myAttributeCount; ++i)
-		if(myAttributes[i]->name == name)
-			return myAttributes[i]->value.ToInt(v);
+		if(myAttributes[i].name == name)
+			return myAttributes[i].value.ToInt(v);
 	return false;
 }
 
 bool XmlElem::GetAttribute(const char* name, bool& v) const
 {
 	for(int i=0; i<myAttributeCount; ++i)
-		if(myAttributes[i]->name == name)
-			return myAttributes[i]->value.ToBool(v);
+		if(myAttributes[i].name == name)
+			return myAttributes[i].value.ToBool(v);
 	return false;
 }
 
 bool XmlElem::GetAttribute(const char* name, float& v) const
 {
 	for(int i=0; i<myAttributeCount; ++i)
-		if(myAttributes[i]->name == name)
-			return myAttributes[i]->value.ToFloat(v);
+		if(myAttributes[i].name == name)
+			return myAttributes[i].value.ToFloat(v);
 	return false;
 }
 
 bool XmlElem::GetAttribute(const char* name, GxString& v) const
 {
 	for(int i=0; i<myAttributeCount; ++i)
-		if(myAttributes[i]->name == name)
-			{v = myAttributes[i]->value; return true;}
+		if(myAttributes[i].name == name)
+			{v = myAttributes[i].value; return true;}
 	return false;
 }
 
@@ -933,27 +983,18 @@ bool XmlDocument::Load(const char* path, CondenseWhitespace cw)
 {
 	ClearError();
 
-	// Open the file
-	GxFileInterface* file = GxFileInterface::Get();
-	GxFileHandle fp = file->Open(path);
-	if(!fp)
+	// Read the file contents into a buffer
+	size_t size;
+	char* buffer = GxReadFile(path, size);
+	if(!buffer)
 	{
 		myError.description = "Unable to open xml file";
 		return false;
 	}
 	myValue = path;
 
-	// Read the fp contents into a buffer
-	file->Seek(fp, 0, SEEK_END);
-	size_t size = file->Tell(fp);
-	file->Seek(fp, 0, SEEK_SET);
-
-	char* buffer = GxMalloc<char>(size + 1);
-	size = file->Read(fp, buffer, size);
-	buffer[size] = 0;
-
-	// Parse the string of text
-	bool result = LoadString(buffer, cw);
+	// Parse the buffer
+	bool result = myParse(buffer, cw);
 
 	GxFree(buffer);
 	return result;
@@ -963,36 +1004,66 @@ bool XmlDocument::LoadString(const char* text, CondenseWhitespace cw)
 {
 	int len = GxStrLen(text);
 	char* buffer = GxMalloc<char>(len + 1);
+	memcpy(buffer, text, len + 1);
 
-	// Convert all carriage returns to line feeds
-	const char* read = text;
-	char* write = buffer;
-	while(*read)
+	bool result = myParse(buffer, cw);
+
+	GxFree(buffer);
+	return result;
+}
+
+bool XmlDocument::myParse(char* buffer, CondenseWhitespace cw)
+{
+	XmlReader reader;
+	reader.Reset(buffer, cw);
+
+	// Build the node tree from the reader events
+	XmlNode* parent = this;
+	while(true)
 	{
-		if(*read == 0xD) // CR
+		XmlNode* node = NULL;
+		switch(reader.Next())
+		{
+		case XmlReader::EV_ELEM_START:
 		{
-			*write = 0xA; // LF
-			++write, ++read;
-			if(*read == 0xA) ++read; // LF
+			XmlElem* elem = new XmlElem(reader.GetName());
+			for(int i=0; i<reader.GetAttributeCount(); ++i)
+				elem->AddAttribute(reader.GetAttributeName(i), reader.GetAttributeValue(i));
+			parent->AddChild(elem);
+			parent = elem;
+			break;
 		}
-		else 
+		case XmlReader::EV_ELEM_END:
+			parent = parent->Parent();
+			break;
+		case XmlReader::EV_TEXT:
+			node = new XmlText(reader.GetText());
+			break;
+		case XmlReader::EV_COMMENT:
+			node = new XmlComment(reader.GetText());
+			break;
+		case XmlReader::EV_DECLARATION:
 		{
-			*write++ = *read++;
+			const char* version = reader.GetAttribute("version");
+			const char* encoding = reader.GetAttribute("encoding");
+			const char* standalone = reader.GetAttribute("standalone");
+			XmlDeclaration* decl = new XmlDeclaration();
+			decl->Set(version ? version : "", encoding ? encoding : "", standalone ? standalone : "");
+			node = decl;
+			break;
 		}
+		case XmlReader::EV_UNKNOWN:
+			node = new XmlNode();
+			node->SetValue(reader.GetText());
+			break;
+		case XmlReader::EV_END:
+			return !myError.isError;
+		case XmlReader::EV_ERROR:
+			SetError(reader.GetError());
+			return false;
+		}
+		if(node) parent->AddChild(node);
 	}
-	*write = 0;
-
-	// Skip BOM character
-	const char* p = buffer;
-	const uchar bom[] = {0xEF, 0xBB, 0xBF};
-	if(memcmp(p, bom, 3) == 0) p += 3;
-
-	// Parse the document
-	XmlParser parser(cw);
-	parser.ParseDoc(p, this);
-
-	GxFree(buffer);
-	return !myError.isError;
 }
 
 GxString XmlDocument::Save()
@@ -1019,5 +1090,284 @@ const XmlDocument::Error& XmlDocument::GetError() const {return myError;}
 XmlDocument*              XmlDocument::ToDocument()     {return this;}
 XmlNode::Type             XmlDocument::GetType() const  {return DOCUMENT;}
 
+// ===================================================================================
+// XmlTreeNode
+// ===================================================================================
+
+XmlTreeNode::XmlTreeNode(XmlNode::Type type, const char* value)
+	:myType(type)
+	,myValue(value)
+	,myParent(NULL)
+	,myChild(NULL)
+	,myLastChild(NULL)
+	,myNext(NULL)
+	,myAttributes(NULL)
+	,myAttributeCount(0)
+{
+}
+
+XmlTreeNode* XmlTreeNode::ChildElem()
+{
+	for(XmlTreeNode* n = myChild; n; n = n->myNext)
+		if(n->myType == XmlNode::ELEM)
+			return n;
+	return NULL;
+}
+
+XmlTreeNode* XmlTreeNode::ChildElem(const char* name)
+{
+	for(XmlTreeNode* n = myChild; n; n = n->myNext)
+		if(n->myType == XmlNode::ELEM && !strcmp(n->myValue, name))
+			return n;
+	return NULL;
+}
+
+XmlTreeNode* XmlTreeNode::NextElem()
+{
+	for(XmlTreeNode* n = myNext; n; n = n->myNext)
+		if(n->myType == XmlNode::ELEM)
+			return n;
+	return NULL;
+}
+
+XmlTreeNode* XmlTreeNode::NextElem(const char* name)
+{
+	for(XmlTreeNode* n = myNext; n; n = n->myNext)
+		if(n->myType == XmlNode::ELEM && !strcmp(n->myValue, name))
+			return n;
+	return NULL;
+}
+
+const XmlTreeNode::Attribute* XmlTreeNode::GetAttribute(int index) const
+{
+	return (index >= 0 && index < myAttributeCount) ? 
+		myAttributes + index : NULL;
+}
+
+const char* XmlTreeNode::GetAttribute(const char* name) const
+{
+	const char* value = myFindAttribute(name);
+	return value ? value : "";
+}
+
+bool XmlTreeNode::GetAttribute(const char* name, int& v) const
+{
+	const char* value = myFindAttribute(name);
+	return value ? GxString(value).ToInt(v) : false;
+}
+
+bool XmlTreeNode::GetAttribute(const char* name, bool& v) const
+{
+	const char* value = myFindAttribute(name);
+	return value ? GxString(value).ToBool(v) : false;
+}
+
+bool XmlTreeNode::GetAttribute(const char* name, float& v) const
+{
+	const char* value = myFindAttribute(name);
+	return value ? GxString(value).ToFloat(v) : false;
+}
+
+bool XmlTreeNode::GetAttribute(const char* name, GxString& v) const
+{
+	const char* value = myFindAttribute(name);
+	if(value) v = value;
+	return value != NULL;
+}
+
+const char* XmlTreeNode::GetText() const
+{
+	XmlTreeNode* node = myChild;
+	if(node && node->myType == XmlNode::TEXT)
+		return node->myValue;
+	return "";
+}
+
+const char* XmlTreeNode::myFindAttribute(const char* name) const
+{
+	for(int i=0; i<myAttributeCount; ++i)
+		if(!strcmp(myAttributes[i].name, name))
+			return myAttributes[i].value;
+	return NULL;
+}
+
+XmlNode::Type XmlTreeNode::GetType() const           {return myType;}
+const char*   XmlTreeNode::Value() const             {return myValue;}
+XmlTreeNode*  XmlTreeNode::Parent()                  {return myParent;}
+XmlTreeNode*  XmlTreeNode::Child()                   {return myChild;}
+XmlTreeNode*  XmlTreeNode::Next()                    {return myNext;}
+int           XmlTreeNode::GetAttributeCount() const {return myAttributeCount;}
+
+// ===================================================================================
+// XmlTree
+// ===================================================================================
+
+enum XmlTreeProperties
+{
+	TREE_BLOCK_SIZE = 64 * 1024,
+};
+
+struct XmlTree::Block
+{
+	Block* next;
+};
+
+XmlTree::XmlTree()
+	:XmlTreeNode(XmlNode::DOCUMENT, "")
+	,myBuffer(NULL)
+	,myBlocks(NULL)
+	,myBlockPos(NULL)
+	,myBlockEnd(NULL)
+{
+	myError.description = "No error";
+	myError.isError = false;
+}
+
+XmlTree::~XmlTree()
+{
+	Clear();
+}
+
+void XmlTree::Clear()
+{
+	while(myBlocks)
+	{
+		Block* next = myBlocks->next;
+		GxFree(myBlocks);
+		myBlocks = next;
+	}
+	GxFree(myBuffer);
+
+	myBuffer = NULL;
+	myBlockPos = myBlockEnd = NULL;
+	myChild = myLastChild = NULL;
+	myValue = "";
+	myPath.Clear();
+	myError.description = "No error";
+	myError.isError = false;
+}
+
+bool XmlTree::Load(const char* path, XmlDocument::CondenseWhitespace cw)
+{
+	Clear();
+
+	// Read the file contents into the buffer of the tree
+	size_t size;
+	myBuffer = GxReadFile(path, size);
+	if(!myBuffer)
+	{
+		myError.description = "Unable to open xml file";
+		myError.isError = true;
+		return false;
+	}
+	myPath = path;
+	myValue = myPath.Raw();
+
+	return myParse(cw);
+}
+
+bool XmlTree::LoadString(const char* text, XmlDocument::CondenseWhitespace cw)
+{
+	Clear();
+
+	int len = GxStrLen(text);
+	myBuffer = GxMalloc<char>(len + 1);
+	memcpy(myBuffer, text, len + 1);
+
+	return myParse(cw);
+}
+
+const XmlDocument::Error& XmlTree::GetError() const
+{
+	return myError;
+}
+
+bool XmlTree::myParse(XmlDocument::CondenseWhitespace cw)
+{
+	XmlReader reader;
+	reader.Reset(myBuffer, cw);
+
+	// Build the tree from the reader events, all strings stay inside the buffer
+	XmlTreeNode* parent = this;
+	while(true)
+	{
+		switch(reader.Next())
+		{
+		case XmlReader::EV_ELEM_START:
+			parent = myAddNode(parent, XmlNode::ELEM, reader.GetName());
+			myCopyAttributes(parent, reader);
+			break;
+		case XmlReader::EV_ELEM_END:
+			parent = parent->myParent;
+			break;
+		case XmlReader::EV_TEXT:
+			myAddNode(parent, XmlNode::TEXT, reader.GetText());
+			break;
+		case XmlReader::EV_COMMENT:
+			myAddNode(parent, XmlNode::COMMENT, reader.GetText());
+			break;
+		case XmlReader::EV_DECLARATION:
+			myCopyAttributes(myAddNode(parent, XmlNode::DECLARATION, ""), reader);
+			break;
+		case XmlReader::EV_UNKNOWN:
+			myAddNode(parent, XmlNode::UNKNOWN, reader.GetText());
+			break;
+		case XmlReader::EV_END:
+			return true;
+		case XmlReader::EV_ERROR:
+			myError.description = reader.GetError();
+			myError.isError = true;
+			return false;
+		}
+	}
+}
+
+XmlTreeNode* XmlTree::myAddNode(XmlTreeNode* parent, XmlNode::Type type, const char* value)
+{
+	XmlTreeNode* node = new (myAllocate(sizeof(XmlTreeNode))) XmlTreeNode(type, value);
+	node->myParent = parent;
+	if(parent->myLastChild)
+		parent->myLastChild->myNext = node;
+	else
+		parent->myChild = node;
+	parent->myLastChild = node;
+	return node;
+}
+
+void XmlTree::myCopyAttributes(XmlTreeNode* node, const XmlReader& reader)
+{
+	const int count = reader.GetAttributeCount();
+	if(count == 0) return;
+
+	node->myAttributes = (Attribute*)myAllocate(count * sizeof(Attribute));
+	node->myAttributeCount = count;
+	for(int i=0; i<count; ++i)
+	{
+		node->myAttributes[i].name = reader.GetAttributeName(i);
+		node->myAttributes[i].value = reader.GetAttributeValue(i);
+	}
+}
+
+void* XmlTree::myAllocate(int size)
+{
+	// Keep allocations aligned to the size of a pointer
+	size = (size + (int)sizeof(void*) - 1) & ~((int)sizeof(void*) - 1);
+
+	// Start a new block if the current block is full
+	if(myBlockEnd - myBlockPos < size)
+	{
+		const int capacity = GxMax(size, (int)TREE_BLOCK_SIZE);
+		Block* block = (Block*)GxMalloc<char>(sizeof(Block) + capacity);
+		block->next = myBlocks;
+		myBlocks = block;
+		myBlockPos = (char*)(block + 1);
+		myBlockEnd = myBlockPos + capacity;
+	}
+
+	void* result = myBlockPos;
+	myBlockPos += size;
+	return result;
+}
+
 }; // namespace core
 }; // namespace guix
\ No newline at end of file
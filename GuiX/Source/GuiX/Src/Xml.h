@@ -14,6 +14,7 @@ class XmlText;
 class XmlComment;
 class XmlDeclaration;
 class XmlDocument;
+class XmlTree;
 
 // ===================================================================================
 // XmlNode
@@ -40,7 +41,9 @@ class XmlDocument;
  - XmlDeclaration: value is not used.
  - XmlDocument:    the path of the file.
 
- To load an xml file, create an XmlDocument and use the \c Load() function.
+ To load an xml file, create an XmlDocument and use the \c Load() function. Documents
+ that only have to be read can be loaded faster with XmlTree, or processed without
+ building a tree at all with XmlReader.
 
  @see XmlElem, XmlText, XmlComment, XmlDeclaration, XmlDocument
 */
@@ -121,6 +124,7 @@ protected:
 	XmlNode* myNext;
 	XmlNode* myParent;
 	XmlNode* myChild;
+	XmlNode* myLastChild;
 
 private:
 	XmlNode(const XmlNode&);
@@ -191,8 +195,9 @@ public:
 	Type GetType() const;
 
 protected:
-	Attribute** myAttributes;
+	Attribute* myAttributes;
 	int myAttributeCount;
+	int myAttributeCapacity;
 };
 
 // ===================================================================================
@@ -324,8 +329,252 @@ public:
 	Type GetType() const;
 
 private:
+	bool myParse(char* buffer, CondenseWhitespace cw);
+
 	Error myError;
 };
 
+// ===================================================================================
+// XmlReader
+// ===================================================================================
+/** The XmlReader class reads an xml document as a sequence of events.
+
+ The reader parses a null-terminated buffer of text in place. Names and values are
+ terminated inside the buffer, and entities and whitespace are condensed where they are
+ found, so the reader does not allocate memory for the nodes it reads. The strings that
+ it returns remain valid for as long as the buffer exists. Use \c Next() to advance to
+ the next event, and the accessor functions to read the data of the current event:
+
+ - EV_ELEM_START:  start of an element. The name and attributes are available.
+ - EV_ELEM_END:    end of an element, also reported directly after an empty element.
+ - EV_TEXT:        a section of text or CDATA inside an element.
+ - EV_COMMENT:     a comment. The comment text is available.
+ - EV_DECLARATION: the xml declaration. Its attributes are available.
+ - EV_UNKNOWN:     any other tag, such as a doctype. The content of the tag is available.
+ - EV_END:         the end of the document has been reached.
+ - EV_ERROR:       the document is malformed, \c GetError() describes the problem.
+
+ Text is handled in the same way as by XmlDocument, using the whitespace setting that is
+ passed to \c Reset().
+
+ @see XmlDocument, XmlTree
+*/
+class XmlReader
+{
+public:
+	// Events that are reported by the reader.
+	enum Event
+	{
+		EV_ELEM_START,
+		EV_ELEM_END,
+		EV_TEXT,
+		EV_COMMENT,
+		EV_DECLARATION,
+		EV_UNKNOWN,
+		EV_END,
+		EV_ERROR,
+	};
+
+	/// Constructs a reader without a document.
+	XmlReader();
+	~XmlReader();
+
+	/// Starts reading the null-terminated text in buffer. The buffer is modified while
+	/// the document is read, and has to remain valid while the strings are in use.
+	void Reset(char* buffer, XmlDocument::CondenseWhitespace cw = XmlDocument::CW_FULL);
+
+	/// Reads the next event. Once EV_END or EV_ERROR is reached, it is returned again.
+	Event Next();
+
+	/// Returns the current event.
+	Event GetEvent() const;
+
+	/// Returns the name of the current element, or an empty string for other events.
+	const char* GetName() const;
+
+	/// Returns the text of the current text, comment or unknown tag event.
+	const char* GetText() const;
+
+	/// Returns the number of attributes of the current element or declaration.
+	int GetAttributeCount() const;
+
+	/// Returns the name and value of the attribute at position index.
+	/// @{
+	const char* GetAttributeName(int index) const;
+	const char* GetAttributeValue(int index) const;
+	/// @}
+
+	/// Returns the value of the attribute with name, or NULL if it does not exist.
+	const char* GetAttribute(const char* name) const;
+
+	/// Returns the number of elements that contain the current event.
+	int GetDepth() const;
+
+	/// Returns a description of the error when EV_ERROR was reached.
+	const GxString& GetError() const;
+
+private:
+	Event myFail(const GxString& description);
+	Event myReadText(char* p);
+	Event myReadElem(char* p);
+	Event myReadEndTag(char* p);
+	Event myReadDecl(char* p);
+	char* myReadAttribute(char* p);
+
+	char* myPos;
+	const char* myName;
+	const char* myText;
+	const char** myAttributes;
+	int myAttributeCount;
+	int myAttributeCapacity;
+	const char** myStack;
+	int myDepth;
+	int myStackCapacity;
+	Event myEvent;
+	XmlDocument::CondenseWhitespace myCw;
+	GxString myError;
+	bool myAtTag;
+	bool myIsEmptyElem;
+};
+
+// ===================================================================================
+// XmlTreeNode
+// ===================================================================================
+/** The XmlTreeNode class is a node of a read-only xml tree.
+
+ XmlTreeNode offers the same traversal functions as XmlNode and XmlElem. The value and
+ attributes of a node point into the buffer of the XmlTree that owns it. The type of the
+ node is one of the XmlNode types.
+
+ @see XmlTree
+*/
+class XmlTreeNode
+{
+public:
+	/// Used to store xml element attributes.
+	struct Attribute
+	{
+		const char* name;  ///< The attribute name.
+		const char* value; ///< The attribute value.
+	};
+
+	/// Returns the type of the node.
+	XmlNode::Type GetType() const;
+
+	/// Returns the value of the node, see XmlNode for more info.
+	const char* Value() const;
+
+	/// Returns the node that contains this node, or NULL if there is none.
+	XmlTreeNode* Parent();
+
+	/// Returns the first child, or NULL if there is none.
+	XmlTreeNode* Child();
+
+	/// Returns the first child element, or NULL if there is none.
+	XmlTreeNode* ChildElem();
+
+	/// Returns the first child element that matches name, or NULL if there is none.
+	XmlTreeNode* ChildElem(const char* name);
+
+	/// Returns the next sibling, or NULL if there is none.
+	XmlTreeNode* Next();
+
+	/// Returns the next sibling element, or NULL if there is none.
+	XmlTreeNode* NextElem();
+
+	/// Returns the next sibling element that matches name, or NULL if there is none.
+	XmlTreeNode* NextElem(const char* name);
+
+	/// Returns the number of attributes that the element has.
+	int GetAttributeCount() const;
+
+	/// Returns the attribute of the element at position index.
+	const Attribute* GetAttribute(int index) const;
+
+	/// Returns the value of the attribute with name, or an empty string if it does not exist.
+	const char* GetAttribute(const char* name) const;
+
+	/// Finds and stores the value of the attribute with name in v. Returns true if 
+	/// the attribute was found and could be converted. On failure v is unchanged.
+	/// @{
+	bool GetAttribute(const char* name, int& v) const;
+	bool GetAttribute(const char* name, bool& v) const;
+	bool GetAttribute(const char* name, float& v) const;
+	bool GetAttribute(const char* name, GxString& v) const;
+	/// @}
+
+	/// Returns the value of the first text node inside the element, or an empty string
+	/// if the element does not start with a text node.
+	const char* GetText() const;
+
+protected:
+	XmlTreeNode(XmlNode::Type type, const char* value);
+
+	const char* myFindAttribute(const char* name) const;
+
+	XmlNode::Type myType;
+	const char* myValue;
+	XmlTreeNode* myParent;
+	XmlTreeNode* myChild;
+	XmlTreeNode* myLastChild;
+	XmlTreeNode* myNext;
+	Attribute* myAttributes;
+	int myAttributeCount;
+
+private:
+	friend class XmlTree;
+
+	XmlTreeNode(const XmlTreeNode&);
+	void operator = (const XmlTreeNode&);
+};
+
+// ===================================================================================
+// XmlTree
+// ===================================================================================
+/** The XmlTree class loads an xml document into a read-only tree.
+
+ XmlTree is meant for reading large documents that do not have to be modified or saved.
+ The document is read by XmlReader from a single buffer that is owned by the tree, and
+ the nodes point to the names and values inside that buffer. Nodes and attribute lists
+ are allocated from large blocks of memory, which are released together when the tree
+ is cleared or destroyed.
+
+ @see XmlTreeNode, XmlReader, XmlDocument
+*/
+class XmlTree : public XmlTreeNode
+{
+public:
+	/// Constructs an empty xml tree.
+	XmlTree();
+	~XmlTree();
+
+	/// Removes all nodes and releases the memory of the tree.
+	void Clear();
+
+	/// Loads an xml document from an xml file.
+	bool Load(const char* path, XmlDocument::CondenseWhitespace cw = XmlDocument::CW_FULL);
+
+	/// Loads an xml document from a string of text.
+	bool LoadString(const char* text, XmlDocument::CondenseWhitespace cw = XmlDocument::CW_FULL);
+
+	/// Returns error information when loading an xml document has failed.
+	const XmlDocument::Error& GetError() const;
+
+private:
+	struct Block;
+
+	bool myParse(XmlDocument::CondenseWhitespace cw);
+	XmlTreeNode* myAddNode(XmlTreeNode* parent, XmlNode::Type type, const char* value);
+	void myCopyAttributes(XmlTreeNode* node, const XmlReader& reader);
+	void* myAllocate(int size);
+
+	char* myBuffer;
+	Block* myBlocks;
+	char* myBlockPos;
+	char* myBlockEnd;
+	GxString myPath;
+	XmlDocument::Error myError;
+};
+
 }; // namespace core
 }; // namespace guix
\ No newline at end of file
@@ -87,6 +87,7 @@ void GxButton::Draw()
 void GxButton::SetText(GxString text)
 {
 	myText = text;
+	Invalidate();
 }
 
 const GxString& GxButton::GetText() const
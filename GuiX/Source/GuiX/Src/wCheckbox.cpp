@@ -104,6 +104,7 @@ void GxCheckbox::Draw()
 void GxCheckbox::SetText(const GxString& text)
 {
 	myText = text;
+	Invalidate();
 }
 
 void GxCheckbox::SetVarPtr(bool* var)
@@ -114,6 +115,7 @@ void GxCheckbox::SetVarPtr(bool* var)
 void GxCheckbox::SetChecked(bool checked)
 {
 	myFlags.Set(F_CHECKED, checked);
+	InvalidateGeometry();
 }
 
 const GxString& GxCheckbox::GetText() const
@@ -202,7 +202,12 @@ void GxColorPicker::Tick(float dt)
 	}
 	else if(IsHoverWidget())
 	{
-		myHoverItem = myGetItemAtPos(mpos.x, mpos.y);
+		const int item = myGetItemAtPos(mpos.x, mpos.y);
+		if(item != myHoverItem)
+		{
+			myHoverItem = item;
+			InvalidateGeometry();
+		}
 	}
 
 	// Tick the RGB controls.
@@ -349,6 +354,7 @@ void GxColorPicker::myUpdateHSL(const GxVec4f& hsl)
 		myHSL = hsl;
 		myRGB = HSLtoRGB(myHSL);
 		SetRGBColor(mySliders, myRGB);
+		InvalidateGeometry();
 		EmitEvent(eChanged(), myRGB);
 	}
 }
@@ -8,6 +8,8 @@
 #include <GuiX/wDock.h>
 #include <GuiX/wScrollbar.h>
 
+#include <Src/GuiUtils.h>
+
 namespace guix {
 namespace widgets {
 
@@ -54,6 +56,7 @@ GxDock::GxDock()
 	:GxContainer(new GxListLayout())
 	,myOwner(NULL)
 	,myState(DS_FLOATING)
+	,myMouseItem(I_NONE)
 {
 	myPolicy->min.Set(64, barH);
 	myPolicy->hint.Set(128, barH);
@@ -147,16 +150,27 @@ void GxDock::SetFloatingPos(int x, int y)
 {
 	myFloatRect.x = x;
 	myFloatRect.y = y;
+	Invalidate();
 }
 
 void GxDock::SetFloatingSize(int w, int h)
 {
 	myFloatRect.w = w;
 	myFloatRect.h = h;
+	Invalidate();
 }
 
 void GxDock::Tick(float dt)
 {
+	// The button under the mouse is highlighted.
+	GxVec2i mpos = GxInput::Get()->GetMousePos();
+	const Item item = myGetItemAt(mpos.x, mpos.y);
+	if(item != myMouseItem)
+	{
+		myMouseItem = item;
+		InvalidateGeometry();
+	}
+
 	if(!myState[DS_COLLAPSED])
 		myLayout->Tick(dt);
 }
@@ -166,10 +180,6 @@ void GxDock::Draw()
 	GxDraw* draw = GxDraw::Get();
 	GxStyle& style = *GxStyle::Get();
 
-	// Get the mouse over item
-	GxVec2i mpos = GxInput::Get()->GetMousePos();
-	Item mouseItem = myGetItemAt(mpos.x, mpos.y);
-
 	// Draw dock frame.
 	GxRecti r = myRect;
 	if(IsFloating())
@@ -194,7 +204,7 @@ void GxDock::Draw()
 	for(int i=0; i<myButtons.Size(); ++i)
 	{
 		int type = myButtons[i];
-		bool hl = (mouseItem == type);
+		bool hl = (myMouseItem == type);
 
 		GxSprite* sprite = &style.d.close;
 		if(type == I_COLLAPSE)
@@ -230,16 +240,20 @@ void GxDock::SetFlags(GxFlags flags)
 
 	if(myFlags[F_COLLAPSE])
 		myButtons.Append(I_COLLAPSE);
+
+	Invalidate();
 }
 
 void GxDock::SetTitle(GxString title)
 {
 	myTitle = title;
+	Invalidate();
 }
 
 void GxDock::Collapse(bool collapsed)
 {
 	myState.Set(DS_COLLAPSED, collapsed);
+	Invalidate();
 }
 
 void GxDock::MoveToTop()
@@ -406,6 +420,9 @@ void GxDockBin::Adjust()
 
 void GxDockBin::SetRect(const GxRecti& rect)
 {
+	// The scrollbar visibility depends on the height of the bin, see Adjust.
+	if(rect.h != myRect.h) myLayout.Invalidate();
+
 	GxRecti r = myRect = rect;
 
 	if(!myScrollbar->IsHidden())
@@ -510,8 +527,7 @@ GxDockArea::~GxDockArea()
 }
 
 GxDockArea::GxDockArea()
-	:myHoverDock(NULL)
-	,myFocusDock(NULL)
+	:myFocusDock(NULL)
 	,myDragHl(0.f)
 {
 	myPolicy->min.Set(64, 64);
@@ -527,7 +543,7 @@ GxDockArea::GxDockArea()
 
 void GxDockArea::OnMousePress(GxMouseEvent& evt)
 {
-	GxDock* hover = myHoverDock;
+	GxDock* hover = myGetHoverDock();
 	GxDock* focus = myFocusDock;
 
 	if(hover)
@@ -544,7 +560,7 @@ void GxDockArea::OnMousePress(GxMouseEvent& evt)
 
 			case GxDock::I_COLLAPSE:
 				myStartPress(hover);
-				hover->myState.Flip(DS_COLLAPSED);
+				hover->Collapse(!hover->myState[DS_COLLAPSED]);
 				break;
 
 			case GxDock::I_BAR:
@@ -586,7 +602,7 @@ void GxDockArea::Adjust()
 
 	// Adjust the floating docks
 	for(int i=0; i<myDocks.Size(); ++i)
-		myDocks[i]->Adjust();
+		myDocks[i]->UpdateAdjust();
 }
 
 void GxDockArea::SetRect(const GxRecti& rect)
@@ -621,7 +637,7 @@ void GxDockArea::SetRect(const GxRecti& rect)
 			r.x += myRect.x;
 			r.y += myRect.y;
 			if(dock->myState[DS_COLLAPSED]) r.h = barH;
-			dock->SetRect(r);
+			dock->UpdateRect(r);
 		}
 	}
 }
@@ -630,7 +646,6 @@ GxWidget* GxDockArea::FindHoverWidget(int x, int y)
 {
 	GxWidget* hover = NULL;
 	GxDockBin* bin = NULL;
-	myHoverDock = NULL;
 
 	if(!myRect.Contains(x, y))
 		return NULL;
@@ -643,9 +658,6 @@ GxWidget* GxDockArea::FindHoverWidget(int x, int y)
 			if(myDocks[i]->IsFloating())
 			{
 				hover = myDocks[i]->FindHoverWidget(x, y);
-				GxDock* dock = static_cast<GxDock*>(hover);
-				if(dock && myDocks.Contains(dock))
-					myHoverDock = dock;
 			}
 		}
 
@@ -655,9 +667,6 @@ GxWidget* GxDockArea::FindHoverWidget(int x, int y)
 			if(myBins[i])
 			{
 				hover = myBins[i]->FindHoverWidget(x, y);
-				GxDock* dock = static_cast<GxDock*>(hover);
-				if(dock && myDocks.Contains(dock))
-					myHoverDock = dock;
 				if(myBins[i]->GetRect().Contains(x, y))
 					bin = myBins[i];
 			}
@@ -676,15 +685,16 @@ void GxDockArea::Tick(float dt)
 	GxVec2i resizeDir = GxVec2i(0, 0);
 	bool draggingAction = false;
 
-	if(myHoverDock)
+	GxDock* hoverDock = myGetHoverDock();
+	if(hoverDock)
 	{
-		GxDock::Item item = myHoverDock->myGetItemAt(mpos.x, mpos.y);
+		GxDock::Item item = hoverDock->myGetItemAt(mpos.x, mpos.y);
 
 		if(item == GxDock::I_BAR)
 			draggingAction = true;
 
 		if(item == GxDock::I_FRAME)
-			resizeDir = myHoverDock->myGetResizeDir(mpos.x, mpos.y);
+			resizeDir = hoverDock->myGetResizeDir(mpos.x, mpos.y);
 	}
 
 	// Handle floating dock dragging action.
@@ -692,6 +702,7 @@ void GxDockArea::Tick(float dt)
 	{
 		draggingAction = true;
 
+		const GxRecti old = myFocusDock->myFloatRect;
 		GxRecti r = myActionDims;
 		r.x += mpos.x - myActionPos.x;
 		r.y += mpos.y - myActionPos.y;
@@ -699,18 +710,23 @@ void GxDockArea::Tick(float dt)
 		myFocusDock->myFloatRect = r;
 		myFocusDock->myClampFloatSize(GxVec2i());
 		myFocusDock->myClampFloatPos(GxVec2i(myRect.w, myRect.h));
+		if(!SameRect(myFocusDock->myFloatRect, old))
+			myFocusDock->Invalidate();
 
 		myDragHl = GxMin(1.f, myDragHl + dt * 2);
+		InvalidateGeometry();
 	}
-	else 
+	else if(myDragHl > 0.f)
 	{
 		myDragHl = GxMax(0.f, myDragHl - dt * 4);
+		InvalidateGeometry();
 	}
 
 	// Handle floating dock resize action.
 	if(myActionType == FA_RESIZE)
 	{
 		resizeDir = myResizeDir;
+		const GxRecti old = myFocusDock->myFloatRect;
 		GxRecti r = myActionDims;
 		GxVec2i d = mpos - myActionPos;
 
@@ -722,6 +738,8 @@ void GxDockArea::Tick(float dt)
 		myFocusDock->myFloatRect = r;
 		myFocusDock->myClampFloatSize(myResizeDir);
 		myFocusDock->myClampFloatPos(GxVec2i(myRect.w, myRect.h));
+		if(!SameRect(myFocusDock->myFloatRect, old))
+			myFocusDock->Invalidate();
 	}
 
 	// Change the mouse cursor image when resizing.
@@ -769,7 +787,7 @@ void GxDockArea::Draw()
 	// Draw the floating docks.
 	for(int i=0; i<myDocks.Size(); ++i)
 		if(myDocks[i]->IsFloating() && !myDocks[i]->IsHidden())
-			myDocks[i]->Draw();
+			myDocks[i]->DrawCached();
 
 	// Draw docking area highlights.
 	if(myDragHl > 0.01f)
@@ -875,6 +893,7 @@ void GxDockArea::myMoveToTop(GxDock* dock)
 {
 	myDocks.EraseValue(dock);
 	myDocks.Append(dock);
+	InvalidateGeometry();
 }
 
 void GxDockArea::myUndock(GxDock* dock)
@@ -903,6 +922,17 @@ int GxDockArea::myGetBinAt(int x, int y) const
 	return -1;
 }
 
+GxDock* GxDockArea::myGetHoverDock() const
+{
+	// The hover dock is looked up every time, so it is never left over from a frame in which
+	// the dock area was not searched for the hover widget.
+	for(int i=0; i<myDocks.Size(); ++i)
+		if(myDocks[i]->IsHoverWidget())
+			return myDocks[i];
+
+	return NULL;
+}
+
 // ===================================================================================
 // Widget events
 // ===================================================================================
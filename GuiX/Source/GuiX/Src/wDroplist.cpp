@@ -8,12 +8,33 @@
 namespace guix {
 namespace widgets {
 
+namespace {
+
+// Presents the items of a droplist to its select list, so they do not have to be copied.
+class ItemModel : public GxListModel
+{
+public:
+	ItemModel(const GxList<GxString>* items) : myItems(items) {}
+
+	int GetRowCount() const {return myItems->Size();}
+	GxString GetRowText(int index) const {return (*myItems)[index];}
+
+private:
+	const GxList<GxString>* myItems;
+};
+
+// Typed text that follows the previous text within this many seconds extends the search.
+static const float SEARCH_DELAY = 1.f;
+
+}; // anonymous namespace
+
 // ===================================================================================
 // GxDroplist
 // ===================================================================================
 
 GxDroplist::~GxDroplist()
 {
+	delete myItemModel;
 }
 
 GxDroplist::GxDroplist() 
@@ -29,33 +50,56 @@ GxDroplist::GxDroplist(const char* id)
 
 void GxDroplist::myInit()
 {
+	myModel = NULL;
+	myItemModel = new ItemModel(&myItems);
 	mySelectList = NULL;
 	mySelectedItem = 0;
+	mySearchTimer = 0.f;
 
 	myPolicy->min.Set(16, 16);
 	myPolicy->hint.Set(96, 24);
 }
 
+void GxDroplist::OnKeyPress(GxKeyEvent& evt)
+{
+	if(mySelectList && !evt.handled)
+	{
+		if(evt.key == GX_KC_RETURN || evt.key == GX_KC_ESCAPE)
+		{
+			myCloseList(evt.key == GX_KC_RETURN);
+			evt.handled = true;
+		}
+	}
+}
+
+void GxDroplist::OnTextInput(GxTextEvent& evt)
+{
+	if(mySelectList && !evt.handled && evt.text.Length())
+	{
+		if(mySearchTimer > SEARCH_DELAY)
+			mySearchText.Clear();
+		mySearchTimer = 0.f;
+
+		// Typing the same character again moves to the next item that begins with it.
+		if(mySearchText.Length() == 1 && mySearchText == evt.text)
+		{
+			mySearch(true);
+		}
+		else
+		{
+			mySearchText.Append(evt.text);
+			mySearch(mySearchText.Length() == evt.text.Length());
+		}
+		evt.handled = true;
+	}
+}
+
 void GxDroplist::OnMousePress(GxMouseEvent& evt)
 {
 	if(mySelectList)
 	{
 		if(mySelectList->IsInteracted() || !evt.handled)
-		{
-			int index = mySelectList->GetSelectedItem();
-			
-			EmitEvent(eSelected(), myValues[index]);
-			if(index >= 0 && mySelectedItem != index)
-			{
-				mySelectedItem = index;
-				EmitEvent(eChanged(), myValues[index]);
-				myFlags.Set(F_CHANGED);
-			}
-			myFlags.Set(F_INTERACTED);
-
-			GetContext()->PopLayer();
-			mySelectList = NULL;
-		}
+			myCloseList(true);
 		evt.handled = true;
 	}
 	else if(IsHoverWidget())
@@ -68,6 +112,12 @@ void GxDroplist::OnMousePress(GxMouseEvent& evt)
 	}
 }
 
+void GxDroplist::Tick(float dt)
+{
+	if(mySelectList)
+		mySearchTimer += dt;
+}
+
 void GxDroplist::Draw()
 {
 	GxDraw* draw = GxDraw::Get();
@@ -83,8 +133,8 @@ void GxDroplist::Draw()
 	style.d.arrow.Draw(rect.x + rect.w - 12, rect.y + rect.h/2);
 	rect.w -= 12;
 
-	if(mySelectedItem >= 0 && mySelectedItem < myItems.Size())
-		style.Label(rect, GX_TA_CENTER, GX_TA_MIDDLE, myItems[mySelectedItem], lock);
+	if(mySelectedItem >= 0 && mySelectedItem < GetItemCount())
+		style.Label(rect, GX_TA_CENTER, GX_TA_MIDDLE, myModel ? myModel->GetRowText(mySelectedItem) : myItems[mySelectedItem], lock);
 }
 
 void GxDroplist::Clear()
@@ -92,29 +142,45 @@ void GxDroplist::Clear()
 	myItems.Clear();
 	myValues.Clear();
 	mySelectedItem = 0;
+	Invalidate();
 }
 
 void GxDroplist::AddItem(GxString text)
 {
 	myItems.Append(text);
 	myValues.Append(myValues.Size());
+	Invalidate();
 }
 
 void GxDroplist::AddItem(GxString text, const GxVariant& value)
 {
 	myItems.Append(text);
 	myValues.Append(value);
+	Invalidate();
 }
 
 void GxDroplist::SetSelectedItem(int index)
 {
 	mySelectedItem = index;
+	InvalidateGeometry();
+}
+
+void GxDroplist::SetModel(GxListModel* model)
+{
+	myModel = model;
+	mySelectedItem = 0;
+	Invalidate();
+}
+
+GxListModel* GxDroplist::GetModel() const
+{
+	return myModel;
 }
 
 GxVariant GxDroplist::GetValue() const
 {
-	if(mySelectedItem >= 0 && mySelectedItem < myValues.Size())
-		return myValues[mySelectedItem];
+	if(mySelectedItem >= 0 && mySelectedItem < GetItemCount())
+		return myModel ? GxVariant(mySelectedItem) : myValues[mySelectedItem];
 	return GxVariant();
 }
 
@@ -125,7 +191,7 @@ int GxDroplist::GetSelectedItem() const
 
 int GxDroplist::GetItemCount() const
 {
-	return myItems.Size();
+	return myModel ? myModel->GetRowCount() : myItems.Size();
 }
 
 void GxDroplist::myOpenList()
@@ -136,16 +202,15 @@ void GxDroplist::myOpenList()
 	GxRecti view = GetContext()->GetView();
 	GxRecti rect = myRect;
 
-	// Initialize the list.
-	for(int i=0; i<myItems.Size(); ++i)
-		mySelectList->AddItem(myItems[i]);
-
+	// Initialize the list; it reads the items from the model, and only draws the visible ones.
+	mySelectList->SetModel(myModel ? myModel : myItemModel);
 	mySelectList->SetSelectedItem(mySelectedItem);
+	mySelectList->ScrollToItem(mySelectedItem);
 
 	// Determine the list rectangle.
 	mySelectList->Adjust();
 
-	int prfH = GxMax(mySelectList->GetPreferredSize().y, GxMin(myItems.Size()*16, 320));
+	int prfH = GxMax(mySelectList->GetPreferredSize().y, GxMin(mySelectList->GetItemCount(), 20) * 16);
 	int topH = rect.y - view.y - 16;
 	int btmH = view.y + view.h - (rect.y + rect.h) - 16;
 
@@ -162,6 +227,47 @@ void GxDroplist::myOpenList()
 	}
 
 	GetContext()->PushLayer(mySelectList, r);
+
+	// Grab the input to receive the text that is typed to search the list.
+	mySearchText.Clear();
+	mySearchTimer = 0.f;
+	GrabInput();
+}
+
+void GxDroplist::myCloseList(bool select)
+{
+	int index = mySelectList->GetSelectedItem();
+	if(select && index >= 0)
+	{
+		const GxVariant value = myModel ? GxVariant(index) : myValues[index];
+		EmitEvent(eSelected(), value);
+		if(mySelectedItem != index)
+		{
+			mySelectedItem = index;
+			EmitEvent(eChanged(), value);
+			myFlags.Set(F_CHANGED);
+		}
+		myFlags.Set(F_INTERACTED);
+	}
+
+	GetContext()->PopLayer();
+	mySelectList = NULL;
+	mySearchText.Clear();
+	ReleaseInput();
+}
+
+void GxDroplist::mySearch(bool next)
+{
+	// Typing another character keeps the current item if it still matches, and cycling moves
+	// on to the next match. FindRow wraps around, so items before the current one are found too.
+	GxListModel* model = myModel ? myModel : myItemModel;
+	const int current = GxMax(mySelectList->GetSelectedItem(), 0);
+	const int index = model->FindRow(mySearchText, next ? current + 1 : current);
+	if(index >= 0)
+	{
+		mySelectList->SetSelectedItem(index);
+		mySelectList->ScrollToItem(index);
+	}
 }
 
 // ===================================================================================
@@ -39,6 +39,7 @@ void GxExpandingButton::OnMousePress(GxMouseEvent& evt)
 		if(evt.button == GX_MC_LEFT && !evt.handled && !IsLockedWidget())
 		{
 			myFlags.Flip(F_COLLAPSED);
+			Invalidate();
 		}
 		evt.handled = true;
 	}
@@ -161,6 +162,7 @@ void GxExpandingButton::Draw()
 void GxExpandingButton::SetCollapsed(bool enabled)
 {
 	myFlags.Set(F_COLLAPSED, enabled);
+	Invalidate();
 }
 
 }; // namespace widgets
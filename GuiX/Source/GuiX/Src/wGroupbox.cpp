@@ -53,6 +53,7 @@ void GxGroupbox::OnMousePress(GxMouseEvent& evt)
 		if(evt.button == GX_MC_LEFT && !evt.handled && !IsLockedWidget())
 		{
 			myFlags.Flip(F_COLLAPSED);
+			Invalidate();
 		}
 		evt.handled = true;
 	}
@@ -208,16 +209,19 @@ GxVec2i GxGroupbox::GetMinimumSize() const
 void GxGroupbox::SetText(const GxString& text)
 {
 	myText = text;
+	Invalidate();
 }
 
 void GxGroupbox::SetCollapsable(bool enabled)
 {
 	myFlags.Set(F_COLLAPSE, enabled);
+	Invalidate();
 }
 
 void GxGroupbox::SetTabAppearance(bool enabled)
 {
 	myFlags.Set(F_TAB, enabled);
+	Invalidate();
 }
 
 const GxString& GxGroupbox::GetText() const
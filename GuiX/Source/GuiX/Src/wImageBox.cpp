@@ -103,11 +103,13 @@ void GxImageBox::Draw()
 void GxImageBox::SetFrame(bool enabled)
 {
 	myFlags.Set(F_FRAME, enabled);
+	Invalidate();
 }
 
 void GxImageBox::SetBackgroundColor(GxColor c)
 {
 	myBgColor = c;
+	InvalidateGeometry();
 }
 
 GxSprite& GxImageBox::GetSprite()
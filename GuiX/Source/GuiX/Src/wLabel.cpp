@@ -100,9 +100,17 @@ void GxLabel::Draw()
 	}
 }
 
+void GxLabel::SetRect(const GxRecti& rect)
+{
+	// The preferred height of the label depends on its width when the text is wrapped.
+	if(rect.w != myRect.w) Invalidate();
+	myRect = rect;
+}
+
 void GxLabel::SetText(GxString text)
 {
 	myText = text;
+	Invalidate();
 }
 
 void GxLabel::SetMultiLine(bool enabled)
@@ -110,6 +118,7 @@ void GxLabel::SetMultiLine(bool enabled)
 	if(!mySettings)
 		mySettings = new GxText(GetTextSettings());
 	mySettings->SetFlag(GX_TF_ELLIPSIS, false);
+	Invalidate();
 }
 
 void GxLabel::SetTextAlignH(GxTextAlignH alignH)
@@ -117,6 +126,7 @@ void GxLabel::SetTextAlignH(GxTextAlignH alignH)
 	if(!mySettings) 
 		mySettings = new GxText(GetTextSettings());
 	mySettings->alignH = alignH;
+	Invalidate();
 }
 
 const GxString& GxLabel::GetText() const
@@ -130,6 +140,7 @@ void GxLabel::SetTextSettings(const GxText& settings)
 		mySettings = new GxText(settings);
 	else
 		*mySettings = settings;
+	Invalidate();
 }
 
 GxText GxLabel::GetTextSettings() const
@@ -38,8 +38,13 @@ GxProgressBar::GxProgressBar()
 
 void GxProgressBar::Tick(float dt)
 {
-	myValue += dt;
-	if(myValue > 1.0) myValue = 0.0;
+	// Only indefinite progress is animated, the value of other progress bars is set by SetProgress.
+	if(myFlags[PS_INDEFINITE])
+	{
+		myValue += dt;
+		if(myValue > 1.0) myValue = 0.0;
+		InvalidateGeometry();
+	}
 }
 
 void GxProgressBar::Draw()
@@ -94,6 +99,7 @@ void GxProgressBar::SetProgressIndefinite()
 	myFlags.Set(PS_INDEFINITE);
 	myFlags.Reset(PS_PERCENTAGE);
 	myFlags.Reset(PS_VALUE_MAX);
+	InvalidateGeometry();
 }
 
 void GxProgressBar::SetProgress(double percentage)
@@ -103,6 +109,7 @@ void GxProgressBar::SetProgress(double percentage)
 	myFlags.Reset(PS_VALUE_MAX);
 
 	myValue = GxClamp(percentage, 0.0, 100.0);
+	InvalidateGeometry();
 }
 
 void GxProgressBar::SetProgress(double value, double maximum)
@@ -113,6 +120,7 @@ void GxProgressBar::SetProgress(double value, double maximum)
 
 	myMaximum = GxMax(maximum, 0.0);
 	myValue = GxClamp(value, 0.0, maximum);
+	InvalidateGeometry();
 }
 
 double GxProgressBar::GetProgress() const
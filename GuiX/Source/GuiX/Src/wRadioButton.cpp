@@ -64,7 +64,10 @@ void GxRadioButton::OnMouseRelease(GxMouseEvent& evt)
 void GxRadioButton::OnGroupEvent(GxWidget* sender)
 {
 	if(sender->HasType<GxRadioButton>())
+	{
 		myFlags.Reset(F_SELECTED);
+		InvalidateGeometry();
+	}
 }
 
 void GxRadioButton::Adjust()
@@ -103,16 +106,19 @@ void GxRadioButton::Draw()
 void GxRadioButton::SetText(GxString text)
 {
 	myText = text;
+	Invalidate();
 }
 
 void GxRadioButton::SetValue(int value)
 {
 	myValue = value;
+	InvalidateGeometry();
 }
 
 void GxRadioButton::SetSelected()
 {
 	myFlags.Set(F_SELECTED, true);
+	InvalidateGeometry();
 	EmitGroupEvent();
 }
 
@@ -44,6 +44,7 @@ void GxScrollArea::myInit(bool scrollH, bool scrollV)
 {
 	myScrollbarH = NULL;
 	myScrollbarV = NULL;
+	myIsLazyArrange = false;
 
 	myPolicy->min.Set(32, 32);
 	myPolicy->hint.Set(64, 64);
@@ -126,6 +127,10 @@ void GxScrollArea::SetRect(const GxRecti& rect)
 		myScrollbarV->SetRange(0, scrollRange.y, view.h, 24);
 		myScrollbarV->SetRect(r);
 	}
+
+	// The layout may have been replaced, so the view is passed on every time it is arranged.
+	myLayout->SetVisibleRect(view);
+	myLayout->SetLazyArrange(myIsLazyArrange);
 	myLayout->Arrange(layoutRect);
 }
 
@@ -190,6 +195,7 @@ void GxScrollArea::SetScrollH(bool enabled)
 		delete myScrollbarH;
 		myScrollbarH = NULL;
 	}
+	Invalidate();
 }
 
 void GxScrollArea::SetScrollV(bool enabled)
@@ -205,6 +211,13 @@ void GxScrollArea::SetScrollV(bool enabled)
 		delete myScrollbarH;
 		myScrollbarV = NULL;
 	}
+	Invalidate();
+}
+
+void GxScrollArea::SetLazyArrange(bool enabled)
+{
+	myIsLazyArrange = enabled;
+	Invalidate();
 }
 
 bool GxScrollArea::myIsActiveH() const
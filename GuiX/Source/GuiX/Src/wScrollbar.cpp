@@ -128,7 +128,14 @@ void GxScrollbarAbstract::Tick(float dt)
 		myDragScrollbar(mpos.x, mpos.y);
 
 	if(IsHoverWidget())
-		myLastItem = myGetItemAtPos(mpos.x, mpos.y);
+	{
+		const int item = myGetItemAtPos(mpos.x, mpos.y);
+		if(item != myLastItem)
+		{
+			myLastItem = item;
+			InvalidateGeometry();
+		}
+	}
 
 	if(IsFocusWidget())
 	{
@@ -258,6 +265,7 @@ void GxScrollbarAbstract::SetRange(double begin, double end, double pageSize, do
 void GxScrollbarAbstract::SetButtons(bool enabled)
 {
 	myFlags.Set(F_BUTTONS, enabled);
+	InvalidateGeometry();
 }
 
 void GxScrollbarAbstract::SetSnapToSteps(bool enabled)
@@ -297,10 +305,15 @@ void GxScrollbarAbstract::myUpdateValue(double value, bool emitEvent)
 	}
 	value = GxClamp(value, min, max);
 
-	if(myValue != value && emitEvent)
+	if(myValue != value)
 	{
-		EmitEvent(eChanged(), value);
-		myFlags.Set(F_CHANGED);
+		// Parent widgets might arrange their children based on the scrollbar value.
+		Invalidate();
+		if(emitEvent)
+		{
+			EmitEvent(eChanged(), value);
+			myFlags.Set(F_CHANGED);
+		}
 	}
 
 	myValue = value;
@@ -1,5 +1,7 @@
 #include <GuiX/Config.h>
 
+#include <limits.h>
+
 #include <GuiX/Common.h>
 
 #include <GuiX/Style.h>
@@ -9,6 +11,37 @@
 namespace guix {
 namespace widgets {
 
+namespace {
+
+// Returns the height of count rows. Rows that would make the height overflow an int are not
+// counted, so models with more rows than that can not scroll to the last ones.
+static int GetRowsHeight(int count)
+{
+	return GxMin(count, (INT_MAX - 64) / 16) * 16;
+}
+
+}; // anonymous namespace
+
+// ===================================================================================
+// GxListModel
+// ===================================================================================
+
+int GxListModel::FindRow(const GxString& prefix, int start) const
+{
+	const int count = GetRowCount();
+	if(count <= 0) return -1;
+
+	if(start < 0 || start >= count) start = 0;
+	for(int i=0; i<count; ++i)
+	{
+		int index = start + i;
+		if(index >= count) index -= count;
+		if(GetRowText(index).StartsWith(prefix, false))
+			return index;
+	}
+	return -1;
+}
+
 // ===================================================================================
 // GxSelectList
 // ===================================================================================
@@ -19,8 +52,12 @@ GxSelectList::~GxSelectList()
 }
 
 GxSelectList::GxSelectList() 
-	:myScrollbar(NULL)
+	:myModel(NULL)
+	,myItemCount(0)
+	,myScrollbar(NULL)
+	,myMouseOverItem(-1)
 	,mySelectedItem(-1)
+	,myScrollToItem(-1)
 {
 	myAlignH = GX_TA_CENTER;
 
@@ -34,8 +71,12 @@ GxSelectList::GxSelectList()
 
 GxSelectList::GxSelectList(const char* id)
 	:GxWidget(id)
+	,myModel(NULL)
+	,myItemCount(0)
 	,myScrollbar(NULL)
+	,myMouseOverItem(-1)
 	,mySelectedItem(-1)
+	,myScrollToItem(-1)
 {
 	myAlignH = GX_TA_CENTER;
 
@@ -98,7 +139,7 @@ void GxSelectList::Adjust()
 {
 	if(myPolicy->adjustHint)
 	{
-		int itemH = myItems.Size() * 16 + 4;
+		int itemH = GetRowsHeight(myItemCount) + 4;
 		myPolicy->hint.y = GxClamp(itemH, 20, 128);
 	}
 }
@@ -108,11 +149,13 @@ void GxSelectList::SetRect(const GxRecti& rect)
 	GxRecti r = myRect = rect;
 
 	r.Shrink(r.w - 16, 0, 0, 0);
-	int itemH = myItems.Size() * 16 + 4;
+	int itemH = GetRowsHeight(myItemCount) + 4;
 
 	myScrollbar->SetRect(r);
 	myScrollbar->SetDisabled(itemH <= r.h);
 	myScrollbar->SetRange(0, itemH - r.h, r.h, 16);
+
+	myApplyScrollToItem();
 }
 
 GxWidget* GxSelectList::FindHoverWidget(int x, int y)
@@ -124,13 +167,36 @@ GxWidget* GxSelectList::FindHoverWidget(int x, int y)
 
 void GxSelectList::Tick(float dt)
 {
+	if(myModel)
+	{
+		const int count = myModel->GetRowCount();
+		if(count != myItemCount)
+		{
+			// Rows that were removed can no longer be selected.
+			myItemCount = count;
+			myMouseOverItem = GxMin(myMouseOverItem, count - 1);
+			if(mySelectedItem > count - 1)
+			{
+				mySelectedItem = count - 1;
+				EmitEvent(eChanged(), mySelectedItem);
+				myFlags.Set(F_CHANGED);
+			}
+			Invalidate();
+		}
+	}
+
 	if(!myScrollbar->IsHidden())
 		myScrollbar->Tick(dt);
 
 	if(IsHoverWidget())
 	{
 		GxVec2i pos = GxInput::Get()->GetMousePos();
-		myMouseOverItem = myGetItemAtPos(pos.x, pos.y);
+		const int item = myGetItemAtPos(pos.x, pos.y);
+		if(item != myMouseOverItem)
+		{
+			myMouseOverItem = item;
+			InvalidateGeometry();
+		}
 	}
 }
 
@@ -165,17 +231,17 @@ void GxSelectList::Draw()
 	if(myAlignH == GX_TA_CENTER) ox = listR.w/2;
 	else if(myAlignH == GX_TA_RIGHT) ox = listR.w - ox;
 
-	for(int i=0; i<myItems.Size(); ++i)
+	// Only the items that intersect the view rectangle are drawn.
+	const int first = GxMax(0, (viewRect.y - listR.y) / 16);
+	const int last = GxMin(myItemCount, (viewRect.y + viewRect.h - listR.y + 15) / 16);
+	for(int i=first; i<last; ++i)
 	{
 		GxRecti r(listR.x, listR.y + i*16, listR.w, 16);
-		if(r.y < viewRect.y+viewRect.h && r.y+r.h > viewRect.y)
-		{
-			if(i == mySelectedItem)
-				draw->Rect(r.x, r.y, r.w, r.h, style.c.textSelect);
-			else if(i == myMouseOverItem)
-				draw->Rect(r.x, r.y, r.w, r.h, style.c.textSelect.Alpha(hl * 0.5f));
-			settings.Draw(r.x + ox, r.y+r.h/2-2, myItems[i]);
-		}
+		if(i == mySelectedItem)
+			draw->Rect(r.x, r.y, r.w, r.h, style.c.textSelect);
+		else if(i == myMouseOverItem)
+			draw->Rect(r.x, r.y, r.w, r.h, style.c.textSelect.Alpha(hl * 0.5f));
+		settings.Draw(r.x + ox, r.y+r.h/2-2, myModel ? myModel->GetRowText(i) : myItems[i]);
 	}
 
 	settings.SetMaxWidth();
@@ -186,32 +252,58 @@ void GxSelectList::Draw()
 void GxSelectList::Clear()
 {
 	myItems.Clear();
+	if(!myModel) myItemCount = 0;
 	mySelectedItem = -1;
+	Invalidate();
 }
 
 void GxSelectList::AddItem(GxString text)
 {
 	myItems.Append(text);
+	if(!myModel) myItemCount = myItems.Size();
+	Invalidate();
 }
 
 void GxSelectList::SetSelectedItem(int index)
 {
 	mySelectedItem = index;
+	InvalidateGeometry();
 }
 
 void GxSelectList::SetTextAlignH(GxTextAlignH alignH)
 {
 	myAlignH = alignH;
+	InvalidateGeometry();
+}
+
+void GxSelectList::ScrollToItem(int index)
+{
+	myScrollToItem = index;
+	if(myRect.h > 0) myApplyScrollToItem();
 }
 
 GxString GxSelectList::GetItem(int index) const
 {
-	if(index >= 0 && index < myItems.Size())
-		return myItems[index];
+	if(index >= 0 && index < myItemCount)
+		return myModel ? myModel->GetRowText(index) : myItems[index];
 
 	return GxString();
 }
 
+void GxSelectList::SetModel(GxListModel* model)
+{
+	myModel = model;
+	myItemCount = model ? model->GetRowCount() : myItems.Size();
+	myMouseOverItem = -1;
+	mySelectedItem = -1;
+	Invalidate();
+}
+
+GxListModel* GxSelectList::GetModel() const
+{
+	return myModel;
+}
+
 int GxSelectList::GetSelectedItem() const
 {
 	return mySelectedItem;
@@ -219,7 +311,7 @@ int GxSelectList::GetSelectedItem() const
 
 int GxSelectList::GetItemCount() const
 {
-	return myItems.Size();
+	return myItemCount;
 }
 
 GxRecti GxSelectList::myGetListRect() const
@@ -231,19 +323,35 @@ GxRecti GxSelectList::myGetListRect() const
 	}
 
 	const int ofs = 2 - GxInt(myScrollbar->GetValue());
-	return GxRecti(myRect.x + 2, myRect.y + ofs, myRect.w - 20, myItems.Size() * 16);
+	return GxRecti(myRect.x + 2, myRect.y + ofs, myRect.w - 20, GetRowsHeight(myItemCount));
 }
 
-int GxSelectList::myGetItemAtPos(int x, int y) const
+void GxSelectList::myApplyScrollToItem()
 {
-	GxRecti r = myGetListRect();
-	for(int i=0; i<myItems.Size(); ++i)
+	// The item is at a fixed offset, so the scroll value follows from its index.
+	if(myScrollToItem >= 0 && myScrollToItem < myItemCount && !myScrollbar->IsHidden())
 	{
-		if(y < r.y + 16)
-			return i;
-		r.y += 16;
+		const int top = GetRowsHeight(myScrollToItem);
+		const int viewH = myRect.h - 4;
+		const int value = myScrollbar->GetIntValue();
+		if(top < value)
+			myScrollbar->SetValue(top);
+		else if(top + 16 > value + viewH)
+			myScrollbar->SetValue(top + 16 - viewH);
 	}
-	return -1;
+	myScrollToItem = -1;
+}
+
+int GxSelectList::myGetItemAtPos(int x, int y) const
+{
+	GxRecti r = myGetListRect();
+	if(myItemCount == 0)
+		return -1;
+	if(y < r.y)
+		return 0;
+
+	const int index = (y - r.y) / 16;
+	return (index < myItemCount) ? index : -1;
 }
 
 // ===================================================================================
@@ -182,11 +182,13 @@ void GxSliderAbstract::SetRange(double begin, double end, double tickInterval)
 void GxSliderAbstract::SetSnapToTicks(bool enabled)
 {
 	myFlags.Set(F_SNAPPING, enabled);
+	InvalidateGeometry();
 }
 
 void GxSliderAbstract::SetShowTicks(bool enabled)
 {
 	myFlags.Set(F_SHOWTICKS, enabled);
+	InvalidateGeometry();
 }
 
 int GxSliderAbstract::GetIntValue() const
@@ -227,10 +229,14 @@ void GxSliderAbstract::myUpdateValue(double value, bool emitEvent)
 	}
 	value = GxClamp(value, min, max);
 
-	if(myValue != value && emitEvent)
+	if(myValue != value)
 	{
-		EmitEvent(eChanged(), value);
-		myFlags.Set(F_CHANGED);
+		InvalidateGeometry();
+		if(emitEvent)
+		{
+			EmitEvent(eChanged(), value);
+			myFlags.Set(F_CHANGED);
+		}
 	}
 
 	myValue = value;
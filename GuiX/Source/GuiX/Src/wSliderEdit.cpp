@@ -33,7 +33,9 @@ void GxSliderEdit::myInit()
 	myLayout->Add(mySlider = new GxSliderH);
 	myLayout->Add(mySpinner = new GxSpinner);
 
-	mySpinner->GetPolicy().flagsH = GX_SP_RESIZE;
+	GxSizePolicy spinnerPolicy = mySpinner->GetPolicy();
+	spinnerPolicy.flagsH = GX_SP_RESIZE;
+	mySpinner->SetPolicy(spinnerPolicy);
 	mySpinner->SetRange(0.0, 1.0, 0.1, 2);
 
 	myLayout->Adjust();
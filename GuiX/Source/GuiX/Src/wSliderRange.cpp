@@ -25,6 +25,7 @@ GxSliderRange::GxSliderRange(const char* id, bool addSpinners)
 	,myValue(0,0)
 	,myRange(0,0)
 	,mySpinners(NULL)
+	,myHlLeft(false)
 {
 	myPolicy->min.Set(24, 16);
 	myPolicy->hint.Set(48, 16);
@@ -129,10 +130,17 @@ void GxSliderRange::Tick(float dt)
 	for(int i=0; mySpinners && i<2; ++i)
 		mySpinners[i].Tick(dt);
 
+	const GxVec2i mpos = GxInput::Get()->GetMousePos();
 	if(IsFocusWidget())
-	{
-		const GxVec2i mpos = GxInput::Get()->GetMousePos();
 		myDragSlider(mpos.x, mpos.y);
+
+	// The box closest to the mouse is highlighted.
+	const GxVec3i valPos = myGetValuePos();
+	const bool hlLeft = mpos.x < (valPos.x+valPos.y) / 2;
+	if(hlLeft != myHlLeft)
+	{
+		myHlLeft = hlLeft;
+		InvalidateGeometry();
 	}
 }
 
@@ -157,9 +165,7 @@ void GxSliderRange::Draw()
 	draw->Rect(valPos.x, valPos.z-1, valPos.y-valPos.x, 2, hlB, hlA, hlB, hlA);
 
 	// Slider box
-	int mouseX = GxInput::Get()->GetMousePos().x;
-	bool hlLeft = mouseX < (valPos.x+valPos.y) / 2;
-
+	const bool hlLeft = myHlLeft;
 	const GxVec2i dim(6, 12);
 	const GxRecti boxA(valPos.x - dim.x, valPos.z - dim.y/2, dim.x, dim.y);
 	const GxRecti boxB(valPos.y, valPos.z - dim.y/2, dim.x, dim.y);
@@ -235,6 +241,7 @@ void GxSliderRange::myUpdateValue(double value, bool left, bool emitEvent)
 	if(dst != value)
 	{
 		dst = value;
+		InvalidateGeometry();
 		if(emitEvent)
 		{
 			EmitEvent(eChanged(), GxVec2f(myValue));
@@ -162,7 +162,14 @@ void GxSpinner::Tick(float dt)
 	myField.Tick(mpos.x, mpos.y, dt);
 
 	if(!IsFocusWidget())
-		myMouseOverItem = myGetItemAtPos(mpos.x, mpos.y);
+	{
+		const int item = myGetItemAtPos(mpos.x, mpos.y);
+		if(item != myMouseOverItem)
+		{
+			myMouseOverItem = item;
+			InvalidateGeometry();
+		}
+	}
 
 	if(IsFocusWidget())
 	{
@@ -327,10 +334,14 @@ void GxSpinner::myUpdateValue(double value, bool emitEvent)
 	myField.SetText(valStr);
 
 	// Emit event
-	if(myValue != oldValue && emitEvent)
+	if(myValue != oldValue)
 	{
-		EmitEvent(eChanged(), myValue);
-		myFlags.Set(F_CHANGED);
+		InvalidateGeometry();
+		if(emitEvent)
+		{
+			EmitEvent(eChanged(), myValue);
+			myFlags.Set(F_CHANGED);
+		}
 	}
 }
 
@@ -44,7 +44,7 @@ void GxTabs::Adjust()
 		myTabs[i]->GetLayout().Adjust();
 
 	const int tabCount = GxMax(myTabs.Size(), 1);
-	GxSizePolicy& pol = GetPolicy();
+	GxSizePolicy& pol = *myPolicy;
 
 	if(pol.adjustMin)
 	{
@@ -116,7 +116,12 @@ GxWidget* GxTabs::FindHoverWidget(int x, int y)
 void GxTabs::Tick(float dt)
 {
 	GxVec2i mpos = GxInput::Get()->GetMousePos();
-	myHoverTab = myGetTabAtPos(mpos.x, mpos.y);
+	const int hoverTab = myGetTabAtPos(mpos.x, mpos.y);
+	if(hoverTab != myHoverTab)
+	{
+		myHoverTab = hoverTab;
+		InvalidateGeometry();
+	}
 
 	if(mySelectedTab)
 		mySelectedTab->GetLayout().Tick(dt);
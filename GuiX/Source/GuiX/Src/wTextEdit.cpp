@@ -1,6 +1,7 @@
 #include <GuiX/Config.h>
 
 #include <math.h>
+#include <limits.h>
 
 #include <GuiX/Core.h>
 #include <GuiX/Draw.h>
@@ -28,6 +29,7 @@ GxTextEditHelper::GxTextEditHelper()
 	,myIsSelected(false)
 	,myIsDragging(false)
 	,myForceScrollUpdate(false)
+	,myIsTextChanged(false)
 	,myReplacementChar('*')
 	,myHlColor(160)
 {
@@ -59,6 +61,14 @@ void GxTextEditHelper::OnKeyPress(GxKeyEvent& evt)
 	bool shift = (evt.flags & GX_KF_SHIFT) != 0;
 	bool ctrl  = (evt.flags & GX_KF_CTRL ) != 0;
 
+	if(ctrl && (key == GX_KC_Z || key == GX_KC_Y))
+	{
+		(key == GX_KC_Y || shift) ? Redo() : Undo();
+		return;
+	}
+	if(key == GX_KC_HOME || key == GX_KC_END || key == GX_KC_LEFT || key == GX_KC_RIGHT || key == GX_KC_UP || key == GX_KC_DOWN)
+		myContent.EndUndoGroup();
+
 	if(shift)
 	{
 		if(key == GX_KC_HOME ) myCursor.y = 0;
@@ -124,13 +134,13 @@ void GxTextEditHelper::OnMousePress(GxMouseEvent& evt)
 	if(!myIsSelected) return;
 
 	myIsDragging = true;
+	myContent.EndUndoGroup();
 
 	GxVec2i ofs = myGetScrollOffset();
 	GxVec2i pos = GxVec2i(evt.x, myIsMultiLine ? evt.y : (ofs.y + 2));
-	GxString str = myGetDisplayString();
 
 	myAdjustSettings();
-	myCursor.x = myCursor.y = mySettings.GetCharIndex(ofs.x, ofs.y, pos.x, pos.y, str);
+	myCursor.x = myCursor.y = myLayout.GetCharIndex(ofs.x, ofs.y, pos.x, pos.y);
 }
 
 void GxTextEditHelper::OnMouseRelease(GxMouseEvent& evt)
@@ -147,6 +157,8 @@ void GxTextEditHelper::OnTextInput(const GxString& text)
 	myFilterText(input);
 	input.Truncate(myMaxLength - myContent.Length());
 	myContent.Insert(myCursor.y, input);
+	myLayout.Insert(myCursor.y, myGetDisplayString(myCursor.y, input.Length()));
+	myIsTextChanged = true;
 	myCursor.y += input.Length();
 	myCursor.x = myCursor.y;
 	myForceScrollUpdate = true;
@@ -158,13 +170,12 @@ void GxTextEditHelper::Tick(int mouseX, int mouseY, float dt)
 
 	myAdjustSettings();
 	GxVec2i pos = myGetScrollOffset();
-	GxString string = myGetDisplayString();
 
 	// Update cursor position
 	if(myIsDragging)
 	{
 		GxVec2i m = GxVec2i(mouseX, myIsMultiLine ? mouseY : (pos.y+2));
-		int i = mySettings.GetCharIndex(pos.x, pos.y, m.x, m.y, string);
+		int i = myLayout.GetCharIndex(pos.x, pos.y, m.x, m.y);
 		myBlinkTime = 0.f;
 		myCursor.y = i;
 	}
@@ -176,9 +187,9 @@ void GxTextEditHelper::Tick(int mouseX, int mouseY, float dt)
 	const float fontH = (float)mySettings.font.GetSize();
 
 	const GxRectf textMargins(8.f, 8.f, 8.f, 8.f + fontH);
-	const GxRecti textRect = mySettings.GetTextRect(pos.x, pos.y, string);
+	const GxRecti textRect = myLayout.GetTextRect(pos.x, pos.y);
 	const GxVec2f textSize = GxVec2f((float)textRect.w, (float)textRect.h);
-	const GxRecti charRect = mySettings.GetCharRect(0, 0, myCursor.y, string);
+	const GxRecti charRect = myLayout.GetCharRect(0, 0, myCursor.y);
 	const GxVec2f cursorPos = GxVec2f((float)charRect.x, (float)charRect.y);
 
 	if(myIsMultiLine)
@@ -220,7 +231,6 @@ void GxTextEditHelper::Draw()
 
 	myAdjustSettings();
 	GxVec2i pos = myGetScrollOffset();
-	GxString string = myGetDisplayString();
 
 	draw->PushScissorRect(myRect.x, myRect.y, myRect.w, myRect.h);
 
@@ -229,29 +239,43 @@ void GxTextEditHelper::Draw()
 	{
 		GxVec2i cursor = myCursor;
 		if(cursor.x > cursor.y) GxSwap(cursor.x, cursor.y);
-		const GxColor top = mySettings.top;
-		const GxColor btm = mySettings.bottom;
-		mySettings.SetColor(myHlColor);
-		mySettings.SetRange(cursor.x, cursor.y);
-		mySettings.DrawHighlight(pos.x, pos.y+2, string);
-		mySettings.SetRange();
-		mySettings.top = top;
-		mySettings.bottom = btm;
+		GxText highlight = mySettings;
+		highlight.SetColor(myHlColor);
+		highlight.SetRange(cursor.x, cursor.y);
+		myLayout.SetSettings(highlight);
+		myLayout.DrawHighlight(pos.x, pos.y+2);
+		myLayout.SetSettings(mySettings);
 	}
 
 	// GxText rendering
-	mySettings.Draw(pos.x, pos.y, string);
+	myLayout.Draw(pos.x, pos.y);
 
 	// Selection cursor
 	if(myIsSelected && myBlinkTime < 0.5f)
 	{
-		GxRecti r = mySettings.GetCharRect(pos.x, pos.y, myCursor.y, string);
+		GxRecti r = myLayout.GetCharRect(pos.x, pos.y, myCursor.y);
 		draw->Rect(r.x, r.y+2, 1, r.h, mySettings.top, mySettings.bottom);
 	}
 
 	draw->PopScissorRect();
 }
 
+bool GxTextEditHelper::Undo()
+{
+	GxTextChange change;
+	if(!myContent.Undo(&change)) return false;
+	myApplyChange(change);
+	return true;
+}
+
+bool GxTextEditHelper::Redo()
+{
+	GxTextChange change;
+	if(!myContent.Redo(&change)) return false;
+	myApplyChange(change);
+	return true;
+}
+
 void GxTextEditHelper::SetRect(const GxRecti& rect)
 {
 	myRect = rect;
@@ -272,26 +296,25 @@ void GxTextEditHelper::SetMaxLength(size_t maxLength)
 void GxTextEditHelper::SetNumerical(bool isNumerical)
 {
 	myIsNumerical = isNumerical;
-	myFilterText(myContent);
+	mySetContent(GetText());
 }
 
 void GxTextEditHelper::SetMultiLine(bool isMultiLine)
 {
 	myIsMultiLine = isMultiLine;
-	myFilterText(myContent);
+	mySetContent(GetText());
 }
 
 void GxTextEditHelper::SetPassword(bool isPassword, char replacement)
 {
 	myIsPassword = isPassword;
 	myReplacementChar = replacement;
+	myUpdateLayout();
 }
 
 void GxTextEditHelper::SetText(const GxString& text)
 {
-	myContent = text;
-	myFilterText(myContent);
-	myContent.Truncate(myMaxLength);
+	mySetContent(text);
 	myCursor.x = myCursor.y = 0;
 }
 
@@ -332,7 +355,12 @@ size_t GxTextEditHelper::GetMaxLength() const
 
 const GxString& GxTextEditHelper::GetText() const
 {
-	return myContent;
+	if(myIsTextChanged)
+	{
+		myText = myContent.Substr();
+		myIsTextChanged = false;
+	}
+	return myText;
 }
 
 const GxText& GxTextEditHelper::GetSettings() const
@@ -351,6 +379,33 @@ void GxTextEditHelper::myAdjustSettings()
 	mySettings.alignH = GX_TA_LEFT;
 	mySettings.maxWidth = myIsMultiLine ? myRect.w : GxText::npos();
 	mySettings.SetFlag(GX_TF_ELLIPSIS, false);
+	myLayout.SetSettings(mySettings);
+}
+
+void GxTextEditHelper::mySetContent(GxString text)
+{
+	myFilterText(text);
+	text.Truncate(myMaxLength);
+	myContent.Set(text);
+	myIsTextChanged = true;
+	myUpdateLayout();
+}
+
+void GxTextEditHelper::myUpdateLayout()
+{
+	myLayout.SetText(myGetDisplayString());
+}
+
+// Updates the layout and the cursor after the content was changed by an undo or redo.
+void GxTextEditHelper::myApplyChange(const GxTextChange& change)
+{
+	myLayout.Erase(change.pos, change.erased);
+	myLayout.Insert(change.pos, myGetDisplayString(change.pos, change.inserted));
+	myCursor.x = change.pos;
+	myCursor.y = change.pos + change.inserted;
+	myIsTextChanged = true;
+	myForceScrollUpdate = true;
+	myBlinkTime = 0.f;
 }
 
 void GxTextEditHelper::myDeleteSelection()
@@ -360,6 +415,8 @@ void GxTextEditHelper::myDeleteSelection()
 		if(myCursor.x > myCursor.y) 
 			GxSwap(myCursor.x, myCursor.y);
 		myContent.Erase(myCursor.x, myCursor.y - myCursor.x);
+		myLayout.Erase(myCursor.x, myCursor.y - myCursor.x);
+		myIsTextChanged = true;
 		myCursor.y = myCursor.x;
 		myForceScrollUpdate = true;
 	}
@@ -370,7 +427,7 @@ int GxTextEditHelper::myAdvanceCursorLine(bool forward)
 	int pos = myCursor.y;
 	if(myIsMultiLine)
 	{
-		const char* str = myContent.Raw();
+		const GxTextBuffer& str = myContent;
 		int len = (int)myContent.Length();
 		if(forward)
 		{
@@ -413,11 +470,11 @@ void GxTextEditHelper::myFilterText(GxString& text) const
 	}
 }
 
-GxString GxTextEditHelper::myGetDisplayString() const
+GxString GxTextEditHelper::myGetDisplayString(int pos, int n) const
 {
 	if(myIsPassword)
-		return GxString(myReplacementChar, myContent.Length());
-	return myContent;
+		return GxString(myReplacementChar, GxClamp(n, 0, myContent.Length() - pos));
+	return myContent.Substr(pos, n);
 }
 
 GxVec2i GxTextEditHelper::myGetScrollOffset() const
@@ -0,0 +1,810 @@
+#include <GuiX/Config.h>
+
+#include <string.h>
+#include <math.h>
+
+#include <GuiX/Core.h>
+#include <GuiX/RenderInterfaceSoftware.h>
+
+#include "../../Win32Framework/Src/stb_image.h"
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define GX_SOFTWARE_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define GX_SOFTWARE_SSE2
+#endif
+
+namespace guix {
+namespace framework {
+
+// ===================================================================================
+// Pixel operations
+// ===================================================================================
+// Pixels are stored as RGBA bytes, which means red is in the low byte of a uint.
+
+namespace {
+
+struct Texture
+{
+	int width, height;
+	uint* pixels;
+};
+
+static inline uint ToPixel(const GxColor& c)
+{
+	return (uint)c.r | ((uint)c.g << 8) | ((uint)c.b << 16) | ((uint)c.a << 24);
+}
+
+// Returns the first pixel whose center lies on or after the given coordinate.
+static inline int PixelEdge(float x)
+{
+	return (int)ceilf(x - 0.5f);
+}
+
+// Divides by 255 with correct rounding, for values up to 255 * 255.
+static inline uint Div255(uint x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+// Interpolates all channels of two pixels; f ranges from 0 to 256.
+static inline uint Lerp(uint a, uint b, uint f)
+{
+	const uint rb = (((a & 0xFF00FF) * (256 - f) + (b & 0xFF00FF) * f) >> 8) & 0xFF00FF;
+	const uint ga = (((a >> 8) & 0xFF00FF) * (256 - f) + ((b >> 8) & 0xFF00FF) * f) & 0xFF00FF00;
+	return rb | ga;
+}
+
+static inline uint Modulate(uint a, uint b)
+{
+	uint out = 0;
+	for(int i=0; i<32; i+=8)
+		out |= Div255(((a >> i) & 0xFF) * ((b >> i) & 0xFF)) << i;
+	return out;
+}
+
+// Blends a source pixel onto a destination pixel, with the same blend functions as the GL renderer.
+template <int Mode>
+static inline uint Blend(uint d, uint s)
+{
+	if(Mode == GX_BM_NONE) return s;
+
+	const uint sa = s >> 24, ia = 255 - sa;
+	uint out = 0;
+	for(int i=0; i<32; i+=8)
+	{
+		const uint sc = (s >> i) & 0xFF, dc = (d >> i) & 0xFF;
+		uint c;
+		if(Mode == GX_BM_ADD)
+			c = GxMin(255u, dc + Div255(sc * sa));
+		else if(Mode == GX_BM_MULTIPLY)
+			c = GxMin(255u, Div255(sc * dc) + Div255(dc * ia));
+		else
+			c = Div255(sc * sa + dc * ia);
+		out |= c << i;
+	}
+	return out;
+}
+
+// Samples a texture with bilinear filtering and clamped coordinates.
+static inline uint Sample(const Texture* tex, float u, float v)
+{
+	const float x = u * (float)tex->width - 0.5f;
+	const float y = v * (float)tex->height - 0.5f;
+	const float fx = floorf(x), fy = floorf(y);
+	const int x0 = GxClamp((int)fx, 0, tex->width - 1), x1 = GxClamp((int)fx + 1, 0, tex->width - 1);
+	const int y0 = GxClamp((int)fy, 0, tex->height - 1), y1 = GxClamp((int)fy + 1, 0, tex->height - 1);
+	const uint wx = (uint)((x - fx) * 256.f), wy = (uint)((y - fy) * 256.f);
+
+	const uint* row0 = tex->pixels + y0 * tex->width;
+	const uint* row1 = tex->pixels + y1 * tex->width;
+	return Lerp(Lerp(row0[x0], row0[x1], wx), Lerp(row1[x0], row1[x1], wx), wy);
+}
+
+// Samples a horizontal span of a texture with bilinear filtering and clamped coordinates.
+// The horizontal texel position is stepped in 16.16 fixed point.
+static void SampleSpan(const Texture* tex, float u, float du, float v, uint* span, int n)
+{
+	const float y = v * (float)tex->height - 0.5f;
+	const float fy = floorf(y);
+	const int y0 = GxClamp((int)fy, 0, tex->height - 1), y1 = GxClamp((int)fy + 1, 0, tex->height - 1);
+	const uint wy = (uint)((y - fy) * 256.f);
+	const uint* row0 = tex->pixels + y0 * tex->width;
+	const uint* row1 = tex->pixels + y1 * tex->width;
+
+	const int maxX = tex->width - 1;
+	const int dx = (int)(du * (float)tex->width * 65536.f);
+	int x = (int)((u * (float)tex->width - 0.5f) * 65536.f);
+	for(int i=0; i<n; ++i, x += dx)
+	{
+		const int ix = x >> 16;
+		const uint wx = (uint)(x >> 8) & 0xFF;
+		const int x0 = GxClamp(ix, 0, maxX), x1 = GxClamp(ix + 1, 0, maxX);
+		const uint top = Lerp(row0[x0], row0[x1], wx);
+		span[i] = wy ? Lerp(top, Lerp(row1[x0], row1[x1], wx), wy) : top;
+	}
+}
+
+// ===================================================================================
+// SIMD pixel operations, four (SSE2) or eight (AVX2) pixels at a time.
+
+#if defined(GX_SOFTWARE_SSE2)
+
+static inline __m128i Div255(__m128i x)
+{
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+static inline __m128i Alpha(__m128i x)
+{
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xFF), 0xFF);
+}
+
+template <int Mode>
+static inline __m128i Blend(__m128i d, __m128i s)
+{
+	if(Mode == GX_BM_NONE) return s;
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i sl = _mm_unpacklo_epi8(s, zero), sh = _mm_unpackhi_epi8(s, zero);
+	const __m128i dl = _mm_unpacklo_epi8(d, zero), dh = _mm_unpackhi_epi8(d, zero);
+	const __m128i al = Alpha(sl), ah = Alpha(sh);
+	if(Mode == GX_BM_ADD)
+	{
+		const __m128i l = Div255(_mm_mullo_epi16(sl, al));
+		const __m128i h = Div255(_mm_mullo_epi16(sh, ah));
+		return _mm_adds_epu8(d, _mm_packus_epi16(l, h));
+	}
+
+	const __m128i c255 = _mm_set1_epi16(255);
+	const __m128i il = _mm_sub_epi16(c255, al), ih = _mm_sub_epi16(c255, ah);
+	if(Mode == GX_BM_MULTIPLY)
+	{
+		const __m128i ml = Div255(_mm_mullo_epi16(sl, dl)), mh = Div255(_mm_mullo_epi16(sh, dh));
+		const __m128i kl = Div255(_mm_mullo_epi16(dl, il)), kh = Div255(_mm_mullo_epi16(dh, ih));
+		return _mm_adds_epu8(_mm_packus_epi16(ml, mh), _mm_packus_epi16(kl, kh));
+	}
+
+	const __m128i l = Div255(_mm_add_epi16(_mm_mullo_epi16(sl, al), _mm_mullo_epi16(dl, il)));
+	const __m128i h = Div255(_mm_add_epi16(_mm_mullo_epi16(sh, ah), _mm_mullo_epi16(dh, ih)));
+	return _mm_packus_epi16(l, h);
+}
+
+static inline __m128i Modulate(__m128i s, __m128i cl)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i l = Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), cl));
+	const __m128i h = Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), cl));
+	return _mm_packus_epi16(l, h);
+}
+
+#endif // GX_SOFTWARE_SSE2
+
+#if defined(GX_SOFTWARE_AVX2)
+
+static inline __m256i Div255(__m256i x)
+{
+	x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+static inline __m256i Alpha(__m256i x)
+{
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, 0xFF), 0xFF);
+}
+
+template <int Mode>
+static inline __m256i Blend(__m256i d, __m256i s)
+{
+	if(Mode == GX_BM_NONE) return s;
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i sl = _mm256_unpacklo_epi8(s, zero), sh = _mm256_unpackhi_epi8(s, zero);
+	const __m256i dl = _mm256_unpacklo_epi8(d, zero), dh = _mm256_unpackhi_epi8(d, zero);
+	const __m256i al = Alpha(sl), ah = Alpha(sh);
+	if(Mode == GX_BM_ADD)
+	{
+		const __m256i l = Div255(_mm256_mullo_epi16(sl, al));
+		const __m256i h = Div255(_mm256_mullo_epi16(sh, ah));
+		return _mm256_adds_epu8(d, _mm256_packus_epi16(l, h));
+	}
+
+	const __m256i c255 = _mm256_set1_epi16(255);
+	const __m256i il = _mm256_sub_epi16(c255, al), ih = _mm256_sub_epi16(c255, ah);
+	if(Mode == GX_BM_MULTIPLY)
+	{
+		const __m256i ml = Div255(_mm256_mullo_epi16(sl, dl)), mh = Div255(_mm256_mullo_epi16(sh, dh));
+		const __m256i kl = Div255(_mm256_mullo_epi16(dl, il)), kh = Div255(_mm256_mullo_epi16(dh, ih));
+		return _mm256_adds_epu8(_mm256_packus_epi16(ml, mh), _mm256_packus_epi16(kl, kh));
+	}
+
+	const __m256i l = Div255(_mm256_add_epi16(_mm256_mullo_epi16(sl, al), _mm256_mullo_epi16(dl, il)));
+	const __m256i h = Div255(_mm256_add_epi16(_mm256_mullo_epi16(sh, ah), _mm256_mullo_epi16(dh, ih)));
+	return _mm256_packus_epi16(l, h);
+}
+
+static inline __m256i Modulate(__m256i s, __m256i cl)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i l = Div255(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), cl));
+	const __m256i h = Div255(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), cl));
+	return _mm256_packus_epi16(l, h);
+}
+
+#endif // GX_SOFTWARE_AVX2
+
+// ===================================================================================
+// Span operations
+
+// Blends a span of source pixels onto a span of destination pixels.
+// With alpha blending, groups of pixels that are fully opaque or fully transparent are copied or skipped.
+template <int Mode>
+static void BlendSpan(uint* dst, const uint* src, int n)
+{
+	int i = 0;
+#if defined(GX_SOFTWARE_AVX2)
+	const __m256i amask8 = _mm256_set1_epi32((int)0xFF000000);
+	for(; i + 8 <= n; i += 8)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		if(Mode == GX_BM_ALPHA)
+		{
+			const __m256i a = _mm256_and_si256(s, amask8);
+			if(_mm256_testz_si256(a, a)) continue;
+			if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, amask8)) == -1)
+			{
+				_mm256_storeu_si256((__m256i*)(dst + i), s);
+				continue;
+			}
+		}
+		const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), Blend<Mode>(d, s));
+	}
+#endif
+#if defined(GX_SOFTWARE_SSE2)
+	const __m128i amask4 = _mm_set1_epi32((int)0xFF000000);
+	for(; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		if(Mode == GX_BM_ALPHA)
+		{
+			const __m128i a = _mm_and_si128(s, amask4);
+			const int opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(a, amask4));
+			if(opaque == 0xFFFF)
+			{
+				_mm_storeu_si128((__m128i*)(dst + i), s);
+				continue;
+			}
+			if(_mm_movemask_epi8(_mm_cmpeq_epi32(a, _mm_setzero_si128())) == 0xFFFF) continue;
+		}
+		const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		_mm_storeu_si128((__m128i*)(dst + i), Blend<Mode>(d, s));
+	}
+#endif
+	for(; i < n; ++i)
+		dst[i] = Blend<Mode>(dst[i], src[i]);
+}
+
+// Blends a single color onto a span of destination pixels.
+template <int Mode>
+static void FillSpan(uint* dst, uint color, int n)
+{
+	int i = 0;
+#if defined(GX_SOFTWARE_AVX2)
+	const __m256i s8 = _mm256_set1_epi32((int)color);
+	for(; i + 8 <= n; i += 8)
+	{
+		const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), Blend<Mode>(d, s8));
+	}
+#endif
+#if defined(GX_SOFTWARE_SSE2)
+	const __m128i s4 = _mm_set1_epi32((int)color);
+	for(; i + 4 <= n; i += 4)
+	{
+		const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		_mm_storeu_si128((__m128i*)(dst + i), Blend<Mode>(d, s4));
+	}
+#endif
+	for(; i < n; ++i)
+		dst[i] = Blend<Mode>(dst[i], color);
+}
+
+// Multiplies a span of pixels with a color.
+static void ModulateSpan(uint* span, uint color, int n)
+{
+	int i = 0;
+#if defined(GX_SOFTWARE_AVX2)
+	const __m256i c8 = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)color), _mm256_setzero_si256());
+	for(; i + 8 <= n; i += 8)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i*)(span + i));
+		_mm256_storeu_si256((__m256i*)(span + i), Modulate(s, c8));
+	}
+#endif
+#if defined(GX_SOFTWARE_SSE2)
+	const __m128i c4 = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), _mm_setzero_si128());
+	for(; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i*)(span + i));
+		_mm_storeu_si128((__m128i*)(span + i), Modulate(s, c4));
+	}
+#endif
+	for(; i < n; ++i)
+		span[i] = Modulate(span[i], color);
+}
+
+static void BlendSpan(GxBlendMode mode, uint* dst, const uint* src, int n)
+{
+	switch(mode)
+	{
+		case GX_BM_NONE:     BlendSpan<GX_BM_NONE>(dst, src, n); break;
+		case GX_BM_ADD:      BlendSpan<GX_BM_ADD>(dst, src, n); break;
+		case GX_BM_MULTIPLY: BlendSpan<GX_BM_MULTIPLY>(dst, src, n); break;
+		default:             BlendSpan<GX_BM_ALPHA>(dst, src, n); break;
+	};
+}
+
+static void FillSpan(GxBlendMode mode, uint* dst, uint color, int n)
+{
+	const uint alpha = color >> 24;
+	if(mode == GX_BM_NONE || (mode == GX_BM_ALPHA && alpha == 255))
+	{
+		for(int i=0; i<n; ++i) dst[i] = color;
+		return;
+	}
+	if(alpha == 0 && (mode == GX_BM_ALPHA || mode == GX_BM_ADD))
+		return;
+
+	switch(mode)
+	{
+		case GX_BM_ADD:      FillSpan<GX_BM_ADD>(dst, color, n); break;
+		case GX_BM_MULTIPLY: FillSpan<GX_BM_MULTIPLY>(dst, color, n); break;
+		default:             FillSpan<GX_BM_ALPHA>(dst, color, n); break;
+	};
+}
+
+}; // anonymous namespace
+
+// ===================================================================================
+// stb_image callbacks
+// ===================================================================================
+
+namespace {
+
+static int fileRead(void* user, char* data, int size)
+{
+	GxFileInterface* io = GxFileInterface::Get();
+	GxFileHandle* handle = (GxFileHandle*)user;
+
+	return (int)io->Read(*handle, data, size);
+}
+
+static void fileSkip(void* user, unsigned int n)
+{
+	GxFileInterface* io = GxFileInterface::Get();
+	GxFileHandle* handle = (GxFileHandle*)user;
+
+	io->Seek(*handle, n, GxFileInterface::SeekCur());
+}
+
+static int fileEof(void* user)
+{
+	GxFileInterface* io = GxFileInterface::Get();
+	GxFileHandle* handle = (GxFileHandle*)user;
+
+	return (io->EndOfFile(*handle) ? 1 : 0);
+}
+
+}; // anonymous namespace.
+
+// ===================================================================================
+// GxRenderInterfaceSoftware
+// ===================================================================================
+
+GxRenderInterfaceSoftware::GxRenderInterfaceSoftware()
+	:myPixels(NULL)
+	,mySpan(NULL)
+	,myBlendMode(GX_BM_ALPHA)
+	,myIsScissorEnabled(false)
+{
+	SetViewSize(GxVec2i(640, 480));
+}
+
+GxRenderInterfaceSoftware::~GxRenderInterfaceSoftware()
+{
+	GxFree(myPixels);
+	GxFree(mySpan);
+}
+
+void GxRenderInterfaceSoftware::SetViewSize(GxVec2i size)
+{
+	size.x = GxMax(size.x, 1);
+	size.y = GxMax(size.y, 1);
+
+	myViewSize = size;
+	myPixels = GxRealloc(myPixels, size.x * size.y);
+	mySpan = GxRealloc(mySpan, size.x);
+	memset(myPixels, 0, size.x * size.y * sizeof(uint));
+
+	myUpdateClipRect();
+}
+
+GxVec2i GxRenderInterfaceSoftware::GetViewSize()
+{
+	return myViewSize;
+}
+
+void GxRenderInterfaceSoftware::Clear(GxColor color)
+{
+	const uint c = ToPixel(color);
+	const int n = myViewSize.x * myViewSize.y;
+	for(int i=0; i<n; ++i)
+		myPixels[i] = c;
+}
+
+const uchar* GxRenderInterfaceSoftware::GetPixels() const
+{
+	return (const uchar*)myPixels;
+}
+
+void GxRenderInterfaceSoftware::DrawTriangles(const GxVertex* vertices, int vertexCount, GxTextureHandle texture)
+{
+	for(int i=0; i + 3 <= vertexCount; i += 3)
+		myDrawTriangle(vertices[i], vertices[i+1], vertices[i+2], texture);
+}
+
+void GxRenderInterfaceSoftware::DrawTriangles(const GxVertex* vertices, int vertexCount, const uint* indices, int indexCount, GxTextureHandle texture)
+{
+	// Triangles that refer to vertices past the end of the vertex array are skipped.
+	const uint n = (uint)GxMax(vertexCount, 0);
+	int i = 0;
+	while(i + 3 <= indexCount)
+	{
+		// GxDraw emits quads as two triangles (a, b, c) and (a, c, d) that share the diagonal a-c.
+		// If such a quad is axis-aligned and so are its texture coordinates, it can be filled
+		// as a rectangle. Vertex b is either the horizontal or the vertical neighbour of a.
+		if(i + 6 <= indexCount && indices[i] == indices[i+3] && indices[i+2] == indices[i+4] &&
+		   indices[i] < n && indices[i+1] < n && indices[i+2] < n && indices[i+5] < n)
+		{
+			const GxVertex* a = &vertices[indices[i]];
+			const GxVertex* b = &vertices[indices[i+1]];
+			const GxVertex* c = &vertices[indices[i+2]];
+			const GxVertex* d = &vertices[indices[i+5]];
+			if(a->pos.y != b->pos.y) GxSwap(b, d);
+
+			const GxVertex* q[4] = {a, b, d, c};
+			if(q[0]->pos.y == q[1]->pos.y && q[2]->pos.y == q[3]->pos.y &&
+			   q[0]->pos.x == q[2]->pos.x && q[1]->pos.x == q[3]->pos.x &&
+			   q[0]->uvs.y == q[1]->uvs.y && q[2]->uvs.y == q[3]->uvs.y &&
+			   q[0]->uvs.x == q[2]->uvs.x && q[1]->uvs.x == q[3]->uvs.x)
+			{
+				myDrawQuad(q, texture);
+				i += 6;
+				continue;
+			}
+		}
+		if(indices[i] < n && indices[i+1] < n && indices[i+2] < n)
+			myDrawTriangle(vertices[indices[i]], vertices[indices[i+1]], vertices[indices[i+2]], texture);
+		i += 3;
+	}
+}
+
+void GxRenderInterfaceSoftware::SetBlendMode(GxBlendMode blendMode)
+{
+	// Like the GL renderer, blend modes that are not supported fall back to alpha blending.
+	if(blendMode == GX_BM_NONE || blendMode == GX_BM_ADD || blendMode == GX_BM_MULTIPLY)
+		myBlendMode = blendMode;
+	else
+		myBlendMode = GX_BM_ALPHA;
+}
+
+void GxRenderInterfaceSoftware::EnableScissorRect(bool enable)
+{
+	myIsScissorEnabled = enable;
+	myUpdateClipRect();
+}
+
+void GxRenderInterfaceSoftware::SetScissorRect(int x, int y, int width, int height)
+{
+	myScissorRect = GxRecti(x, y, width, height);
+	myUpdateClipRect();
+}
+
+bool GxRenderInterfaceSoftware::LoadTexture(GxTextureHandle& outTexture, int& outWidth, int& outHeight, const char* path)
+{
+	outWidth = outHeight = 0;
+
+	int w, h;
+	uchar* bits = NULL;
+	if(!LoadPixels(bits, w, h, path)) return false;
+
+	// If the loading succeeded, we fill in the output data.
+	bool result = GenerateTexture(outTexture, w, h, bits);
+	if(result)
+	{
+		outWidth = w;
+		outHeight = h;
+	}
+	ReleasePixels(bits);
+	return result;
+}
+
+bool GxRenderInterfaceSoftware::LoadPixels(uchar*& outPixels, int& outWidth, int& outHeight, const char* path)
+{
+	outPixels = NULL;
+	outWidth = outHeight = 0;
+
+	// Try to open the image file.
+	GxFileInterface* io = GxFileInterface::Get();
+	GxFileHandle file = io->Open(path);
+	if(!file) return false;
+
+	// Process the file using stb_image.
+	stbi_io_callbacks callbacks;
+	callbacks.read = fileRead;
+	callbacks.skip = fileSkip;
+	callbacks.eof = fileEof;
+
+	int cfmt, w, h;
+	uchar* bits = (uchar*)stbi_load_from_callbacks(&callbacks, &file, &w, &h, &cfmt, STBI_rgb_alpha);
+	io->Close(file);
+	if(!bits) return false;
+
+	outPixels = bits;
+	outWidth = w;
+	outHeight = h;
+	return true;
+}
+
+void GxRenderInterfaceSoftware::ReleasePixels(uchar* pixels)
+{
+	stbi_image_free(pixels);
+}
+
+bool GxRenderInterfaceSoftware::GenerateTexture(GxTextureHandle& outTexture, int width, int height, const uchar* pixeldata)
+{
+	if(width <= 0 || height <= 0) return false;
+
+	Texture* tex = new Texture;
+	tex->width = width;
+	tex->height = height;
+	tex->pixels = GxMalloc<uint>(width * height);
+	if(pixeldata)
+		memcpy(tex->pixels, pixeldata, width * height * sizeof(uint));
+	else
+		memset(tex->pixels, 0, width * height * sizeof(uint));
+
+	outTexture = (GxTextureHandle)tex;
+	return true;
+}
+
+void GxRenderInterfaceSoftware::ReleaseTexture(GxTextureHandle texture)
+{
+	Texture* tex = (Texture*)texture;
+	if(tex)
+	{
+		GxFree(tex->pixels);
+		delete tex;
+	}
+}
+
+bool GxRenderInterfaceSoftware::UpdateTexture(GxTextureHandle texture, int x, int y, int width, int height, const uchar* pixeldata)
+{
+	Texture* tex = (Texture*)texture;
+	if(!tex || x < 0 || y < 0 || x + width > tex->width || y + height > tex->height)
+		return false;
+
+	for(int row=0; row<height; ++row)
+		memcpy(tex->pixels + (y + row) * tex->width + x, pixeldata + row * width * 4, width * sizeof(uint));
+
+	return true;
+}
+
+// ===================================================================================
+// Private functions
+
+void GxRenderInterfaceSoftware::myUpdateClipRect()
+{
+	int l = 0, t = 0, r = myViewSize.x, b = myViewSize.y;
+	if(myIsScissorEnabled)
+	{
+		const GxRecti& s = myScissorRect;
+		l = GxMax(l, s.x);
+		t = GxMax(t, s.y);
+		r = GxMin(r, s.x + s.w);
+		b = GxMin(b, s.y + s.h);
+	}
+	myClipRect = GxRecti(l, t, GxMax(0, r - l), GxMax(0, b - t));
+}
+
+// Fills an axis-aligned quad; the vertices are ordered top-left, top-right, bottom-left, bottom-right.
+// Pixels are filled if their center lies inside the quad, like the triangles of the GL renderer.
+void GxRenderInterfaceSoftware::myDrawQuad(const GxVertex* v[4], GxTextureHandle texture)
+{
+	const float x0 = v[0]->pos.x, y0 = v[0]->pos.y;
+	const float w = v[1]->pos.x - x0, h = v[2]->pos.y - y0;
+	if(w == 0.f || h == 0.f) return;
+
+	const GxRecti& clip = myClipRect;
+	const int l = GxMax(clip.x, PixelEdge(GxMin(x0, x0 + w)));
+	const int r = GxMin(clip.x + clip.w, PixelEdge(GxMax(x0, x0 + w)));
+	const int t = GxMax(clip.y, PixelEdge(GxMin(y0, y0 + h)));
+	const int b = GxMin(clip.y + clip.h, PixelEdge(GxMax(y0, y0 + h)));
+	if(l >= r || t >= b) return;
+
+	const int n = r - l;
+	const uint c[4] = {ToPixel(v[0]->color), ToPixel(v[1]->color), ToPixel(v[2]->color), ToPixel(v[3]->color)};
+	const bool isGradientH = (c[0] != c[1] || c[2] != c[3]);
+	const bool isGradientV = (c[0] != c[2] || c[1] != c[3]);
+
+	// Texture coordinates at the center of the first pixel, and their change per pixel.
+	const Texture* tex = (const Texture*)texture;
+	float u = 0, du = 0, tv = 0, dv = 0;
+	bool isExact = false;
+	if(tex)
+	{
+		du = (v[1]->uvs.x - v[0]->uvs.x) / w;
+		dv = (v[2]->uvs.y - v[0]->uvs.y) / h;
+		u = v[0]->uvs.x + du * ((float)l + 0.5f - x0);
+		tv = v[0]->uvs.y + dv * ((float)t + 0.5f - y0);
+
+		// If texels map one-to-one onto pixels, the texture can be copied instead of filtered.
+		const float tx = u * (float)tex->width - 0.5f, ty = tv * (float)tex->height - 0.5f;
+		isExact = fabsf(du * (float)tex->width - 1.f) < 0.001f && fabsf(tx - floorf(tx + 0.5f)) < 0.001f &&
+		          fabsf(dv * (float)tex->height - 1.f) < 0.001f && fabsf(ty - floorf(ty + 0.5f)) < 0.001f;
+	}
+
+	for(int y=t; y<b; ++y)
+	{
+		uint* dst = myPixels + y * myViewSize.x + l;
+		const float fy = ((float)y + 0.5f - y0) / h;
+		const uint wy = (uint)GxClamp((int)(fy * 256.f), 0, 256);
+		const uint cl = isGradientV ? Lerp(c[0], c[2], wy) : c[0];
+		const uint cr = isGradientV ? Lerp(c[1], c[3], wy) : c[1];
+
+		// Untextured spans with a single color are blended directly.
+		if(!tex && !isGradientH)
+		{
+			FillSpan(myBlendMode, dst, cl, n);
+			continue;
+		}
+
+		uint* span = mySpan;
+		if(tex)
+		{
+			const float rv = tv + dv * (float)(y - t);
+			if(isExact)
+			{
+				const int ix = (int)floorf(u * (float)tex->width);
+				const int iy = GxClamp((int)floorf(rv * (float)tex->height), 0, tex->height - 1);
+				const uint* row = tex->pixels + iy * tex->width;
+				if(ix >= 0 && ix + n <= tex->width)
+					memcpy(span, row + ix, n * sizeof(uint));
+				else
+					for(int i=0; i<n; ++i) span[i] = row[GxClamp(ix + i, 0, tex->width - 1)];
+			}
+			else
+			{
+				SampleSpan(tex, u, du, rv, span, n);
+			}
+
+			if(!isGradientH)
+			{
+				if(cl != 0xFFFFFFFF) ModulateSpan(span, cl, n);
+			}
+			else
+			{
+				for(int i=0; i<n; ++i)
+				{
+					const float fx = ((float)(l + i) + 0.5f - x0) / w;
+					span[i] = Modulate(span[i], Lerp(cl, cr, (uint)GxClamp((int)(fx * 256.f), 0, 256)));
+				}
+			}
+		}
+		else
+		{
+			for(int i=0; i<n; ++i)
+			{
+				const float fx = ((float)(l + i) + 0.5f - x0) / w;
+				span[i] = Lerp(cl, cr, (uint)GxClamp((int)(fx * 256.f), 0, 256));
+			}
+		}
+		BlendSpan(myBlendMode, dst, span, n);
+	}
+}
+
+// Rasterizes a triangle with scanlines. Pixels are filled if their center lies inside the triangle;
+// pixels on left and top edges are included, pixels on right and bottom edges are not.
+void GxRenderInterfaceSoftware::myDrawTriangle(const GxVertex& a, const GxVertex& b, const GxVertex& c, GxTextureHandle texture)
+{
+	const float e1x = b.pos.x - a.pos.x, e1y = b.pos.y - a.pos.y;
+	const float e2x = c.pos.x - a.pos.x, e2y = c.pos.y - a.pos.y;
+	const float area = e1x * e2y - e2x * e1y;
+	if(fabsf(area) < 1e-6f) return;
+
+	// Sort the vertices by their vertical position.
+	const GxVertex* p[3] = {&a, &b, &c};
+	if(p[1]->pos.y < p[0]->pos.y) GxSwap(p[0], p[1]);
+	if(p[2]->pos.y < p[1]->pos.y) GxSwap(p[1], p[2]);
+	if(p[1]->pos.y < p[0]->pos.y) GxSwap(p[0], p[1]);
+
+	const GxRecti& clip = myClipRect;
+	const int top = GxMax(clip.y, PixelEdge(p[0]->pos.y));
+	const int bottom = GxMin(clip.y + clip.h, PixelEdge(p[2]->pos.y));
+	if(top >= bottom) return;
+
+	// Calculate the gradients of the vertex attributes; color channels followed by texture coordinates.
+	float attr[6], ddx[6], ddy[6];
+	const float va[6] = {(float)a.color.r, (float)a.color.g, (float)a.color.b, (float)a.color.a, a.uvs.x, a.uvs.y};
+	const float vb[6] = {(float)b.color.r, (float)b.color.g, (float)b.color.b, (float)b.color.a, b.uvs.x, b.uvs.y};
+	const float vc[6] = {(float)c.color.r, (float)c.color.g, (float)c.color.b, (float)c.color.a, c.uvs.x, c.uvs.y};
+	for(int i=0; i<6; ++i)
+	{
+		const float d1 = vb[i] - va[i], d2 = vc[i] - va[i];
+		ddx[i] = (d1 * e2y - d2 * e1y) / area;
+		ddy[i] = (d2 * e1x - d1 * e2x) / area;
+	}
+
+	const Texture* tex = (const Texture*)texture;
+	const uint color = ToPixel(a.color);
+	const bool isFlat = (color == ToPixel(b.color) && color == ToPixel(c.color));
+
+	for(int y=top; y<bottom; ++y)
+	{
+		// Find the horizontal span of the triangle at the center of the row. Edges are always
+		// evaluated from top to bottom, so triangles that share an edge do not overlap.
+		const float yc = (float)y + 0.5f;
+		const GxVertex* e0 = (yc < p[1]->pos.y) ? p[0] : p[1];
+		const GxVertex* e1 = (yc < p[1]->pos.y) ? p[1] : p[2];
+		const float xa = p[0]->pos.x + (yc - p[0]->pos.y) * (p[2]->pos.x - p[0]->pos.x) / (p[2]->pos.y - p[0]->pos.y);
+		const float xb = e0->pos.x + (yc - e0->pos.y) * (e1->pos.x - e0->pos.x) / (e1->pos.y - e0->pos.y);
+
+		const int l = GxMax(clip.x, PixelEdge(GxMin(xa, xb)));
+		const int r = GxMin(clip.x + clip.w, PixelEdge(GxMax(xa, xb)));
+		if(l >= r) continue;
+
+		const int n = r - l;
+		uint* dst = myPixels + y * myViewSize.x + l;
+		if(!tex && isFlat)
+		{
+			FillSpan(myBlendMode, dst, color, n);
+			continue;
+		}
+
+		// Evaluate the attributes at the center of the first pixel, and step them per pixel.
+		const float dx = (float)l + 0.5f - a.pos.x, dy = yc - a.pos.y;
+		for(int i=0; i<6; ++i)
+			attr[i] = va[i] + ddx[i] * dx + ddy[i] * dy;
+
+		uint* span = mySpan;
+		for(int i=0; i<n; ++i)
+		{
+			uint px = color;
+			if(!isFlat)
+			{
+				const uint cr = (uint)GxClamp((int)(attr[0] + 0.5f), 0, 255);
+				const uint cg = (uint)GxClamp((int)(attr[1] + 0.5f), 0, 255);
+				const uint cb = (uint)GxClamp((int)(attr[2] + 0.5f), 0, 255);
+				const uint ca = (uint)GxClamp((int)(attr[3] + 0.5f), 0, 255);
+				px = cr | (cg << 8) | (cb << 16) | (ca << 24);
+			}
+			if(tex)
+				px = Modulate(Sample(tex, attr[4], attr[5]), px);
+
+			span[i] = px;
+			for(int j=0; j<6; ++j)
+				attr[j] += ddx[j];
+		}
+		BlendSpan(myBlendMode, dst, span, n);
+	}
+}
+
+}; // namespace framework
+}; // namespace guix
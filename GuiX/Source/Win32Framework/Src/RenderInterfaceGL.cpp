@@ -123,6 +123,26 @@ bool GxRenderInterfaceGL::LoadTexture(GxTextureHandle& outTexture, int& outWidth
 {
 	outWidth = outHeight = 0;
 
+	int w, h;
+	uchar* bits = NULL;
+	if(!LoadPixels(bits, w, h, path)) return false;
+
+	// If the loading succeeded, we fill in the output data.
+	bool result = GenerateTexture(outTexture, w, h, bits);
+	if(result)
+	{
+		outWidth = w;
+		outHeight = h;
+	}
+	ReleasePixels(bits);
+	return result;
+}
+
+bool GxRenderInterfaceGL::LoadPixels(uchar*& outPixels, int& outWidth, int& outHeight, const char* path)
+{
+	outPixels = NULL;
+	outWidth = outHeight = 0;
+
 	// Try to open the image file.
 	GxFileInterface* io = GxFileInterface::Get();
 	GxFileHandle file = io->Open(path);
@@ -136,19 +156,18 @@ bool GxRenderInterfaceGL::LoadTexture(GxTextureHandle& outTexture, int& outWidth
 
 	int cfmt, w, h;
 	uchar* bits = (uchar*)stbi_load_from_callbacks(&callbacks, &file, &w, &h, &cfmt, STBI_rgb_alpha);
-	const char* reason = stbi_failure_reason();
 	io->Close(file);
 	if(!bits) return false;
 
-	// If the loading succeeded, we fill in the output data.
-	bool result = GenerateTexture(outTexture, w, h, bits);
-	if(result)
-	{
-		outWidth = w;
-		outHeight = h;
-	}
-	stbi_image_free(bits);
-	return result;
+	outPixels = bits;
+	outWidth = w;
+	outHeight = h;
+	return true;
+}
+
+void GxRenderInterfaceGL::ReleasePixels(uchar* pixels)
+{
+	stbi_image_free(pixels);
 }
 
 bool GxRenderInterfaceGL::GenerateTexture(GxTextureHandle& outTexture, int width, int height, const uchar* pixeldata)
@@ -174,6 +193,14 @@ void GxRenderInterfaceGL::ReleaseTexture(GxTextureHandle texture_handle)
 	glDeleteTextures(1, (GLuint*) &texture_handle);
 }
 
+bool GxRenderInterfaceGL::UpdateTexture(GxTextureHandle texture, int x, int y, int width, int height, const uchar* pixeldata)
+{
+	glBindTexture(GL_TEXTURE_2D, (GLuint)texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixeldata);
+	return true;
+}
+
 static void SetBlendFunc(uint src, uint dst)
 {
 	glEnable(GL_BLEND);